@@ -167,14 +167,23 @@ file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/hybridcd.cmake.lst "${CMAKE_CURRENT_BINAR
 add_allusers_profile_dirs(${CMAKE_CURRENT_BINARY_DIR}/hybridcd.cmake.lst "livecd/Profiles")
 add_user_profile_dirs(${CMAKE_CURRENT_BINARY_DIR}/hybridcd.cmake.lst "livecd/Profiles" "Default User")
 
+# The live image is only compressed on request, see COMPRESS_HYBRIDCD_LIVECD
+set(_livecd_compress_command)
+set(_livecd_compress_depends)
+if(COMPRESS_HYBRIDCD_LIVECD)
+    set(_livecd_compress_command COMMAND native-bootcomp ${REACTOS_BINARY_DIR}/livecd.iso ${REACTOS_BINARY_DIR}/livecd.is_)
+    set(_livecd_compress_depends native-bootcomp)
+endif()
+
 add_custom_target(hybridcd
+    ${_livecd_compress_command}
     COMMAND native-mkisofs -quiet -o ${REACTOS_BINARY_DIR}/hybridcd.iso -iso-level 4
         -publisher ${ISO_MANUFACTURER} -preparer ${ISO_MANUFACTURER} -volid ${ISO_VOLNAME} -volset ${ISO_VOLNAME}
         -eltorito-boot loader/isoboot.bin -no-emul-boot -boot-load-size 4 ${ISO_EFI_BOOT_PARAMS} -hide boot.catalog
         -sort ${CMAKE_CURRENT_BINARY_DIR}/bootfiles.sort
         -duplicates-once -no-cache-inodes -graft-points -path-list ${CMAKE_CURRENT_BINARY_DIR}/hybridcd.$<CONFIG>.lst
     COMMAND native-isohybrid -b ${_isombr_file} -t 0x96 ${REACTOS_BINARY_DIR}/hybridcd.iso
-    DEPENDS bootcd livecd
+    DEPENDS bootcd livecd ${_livecd_compress_depends}
     VERBATIM)
 
 if(DEFINED EFI_PLATFORM_ID)
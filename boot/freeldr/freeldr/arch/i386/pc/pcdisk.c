@@ -821,11 +821,12 @@ PcDiskGetCacheableBlockCount(UCHAR DriveNumber)
         return 1; // Unknown count.
 
     /*
-     * If LBA is supported then the block size will be 64 sectors (32k).
-     * If not then the block size is the size of one track.
+     * If LBA is supported then the block size will be 16 sectors (8k),
+     * so that the cache can read several blocks at once into the disk
+     * read buffer. If not then the block size is the size of one track.
      */
     if (DiskDrive->Int13ExtensionsSupported)
-        return 64;
+        return 16;
     else
         return DiskDrive->Geometry.SectorsPerTrack;
 }
@@ -95,6 +95,7 @@
 @ cdecl TuiPrintf()
 
 # Other
+@ cdecl CacheDumpStatistics()
 @ cdecl ChainLoadBiosBootSectorCode()
 @ cdecl ConstructArcPath()
 @ cdecl DissectArcPath()
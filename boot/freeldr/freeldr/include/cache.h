@@ -23,18 +23,27 @@
 #define TAG_CACHE_DATA 'DcaC'
 #define TAG_CACHE_BLOCK 'BcaC'
 
+// Number of buckets of the block hash table, must be a power of two
+#define CACHE_HASH_SIZE 256
+
+// Maximum number of blocks read ahead once the reads look sequential
+#define CACHE_READ_AHEAD_BLOCKS 8
+
 ///////////////////////////////////////////////////////////////////////////////////////
 //
 // This structure describes a cached block element. The disk is divided up into
 // cache blocks. For disks which LBA is not supported each block is the size of
 // one track. This will force the cache manager to make track sized reads, and
 // therefore maximizes throughput. For disks which support LBA the block size
-// is 64k because they have no cylinder, head, or sector boundaries.
+// is 8k because they have no cylinder, head, or sector boundaries. Adjacent
+// blocks missing from the cache are read together with a single disk read,
+// as many as fit in the disk read buffer.
 //
 ///////////////////////////////////////////////////////////////////////////////////////
 typedef struct
 {
     LIST_ENTRY    ListEntry;                    // Doubly linked list synchronization member
+    LIST_ENTRY    HashEntry;                    // Hash bucket list member
 
     ULONG            BlockNumber;                // Track index for CHS, 64k block index for LBA
     BOOLEAN        LockedInCache;                // Indicates that this block is locked in cache memory
@@ -57,10 +66,29 @@ typedef struct
     ULONG            BytesPerSector;
 
     ULONG            BlockSize;            // Block size (in sectors)
-    LIST_ENTRY        CacheBlockHead;            // Contains CACHE_BLOCK structures
+    LIST_ENTRY        CacheBlockHead;            // Contains CACHE_BLOCK structures, most recently used first
+    LIST_ENTRY        HashTable[CACHE_HASH_SIZE];    // Contains CACHE_BLOCK structures, hashed by block number
+
+    ULONG            NextSequentialBlock;    // Block following the last one read from the disk
 
 } CACHE_DRIVE, *PCACHE_DRIVE;
 
+///////////////////////////////////////////////////////////////////////////////////////
+//
+// Statistics of the cache manager, dumped to the debug output port
+// by CacheDumpStatistics() before the OS loader hands over control.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    ULONG            BlockHits;            // Blocks found in the cache
+    ULONG            BlockMisses;            // Blocks read from the disk on request
+    ULONG            BlocksReadAhead;        // Blocks read from the disk ahead of time
+    ULONG            ReadsIssued;            // Number of disk reads
+    ULONGLONG        BytesRead;            // Number of bytes read from the disk
+
+} CACHE_STATISTICS, *PCACHE_STATISTICS;
+
 
 ///////////////////////////////////////////////////////////////////////////////////////
 //
@@ -72,15 +100,17 @@ extern    BOOLEAN            CacheManagerInitialized;
 extern    ULONG                CacheBlockCount;
 extern    SIZE_T                CacheSizeLimit;
 extern    SIZE_T                CacheSizeCurrent;
+extern    ULONG                CacheReadAheadBlocks;
+extern    CACHE_STATISTICS    CacheStatistics;
 
 ///////////////////////////////////////////////////////////////////////////////////////
 //
 // Internal functions
 //
 ///////////////////////////////////////////////////////////////////////////////////////
-PCACHE_BLOCK    CacheInternalGetBlockPointer(PCACHE_DRIVE CacheDrive, ULONG BlockNumber);                // Returns a pointer to a CACHE_BLOCK structure given a block number
-PCACHE_BLOCK    CacheInternalFindBlock(PCACHE_DRIVE CacheDrive, ULONG BlockNumber);                    // Searches the block list for a particular block
-PCACHE_BLOCK    CacheInternalAddBlockToCache(PCACHE_DRIVE CacheDrive, ULONG BlockNumber);                // Adds a block to the cache's block list
+PCACHE_BLOCK    CacheInternalGetBlockPointer(PCACHE_DRIVE CacheDrive, ULONG BlockNumber, ULONG BlockCount);    // Returns a pointer to a CACHE_BLOCK structure given a block number, BlockCount blocks are about to be read
+PCACHE_BLOCK    CacheInternalFindBlock(PCACHE_DRIVE CacheDrive, ULONG BlockNumber);                    // Searches the block hash table for a particular block
+PCACHE_BLOCK    CacheInternalAddBlocksToCache(PCACHE_DRIVE CacheDrive, ULONG BlockNumber, ULONG BlockCount);    // Reads a run of blocks with a single disk read and adds them to the cache's block list
 BOOLEAN            CacheInternalFreeBlock(PCACHE_DRIVE CacheDrive);                                    // Removes a block from the cache's block list & frees the memory
 VOID            CacheInternalCheckCacheSizeLimits(PCACHE_DRIVE CacheDrive);                            // Checks the cache size limits to see if we can add a new block, if not calls CacheInternalFreeBlock()
 VOID            CacheInternalDumpBlockList(PCACHE_DRIVE CacheDrive);                                // Dumps the list of cached blocks to the debug output port
@@ -92,3 +122,4 @@ VOID    CacheInvalidateCacheData(VOID);
 BOOLEAN    CacheReadDiskSectors(UCHAR DiskNumber, ULONGLONG StartSector, ULONG SectorCount, PVOID Buffer);
 BOOLEAN    CacheForceDiskSectorsIntoCache(UCHAR DiskNumber, ULONGLONG StartSector, ULONG SectorCount);
 BOOLEAN    CacheReleaseMemory(ULONG MinimumAmountToRelease);
+VOID    CacheDumpStatistics(VOID);
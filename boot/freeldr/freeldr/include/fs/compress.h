@@ -0,0 +1,35 @@
+/*
+ * PROJECT:     FreeLoader
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Transparent access to files compressed by the bootcomp tool
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+/*
+ * A compressed file starts with this header, followed by BlockCount + 1
+ * offsets (from the start of the file) delimiting the data of each block.
+ * Blocks are compressed independently so that they can be read in any order.
+ * A block whose data is as large as the block itself is stored as is.
+ *
+ * Keep in sync with sdk/tools/bootcomp/bootcomp.c
+ */
+#define COMPRESSED_FILE_SIGNATURE   0x31435A46 // "FZC1"
+#define COMPRESSED_MIN_BLOCK_SHIFT  12
+#define COMPRESSED_MAX_BLOCK_SHIFT  20
+
+#include <pshpack1.h>
+typedef struct _COMPRESSED_FILE_HEADER
+{
+    ULONG Signature;
+    USHORT Format;          // COMPRESSION_FORMAT_LZNT1
+    USHORT BlockShift;
+    ULONG UncompressedSize;
+    ULONG BlockCount;
+} COMPRESSED_FILE_HEADER, *PCOMPRESSED_FILE_HEADER;
+#include <poppack.h>
+
+extern const DEVVTBL CompressedFileFuncTable;
+
+ULONG CompressedGetBaseFileId(ULONG FileId);
@@ -145,13 +145,22 @@ typedef struct
 
 typedef struct _FAT_VOLUME_INFO *PFAT_VOLUME_INFO;
 
+/* A run of contiguous clusters of a cluster chain */
+typedef struct
+{
+    ULONG    FileCluster;     /* Index of the first cluster of the run in the chain */
+    ULONG    DiskCluster;     /* First cluster of the run on the volume */
+    ULONG    ClusterCount;    /* Number of clusters in the run */
+} FAT_EXTENT, * PFAT_EXTENT;
+
 typedef struct
 {
     PFAT_VOLUME_INFO    Volume;
     ULONG    FileSize;        /* File size */
     ULONG    FilePointer;        /* File pointer */
-    ULONG    CurrentCluster;  /* The cluster for file pointer */
     ULONG    StartCluster;    /* The first cluster for file */
+    PFAT_EXTENT    Extents;   /* Cluster runs of the file, built on open */
+    ULONG    ExtentCount;     /* Number of entries in Extents */
     UCHAR    Attributes;      /* File attributes */
 } FAT_FILE_INFO, * PFAT_FILE_INFO;
 
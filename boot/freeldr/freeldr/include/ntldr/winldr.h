@@ -13,6 +13,7 @@
 #define TAG_WLDR_DTE 'eDlW'
 #define TAG_WLDR_BDE 'dBlW'
 #define TAG_WLDR_NAME 'mNlW'
+#define TAG_WLDR_PRELOAD 'lPlW'
 
 // Some definitions
 
@@ -42,6 +42,15 @@ PeLdrLoadImageEx(
     _Out_ PVOID* ImageBasePA,
     _In_ BOOLEAN KernelMapping);
 
+BOOLEAN
+PeLdrPreloadImages(
+    _In_ PLIST_ENTRY ModuleListHead,
+    _In_reads_(FileCount) PCSTR* FilePaths,
+    _In_ ULONG FileCount);
+
+VOID
+PeLdrFreePreloadedImages(VOID);
+
 BOOLEAN
 PeLdrAllocateDataTableEntry(
     IN OUT PLIST_ENTRY ModuleListHead,
@@ -22,14 +22,17 @@
 #include <debug.h>
 DBG_DEFAULT_CHANNEL(CACHE);
 
+#define CACHE_HASH_BUCKET(BlockNumber)    ((BlockNumber) & (CACHE_HASH_SIZE - 1))
+
 // Returns a pointer to a CACHE_BLOCK structure
 // Adds the block to the cache manager block list
 // in cache memory if it isn't already there
-PCACHE_BLOCK CacheInternalGetBlockPointer(PCACHE_DRIVE CacheDrive, ULONG BlockNumber)
+PCACHE_BLOCK CacheInternalGetBlockPointer(PCACHE_DRIVE CacheDrive, ULONG BlockNumber, ULONG BlockCount)
 {
     PCACHE_BLOCK    CacheBlock = NULL;
+    ULONG            ReadCount;
 
-    TRACE("CacheInternalGetBlockPointer() BlockNumber = %d\n", BlockNumber);
+    TRACE("CacheInternalGetBlockPointer() BlockNumber = %d BlockCount = %d\n", BlockNumber, BlockCount);
 
     CacheBlock = CacheInternalFindBlock(CacheDrive, BlockNumber);
 
@@ -37,12 +40,31 @@ PCACHE_BLOCK CacheInternalGetBlockPointer(PCACHE_DRIVE CacheDrive, ULONG BlockNu
     {
         TRACE("Cache hit! BlockNumber: %d CacheBlock->BlockNumber: %d\n", BlockNumber, CacheBlock->BlockNumber);
 
-        return CacheBlock;
+        CacheStatistics.BlockHits++;
+
+        // Increment the blocks access count
+        CacheBlock->AccessCount++;
     }
+    else
+    {
+        TRACE("Cache miss! BlockNumber: %d\n", BlockNumber);
 
-    TRACE("Cache miss! BlockNumber: %d\n", BlockNumber);
+        CacheStatistics.BlockMisses++;
+
+        // Read all the blocks the caller is about to need at once,
+        // and some more if this continues the previous disk read
+        ReadCount = BlockCount;
+        if (BlockNumber == CacheDrive->NextSequentialBlock)
+        {
+            ReadCount += CacheReadAheadBlocks;
+        }
 
-    CacheBlock = CacheInternalAddBlockToCache(CacheDrive, BlockNumber);
+        CacheBlock = CacheInternalAddBlocksToCache(CacheDrive, BlockNumber, ReadCount);
+        if (CacheBlock == NULL)
+        {
+            return NULL;
+        }
+    }
 
     // Optimize the block list so it has a LRU structure
     CacheInternalOptimizeBlockList(CacheDrive, CacheBlock);
@@ -52,91 +74,123 @@ PCACHE_BLOCK CacheInternalGetBlockPointer(PCACHE_DRIVE CacheDrive, ULONG BlockNu
 
 PCACHE_BLOCK CacheInternalFindBlock(PCACHE_DRIVE CacheDrive, ULONG BlockNumber)
 {
-    PCACHE_BLOCK    CacheBlock = NULL;
+    PLIST_ENTRY        BucketHead;
+    PLIST_ENTRY        Entry;
+    PCACHE_BLOCK    CacheBlock;
 
     TRACE("CacheInternalFindBlock() BlockNumber = %d\n", BlockNumber);
 
     //
-    // Make sure the block list has entries before I start searching it.
+    // Search the hash bucket of this block number
     //
-    if (!IsListEmpty(&CacheDrive->CacheBlockHead))
+    BucketHead = &CacheDrive->HashTable[CACHE_HASH_BUCKET(BlockNumber)];
+
+    for (Entry = BucketHead->Flink; Entry != BucketHead; Entry = Entry->Flink)
     {
+        CacheBlock = CONTAINING_RECORD(Entry, CACHE_BLOCK, HashEntry);
+
         //
-        // Search the list and find the BIOS drive number
+        // We found the block, so return it
         //
-        CacheBlock = CONTAINING_RECORD(CacheDrive->CacheBlockHead.Flink, CACHE_BLOCK, ListEntry);
-
-        while (&CacheBlock->ListEntry != &CacheDrive->CacheBlockHead)
+        if (CacheBlock->BlockNumber == BlockNumber)
         {
-            //
-            // We found the block, so return it
-            //
-            if (CacheBlock->BlockNumber == BlockNumber)
-            {
-                //
-                // Increment the blocks access count
-                //
-                CacheBlock->AccessCount++;
-
-                return CacheBlock;
-            }
-
-            CacheBlock = CONTAINING_RECORD(CacheBlock->ListEntry.Flink, CACHE_BLOCK, ListEntry);
+            return CacheBlock;
         }
     }
 
     return NULL;
 }
 
-PCACHE_BLOCK CacheInternalAddBlockToCache(PCACHE_DRIVE CacheDrive, ULONG BlockNumber)
+PCACHE_BLOCK CacheInternalAddBlocksToCache(PCACHE_DRIVE CacheDrive, ULONG BlockNumber, ULONG BlockCount)
 {
-    PCACHE_BLOCK    CacheBlock = NULL;
+    PCACHE_BLOCK    CacheBlock;
+    PCACHE_BLOCK    FirstCacheBlock = NULL;
+    ULONG            BlockBytes = CacheDrive->BlockSize * CacheDrive->BytesPerSector;
+    ULONG            MaxBlocks;
+    ULONG            Idx;
 
-    TRACE("CacheInternalAddBlockToCache() BlockNumber = %d\n", BlockNumber);
+    TRACE("CacheInternalAddBlocksToCache() BlockNumber = %d BlockCount = %d\n", BlockNumber, BlockCount);
 
-    // Check the size of the cache so we don't exceed our limits
-    CacheInternalCheckCacheSizeLimits(CacheDrive);
+    // A single read must fit in the disk read buffer,
+    // and must not evict the blocks it just read
+    MaxBlocks = (ULONG)min(DiskReadBufferSize, CacheSizeLimit) / BlockBytes;
+    BlockCount = max(min(BlockCount, MaxBlocks), 1);
 
-    // We will need to add the block to the
-    // drive's list of cached blocks. So allocate
-    // the block memory.
-    CacheBlock = FrLdrTempAlloc(sizeof(CACHE_BLOCK), TAG_CACHE_BLOCK);
-    if (CacheBlock == NULL)
+    // Stop at the first block that is already cached
+    for (Idx = 1; Idx < BlockCount; Idx++)
     {
-        return NULL;
+        if (CacheInternalFindBlock(CacheDrive, BlockNumber + Idx) != NULL)
+        {
+            break;
+        }
     }
-
-    // Now initialize the structure and
-    // allocate room for the block data
-    RtlZeroMemory(CacheBlock, sizeof(CACHE_BLOCK));
-    CacheBlock->BlockNumber = BlockNumber;
-    CacheBlock->BlockData = FrLdrTempAlloc(CacheDrive->BlockSize * CacheDrive->BytesPerSector,
-                                           TAG_CACHE_DATA);
-    if (CacheBlock->BlockData ==NULL)
+    BlockCount = Idx;
+
+    // Now try to read in the blocks. The blocks read ahead may
+    // lie beyond the end of the disk, so if that fails try again
+    // with the requested block only.
+    while (!MachDiskReadLogicalSectors(CacheDrive->DriveNumber,
+                                       (ULONGLONG)BlockNumber * CacheDrive->BlockSize,
+                                       BlockCount * CacheDrive->BlockSize,
+                                       DiskReadBuffer))
     {
-        FrLdrTempFree(CacheBlock, TAG_CACHE_BLOCK);
-        return NULL;
+        if (BlockCount == 1)
+        {
+            return NULL;
+        }
+
+        BlockCount = 1;
     }
 
-    // Now try to read in the block
-    if (!MachDiskReadLogicalSectors(CacheDrive->DriveNumber, (BlockNumber * CacheDrive->BlockSize), CacheDrive->BlockSize, DiskReadBuffer))
+    CacheStatistics.ReadsIssued++;
+    CacheStatistics.BytesRead += (ULONGLONG)BlockCount * BlockBytes;
+    CacheStatistics.BlocksReadAhead += BlockCount - 1;
+    CacheDrive->NextSequentialBlock = BlockNumber + BlockCount;
+
+    for (Idx = 0; Idx < BlockCount; Idx++)
     {
-        FrLdrTempFree(CacheBlock->BlockData, TAG_CACHE_DATA);
-        FrLdrTempFree(CacheBlock, TAG_CACHE_BLOCK);
-        return NULL;
-    }
-    RtlCopyMemory(CacheBlock->BlockData, DiskReadBuffer, CacheDrive->BlockSize * CacheDrive->BytesPerSector);
+        // Check the size of the cache so we don't exceed our limits
+        CacheInternalCheckCacheSizeLimits(CacheDrive);
+
+        // We will need to add the block to the
+        // drive's list of cached blocks. So allocate
+        // the block memory.
+        CacheBlock = FrLdrTempAlloc(sizeof(CACHE_BLOCK), TAG_CACHE_BLOCK);
+        if (CacheBlock == NULL)
+        {
+            break;
+        }
 
-    // Add it to our list of blocks managed by the cache
-    InsertTailList(&CacheDrive->CacheBlockHead, &CacheBlock->ListEntry);
+        // Now initialize the structure and
+        // allocate room for the block data
+        RtlZeroMemory(CacheBlock, sizeof(CACHE_BLOCK));
+        CacheBlock->BlockNumber = BlockNumber + Idx;
+        CacheBlock->BlockData = FrLdrTempAlloc(BlockBytes, TAG_CACHE_DATA);
+        if (CacheBlock->BlockData == NULL)
+        {
+            FrLdrTempFree(CacheBlock, TAG_CACHE_BLOCK);
+            break;
+        }
+        RtlCopyMemory(CacheBlock->BlockData, (PUCHAR)DiskReadBuffer + Idx * BlockBytes, BlockBytes);
 
-    // Update the cache data
-    CacheBlockCount++;
-    CacheSizeCurrent = CacheBlockCount * (CacheDrive->BlockSize * CacheDrive->BytesPerSector);
+        // Add it to our list of blocks managed by the cache.
+        // It was just read, so it goes to the head of the list.
+        InsertHeadList(&CacheDrive->CacheBlockHead, &CacheBlock->ListEntry);
+        InsertHeadList(&CacheDrive->HashTable[CACHE_HASH_BUCKET(CacheBlock->BlockNumber)], &CacheBlock->HashEntry);
+
+        // Update the cache data
+        CacheBlockCount++;
+        CacheSizeCurrent = CacheBlockCount * BlockBytes;
+
+        if (Idx == 0)
+        {
+            FirstCacheBlock = CacheBlock;
+        }
+    }
 
     CacheInternalDumpBlockList(CacheDrive);
 
-    return CacheBlock;
+    return FirstCacheBlock;
 }
 
 BOOLEAN CacheInternalFreeBlock(PCACHE_DRIVE CacheDrive)
@@ -162,6 +216,7 @@ BOOLEAN CacheInternalFreeBlock(PCACHE_DRIVE CacheDrive)
     }
 
     RemoveEntryList(&CacheBlockToFree->ListEntry);
+    RemoveEntryList(&CacheBlockToFree->HashEntry);
 
     // Free the block memory and the block structure
     FrLdrTempFree(CacheBlockToFree->BlockData, TAG_CACHE_DATA);
@@ -193,7 +248,9 @@ VOID CacheInternalCheckCacheSizeLimits(PCACHE_DRIVE CacheDrive)
 
 VOID CacheInternalDumpBlockList(PCACHE_DRIVE CacheDrive)
 {
+#if DBG
     PCACHE_BLOCK    CacheBlock;
+#endif
 
     TRACE("Dumping block list for BIOS drive 0x%x.\n", CacheDrive->DriveNumber);
     TRACE("BytesPerSector: %d.\n", CacheDrive->BytesPerSector);
@@ -202,6 +259,8 @@ VOID CacheInternalDumpBlockList(PCACHE_DRIVE CacheDrive)
     TRACE("CacheSizeCurrent: %d.\n", CacheSizeCurrent);
     TRACE("CacheBlockCount: %d.\n", CacheBlockCount);
 
+#if DBG
+    // Walking the whole list on every cache miss is only worth it in debug builds
     CacheBlock = CONTAINING_RECORD(CacheDrive->CacheBlockHead.Flink, CACHE_BLOCK, ListEntry);
     while (&CacheBlock->ListEntry != &CacheDrive->CacheBlockHead)
     {
@@ -218,6 +277,7 @@ VOID CacheInternalDumpBlockList(PCACHE_DRIVE CacheDrive)
 
         CacheBlock = CONTAINING_RECORD(CacheBlock->ListEntry.Flink, CACHE_BLOCK, ListEntry);
     }
+#endif
 }
 
 VOID CacheInternalOptimizeBlockList(PCACHE_DRIVE CacheDrive, PCACHE_BLOCK CacheBlock)
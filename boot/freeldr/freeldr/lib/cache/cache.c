@@ -33,11 +33,14 @@ BOOLEAN            CacheManagerDataInvalid = FALSE;
 ULONG            CacheBlockCount = 0;
 SIZE_T            CacheSizeLimit = 0;
 SIZE_T            CacheSizeCurrent = 0;
+ULONG            CacheReadAheadBlocks = CACHE_READ_AHEAD_BLOCKS;
+CACHE_STATISTICS    CacheStatistics;
 
 BOOLEAN CacheInitializeDrive(UCHAR DriveNumber)
 {
     PCACHE_BLOCK    NextCacheBlock;
     GEOMETRY    DriveGeometry;
+    ULONG        Idx;
 
     // If we already have a cache for this drive then
     // by all means lets keep it, unless it is a removable
@@ -80,6 +83,10 @@ BOOLEAN CacheInitializeDrive(UCHAR DriveNumber)
     // Initialize the structure
     RtlZeroMemory(&CacheManagerDrive, sizeof(CACHE_DRIVE));
     InitializeListHead(&CacheManagerDrive.CacheBlockHead);
+    for (Idx = 0; Idx < CACHE_HASH_SIZE; Idx++)
+    {
+        InitializeListHead(&CacheManagerDrive.HashTable[Idx]);
+    }
     CacheManagerDrive.DriveNumber = DriveNumber;
     if (!MachDiskGetDriveGeometry(DriveNumber, &DriveGeometry))
     {
@@ -148,7 +155,7 @@ BOOLEAN CacheReadDiskSectors(UCHAR DiskNumber, ULONGLONG StartSector, ULONG Sect
         //
         // Get cache block pointer (this forces the disk sectors into the cache memory)
         //
-        CacheBlock = CacheInternalGetBlockPointer(&CacheManagerDrive, StartBlock);
+        CacheBlock = CacheInternalGetBlockPointer(&CacheManagerDrive, StartBlock, BlockCount);
         if (CacheBlock == NULL)
         {
             return FALSE;
@@ -181,7 +188,7 @@ BOOLEAN CacheReadDiskSectors(UCHAR DiskNumber, ULONGLONG StartSector, ULONG Sect
         //
         // Get cache block pointer (this forces the disk sectors into the cache memory)
         //
-        CacheBlock = CacheInternalGetBlockPointer(&CacheManagerDrive, Idx);
+        CacheBlock = CacheInternalGetBlockPointer(&CacheManagerDrive, Idx, BlockCount);
         if (CacheBlock == NULL)
         {
             return FALSE;
@@ -214,7 +221,7 @@ BOOLEAN CacheReadDiskSectors(UCHAR DiskNumber, ULONGLONG StartSector, ULONG Sect
         //
         // Get cache block pointer (this forces the disk sectors into the cache memory)
         //
-        CacheBlock = CacheInternalGetBlockPointer(&CacheManagerDrive, EndBlock);
+        CacheBlock = CacheInternalGetBlockPointer(&CacheManagerDrive, EndBlock, 1);
         if (CacheBlock == NULL)
         {
             return FALSE;
@@ -274,7 +281,7 @@ BOOLEAN CacheForceDiskSectorsIntoCache(UCHAR DiskNumber, ULONGLONG StartSector,
         //
         // Get cache block pointer (this forces the disk sectors into the cache memory)
         //
-        CacheBlock = CacheInternalGetBlockPointer(&CacheManagerDrive, Idx);
+        CacheBlock = CacheInternalGetBlockPointer(&CacheManagerDrive, Idx, StartBlock + BlockCount - Idx);
         if (CacheBlock == NULL)
         {
             return FALSE;
@@ -319,3 +326,18 @@ BOOLEAN CacheReleaseMemory(ULONG MinimumAmountToRelease)
     // Return status
     return (AmountReleased >= MinimumAmountToRelease);
 }
+
+VOID CacheDumpStatistics(VOID)
+{
+#if DBG
+    ULONG    BlockAccesses = CacheStatistics.BlockHits + CacheStatistics.BlockMisses;
+
+    TRACE("Disk cache statistics:\n");
+    TRACE("Bytes read: %I64u in %d reads.\n", CacheStatistics.BytesRead, CacheStatistics.ReadsIssued);
+    TRACE("Block hits: %d misses: %d hit rate: %d%%.\n",
+          CacheStatistics.BlockHits,
+          CacheStatistics.BlockMisses,
+          BlockAccesses ? (CacheStatistics.BlockHits * 100 / BlockAccesses) : 0);
+    TRACE("Blocks read along with a miss: %d.\n", CacheStatistics.BlocksReadAhead);
+#endif
+}
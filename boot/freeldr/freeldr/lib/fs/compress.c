@@ -0,0 +1,343 @@
+/*
+ * PROJECT:     FreeLoader
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Transparent access to files compressed by the bootcomp tool
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+/*
+ * ArcOpen() falls back to the compressed form of a file ("ntoskrnl.ex_" for
+ * "ntoskrnl.exe") when the file itself does not exist. The compressed file is
+ * opened as a regular file of its own file system, and reads of the file the
+ * caller asked for are served by decompressing the blocks they cover, so that
+ * even a RAM disk image never needs to be held twice in memory.
+ */
+
+#include <freeldr.h>
+
+#include <debug.h>
+DBG_DEFAULT_CHANNEL(FILESYSTEM);
+
+#define TAG_COMPRESSED_FILE 'FCsF'
+#define TAG_COMPRESSED_BUFFER 'BCsF'
+
+typedef struct _COMPRESSED_FILE
+{
+    ULONG BaseFileId;
+    ULONG FileSize;
+    ULONG FilePointer;
+    ULONG BlockShift;
+    ULONG BlockCount;
+    ULONG CachedBlock;
+    PUCHAR BlockBuffer;         // Holds the uncompressed CachedBlock
+    PUCHAR CompressedBuffer;    // Holds the data of the block being read
+    ULONG BlockOffsets[ANYSIZE_ARRAY];
+} COMPRESSED_FILE, *PCOMPRESSED_FILE;
+
+static
+ULONG
+CompressedGetBlockSize(
+    _In_ PCOMPRESSED_FILE File,
+    _In_ ULONG Block)
+{
+    ULONG BlockStart = Block << File->BlockShift;
+
+    return min(File->FileSize - BlockStart, 1UL << File->BlockShift);
+}
+
+static
+ARC_STATUS
+CompressedReadBlock(
+    _In_ PCOMPRESSED_FILE File,
+    _In_ ULONG Block,
+    _Out_writes_bytes_(CompressedGetBlockSize(File, Block)) PUCHAR Buffer)
+{
+    ULONG BlockSize = CompressedGetBlockSize(File, Block);
+    ULONG DataSize = File->BlockOffsets[Block + 1] - File->BlockOffsets[Block];
+    LARGE_INTEGER Position;
+    ARC_STATUS Status;
+    NTSTATUS NtStatus;
+    ULONG Count;
+
+    Position.QuadPart = File->BlockOffsets[Block];
+    Status = ArcSeek(File->BaseFileId, &Position, SeekAbsolute);
+    if (Status != ESUCCESS)
+        return Status;
+
+    /* Stored blocks are read in place */
+    if (DataSize == BlockSize)
+    {
+        Status = ArcRead(File->BaseFileId, Buffer, BlockSize, &Count);
+        if (Status != ESUCCESS || Count != BlockSize)
+            return EIO;
+        return ESUCCESS;
+    }
+
+    Status = ArcRead(File->BaseFileId, File->CompressedBuffer, DataSize, &Count);
+    if (Status != ESUCCESS || Count != DataSize)
+        return EIO;
+
+    NtStatus = RtlDecompressBuffer(COMPRESSION_FORMAT_LZNT1,
+                                   Buffer,
+                                   BlockSize,
+                                   File->CompressedBuffer,
+                                   DataSize,
+                                   &Count);
+    if (!NT_SUCCESS(NtStatus) || Count != BlockSize)
+    {
+        ERR("Corrupted block %lu in compressed file %lu\n", Block, File->BaseFileId);
+        return EIO;
+    }
+
+    return ESUCCESS;
+}
+
+static
+ARC_STATUS
+CompressedLoadHeader(
+    _In_ ULONG BaseFileId,
+    _Out_ PCOMPRESSED_FILE* CompressedFile)
+{
+    COMPRESSED_FILE_HEADER Header;
+    FILEINFORMATION Information;
+    PCOMPRESSED_FILE File;
+    ULONG BaseFileSize;
+    ULONG BlockSize;
+    ULONG TableSize;
+    ULONG Count;
+    ULONG i;
+    ARC_STATUS Status;
+
+    Status = ArcGetFileInformation(BaseFileId, &Information);
+    if (Status != ESUCCESS)
+        return Status;
+    if (Information.EndingAddress.HighPart != 0)
+        return EFBIG;
+    BaseFileSize = Information.EndingAddress.LowPart;
+
+    Status = ArcRead(BaseFileId, &Header, sizeof(Header), &Count);
+    if (Status != ESUCCESS || Count != sizeof(Header))
+        return EINVAL;
+
+    if (Header.Signature != COMPRESSED_FILE_SIGNATURE ||
+        Header.Format != COMPRESSION_FORMAT_LZNT1 ||
+        Header.BlockShift < COMPRESSED_MIN_BLOCK_SHIFT ||
+        Header.BlockShift > COMPRESSED_MAX_BLOCK_SHIFT)
+    {
+        return EINVAL;
+    }
+
+    BlockSize = 1UL << Header.BlockShift;
+    if (Header.BlockCount != (ULONG)(((ULONGLONG)Header.UncompressedSize + BlockSize - 1) >> Header.BlockShift))
+        return EINVAL;
+
+    TableSize = (Header.BlockCount + 1) * sizeof(ULONG);
+    File = FrLdrTempAlloc(FIELD_OFFSET(COMPRESSED_FILE, BlockOffsets) + TableSize,
+                          TAG_COMPRESSED_FILE);
+    if (!File)
+        return ENOMEM;
+
+    File->BaseFileId = BaseFileId;
+    File->FileSize = Header.UncompressedSize;
+    File->FilePointer = 0;
+    File->BlockShift = Header.BlockShift;
+    File->BlockCount = Header.BlockCount;
+    File->CachedBlock = MAXULONG;
+    File->BlockBuffer = NULL;
+    File->CompressedBuffer = NULL;
+
+    Status = ArcRead(BaseFileId, File->BlockOffsets, TableSize, &Count);
+    if (Status != ESUCCESS || Count != TableSize)
+    {
+        Status = EINVAL;
+        goto Quit;
+    }
+
+    /* The blocks must follow the table and each other, and fit the file */
+    Status = EINVAL;
+    if (File->BlockOffsets[0] != sizeof(Header) + TableSize)
+        goto Quit;
+    for (i = 0; i < File->BlockCount; ++i)
+    {
+        if (File->BlockOffsets[i + 1] < File->BlockOffsets[i] ||
+            File->BlockOffsets[i + 1] - File->BlockOffsets[i] > CompressedGetBlockSize(File, i))
+        {
+            goto Quit;
+        }
+    }
+    if (File->BlockOffsets[File->BlockCount] > BaseFileSize)
+        goto Quit;
+
+    /* The uncompressed block and the block data share one allocation */
+    File->BlockBuffer = FrLdrTempAlloc(2 * BlockSize, TAG_COMPRESSED_BUFFER);
+    if (!File->BlockBuffer)
+    {
+        Status = ENOMEM;
+        goto Quit;
+    }
+    File->CompressedBuffer = File->BlockBuffer + BlockSize;
+
+    *CompressedFile = File;
+    return ESUCCESS;
+
+Quit:
+    FrLdrTempFree(File, TAG_COMPRESSED_FILE);
+    return Status;
+}
+
+static
+ARC_STATUS
+CompressedClose(ULONG FileId)
+{
+    PCOMPRESSED_FILE File = FsGetDeviceSpecific(FileId);
+
+    ArcClose(File->BaseFileId);
+    FrLdrTempFree(File->BlockBuffer, TAG_COMPRESSED_BUFFER);
+    FrLdrTempFree(File, TAG_COMPRESSED_FILE);
+    return ESUCCESS;
+}
+
+static
+ARC_STATUS
+CompressedGetFileInformation(ULONG FileId, FILEINFORMATION* Information)
+{
+    PCOMPRESSED_FILE File = FsGetDeviceSpecific(FileId);
+
+    RtlZeroMemory(Information, sizeof(*Information));
+    Information->EndingAddress.LowPart = File->FileSize;
+    Information->CurrentAddress.LowPart = File->FilePointer;
+
+    TRACE("CompressedGetFileInformation(%lu) -> FileSize = %lu, FilePointer = 0x%lx\n",
+          FileId, Information->EndingAddress.LowPart, Information->CurrentAddress.LowPart);
+
+    return ESUCCESS;
+}
+
+/*
+ * Path is the name of the compressed file, see ArcOpen()
+ */
+static
+ARC_STATUS
+CompressedOpen(CHAR* Path, OPENMODE OpenMode, ULONG* FileId)
+{
+    PCOMPRESSED_FILE File;
+    ULONG BaseFileId;
+    ARC_STATUS Status;
+
+    if (OpenMode != OpenReadOnly)
+        return EACCES;
+
+    TRACE("CompressedOpen() FileName = %s\n", Path);
+
+    Status = ArcOpen(Path, OpenReadOnly, &BaseFileId);
+    if (Status != ESUCCESS)
+        return Status;
+
+    Status = CompressedLoadHeader(BaseFileId, &File);
+    if (Status != ESUCCESS)
+    {
+        WARN("'%s' is not a valid compressed file, Status: %u\n", Path, Status);
+        ArcClose(BaseFileId);
+        return Status;
+    }
+
+    FsSetDeviceSpecific(*FileId, File);
+    return ESUCCESS;
+}
+
+static
+ARC_STATUS
+CompressedRead(ULONG FileId, VOID* Buffer, ULONG N, ULONG* Count)
+{
+    PCOMPRESSED_FILE File = FsGetDeviceSpecific(FileId);
+    PUCHAR Destination = Buffer;
+    ULONG Block, Offset, BlockSize, Length;
+    ARC_STATUS Status;
+
+    *Count = 0;
+
+    if (File->FilePointer >= File->FileSize)
+        return ESUCCESS;
+    N = min(N, File->FileSize - File->FilePointer);
+
+    while (N > 0)
+    {
+        Block = File->FilePointer >> File->BlockShift;
+        Offset = File->FilePointer & ((1UL << File->BlockShift) - 1);
+        BlockSize = CompressedGetBlockSize(File, Block);
+        Length = min(N, BlockSize - Offset);
+
+        if (Length == BlockSize)
+        {
+            /* Whole blocks are decompressed straight into the caller's buffer */
+            Status = CompressedReadBlock(File, Block, Destination);
+            if (Status != ESUCCESS)
+                return Status;
+        }
+        else
+        {
+            if (File->CachedBlock != Block)
+            {
+                File->CachedBlock = MAXULONG;
+                Status = CompressedReadBlock(File, Block, File->BlockBuffer);
+                if (Status != ESUCCESS)
+                    return Status;
+                File->CachedBlock = Block;
+            }
+            RtlCopyMemory(Destination, File->BlockBuffer + Offset, Length);
+        }
+
+        Destination += Length;
+        File->FilePointer += Length;
+        *Count += Length;
+        N -= Length;
+    }
+
+    return ESUCCESS;
+}
+
+static
+ARC_STATUS
+CompressedSeek(ULONG FileId, LARGE_INTEGER* Position, SEEKMODE SeekMode)
+{
+    PCOMPRESSED_FILE File = FsGetDeviceSpecific(FileId);
+    LARGE_INTEGER NewPosition = *Position;
+
+    switch (SeekMode)
+    {
+        case SeekAbsolute:
+            break;
+        case SeekRelative:
+            NewPosition.QuadPart += (ULONGLONG)File->FilePointer;
+            break;
+        default:
+            ASSERT(FALSE);
+            return EINVAL;
+    }
+
+    if (NewPosition.HighPart != 0)
+        return EINVAL;
+    if (NewPosition.LowPart > File->FileSize)
+        return EINVAL;
+
+    File->FilePointer = NewPosition.LowPart;
+    return ESUCCESS;
+}
+
+ULONG
+CompressedGetBaseFileId(ULONG FileId)
+{
+    PCOMPRESSED_FILE File = FsGetDeviceSpecific(FileId);
+    return File->BaseFileId;
+}
+
+/* The service name is the one of the file system holding the compressed file */
+const DEVVTBL CompressedFileFuncTable =
+{
+    CompressedClose,
+    CompressedGetFileInformation,
+    CompressedOpen,
+    CompressedRead,
+    CompressedSeek,
+    NULL,
+};
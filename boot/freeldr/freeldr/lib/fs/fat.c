@@ -13,13 +13,12 @@
 DBG_DEFAULT_CHANNEL(FILESYSTEM);
 
 ULONG    FatDetermineFatType(PFAT_BOOTSECTOR FatBootSector, ULONGLONG PartitionSectorCount);
-PVOID    FatBufferDirectory(PFAT_VOLUME_INFO Volume, ULONG DirectoryStartCluster, ULONG* EntryCountPointer, BOOLEAN RootDirectory);
 BOOLEAN    FatSearchDirectoryBufferForFile(PFAT_VOLUME_INFO Volume, PVOID DirectoryBuffer, ULONG EntryCount, PCHAR FileName, PFAT_FILE_INFO FatFileInfoPointer);
 ARC_STATUS FatLookupFile(PFAT_VOLUME_INFO Volume, PCSTR FileName, PFAT_FILE_INFO FatFileInfoPointer);
 void    FatParseShortFileName(PCHAR Buffer, PDIRENTRY DirEntry);
 static BOOLEAN FatGetFatEntry(PFAT_VOLUME_INFO Volume, UINT32 Cluster, PUINT32 ClusterPointer);
-static ULONG FatCountClustersInChain(PFAT_VOLUME_INFO Volume, UINT32 StartCluster);
-static BOOLEAN FatReadClusterChain(PFAT_VOLUME_INFO Volume, UINT32 StartClusterNumber, UINT32 NumberOfClusters, PVOID Buffer, PUINT32 LastClusterNumber);
+static BOOLEAN FatBuildExtentMap(PFAT_VOLUME_INFO Volume, UINT32 StartCluster, ULONG MaxClusters, PFAT_EXTENT* ExtentsPointer, PULONG ExtentCountPointer, PULONG ClusterCountPointer);
+static BOOLEAN FatReadClusterChain(PFAT_VOLUME_INFO Volume, PFAT_EXTENT Extents, ULONG ExtentCount, ULONG FileCluster, ULONG NumberOfClusters, PVOID Buffer);
 BOOLEAN    FatReadPartialCluster(PFAT_VOLUME_INFO Volume, ULONG ClusterNumber, ULONG StartingOffset, ULONG Length, PVOID Buffer);
 BOOLEAN    FatReadVolumeSectors(PFAT_VOLUME_INFO Volume, ULONG SectorNumber, ULONG SectorCount, PVOID Buffer);
 
@@ -49,6 +48,7 @@ typedef struct _FAT_VOLUME_INFO
     ULONG RootDirStartCluster; /* Starting cluster number of the root directory (fat32 only) */
     ULONG DataSectorStart; /* Starting sector of the data area */
     ULONG DeviceId;
+    LIST_ENTRY DirectoryBufferListHead; /* Buffered directories, most recently used first */
     UINT16 BytesPerSector; /* Number of bytes per sector */
     UINT8 FatType; /* FAT12, FAT16, FAT32, FATX16 or FATX32 */
     UINT8 NumberOfFats; /* Number of FAT tables */
@@ -405,21 +405,234 @@ ULONG FatDetermineFatType(PFAT_BOOTSECTOR FatBootSector, ULONGLONG PartitionSect
     }
 }
 
+/*
+ * FatParseLongFileNameEntry()
+ * Copies the 13 characters of a long file name entry
+ * to their place in LfnNameBuffer
+ */
+static
+VOID FatParseLongFileNameEntry(PCHAR LfnNameBuffer, PLFN_DIRENTRY LfnDirEntry)
+{
+    //
+    // Mask off high two bits of sequence number
+    // and make the sequence number zero-based
+    //
+    LfnDirEntry->SequenceNumber &= 0x3F;
+    LfnDirEntry->SequenceNumber--;
+
+    //
+    // Get all 13 LFN entry characters
+    //
+    if (LfnDirEntry->Name0_4[0] != 0xFFFF)
+    {
+        LfnNameBuffer[0 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name0_4[0];
+    }
+    if (LfnDirEntry->Name0_4[1] != 0xFFFF)
+    {
+        LfnNameBuffer[1 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name0_4[1];
+    }
+    if (LfnDirEntry->Name0_4[2] != 0xFFFF)
+    {
+        LfnNameBuffer[2 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name0_4[2];
+    }
+    if (LfnDirEntry->Name0_4[3] != 0xFFFF)
+    {
+        LfnNameBuffer[3 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name0_4[3];
+    }
+    if (LfnDirEntry->Name0_4[4] != 0xFFFF)
+    {
+        LfnNameBuffer[4 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name0_4[4];
+    }
+    if (LfnDirEntry->Name5_10[0] != 0xFFFF)
+    {
+        LfnNameBuffer[5 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[0];
+    }
+    if (LfnDirEntry->Name5_10[1] != 0xFFFF)
+    {
+        LfnNameBuffer[6 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[1];
+    }
+    if (LfnDirEntry->Name5_10[2] != 0xFFFF)
+    {
+        LfnNameBuffer[7 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[2];
+    }
+    if (LfnDirEntry->Name5_10[3] != 0xFFFF)
+    {
+        LfnNameBuffer[8 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[3];
+    }
+    if (LfnDirEntry->Name5_10[4] != 0xFFFF)
+    {
+        LfnNameBuffer[9 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[4];
+    }
+    if (LfnDirEntry->Name5_10[5] != 0xFFFF)
+    {
+        LfnNameBuffer[10 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[5];
+    }
+    if (LfnDirEntry->Name11_12[0] != 0xFFFF)
+    {
+        LfnNameBuffer[11 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name11_12[0];
+    }
+    if (LfnDirEntry->Name11_12[1] != 0xFFFF)
+    {
+        LfnNameBuffer[12 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name11_12[1];
+    }
+}
+
+#define FAT_NAME_HASH_BUCKETS 64
+#define FAT_NAME_INDEX_END 0xFFFFFFFF
+
+/*
+ * Every name of a buffered directory is hashed once, so a lookup only
+ * compares against the entries whose name hashes to the same value.
+ * A name covers the long name entries in front of a short name entry,
+ * that is exactly what FatSearchDirectoryBufferForFile() needs to look
+ * at to match the file.
+ */
+typedef struct _DIRECTORY_NAME
+{
+    ULONG Hash;
+    ULONG Next; /* Next name in the same bucket, in directory order */
+    ULONG FirstEntry; /* First directory entry describing the file */
+    ULONG EntryCount; /* Number of directory entries describing the file */
+} DIRECTORY_NAME, *PDIRECTORY_NAME;
+
 typedef struct _DIRECTORY_BUFFER
 {
     LIST_ENTRY Link;
-    PVOID Volume;
     ULONG DirectoryStartCluster;
     ULONG DirectorySize;
+    ULONG NameCount;
+    ULONG NameBuckets[FAT_NAME_HASH_BUCKETS];
+    PDIRECTORY_NAME Names;
     UCHAR Data[];
 } DIRECTORY_BUFFER, *PDIRECTORY_BUFFER;
 
-LIST_ENTRY DirectoryBufferListHead = {&DirectoryBufferListHead, &DirectoryBufferListHead};
+static
+ULONG FatHashName(PCSTR Name, SIZE_T Length)
+{
+    ULONG Hash = 0;
+
+    while (Length--)
+    {
+        Hash = (Hash * 31) + toupper((UCHAR)*Name++);
+    }
+
+    return Hash;
+}
+
+static
+VOID FatAddDirectoryName(PDIRECTORY_BUFFER DirectoryBuffer, PCSTR Name, SIZE_T Length, ULONG FirstEntry, ULONG EntryCount)
+{
+    PDIRECTORY_NAME DirectoryName = &DirectoryBuffer->Names[DirectoryBuffer->NameCount++];
+
+    DirectoryName->Hash = FatHashName(Name, Length);
+    DirectoryName->FirstEntry = FirstEntry;
+    DirectoryName->EntryCount = EntryCount;
+}
+
+/*
+ * FatIndexDirectoryBuffer()
+ * Hashes the names of all the files of a buffered directory.
+ * Walks the entries the same way the search routines do.
+ */
+static
+VOID FatIndexDirectoryBuffer(PFAT_VOLUME_INFO Volume, PDIRECTORY_BUFFER DirectoryBuffer)
+{
+    ULONG CurrentEntry, FirstEntry, EntryCount, Bucket;
+    CHAR LfnNameBuffer[265];
+    CHAR ShortNameBuffer[20];
+
+    DirectoryBuffer->NameCount = 0;
+
+    if (ISFATX(Volume->FatType))
+    {
+        PFATX_DIRENTRY Entries = (PFATX_DIRENTRY)DirectoryBuffer->Data;
+        FATX_DIRENTRY DirEntry;
+
+        EntryCount = DirectoryBuffer->DirectorySize / sizeof(FATX_DIRENTRY);
+        for (CurrentEntry = 0; CurrentEntry < EntryCount; CurrentEntry++)
+        {
+            DirEntry = Entries[CurrentEntry];
+            FatSwapFatXDirEntry(&DirEntry);
+            if (DirEntry.FileNameSize == 0xff)
+                break;
+            if (DirEntry.FileNameSize == 0xe5 || DirEntry.FileNameSize > sizeof(DirEntry.FileName))
+                continue;
+
+            FatAddDirectoryName(DirectoryBuffer, DirEntry.FileName, DirEntry.FileNameSize, CurrentEntry, 1);
+        }
+    }
+    else
+    {
+        PDIRENTRY Entries = (PDIRENTRY)DirectoryBuffer->Data;
+        DIRENTRY DirEntry;
+        LFN_DIRENTRY LfnDirEntry;
+
+        RtlZeroMemory(LfnNameBuffer, sizeof(LfnNameBuffer));
+        FirstEntry = 0;
+
+        EntryCount = DirectoryBuffer->DirectorySize / sizeof(DIRENTRY);
+        for (CurrentEntry = 0; CurrentEntry < EntryCount; CurrentEntry++)
+        {
+            LfnDirEntry = *(PLFN_DIRENTRY)&Entries[CurrentEntry];
+            FatSwapLFNDirEntry(&LfnDirEntry);
+            DirEntry = Entries[CurrentEntry];
+            FatSwapDirEntry(&DirEntry);
+
+            if (DirEntry.FileName[0] == '\0')
+                break;
+
+            if (DirEntry.Attr == ATTR_LONG_NAME && DirEntry.FileName[0] != '\xE5')
+            {
+                if (!(LfnDirEntry.SequenceNumber & 0x80))
+                    FatParseLongFileNameEntry(LfnNameBuffer, &LfnDirEntry);
+                continue;
+            }
+
+            /* Deleted entries and volume labels end the long name too */
+            if (DirEntry.FileName[0] != '\xE5' && !(DirEntry.Attr & ATTR_VOLUMENAME))
+            {
+                FatParseShortFileName(ShortNameBuffer, &DirEntry);
 
-PVOID FatBufferDirectory(PFAT_VOLUME_INFO Volume, ULONG DirectoryStartCluster, ULONG *DirectorySize, BOOLEAN RootDirectory)
+                /* A file has at least one long name entry when it has a long name,
+                 * so there are never more names than directory entries */
+                if (LfnNameBuffer[0] != '\0')
+                {
+                    FatAddDirectoryName(DirectoryBuffer, LfnNameBuffer, strlen(LfnNameBuffer),
+                                        FirstEntry, CurrentEntry - FirstEntry + 1);
+                }
+                FatAddDirectoryName(DirectoryBuffer, ShortNameBuffer, strlen(ShortNameBuffer),
+                                    FirstEntry, CurrentEntry - FirstEntry + 1);
+            }
+
+            RtlZeroMemory(LfnNameBuffer, sizeof(LfnNameBuffer));
+            FirstEntry = CurrentEntry + 1;
+        }
+    }
+
+    /* Chain the names backwards so that every bucket is in directory order */
+    for (Bucket = 0; Bucket < FAT_NAME_HASH_BUCKETS; Bucket++)
+    {
+        DirectoryBuffer->NameBuckets[Bucket] = FAT_NAME_INDEX_END;
+    }
+    for (CurrentEntry = DirectoryBuffer->NameCount; CurrentEntry-- > 0; )
+    {
+        Bucket = DirectoryBuffer->Names[CurrentEntry].Hash % FAT_NAME_HASH_BUCKETS;
+        DirectoryBuffer->Names[CurrentEntry].Next = DirectoryBuffer->NameBuckets[Bucket];
+        DirectoryBuffer->NameBuckets[Bucket] = CurrentEntry;
+    }
+
+    TRACE("FatIndexDirectoryBuffer() DirectoryStartCluster = %d NameCount = %d\n",
+          DirectoryBuffer->DirectoryStartCluster, DirectoryBuffer->NameCount);
+}
+
+static
+PDIRECTORY_BUFFER FatBufferDirectory(PFAT_VOLUME_INFO Volume, ULONG DirectoryStartCluster, BOOLEAN RootDirectory)
 {
     PDIRECTORY_BUFFER DirectoryBuffer;
     PLIST_ENTRY Entry;
+    PFAT_EXTENT Extents = NULL;
+    ULONG ExtentCount = 0, ClusterCount = 0;
+    ULONG DirectorySize, EntryCount;
 
     TRACE("FatBufferDirectory() DirectoryStartCluster = %d RootDirectory = %s\n", DirectoryStartCluster, (RootDirectory ? "TRUE" : "FALSE"));
 
@@ -433,20 +646,22 @@ PVOID FatBufferDirectory(PFAT_VOLUME_INFO Volume, ULONG DirectoryStartCluster, U
         RootDirectory = FALSE;
     }
 
-    /* Search the list for a match */
-    for (Entry = DirectoryBufferListHead.Flink;
-         Entry != &DirectoryBufferListHead;
+    /* Search the volume's list for a match */
+    for (Entry = Volume->DirectoryBufferListHead.Flink;
+         Entry != &Volume->DirectoryBufferListHead;
          Entry = Entry->Flink)
     {
         DirectoryBuffer = CONTAINING_RECORD(Entry, DIRECTORY_BUFFER, Link);
 
         /* Check if it matches */
-        if ((DirectoryBuffer->Volume == Volume) &&
-            (DirectoryBuffer->DirectoryStartCluster == DirectoryStartCluster))
+        if (DirectoryBuffer->DirectoryStartCluster == DirectoryStartCluster)
         {
             TRACE("Found cached buffer\n");
-            *DirectorySize = DirectoryBuffer->DirectorySize;
-            return DirectoryBuffer->Data;
+
+            /* Keep the directories being walked at the front */
+            RemoveEntryList(&DirectoryBuffer->Link);
+            InsertHeadList(&Volume->DirectoryBufferListHead, &DirectoryBuffer->Link);
+            return DirectoryBuffer;
         }
     }
 
@@ -455,22 +670,31 @@ PVOID FatBufferDirectory(PFAT_VOLUME_INFO Volume, ULONG DirectoryStartCluster, U
     //
     if (RootDirectory)
     {
-        *DirectorySize = Volume->RootDirSectors * Volume->BytesPerSector;
+        DirectorySize = Volume->RootDirSectors * Volume->BytesPerSector;
     }
     else
     {
-        *DirectorySize = FatCountClustersInChain(Volume, DirectoryStartCluster) * Volume->SectorsPerCluster * Volume->BytesPerSector;
+        if (!FatBuildExtentMap(Volume, DirectoryStartCluster, 0xFFFFFFFF, &Extents, &ExtentCount, &ClusterCount))
+        {
+            return NULL;
+        }
+        DirectorySize = ClusterCount * Volume->SectorsPerCluster * Volume->BytesPerSector;
     }
 
+    EntryCount = DirectorySize / (ISFATX(Volume->FatType) ? sizeof(FATX_DIRENTRY) : sizeof(DIRENTRY));
+
     //
-    // Attempt to allocate memory for directory buffer
+    // Attempt to allocate memory for directory buffer and its name index
     //
-    TRACE("Trying to allocate (DirectorySize) %d bytes.\n", *DirectorySize);
-    DirectoryBuffer = FrLdrTempAlloc(*DirectorySize + sizeof(DIRECTORY_BUFFER),
+    TRACE("Trying to allocate (DirectorySize) %d bytes.\n", DirectorySize);
+    DirectoryBuffer = FrLdrTempAlloc(sizeof(DIRECTORY_BUFFER) + DirectorySize +
+                                     EntryCount * sizeof(DIRECTORY_NAME),
                                      TAG_FAT_BUFFER);
 
     if (DirectoryBuffer == NULL)
     {
+        if (Extents)
+            FrLdrTempFree(Extents, TAG_FAT_CHAIN);
         return NULL;
     }
 
@@ -485,22 +709,27 @@ PVOID FatBufferDirectory(PFAT_VOLUME_INFO Volume, ULONG DirectoryStartCluster, U
             return NULL;
         }
     }
-    else
+    else if (ClusterCount > 0)
     {
-        if (!FatReadClusterChain(Volume, DirectoryStartCluster, 0xFFFFFFFF, DirectoryBuffer->Data, NULL))
+        BOOLEAN Success = FatReadClusterChain(Volume, Extents, ExtentCount, 0, ClusterCount, DirectoryBuffer->Data);
+
+        FrLdrTempFree(Extents, TAG_FAT_CHAIN);
+        if (!Success)
         {
             FrLdrTempFree(DirectoryBuffer, TAG_FAT_BUFFER);
             return NULL;
         }
     }
 
-    /* Enqueue it in the list */
-    DirectoryBuffer->Volume = Volume;
     DirectoryBuffer->DirectoryStartCluster = DirectoryStartCluster;
-    DirectoryBuffer->DirectorySize = *DirectorySize;
-    InsertTailList(&DirectoryBufferListHead, &DirectoryBuffer->Link);
+    DirectoryBuffer->DirectorySize = DirectorySize;
+    DirectoryBuffer->Names = (PDIRECTORY_NAME)&DirectoryBuffer->Data[DirectorySize];
+    FatIndexDirectoryBuffer(Volume, DirectoryBuffer);
+
+    /* Enqueue it in the volume's list */
+    InsertHeadList(&Volume->DirectoryBufferListHead, &DirectoryBuffer->Link);
 
-    return DirectoryBuffer->Data;
+    return DirectoryBuffer;
 }
 
 BOOLEAN FatSearchDirectoryBufferForFile(PFAT_VOLUME_INFO Volume, PVOID DirectoryBuffer, ULONG DirectorySize, PCHAR FileName, PFAT_FILE_INFO FatFileInfoPointer)
@@ -567,68 +796,7 @@ BOOLEAN FatSearchDirectoryBufferForFile(PFAT_VOLUME_INFO Volume, PVOID Directory
                 continue;
             }
 
-            //
-            // Mask off high two bits of sequence number
-            // and make the sequence number zero-based
-            //
-            LfnDirEntry->SequenceNumber &= 0x3F;
-            LfnDirEntry->SequenceNumber--;
-
-            //
-            // Get all 13 LFN entry characters
-            //
-            if (LfnDirEntry->Name0_4[0] != 0xFFFF)
-            {
-                LfnNameBuffer[0 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name0_4[0];
-            }
-            if (LfnDirEntry->Name0_4[1] != 0xFFFF)
-            {
-                LfnNameBuffer[1 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name0_4[1];
-            }
-            if (LfnDirEntry->Name0_4[2] != 0xFFFF)
-            {
-                LfnNameBuffer[2 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name0_4[2];
-            }
-            if (LfnDirEntry->Name0_4[3] != 0xFFFF)
-            {
-                LfnNameBuffer[3 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name0_4[3];
-            }
-            if (LfnDirEntry->Name0_4[4] != 0xFFFF)
-            {
-                LfnNameBuffer[4 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name0_4[4];
-            }
-            if (LfnDirEntry->Name5_10[0] != 0xFFFF)
-            {
-                LfnNameBuffer[5 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[0];
-            }
-            if (LfnDirEntry->Name5_10[1] != 0xFFFF)
-            {
-                LfnNameBuffer[6 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[1];
-            }
-            if (LfnDirEntry->Name5_10[2] != 0xFFFF)
-            {
-                LfnNameBuffer[7 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[2];
-            }
-            if (LfnDirEntry->Name5_10[3] != 0xFFFF)
-            {
-                LfnNameBuffer[8 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[3];
-            }
-            if (LfnDirEntry->Name5_10[4] != 0xFFFF)
-            {
-                LfnNameBuffer[9 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[4];
-            }
-            if (LfnDirEntry->Name5_10[5] != 0xFFFF)
-            {
-                LfnNameBuffer[10 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name5_10[5];
-            }
-            if (LfnDirEntry->Name11_12[0] != 0xFFFF)
-            {
-                LfnNameBuffer[11 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name11_12[0];
-            }
-            if (LfnDirEntry->Name11_12[1] != 0xFFFF)
-            {
-                LfnNameBuffer[12 + (LfnDirEntry->SequenceNumber * 13)] = (UCHAR)LfnDirEntry->Name11_12[1];
-            }
+            FatParseLongFileNameEntry(LfnNameBuffer, LfnDirEntry);
 
             //TRACE("Dumping long name buffer:\n");
             //DbgDumpBuffer(DPRINT_FILESYSTEM, LfnNameBuffer, 260);
@@ -677,7 +845,6 @@ BOOLEAN FatSearchDirectoryBufferForFile(PFAT_VOLUME_INFO Volume, PVOID Directory
             FatFileInfoPointer->FileSize = DirEntry->Size;
             FatFileInfoPointer->FilePointer = 0;
             StartCluster = ((ULONG)DirEntry->ClusterHigh << 16) + DirEntry->ClusterLow;
-            FatFileInfoPointer->CurrentCluster = StartCluster;
             FatFileInfoPointer->StartCluster = StartCluster;
 
             TRACE("MSDOS Directory Entry:\n");
@@ -743,7 +910,6 @@ static BOOLEAN FatXSearchDirectoryBufferForFile(PFAT_VOLUME_INFO Volume, PVOID D
             FatFileInfoPointer->Attributes = DirEntry->Attr;
             FatFileInfoPointer->FileSize = DirEntry->Size;
             FatFileInfoPointer->FilePointer = 0;
-            FatFileInfoPointer->CurrentCluster = DirEntry->StartCluster;
             FatFileInfoPointer->StartCluster = DirEntry->StartCluster;
 
             TRACE("FATX Directory Entry:\n");
@@ -765,6 +931,54 @@ static BOOLEAN FatXSearchDirectoryBufferForFile(PFAT_VOLUME_INFO Volume, PVOID D
     return FALSE;
 }
 
+/*
+ * FatSearchDirectoryForFile()
+ * Looks the file name up in the name index of a buffered directory
+ * and only searches the entries of the files with the same name hash
+ */
+static BOOLEAN FatSearchDirectoryForFile(PFAT_VOLUME_INFO Volume, PDIRECTORY_BUFFER DirectoryBuffer, PCHAR FileName, PFAT_FILE_INFO FatFileInfoPointer)
+{
+    PDIRECTORY_NAME DirectoryName;
+    ULONG Hash, Index, EntrySize;
+
+    Hash = FatHashName(FileName, strlen(FileName));
+    EntrySize = ISFATX(Volume->FatType) ? sizeof(FATX_DIRENTRY) : sizeof(DIRENTRY);
+
+    for (Index = DirectoryBuffer->NameBuckets[Hash % FAT_NAME_HASH_BUCKETS];
+         Index != FAT_NAME_INDEX_END;
+         Index = DirectoryName->Next)
+    {
+        PVOID Entries;
+        ULONG Size;
+
+        DirectoryName = &DirectoryBuffer->Names[Index];
+        if (DirectoryName->Hash != Hash)
+        {
+            continue;
+        }
+
+        Entries = &DirectoryBuffer->Data[DirectoryName->FirstEntry * EntrySize];
+        Size = DirectoryName->EntryCount * EntrySize;
+
+        if (ISFATX(Volume->FatType))
+        {
+            if (FatXSearchDirectoryBufferForFile(Volume, Entries, Size, FileName, FatFileInfoPointer))
+            {
+                return TRUE;
+            }
+        }
+        else
+        {
+            if (FatSearchDirectoryBufferForFile(Volume, Entries, Size, FileName, FatFileInfoPointer))
+            {
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
 /*
  * FatLookupFile()
  * This function searches the file system for the
@@ -776,14 +990,14 @@ ARC_STATUS FatLookupFile(PFAT_VOLUME_INFO Volume, PCSTR FileName, PFAT_FILE_INFO
     UINT32        i;
     ULONG        NumberOfPathParts;
     CHAR        PathPart[261];
-    PVOID        DirectoryBuffer;
+    PDIRECTORY_BUFFER    DirectoryBuffer;
     ULONG        DirectoryStartCluster = 0;
-    ULONG        DirectorySize;
     FAT_FILE_INFO    FatFileInfo;
 
     TRACE("FatLookupFile() FileName = %s\n", FileName);
 
     RtlZeroMemory(FatFileInfoPointer, sizeof(FAT_FILE_INFO));
+    RtlZeroMemory(&FatFileInfo, sizeof(FAT_FILE_INFO));
 
     /* Skip leading path separator, if any */
     if (*FileName == '\\' || *FileName == '/')
@@ -814,7 +1028,7 @@ ARC_STATUS FatLookupFile(PFAT_VOLUME_INFO Volume, PCSTR FileName, PFAT_FILE_INFO
         //
         // Buffer the directory contents
         //
-        DirectoryBuffer = FatBufferDirectory(Volume, DirectoryStartCluster, &DirectorySize, (i == 0) );
+        DirectoryBuffer = FatBufferDirectory(Volume, DirectoryStartCluster, (i == 0) );
         if (DirectoryBuffer == NULL)
         {
             return ENOMEM;
@@ -823,19 +1037,9 @@ ARC_STATUS FatLookupFile(PFAT_VOLUME_INFO Volume, PCSTR FileName, PFAT_FILE_INFO
         //
         // Search for file name in directory
         //
-        if (ISFATX(Volume->FatType))
+        if (!FatSearchDirectoryForFile(Volume, DirectoryBuffer, PathPart, &FatFileInfo))
         {
-            if (!FatXSearchDirectoryBufferForFile(Volume, DirectoryBuffer, DirectorySize, PathPart, &FatFileInfo))
-            {
-                return ENOENT;
-            }
-        }
-        else
-        {
-            if (!FatSearchDirectoryBufferForFile(Volume, DirectoryBuffer, DirectorySize, PathPart, &FatFileInfo))
-            {
-                return ENOENT;
-            }
+            return ENOENT;
         }
 
         //
@@ -1040,112 +1244,158 @@ BOOLEAN FatGetFatEntry(PFAT_VOLUME_INFO Volume, UINT32 Cluster, PUINT32 ClusterP
     return TRUE;
 }
 
+/*
+ * FatBuildExtentMap()
+ * Walks a cluster chain through the FAT and describes it as runs
+ * of contiguous clusters, so reading it back doesn't need the FAT.
+ * At most MaxClusters clusters of the chain are mapped.
+ */
 static
-ULONG FatCountClustersInChain(PFAT_VOLUME_INFO Volume, UINT32 StartCluster)
+BOOLEAN FatBuildExtentMap(
+    PFAT_VOLUME_INFO Volume,
+    UINT32 StartCluster,
+    ULONG MaxClusters,
+    PFAT_EXTENT* ExtentsPointer,
+    PULONG ExtentCountPointer,
+    PULONG ClusterCountPointer)
 {
-    ULONG    ClusterCount = 0;
+    PFAT_EXTENT Extents = NULL;
+    ULONG ExtentCount = 0, ClusterCount = 0;
+    UINT32 Cluster, PreviousCluster = 0;
+    ULONG Pass;
 
-    TRACE("FatCountClustersInChain() StartCluster = %d\n", StartCluster);
+    TRACE("FatBuildExtentMap() StartCluster = %d MaxClusters = %d\n", StartCluster, MaxClusters);
 
-    while (1)
+    *ExtentsPointer = NULL;
+    *ExtentCountPointer = 0;
+    *ClusterCountPointer = 0;
+
+    // The first pass counts the runs, the second one fills them in
+    for (Pass = 0; Pass < 2; Pass++)
     {
-        //
-        // If end of chain then break out of our cluster counting loop
-        //
-        if (FAT_IS_END_CLUSTER(StartCluster))
+        ExtentCount = 0;
+        ClusterCount = 0;
+        Cluster = StartCluster;
+
+        while ((ClusterCount < MaxClusters) && (Cluster >= 2) && !FAT_IS_END_CLUSTER(Cluster))
         {
-            break;
+            if ((ClusterCount == 0) || (Cluster != PreviousCluster + 1))
+            {
+                if (Extents)
+                {
+                    Extents[ExtentCount].FileCluster = ClusterCount;
+                    Extents[ExtentCount].DiskCluster = Cluster;
+                    Extents[ExtentCount].ClusterCount = 0;
+                }
+                ExtentCount++;
+            }
+            if (Extents)
+            {
+                Extents[ExtentCount - 1].ClusterCount++;
+            }
+            ClusterCount++;
+
+            PreviousCluster = Cluster;
+            if (!FatGetFatEntry(Volume, Cluster, &Cluster))
+            {
+                if (Extents)
+                    FrLdrTempFree(Extents, TAG_FAT_CHAIN);
+                return FALSE;
+            }
         }
 
-        //
-        // Increment count
-        //
-        ClusterCount++;
+        if (ExtentCount == 0)
+        {
+            // Empty chain
+            return TRUE;
+        }
 
-        //
-        // Get next cluster
-        //
-        if (!FatGetFatEntry(Volume, StartCluster, &StartCluster))
+        if (Pass == 0)
         {
-            return 0;
+            Extents = FrLdrTempAlloc(ExtentCount * sizeof(FAT_EXTENT), TAG_FAT_CHAIN);
+            if (!Extents)
+            {
+                return FALSE;
+            }
         }
     }
 
-    TRACE("FatCountClustersInChain() ClusterCount = %d\n", ClusterCount);
+    TRACE("FatBuildExtentMap() ClusterCount = %d ExtentCount = %d\n", ClusterCount, ExtentCount);
+
+    *ExtentsPointer = Extents;
+    *ExtentCountPointer = ExtentCount;
+    *ClusterCountPointer = ClusterCount;
 
-    return ClusterCount;
+    return TRUE;
 }
 
+/*
+ * FatFindExtent()
+ * Returns the run holding the given cluster of the chain
+ */
 static
-BOOLEAN FatReadAdjacentClusters(
-    PFAT_VOLUME_INFO Volume,
-    UINT32 StartClusterNumber,
-    UINT32 MaxClusters,
-    PVOID Buffer,
-    PUINT32 ClustersRead,
-    PUINT32 LastClusterNumber)
+PFAT_EXTENT FatFindExtent(PFAT_EXTENT Extents, ULONG ExtentCount, ULONG FileCluster)
 {
-    UINT32 NextClusterNumber;
-    UINT32 ClustersToRead = 1;
-    UINT32 PrevClusterNumber = StartClusterNumber;
-    UINT32 ClusterStartSector = ((PrevClusterNumber - 2) * Volume->SectorsPerCluster) + Volume->DataSectorStart;
+    ULONG Low = 0, High = ExtentCount, Middle;
 
-    *ClustersRead = 0;
-    *LastClusterNumber = 0;
-
-    if (!FatGetFatEntry(Volume, StartClusterNumber, &NextClusterNumber))
+    while (Low < High)
     {
-        return FALSE;
-    }
+        Middle = (Low + High) / 2;
 
-    // getting the number of adjacent clusters
-    while (!FAT_IS_END_CLUSTER(NextClusterNumber) && ClustersToRead < MaxClusters && (NextClusterNumber == PrevClusterNumber + 1))
-    {
-        ClustersToRead++;
-        PrevClusterNumber = NextClusterNumber;
-        if (!FatGetFatEntry(Volume, PrevClusterNumber, &NextClusterNumber))
-        {
-            return FALSE;
-        }
-    }
-
-    if (!FatReadVolumeSectors(Volume, ClusterStartSector, ClustersToRead * Volume->SectorsPerCluster, Buffer))
-    {
-        return FALSE;
+        if (FileCluster < Extents[Middle].FileCluster)
+            High = Middle;
+        else if (FileCluster - Extents[Middle].FileCluster >= Extents[Middle].ClusterCount)
+            Low = Middle + 1;
+        else
+            return &Extents[Middle];
     }
 
-    *ClustersRead = ClustersToRead;
-    *LastClusterNumber = NextClusterNumber;
-
-    return !FAT_IS_END_CLUSTER(NextClusterNumber) && ClustersToRead < MaxClusters;
+    return NULL;
 }
 
 /*
  * FatReadClusterChain()
- * Reads the specified clusters into memory
+ * Reads the specified clusters of a mapped chain into memory,
+ * one read per run of contiguous clusters
  */
 static
-BOOLEAN FatReadClusterChain(PFAT_VOLUME_INFO Volume, UINT32 StartClusterNumber, UINT32 NumberOfClusters, PVOID Buffer, PUINT32 LastClusterNumber)
+BOOLEAN FatReadClusterChain(PFAT_VOLUME_INFO Volume, PFAT_EXTENT Extents, ULONG ExtentCount, ULONG FileCluster, ULONG NumberOfClusters, PVOID Buffer)
 {
-    UINT32 ClustersRead, NextClusterNumber, ClustersLeft = NumberOfClusters;
+    PFAT_EXTENT Extent;
+    ULONG OffsetInExtent, ClustersToRead;
 
-    TRACE("FatReadClusterChain() StartClusterNumber = %d NumberOfClusters = %d Buffer = 0x%x\n", StartClusterNumber, NumberOfClusters, Buffer);
+    TRACE("FatReadClusterChain() FileCluster = %d NumberOfClusters = %d Buffer = 0x%x\n", FileCluster, NumberOfClusters, Buffer);
 
     ASSERT(NumberOfClusters > 0);
 
-    while (FatReadAdjacentClusters(Volume, StartClusterNumber, ClustersLeft, Buffer, &ClustersRead, &NextClusterNumber))
-    {
-        ClustersLeft -= ClustersRead;
-        Buffer = (PVOID)((ULONG_PTR)Buffer + (ClustersRead * Volume->SectorsPerCluster * Volume->BytesPerSector));
-        StartClusterNumber = NextClusterNumber;
-    }
+    Extent = FatFindExtent(Extents, ExtentCount, FileCluster);
 
-    if (LastClusterNumber)
+    while (NumberOfClusters > 0)
     {
-        *LastClusterNumber = NextClusterNumber;
+        if (!Extent || Extent == &Extents[ExtentCount])
+        {
+            ERR("Cluster %lu is beyond the end of the chain\n", FileCluster);
+            return FALSE;
+        }
+
+        OffsetInExtent = FileCluster - Extent->FileCluster;
+        ClustersToRead = min(NumberOfClusters, Extent->ClusterCount - OffsetInExtent);
+
+        if (!FatReadVolumeSectors(Volume,
+                                  ((Extent->DiskCluster + OffsetInExtent - 2) * Volume->SectorsPerCluster) + Volume->DataSectorStart,
+                                  ClustersToRead * Volume->SectorsPerCluster,
+                                  Buffer))
+        {
+            return FALSE;
+        }
+
+        NumberOfClusters -= ClustersToRead;
+        FileCluster += ClustersToRead;
+        Buffer = (PVOID)((ULONG_PTR)Buffer + (ClustersToRead * Volume->SectorsPerCluster * Volume->BytesPerSector));
+        Extent++;
     }
 
-    return (ClustersRead > 0);
+    return TRUE;
 }
 
 /*
@@ -1190,6 +1440,28 @@ BOOLEAN FatReadPartialCluster(PFAT_VOLUME_INFO Volume, ULONG ClusterNumber, ULON
     return Success;
 }
 
+/*
+ * FatGetFileCluster()
+ * Returns the volume cluster holding the byte at the file pointer
+ */
+static
+BOOLEAN FatGetFileCluster(PFAT_FILE_INFO FatFileInfo, PUINT32 ClusterNumber)
+{
+    PFAT_VOLUME_INFO Volume = FatFileInfo->Volume;
+    ULONG FileCluster = FatFileInfo->FilePointer / (Volume->SectorsPerCluster * Volume->BytesPerSector);
+    PFAT_EXTENT Extent;
+
+    Extent = FatFindExtent(FatFileInfo->Extents, FatFileInfo->ExtentCount, FileCluster);
+    if (!Extent)
+    {
+        ERR("Cluster %lu is beyond the end of the chain\n", FileCluster);
+        return FALSE;
+    }
+
+    *ClusterNumber = Extent->DiskCluster + (FileCluster - Extent->FileCluster);
+    return TRUE;
+}
+
 /*
  * FatReadFile()
  * Reads BytesToRead from open file and
@@ -1199,7 +1471,7 @@ static
 BOOLEAN FatReadFile(PFAT_FILE_INFO FatFileInfo, ULONG BytesToRead, ULONG* BytesRead, PVOID Buffer)
 {
     PFAT_VOLUME_INFO Volume = FatFileInfo->Volume;
-    UINT32 NextClusterNumber, BytesPerCluster;
+    UINT32 ClusterNumber, BytesPerCluster;
 
     TRACE("FatReadFile() BytesToRead = %d Buffer = 0x%x\n", BytesToRead, Buffer);
 
@@ -1273,7 +1545,8 @@ BOOLEAN FatReadFile(PFAT_FILE_INFO FatFileInfo, ULONG BytesToRead, ULONG* BytesR
         //
         // Now do the read and update BytesRead, BytesToRead, FilePointer, & Buffer
         //
-        if (!FatReadPartialCluster(Volume, FatFileInfo->CurrentCluster, OffsetInCluster, LengthInCluster, Buffer))
+        if (!FatGetFileCluster(FatFileInfo, &ClusterNumber) ||
+            !FatReadPartialCluster(Volume, ClusterNumber, OffsetInCluster, LengthInCluster, Buffer))
         {
             return FALSE;
         }
@@ -1284,18 +1557,6 @@ BOOLEAN FatReadFile(PFAT_FILE_INFO FatFileInfo, ULONG BytesToRead, ULONG* BytesR
         BytesToRead -= LengthInCluster;
         FatFileInfo->FilePointer += LengthInCluster;
         Buffer = (PVOID)((ULONG_PTR)Buffer + LengthInCluster);
-
-        // get the next cluster if needed
-        if ((LengthInCluster + OffsetInCluster) == BytesPerCluster)
-        {
-            if (!FatGetFatEntry(Volume, FatFileInfo->CurrentCluster, &NextClusterNumber))
-            {
-                return FALSE;
-            }
-
-            FatFileInfo->CurrentCluster = NextClusterNumber;
-            TRACE("FatReadFile() FatFileInfo->CurrentCluster = 0x%x\n", FatFileInfo->CurrentCluster);
-        }
     }
 
     //
@@ -1314,9 +1575,8 @@ BOOLEAN FatReadFile(PFAT_FILE_INFO FatFileInfo, ULONG BytesToRead, ULONG* BytesR
         {
             UINT32 BytesReadHere = NumberOfClusters * BytesPerCluster;
 
-            ASSERT(!FAT_IS_END_CLUSTER(FatFileInfo->CurrentCluster));
-
-            if (!FatReadClusterChain(Volume, FatFileInfo->CurrentCluster, NumberOfClusters, Buffer, &NextClusterNumber))
+            if (!FatReadClusterChain(Volume, FatFileInfo->Extents, FatFileInfo->ExtentCount,
+                                     FatFileInfo->FilePointer / BytesPerCluster, NumberOfClusters, Buffer))
             {
                 return FALSE;
             }
@@ -1328,11 +1588,7 @@ BOOLEAN FatReadFile(PFAT_FILE_INFO FatFileInfo, ULONG BytesToRead, ULONG* BytesR
             BytesToRead -= BytesReadHere;
             Buffer = (PVOID)((ULONG_PTR)Buffer + BytesReadHere);
 
-            ASSERT(!FAT_IS_END_CLUSTER(NextClusterNumber) || BytesToRead == 0);
-
             FatFileInfo->FilePointer += BytesReadHere;
-            FatFileInfo->CurrentCluster = NextClusterNumber;
-            TRACE("FatReadFile() FatFileInfo->CurrentCluster = 0x%x\n", FatFileInfo->CurrentCluster);
         }
     }
 
@@ -1341,12 +1597,11 @@ BOOLEAN FatReadFile(PFAT_FILE_INFO FatFileInfo, ULONG BytesToRead, ULONG* BytesR
     //
     if (BytesToRead > 0)
     {
-        ASSERT(!FAT_IS_END_CLUSTER(FatFileInfo->CurrentCluster));
-
         //
         // Now do the read and update BytesRead & FilePointer
         //
-        if (!FatReadPartialCluster(Volume, FatFileInfo->CurrentCluster, 0, BytesToRead, Buffer))
+        if (!FatGetFileCluster(FatFileInfo, &ClusterNumber) ||
+            !FatReadPartialCluster(Volume, ClusterNumber, 0, BytesToRead, Buffer))
         {
             return FALSE;
         }
@@ -1398,6 +1653,8 @@ ARC_STATUS FatClose(ULONG FileId)
 {
     PFAT_FILE_INFO FileHandle = FsGetDeviceSpecific(FileId);
 
+    if (FileHandle->Extents)
+        FrLdrTempFree(FileHandle->Extents, TAG_FAT_CHAIN);
     FrLdrTempFree(FileHandle, TAG_FAT_FILE);
 
     return ESUCCESS;
@@ -1455,6 +1712,27 @@ ARC_STATUS FatOpen(CHAR* Path, OPENMODE OpenMode, ULONG* FileId)
     RtlCopyMemory(FileHandle, &TempFileInfo, sizeof(FAT_FILE_INFO));
     FileHandle->Volume = FatVolume;
 
+    //
+    // Map the clusters of the file once, reads and seeks then
+    // don't have to follow the chain through the FAT anymore
+    //
+    if (!IsDirectory && FileHandle->FileSize > 0)
+    {
+        ULONG BytesPerCluster = FatVolume->SectorsPerCluster * FatVolume->BytesPerSector;
+        ULONG ClusterCount;
+
+        if (!FatBuildExtentMap(FatVolume,
+                               FileHandle->StartCluster,
+                               (FileHandle->FileSize - 1) / BytesPerCluster + 1,
+                               &FileHandle->Extents,
+                               &FileHandle->ExtentCount,
+                               &ClusterCount))
+        {
+            FrLdrTempFree(FileHandle, TAG_FAT_FILE);
+            return EIO;
+        }
+    }
+
     FsSetDeviceSpecific(*FileId, FileHandle);
     return ESUCCESS;
 }
@@ -1481,7 +1759,6 @@ ARC_STATUS FatRead(ULONG FileId, VOID* Buffer, ULONG N, ULONG* Count)
 ARC_STATUS FatSeek(ULONG FileId, LARGE_INTEGER* Position, SEEKMODE SeekMode)
 {
     PFAT_FILE_INFO FileHandle = FsGetDeviceSpecific(FileId);
-    PFAT_VOLUME_INFO Volume = FileHandle->Volume;
     LARGE_INTEGER NewPosition = *Position;
 
     switch (SeekMode)
@@ -1503,38 +1780,6 @@ ARC_STATUS FatSeek(ULONG FileId, LARGE_INTEGER* Position, SEEKMODE SeekMode)
 
     TRACE("FatSeek() NewPosition = %u, OldPointer = %u, SeekMode = %d\n", NewPosition.LowPart, FileHandle->FilePointer, SeekMode);
 
-    {
-        UINT32 OldClusterIdx = FileHandle->FilePointer / (Volume->SectorsPerCluster * Volume->BytesPerSector);
-        UINT32 NewClusterIdx = NewPosition.LowPart / (Volume->SectorsPerCluster * Volume->BytesPerSector);
-
-        TRACE("FatSeek() OldClusterIdx: %u, NewClusterIdx: %u\n", OldClusterIdx, NewClusterIdx);
-
-        if (NewClusterIdx != OldClusterIdx)
-        {
-            UINT32 CurrentClusterIdx, ClusterNumber;
-
-            if (NewClusterIdx > OldClusterIdx)
-            {
-                CurrentClusterIdx = OldClusterIdx;
-                ClusterNumber = FileHandle->CurrentCluster;
-            }
-            else
-            {
-                CurrentClusterIdx = 0;
-                ClusterNumber = FileHandle->StartCluster;
-            }
-
-            for (; CurrentClusterIdx < NewClusterIdx; CurrentClusterIdx++)
-            {
-                if (!FatGetFatEntry(Volume, ClusterNumber, &ClusterNumber))
-                {
-                    return EIO;
-                }
-            }
-            FileHandle->CurrentCluster = ClusterNumber;
-        }
-    }
-
     FileHandle->FilePointer = NewPosition.LowPart;
 
     return ESUCCESS;
@@ -1582,6 +1827,7 @@ const DEVVTBL* FatMount(ULONG DeviceId)
     if (!Volume)
         return NULL;
     RtlZeroMemory(Volume, sizeof(FAT_VOLUME_INFO));
+    InitializeListHead(&Volume->DirectoryBufferListHead);
 
     //
     // Read the BootSector
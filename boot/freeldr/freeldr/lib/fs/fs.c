@@ -216,7 +216,8 @@ NormalizeArcDeviceName(
     return NormName;
 }
 
-ARC_STATUS ArcOpen(CHAR* Path, OPENMODE OpenMode, ULONG* FileId)
+static ARC_STATUS
+FsOpenDeviceOrFile(CHAR* Path, OPENMODE OpenMode, ULONG* FileId)
 {
     ARC_STATUS Status;
     ULONG i;
@@ -389,6 +390,90 @@ Done:
     return Status;
 }
 
+/*
+ * Build the name under which the compressed form of a file is stored:
+ * the last character of the extension is replaced by '_' ("ntoskrnl.ex_"),
+ * shorter extensions get a '_' appended and a file without one gets "._".
+ */
+static BOOLEAN
+FsGetCompressedFileName(
+    _In_ PCSTR Path,
+    _Out_writes_z_(BufferSize) PCHAR Buffer,
+    _In_ SIZE_T BufferSize)
+{
+    PCSTR FileName, Extension, p;
+    SIZE_T Length;
+
+    /* Find the file name after the device name and the directories */
+    FileName = strrchr(Path, ')');
+    if (!FileName)
+        return FALSE;
+    for (p = ++FileName; *p; ++p)
+    {
+        if (*p == '\\' || *p == '/')
+            FileName = p + 1;
+    }
+
+    /* Nothing to do for raw devices, and compressed files are not nested */
+    Length = strlen(Path);
+    if (!*FileName || Path[Length - 1] == '_')
+        return FALSE;
+
+    if (!NT_SUCCESS(RtlStringCbCopyA(Buffer, BufferSize, Path)))
+        return FALSE;
+
+    Extension = strrchr(FileName, '.');
+    if (!Extension)
+        return NT_SUCCESS(RtlStringCbCatA(Buffer, BufferSize, "._"));
+    if (strlen(Extension + 1) < 3)
+        return NT_SUCCESS(RtlStringCbCatA(Buffer, BufferSize, "_"));
+
+    Buffer[Length - 1] = '_';
+    return TRUE;
+}
+
+ARC_STATUS ArcOpen(CHAR* Path, OPENMODE OpenMode, ULONG* FileId)
+{
+    CHAR CompressedPath[MAX_PATH];
+    ARC_STATUS Status;
+    ULONG i;
+
+    Status = FsOpenDeviceOrFile(Path, OpenMode, FileId);
+    if (Status != ENOENT || OpenMode != OpenReadOnly)
+        return Status;
+
+    /* The file does not exist, try its compressed form, see compress.c */
+    if (!FsGetCompressedFileName(Path, CompressedPath, sizeof(CompressedPath)))
+        return Status;
+
+    /* Find some room for the file */
+    for (i = 0; ; ++i)
+    {
+        if (i >= _countof(FileData))
+            return EMFILE;
+        if (!FileData[i].FuncTable)
+            break;
+    }
+
+    /* It has no parent device, as the compressed file references it already */
+    FileData[i].DeviceId = INVALID_FILE_ID;
+    FileData[i].ReferenceCount = 0;
+    FileData[i].FuncTable = &CompressedFileFuncTable;
+    *FileId = i;
+    Status = FileData[i].FuncTable->Open(CompressedPath, OpenMode, FileId);
+    if (Status != ESUCCESS)
+    {
+        FileData[i].FuncTable = NULL;
+        FileData[i].Specific = NULL;
+        *FileId = INVALID_FILE_ID;
+        return Status;
+    }
+
+    TRACE("Opened '%s' from '%s'\n", Path, CompressedPath);
+    FileData[i].ReferenceCount++;
+    return ESUCCESS;
+}
+
 static DEVICE*
 FsGetDeviceById(ULONG DeviceId)
 {
@@ -619,6 +704,8 @@ PCWSTR FsGetServiceName(ULONG FileId)
 {
     if (!IS_VALID_FILEID(FileId))
         return NULL;
+    if (FileData[FileId].FuncTable == &CompressedFileFuncTable)
+        return FsGetServiceName(CompressedGetBaseFileId(FileId));
     return FileData[FileId].FuncTable->ServiceName;
 }
 
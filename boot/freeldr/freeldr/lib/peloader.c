@@ -29,6 +29,16 @@ LIST_ENTRY FrLdrModuleList;
 
 PELDR_IMPORTDLL_LOAD_CALLBACK PeLdrImportDllLoadCallback = NULL;
 
+/* Images read ahead of time by PeLdrPreloadImages(), waiting to be bound */
+typedef struct _PELDR_PRELOADED_IMAGE
+{
+    LIST_ENTRY Link;
+    PVOID ImageBasePA; /* NULL until the image has been read */
+    CHAR FilePath[ANYSIZE_ARRAY];
+} PELDR_PRELOADED_IMAGE, *PPELDR_PRELOADED_IMAGE;
+
+static LIST_ENTRY PeLdrPreloadedImageList = {&PeLdrPreloadedImageList, &PeLdrPreloadedImageList};
+
 #ifdef _WIN64
 #define COOKIE_MAX 0x0000FFFFFFFFFFFFll
 #define DEFAULT_SECURITY_COOKIE 0x00002B992DDFA232ll
@@ -1039,12 +1049,247 @@ Failure:
     return FALSE;
 }
 
+static PPELDR_PRELOADED_IMAGE
+PeLdrpFindPreloadedImage(
+    _In_ PCSTR FilePath)
+{
+    PLIST_ENTRY Entry;
+    PPELDR_PRELOADED_IMAGE Image;
+
+    for (Entry = PeLdrPreloadedImageList.Flink;
+         Entry != &PeLdrPreloadedImageList;
+         Entry = Entry->Flink)
+    {
+        Image = CONTAINING_RECORD(Entry, PELDR_PRELOADED_IMAGE, Link);
+        if (_stricmp(Image->FilePath, FilePath) == 0)
+            return Image;
+    }
+
+    return NULL;
+}
+
+/* Returns TRUE if a DLL with that name is in the module list, without referencing it */
+static BOOLEAN
+PeLdrpIsDllLoaded(
+    _In_ PLIST_ENTRY ModuleListHead,
+    _In_ PCSTR DllName)
+{
+    PLIST_ENTRY ModuleEntry;
+    PLDR_DATA_TABLE_ENTRY DataTableEntry;
+
+    for (ModuleEntry = ModuleListHead->Flink;
+         ModuleEntry != ModuleListHead;
+         ModuleEntry = ModuleEntry->Flink)
+    {
+        DataTableEntry = CONTAINING_RECORD(ModuleEntry,
+                                           LDR_DATA_TABLE_ENTRY,
+                                           InLoadOrderLinks);
+        if (PeLdrpCompareDllName(DllName, &DataTableEntry->BaseDllName))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static VOID
+PeLdrpQueuePreloadedImage(
+    _In_ PCSTR DirectoryPath,
+    _In_ SIZE_T DirectoryLength,
+    _In_ PCSTR FileName)
+{
+    PPELDR_PRELOADED_IMAGE Image;
+    SIZE_T Size;
+
+    Size = FIELD_OFFSET(PELDR_PRELOADED_IMAGE, FilePath) + DirectoryLength + strlen(FileName) + 1;
+    Image = FrLdrTempAlloc(Size, TAG_WLDR_PRELOAD);
+    if (!Image)
+        return;
+
+    Image->ImageBasePA = NULL;
+    RtlCopyMemory(Image->FilePath, DirectoryPath, DirectoryLength);
+    Image->FilePath[DirectoryLength] = ANSI_NULL;
+    RtlStringCbCatA(Image->FilePath, Size - FIELD_OFFSET(PELDR_PRELOADED_IMAGE, FilePath), FileName);
+
+    /* Someone else already asked for it */
+    if (PeLdrpFindPreloadedImage(Image->FilePath))
+    {
+        FrLdrTempFree(Image, TAG_WLDR_PRELOAD);
+        return;
+    }
+
+    InsertTailList(&PeLdrPreloadedImageList, &Image->Link);
+}
+
+/* Queues the DLLs imported by a preloaded image that nobody has loaded or asked for yet */
+static VOID
+PeLdrpQueuePreloadedImports(
+    _In_ PLIST_ENTRY ModuleListHead,
+    _In_ PPELDR_PRELOADED_IMAGE Image)
+{
+    PIMAGE_IMPORT_DESCRIPTOR ImportTable;
+    ULONG ImportTableSize;
+    PCSTR ImportName, FileName;
+
+    ImportTable = RtlImageDirectoryEntryToData(Image->ImageBasePA,
+                                               TRUE,
+                                               IMAGE_DIRECTORY_ENTRY_IMPORT,
+                                               &ImportTableSize);
+    if (!ImportTable)
+        return;
+
+    /* The imports are looked for in the directory of the importing image */
+    FileName = strrchr(Image->FilePath, '\\');
+    FileName = FileName ? FileName + 1 : Image->FilePath;
+
+    for (; (ImportTable->Name != 0) && (ImportTable->OriginalFirstThunk != 0); ImportTable++)
+    {
+        ImportName = (PCSTR)RVA(Image->ImageBasePA, ImportTable->Name);
+
+        if (_stricmp(ImportName, FileName) == 0 ||
+            PeLdrpIsDllLoaded(ModuleListHead, ImportName))
+        {
+            continue;
+        }
+
+        PeLdrpQueuePreloadedImage(Image->FilePath, FileName - Image->FilePath, ImportName);
+    }
+}
+
+/**
+ * @brief
+ * Reads a set of images, and the DLLs they import that are not loaded yet,
+ * before any of them gets bound. Each round of reads is sorted by path, which
+ * on our boot media is close to the order of the files on the disk. The
+ * images are then handed out by PeLdrLoadImage() instead of being read again.
+ *
+ * @return
+ * FALSE if the images could not be queued. Images that fail to load are
+ * just dropped, the caller then tries to load them and reports the failure.
+ **/
+BOOLEAN
+PeLdrPreloadImages(
+    _In_ PLIST_ENTRY ModuleListHead,
+    _In_reads_(FileCount) PCSTR* FilePaths,
+    _In_ ULONG FileCount)
+{
+    PPELDR_PRELOADED_IMAGE *Batch, Image;
+    PLIST_ENTRY Entry;
+    ULONG i, j, BatchSize;
+    PCSTR FileName;
+
+    for (i = 0; i < FileCount; i++)
+    {
+        FileName = strrchr(FilePaths[i], '\\');
+        FileName = FileName ? FileName + 1 : FilePaths[i];
+
+        if (!PeLdrpIsDllLoaded(ModuleListHead, FileName))
+            PeLdrpQueuePreloadedImage(FilePaths[i], FileName - FilePaths[i], FileName);
+    }
+
+    while (TRUE)
+    {
+        /* Gather the images queued since the last round */
+        BatchSize = 0;
+        for (Entry = PeLdrPreloadedImageList.Flink;
+             Entry != &PeLdrPreloadedImageList;
+             Entry = Entry->Flink)
+        {
+            Image = CONTAINING_RECORD(Entry, PELDR_PRELOADED_IMAGE, Link);
+            if (!Image->ImageBasePA)
+                BatchSize++;
+        }
+        if (BatchSize == 0)
+            break;
+
+        Batch = FrLdrTempAlloc(BatchSize * sizeof(*Batch), TAG_WLDR_PRELOAD);
+        if (!Batch)
+        {
+            PeLdrFreePreloadedImages();
+            return FALSE;
+        }
+
+        /* Sort them by path */
+        BatchSize = 0;
+        for (Entry = PeLdrPreloadedImageList.Flink;
+             Entry != &PeLdrPreloadedImageList;
+             Entry = Entry->Flink)
+        {
+            Image = CONTAINING_RECORD(Entry, PELDR_PRELOADED_IMAGE, Link);
+            if (Image->ImageBasePA)
+                continue;
+
+            for (j = BatchSize; j > 0 && _stricmp(Batch[j - 1]->FilePath, Image->FilePath) > 0; j--)
+                Batch[j] = Batch[j - 1];
+            Batch[j] = Image;
+            BatchSize++;
+        }
+
+        /* Read them, then queue what they import for the next round */
+        for (i = 0; i < BatchSize; i++)
+        {
+            Image = Batch[i];
+            if (!PeLdrLoadImageEx(Image->FilePath, LoaderBootDriver, &Image->ImageBasePA, TRUE))
+            {
+                WARN("Failed to preload '%s'\n", Image->FilePath);
+                RemoveEntryList(&Image->Link);
+                FrLdrTempFree(Image, TAG_WLDR_PRELOAD);
+                Batch[i] = NULL;
+            }
+        }
+        for (i = 0; i < BatchSize; i++)
+        {
+            if (Batch[i])
+                PeLdrpQueuePreloadedImports(ModuleListHead, Batch[i]);
+        }
+
+        FrLdrTempFree(Batch, TAG_WLDR_PRELOAD);
+    }
+
+    return TRUE;
+}
+
+/* Frees the preloaded images nobody asked for */
+VOID
+PeLdrFreePreloadedImages(VOID)
+{
+    PPELDR_PRELOADED_IMAGE Image;
+
+    while (!IsListEmpty(&PeLdrPreloadedImageList))
+    {
+        Image = CONTAINING_RECORD(RemoveHeadList(&PeLdrPreloadedImageList),
+                                  PELDR_PRELOADED_IMAGE,
+                                  Link);
+        if (Image->ImageBasePA)
+        {
+            TRACE("Preloaded image '%s' was not used\n", Image->FilePath);
+            MmFreeMemory(Image->ImageBasePA);
+        }
+        FrLdrTempFree(Image, TAG_WLDR_PRELOAD);
+    }
+}
+
 BOOLEAN
 PeLdrLoadImage(
     _In_ PCSTR FilePath,
     _In_ TYPE_OF_MEMORY MemoryType,
     _Out_ PVOID* ImageBasePA)
 {
+    PPELDR_PRELOADED_IMAGE Image;
+
+    /* Take the image if it has already been read */
+    if (MemoryType == LoaderBootDriver)
+    {
+        Image = PeLdrpFindPreloadedImage(FilePath);
+        if (Image && Image->ImageBasePA)
+        {
+            TRACE("PeLdrLoadImage('%s') using preloaded image at %p\n", FilePath, Image->ImageBasePA);
+            *ImageBasePA = Image->ImageBasePA;
+            RemoveEntryList(&Image->Link);
+            FrLdrTempFree(Image, TAG_WLDR_PRELOAD);
+            return TRUE;
+        }
+    }
+
     return PeLdrLoadImageEx(FilePath, MemoryType, ImageBasePA, TRUE);
 }
 
@@ -375,6 +375,59 @@ WinLdrLoadDeviceDriver(PLIST_ENTRY LoadOrderListHead,
     return TRUE;
 }
 
+/*
+ * Reads all the boot drivers and the DLLs they import in one go, sorted by
+ * path, so that binding them afterwards doesn't have to go back to the disk
+ * for every driver.
+ */
+static VOID
+WinLdrPreloadBootDrivers(PLOADER_PARAMETER_BLOCK LoaderBlock,
+                         PCSTR BootPath)
+{
+    PLIST_ENTRY NextBd;
+    PBOOT_DRIVER_LIST_ENTRY BootDriver;
+    PSTR *FilePaths;
+    ULONG FileCount = 0, i;
+    CHAR FullPath[1024];
+    SIZE_T Size;
+
+    for (NextBd = LoaderBlock->BootDriverListHead.Flink;
+         NextBd != &LoaderBlock->BootDriverListHead;
+         NextBd = NextBd->Flink)
+    {
+        FileCount++;
+    }
+    if (FileCount == 0)
+        return;
+
+    FilePaths = FrLdrTempAlloc(FileCount * sizeof(PSTR), TAG_WLDR_PRELOAD);
+    if (!FilePaths)
+        return;
+
+    FileCount = 0;
+    for (NextBd = LoaderBlock->BootDriverListHead.Flink;
+         NextBd != &LoaderBlock->BootDriverListHead;
+         NextBd = NextBd->Flink)
+    {
+        BootDriver = CONTAINING_RECORD(NextBd, BOOT_DRIVER_LIST_ENTRY, Link);
+
+        /* Same path as WinLdrLoadDeviceDriver() builds */
+        RtlStringCbPrintfA(FullPath, sizeof(FullPath), "%s%wZ", BootPath, &BootDriver->FilePath);
+        Size = strlen(FullPath) + 1;
+        FilePaths[FileCount] = FrLdrTempAlloc(Size, TAG_WLDR_PRELOAD);
+        if (!FilePaths[FileCount])
+            break;
+        RtlCopyMemory(FilePaths[FileCount], FullPath, Size);
+        FileCount++;
+    }
+
+    PeLdrPreloadImages(&LoaderBlock->LoadOrderListHead, (PCSTR*)FilePaths, FileCount);
+
+    for (i = 0; i < FileCount; i++)
+        FrLdrTempFree(FilePaths[i], TAG_WLDR_PRELOAD);
+    FrLdrTempFree(FilePaths, TAG_WLDR_PRELOAD);
+}
+
 BOOLEAN
 WinLdrLoadBootDrivers(PLOADER_PARAMETER_BLOCK LoaderBlock,
                       PCSTR BootPath)
@@ -384,6 +437,18 @@ WinLdrLoadBootDrivers(PLOADER_PARAMETER_BLOCK LoaderBlock,
     PBOOT_DRIVER_LIST_ENTRY BootDriver;
     BOOLEAN Success;
     BOOLEAN ret = TRUE;
+#if DBG && !defined(_M_ARM)
+    ULONGLONG StartTime, ReadTime;
+
+    StartTime = __rdtsc();
+#endif
+
+    /* First read everything, then bind the drivers from memory */
+    WinLdrPreloadBootDrivers(LoaderBlock, BootPath);
+
+#if DBG && !defined(_M_ARM)
+    ReadTime = __rdtsc();
+#endif
 
     /* Walk through the boot drivers list */
     NextBd = LoaderBlock->BootDriverListHead.Flink;
@@ -433,6 +498,14 @@ WinLdrLoadBootDrivers(PLOADER_PARAMETER_BLOCK LoaderBlock,
         }
     }
 
+    /* Drop what was read for drivers that failed */
+    PeLdrFreePreloadedImages();
+
+#if DBG && !defined(_M_ARM)
+    TRACE("Boot drivers: reading took %I64u cycles, binding %I64u cycles\n",
+          ReadTime - StartTime, __rdtsc() - ReadTime);
+#endif
+
     return ret;
 }
 
@@ -1248,6 +1321,9 @@ LoadAndBootWindowsCommon(
     KiSystemStartup = (KERNEL_ENTRY_POINT)KernelDTE->EntryPoint;
     LoaderBlockVA = PaToVa(LoaderBlock);
 
+    /* Report how well the disk cache did while loading */
+    CacheDumpStatistics();
+
     /* "Stop all motors", change videomode */
     MachPrepareForReactOS();
 
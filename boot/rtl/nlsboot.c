@@ -171,6 +171,22 @@ RtlpUpcaseUnicodeChar(
     return Source + (SHORT)Offset;
 }
 
+ULONG
+NTAPI
+RtlpUpcaseUnicodeRun(
+    _Out_ PWCHAR Destination,
+    _In_ PCWCH Source,
+    _In_ ULONG Count)
+{
+    ULONG i;
+
+    /* No case tables here, RtlpUpcaseUnicodeChar does it all */
+    for (i = 0; i < Count; i++)
+        Destination[i] = RtlpUpcaseUnicodeChar(Source[i]);
+
+    return Count;
+}
+
 WCHAR
 NTAPI
 RtlUpcaseUnicodeChar(
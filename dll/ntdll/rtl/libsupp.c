@@ -360,7 +360,7 @@ typedef struct _RTL_ATOM_HANDLE
 NTSTATUS
 RtlpInitAtomTableLock(PRTL_ATOM_TABLE AtomTable)
 {
-   RtlInitializeCriticalSection(&AtomTable->CriticalSection);
+   RtlInitializeSRWLock(&AtomTable->SRWLock);
    return STATUS_SUCCESS;
 }
 
@@ -368,14 +368,13 @@ RtlpInitAtomTableLock(PRTL_ATOM_TABLE AtomTable)
 VOID
 RtlpDestroyAtomTableLock(PRTL_ATOM_TABLE AtomTable)
 {
-   RtlDeleteCriticalSection(&AtomTable->CriticalSection);
 }
 
 
 BOOLEAN
 RtlpLockAtomTable(PRTL_ATOM_TABLE AtomTable)
 {
-   RtlEnterCriticalSection(&AtomTable->CriticalSection);
+   RtlAcquireSRWLockExclusive(&AtomTable->SRWLock);
    return TRUE;
 }
 
@@ -383,7 +382,21 @@ RtlpLockAtomTable(PRTL_ATOM_TABLE AtomTable)
 VOID
 RtlpUnlockAtomTable(PRTL_ATOM_TABLE AtomTable)
 {
-   RtlLeaveCriticalSection(&AtomTable->CriticalSection);
+   RtlReleaseSRWLockExclusive(&AtomTable->SRWLock);
+}
+
+
+VOID
+RtlpLockAtomTableShared(PRTL_ATOM_TABLE AtomTable)
+{
+   RtlAcquireSRWLockShared(&AtomTable->SRWLock);
+}
+
+
+VOID
+RtlpUnlockAtomTableShared(PRTL_ATOM_TABLE AtomTable)
+{
+   RtlReleaseSRWLockShared(&AtomTable->SRWLock);
 }
 
 
@@ -420,12 +420,14 @@ x86BiosCall(
     Fast486Initialize(&EmulatorContext,
                       x86MemRead,
                       x86MemWrite,
+                      NULL,  // MemMapCallback
                       x86IoRead,
                       x86IoWrite,
                       x86BOP,
                       x86IntAck,
                       NULL,  // FpuCallback,
-                      NULL); // Tlb
+                      NULL,  // Tlb
+                      NULL); // MemoryTlb, the context is on the stack
 
     /* Copy the registers */
     EmulatorContext.GeneralRegs[FAST486_REG_EAX].Long = Registers->Eax;
@@ -527,7 +527,7 @@ RtlpGetStackLimits(
 NTSTATUS
 RtlpInitAtomTableLock(PRTL_ATOM_TABLE AtomTable)
 {
-   ExInitializeFastMutex(&AtomTable->FastMutex);
+   ExInitializePushLock(&AtomTable->PushLock);
 
    return STATUS_SUCCESS;
 }
@@ -542,14 +542,30 @@ RtlpDestroyAtomTableLock(PRTL_ATOM_TABLE AtomTable)
 BOOLEAN
 RtlpLockAtomTable(PRTL_ATOM_TABLE AtomTable)
 {
-   ExAcquireFastMutex(&AtomTable->FastMutex);
+   KeEnterCriticalRegion();
+   ExAcquirePushLockExclusive(&AtomTable->PushLock);
    return TRUE;
 }
 
 VOID
 RtlpUnlockAtomTable(PRTL_ATOM_TABLE AtomTable)
 {
-   ExReleaseFastMutex(&AtomTable->FastMutex);
+   ExReleasePushLockExclusive(&AtomTable->PushLock);
+   KeLeaveCriticalRegion();
+}
+
+VOID
+RtlpLockAtomTableShared(PRTL_ATOM_TABLE AtomTable)
+{
+   KeEnterCriticalRegion();
+   ExAcquirePushLockShared(&AtomTable->PushLock);
+}
+
+VOID
+RtlpUnlockAtomTableShared(PRTL_ATOM_TABLE AtomTable)
+{
+   ExReleasePushLockShared(&AtomTable->PushLock);
+   KeLeaveCriticalRegion();
 }
 
 BOOLEAN
@@ -679,7 +695,7 @@ RtlpGetAtomEntry(PRTL_ATOM_TABLE AtomTable, ULONG Index)
 
    /* NOTE: There's no need to explicitly enter a critical region because it's
             guaranteed that we're in a critical region right now (as we hold
-            the atom table lock) */
+            the atom table lock, either shared or exclusive) */
 
    ExEntry = ExMapHandleToPointer(AtomTable->ExHandleTable,
                                   (HANDLE)((ULONG_PTR)Index << 2));
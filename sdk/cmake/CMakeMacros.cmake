@@ -418,10 +418,18 @@ function(create_iso_lists)
         DESTINATION reactos
         NO_CAB FOR bootcd regtest)
 
-    add_cd_file(
-        FILE ${CMAKE_CURRENT_BINARY_DIR}/livecd.iso
-        DESTINATION livecd
-        FOR hybridcd)
+    if(COMPRESS_HYBRIDCD_LIVECD)
+        # FreeLoader loads livecd.is_ in place of the missing livecd.iso
+        add_cd_file(
+            FILE ${CMAKE_CURRENT_BINARY_DIR}/livecd.is_
+            DESTINATION livecd
+            FOR hybridcd)
+    else()
+        add_cd_file(
+            FILE ${CMAKE_CURRENT_BINARY_DIR}/livecd.iso
+            DESTINATION livecd
+            FOR hybridcd)
+    endif()
 
     get_property(_filelist GLOBAL PROPERTY BOOTCD_FILE_LIST)
     string(REPLACE ";" "\n" _filelist "${_filelist}")
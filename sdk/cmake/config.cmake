@@ -98,6 +98,10 @@ cmake_dependent_option(ISAPNP_ENABLE "Whether to enable the ISA PnP support." ON
 set(GENERATE_DEPENDENCY_GRAPH FALSE CACHE BOOL
 "Whether to create a GraphML dependency graph of DLLs.")
 
+set(COMPRESS_HYBRIDCD_LIVECD FALSE CACHE BOOL
+"Whether to put the live image on the hybrid CD as a compressed livecd.is_
+instead of livecd.iso. Only FreeLoader can boot from it.")
+
 if(CMAKE_C_COMPILER_ID STREQUAL "MSVC")
     option(_PREFAST_ "Whether to enable PREFAST while compiling." OFF)
     option(_VS_ANALYZE_ "Whether to enable static analysis while compiling." OFF)
@@ -363,6 +363,7 @@ C_ASSERT(HEAP_CREATE_VALID_MASK == 0x0007F0FF);
 #define RTL_DEBUG_QUERY_HEAP_TAGS                           0x08
 #define RTL_DEBUG_QUERY_HEAP_BLOCKS                         0x10
 #define RTL_DEBUG_QUERY_LOCKS                               0x20
+#define RTL_DEBUG_QUERY_LOCK_STATISTICS                     0x40000000
 
 //
 // RTL Handle Flags
@@ -1149,6 +1150,22 @@ typedef struct _RTL_PROCESS_LOCKS
     RTL_PROCESS_LOCK_INFORMATION Locks[1];
 } RTL_PROCESS_LOCKS, *PRTL_PROCESS_LOCKS;
 
+//
+// Process wide contention counters of critical sections and SRW locks
+// (ReactOS specific, RTL_DEBUG_QUERY_LOCK_STATISTICS)
+//
+typedef struct _RTL_PROCESS_LOCK_STATISTICS
+{
+    ULONG CriticalSectionSpinAcquires;
+    ULONG CriticalSectionSpinFailures;
+    ULONG CriticalSectionWaits;
+    ULONG CriticalSectionHandoffs;
+    ULONG SRWLockSpinAcquires;
+    ULONG SRWLockYields;
+    ULONG SRWLockWaits;
+    ULONG SRWLockHandoffs;
+} RTL_PROCESS_LOCK_STATISTICS, *PRTL_PROCESS_LOCK_STATISTICS;
+
 typedef struct _RTL_PROCESS_BACKTRACE_INFORMATION
 {
     PVOID SymbolicBackTrace;
@@ -1205,7 +1222,8 @@ typedef struct _RTL_DEBUG_INFORMATION
     HANDLE ProcessHeap;
     HANDLE CriticalSectionHandle;
     HANDLE CriticalSectionOwnerThread;
-    PVOID Reserved[4];
+    PRTL_PROCESS_LOCK_STATISTICS LockStatistics;
+    PVOID Reserved[3];
 } RTL_DEBUG_INFORMATION, *PRTL_DEBUG_INFORMATION;
 
 //
@@ -1704,9 +1722,9 @@ typedef struct _RTL_ATOM_TABLE
     union
     {
 #ifdef NTOS_MODE_USER
-        RTL_CRITICAL_SECTION CriticalSection;
+        RTL_SRWLOCK SRWLock;
 #else
-        FAST_MUTEX FastMutex;
+        EX_PUSH_LOCK PushLock;
 #endif
     };
     union
@@ -1717,6 +1735,8 @@ typedef struct _RTL_ATOM_TABLE
         PHANDLE_TABLE ExHandleTable;
 #endif
     };
+    ULONG NumberOfAtoms;
+    PRTL_ATOM_TABLE_ENTRY *HashBuckets;
     ULONG NumberOfBuckets;
     PRTL_ATOM_TABLE_ENTRY Buckets[1];
 } RTL_ATOM_TABLE, *PRTL_ATOM_TABLE;
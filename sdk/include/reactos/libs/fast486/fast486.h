@@ -105,6 +105,10 @@
 #define FAST486_FPU_DEFAULT_CONTROL 0x037F
 
 #define FAST486_PAGE_SIZE 4096
+#define FAST486_MEMORY_TLB_SIZE 256
+#define FAST486_MEMORY_TLB_VALID (1 << 0)
+#define FAST486_MEMORY_TLB_USER  (1 << 1)
+
 #define FAST486_CACHE_SIZE 32
 
 /*
@@ -116,6 +120,9 @@
 C_ASSERT((FAST486_CACHE_SIZE >= sizeof(ULONG))
          && (FAST486_CACHE_SIZE <= FAST486_PAGE_SIZE));
 
+/* The memory TLB is indexed with the low bits of the page number */
+C_ASSERT((FAST486_MEMORY_TLB_SIZE & (FAST486_MEMORY_TLB_SIZE - 1)) == 0);
+
 struct _FAST486_STATE;
 typedef struct _FAST486_STATE FAST486_STATE, *PFAST486_STATE;
 
@@ -200,6 +207,21 @@ VOID
     ULONG Size
 );
 
+/*
+ * Returns the host address of the physical page containing Address, if it
+ * is plain memory that can be read (or written) directly, or NULL if the
+ * accesses to that page must go through the memory callbacks. This is only
+ * used when a memory TLB was given to Fast486Initialize.
+ */
+typedef
+PVOID
+(FASTCALL *FAST486_MEM_MAP_PROC)
+(
+    PFAST486_STATE State,
+    ULONG Address,
+    BOOLEAN Write
+);
+
 typedef
 VOID
 (FASTCALL *FAST486_IO_READ_PROC)
@@ -511,10 +533,19 @@ typedef union _FAST486_FPU_CONTROL_REG
     };
 } FAST486_FPU_CONTROL_REG, *PFAST486_FPU_CONTROL_REG;
 
+typedef struct _FAST486_MEMORY_TLB_ENTRY
+{
+    ULONG Tag;
+    BOOLEAN WriteChecked;
+    PUCHAR Read;
+    PUCHAR Write;
+} FAST486_MEMORY_TLB_ENTRY, *PFAST486_MEMORY_TLB_ENTRY;
+
 struct _FAST486_STATE
 {
     FAST486_MEM_READ_PROC MemReadCallback;
     FAST486_MEM_WRITE_PROC MemWriteCallback;
+    FAST486_MEM_MAP_PROC MemMapCallback;
     FAST486_IO_READ_PROC IoReadCallback;
     FAST486_IO_WRITE_PROC IoWriteCallback;
     FAST486_BOP_PROC BopCallback;
@@ -539,6 +570,8 @@ struct _FAST486_STATE
     BOOLEAN DoNotInterrupt;
     PULONG Tlb;
     BOOLEAN TlbEmpty;
+    PFAST486_MEMORY_TLB_ENTRY MemoryTlb;
+    BOOLEAN MemoryTlbEmpty;
 #ifndef FAST486_NO_PREFETCH
     BOOLEAN PrefetchValid;
     ULONG PrefetchAddress;
@@ -563,12 +596,14 @@ NTAPI
 Fast486Initialize(PFAST486_STATE         State,
                   FAST486_MEM_READ_PROC  MemReadCallback,
                   FAST486_MEM_WRITE_PROC MemWriteCallback,
+                  FAST486_MEM_MAP_PROC   MemMapCallback,
                   FAST486_IO_READ_PROC   IoReadCallback,
                   FAST486_IO_WRITE_PROC  IoWriteCallback,
                   FAST486_BOP_PROC       BopCallback,
                   FAST486_INT_ACK_PROC   IntAckCallback,
                   FAST486_FPU_PROC       FpuCallback,
-                  PULONG                 Tlb);
+                  PULONG                 Tlb,
+                  PFAST486_MEMORY_TLB_ENTRY MemoryTlb);
 
 VOID
 NTAPI
@@ -619,6 +654,10 @@ VOID
 NTAPI
 Fast486Rewind(PFAST486_STATE State);
 
+VOID
+NTAPI
+Fast486FlushCache(PFAST486_STATE State);
+
 #endif // _FAST486_H_
 
 /* EOF */
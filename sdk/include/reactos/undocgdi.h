@@ -32,6 +32,15 @@ typedef struct GDI_DRAW_STREAM_TAG
 
 BOOL WINAPI GdiDrawStream(HDC dc, ULONG l, PGDI_DRAW_STREAM pDS);
 
+typedef struct _GDI_BATCH_STATISTICS
+{
+    LONG cBatched;      // Calls queued as a new batch command
+    LONG cCoalesced;    // Calls merged into the last batch command
+    LONG cImmediate;    // Calls that went to win32k directly
+} GDI_BATCH_STATISTICS, *PGDI_BATCH_STATISTICS;
+
+BOOL WINAPI GdiQueryBatchStatistics(PGDI_BATCH_STATISTICS pStatistics);
+
 BOOL WINAPI
 GetTextExtentExPointWPri(
     _In_ HDC hdc,
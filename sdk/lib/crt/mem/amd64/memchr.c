@@ -0,0 +1,62 @@
+/*
+ * PROJECT:     ReactOS CRT library
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     SSE2 implementation of memchr for amd64
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <string.h>
+#include <intrin.h>
+#include <emmintrin.h>
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1910 || !defined(_WIN64))
+#pragma function(memchr)
+#endif /* _MSC_VER */
+
+void* __cdecl memchr(const void *s, int c, size_t n)
+{
+    const unsigned char *p = s;
+    __m128i Match = _mm_set1_epi8((char)c);
+    unsigned long Index;
+    unsigned __int64 Mask;
+    size_t i = 0;
+
+    /* Only whole blocks inside the buffer are loaded, it may end at a page boundary */
+    for (; i + 64 <= n; i += 64)
+    {
+        __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i)), Match);
+        __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i + 16)), Match);
+        __m128i c = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i + 32)), Match);
+        __m128i d = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i + 48)), Match);
+
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))))
+        {
+            Mask = (unsigned __int64)(unsigned)_mm_movemask_epi8(a) |
+                   (unsigned __int64)(unsigned)_mm_movemask_epi8(b) << 16 |
+                   (unsigned __int64)(unsigned)_mm_movemask_epi8(c) << 32 |
+                   (unsigned __int64)(unsigned)_mm_movemask_epi8(d) << 48;
+            _BitScanForward64(&Index, Mask);
+            return (void *)(p + i + Index);
+        }
+    }
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i Chars = _mm_loadu_si128((const __m128i *)(p + i));
+
+        Mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(Chars, Match));
+        if (Mask)
+        {
+            _BitScanForward64(&Index, Mask);
+            return (void *)(p + i + Index);
+        }
+    }
+
+    for (; i < n; i++)
+    {
+        if (p[i] == (unsigned char)c)
+            return (void *)(p + i);
+    }
+
+    return 0;
+}
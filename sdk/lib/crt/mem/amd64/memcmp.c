@@ -0,0 +1,61 @@
+/*
+ * PROJECT:     ReactOS CRT library
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     SSE2 implementation of memcmp for amd64
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <string.h>
+#include <intrin.h>
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4164)
+#pragma function(memcmp)
+#endif
+
+int __cdecl memcmp(const void *s1, const void *s2, size_t n)
+{
+    const unsigned char *p1 = s1, *p2 = s2;
+    unsigned long Index;
+    unsigned int Mask;
+    size_t i = 0;
+
+    for (; i + 64 <= n; i += 64)
+    {
+        __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p1 + i)),
+                                   _mm_loadu_si128((const __m128i *)(p2 + i)));
+        __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p1 + i + 16)),
+                                   _mm_loadu_si128((const __m128i *)(p2 + i + 16)));
+        __m128i c = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p1 + i + 32)),
+                                   _mm_loadu_si128((const __m128i *)(p2 + i + 32)));
+        __m128i d = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p1 + i + 48)),
+                                   _mm_loadu_si128((const __m128i *)(p2 + i + 48)));
+
+        /* Leave it to the loop below to find the difference */
+        if (_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(a, b), _mm_and_si128(c, d))) != 0xFFFF)
+            break;
+    }
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(p1 + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(p2 + i));
+
+        /* One bit per byte that differs */
+        Mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF;
+        if (Mask)
+        {
+            _BitScanForward(&Index, Mask);
+            return p1[i + Index] - p2[i + Index];
+        }
+    }
+
+    for (; i < n; i++)
+    {
+        if (p1[i] != p2[i])
+            return p1[i] - p2[i];
+    }
+
+    return 0;
+}
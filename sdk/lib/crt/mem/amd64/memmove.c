@@ -0,0 +1,157 @@
+/*
+ * PROJECT:     ReactOS CRT library
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     SSE2 implementation of memmove and memcpy for amd64
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <intrin.h>
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#pragma function(memcpy)
+#pragma function(memmove)
+#endif /* _MSC_VER */
+
+/* From this size on, non-overlapping copies use rep movsb */
+#define MOVSB_THRESHOLD 2048
+
+/*
+ * Copies of up to 32 bytes load everything before storing anything,
+ * which makes them safe for overlapping buffers in either direction.
+ */
+static __inline void
+CopySmall(unsigned char *Dest, const unsigned char *Src, size_t Count)
+{
+    if (Count >= 16)
+    {
+        __m128i Head = _mm_loadu_si128((const __m128i *)Src);
+        __m128i Tail = _mm_loadu_si128((const __m128i *)(Src + Count - 16));
+        _mm_storeu_si128((__m128i *)Dest, Head);
+        _mm_storeu_si128((__m128i *)(Dest + Count - 16), Tail);
+    }
+    else if (Count >= 8)
+    {
+        __m128i Head = _mm_loadl_epi64((const __m128i *)Src);
+        __m128i Tail = _mm_loadl_epi64((const __m128i *)(Src + Count - 8));
+        _mm_storel_epi64((__m128i *)Dest, Head);
+        _mm_storel_epi64((__m128i *)(Dest + Count - 8), Tail);
+    }
+    else if (Count >= 4)
+    {
+        unsigned int Head = *(const unsigned int *)Src;
+        unsigned int Tail = *(const unsigned int *)(Src + Count - 4);
+        *(unsigned int *)Dest = Head;
+        *(unsigned int *)(Dest + Count - 4) = Tail;
+    }
+    else if (Count >= 2)
+    {
+        unsigned short Head = *(const unsigned short *)Src;
+        unsigned short Tail = *(const unsigned short *)(Src + Count - 2);
+        *(unsigned short *)Dest = Head;
+        *(unsigned short *)(Dest + Count - 2) = Tail;
+    }
+    else if (Count)
+    {
+        *Dest = *Src;
+    }
+}
+
+/*
+ * Larger copies keep the first and last 16 bytes in registers and store
+ * them last, the loop in between only does aligned stores. In each step
+ * all loads are done before the stores, so a destination below the
+ * source can be copied forwards and one above the source backwards.
+ */
+static void
+CopyForward(unsigned char *Dest, const unsigned char *Src, size_t Count)
+{
+    __m128i Head = _mm_loadu_si128((const __m128i *)Src);
+    __m128i Tail = _mm_loadu_si128((const __m128i *)(Src + Count - 16));
+    size_t i = 16 - ((size_t)Dest & 15);
+    size_t End = Count - 16;
+
+    for (; i + 64 <= End; i += 64)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(Src + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(Src + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(Src + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *)(Src + i + 48));
+        _mm_store_si128((__m128i *)(Dest + i), a);
+        _mm_store_si128((__m128i *)(Dest + i + 16), b);
+        _mm_store_si128((__m128i *)(Dest + i + 32), c);
+        _mm_store_si128((__m128i *)(Dest + i + 48), d);
+    }
+
+    for (; i < End; i += 16)
+    {
+        _mm_store_si128((__m128i *)(Dest + i),
+                        _mm_loadu_si128((const __m128i *)(Src + i)));
+    }
+
+    _mm_storeu_si128((__m128i *)Dest, Head);
+    _mm_storeu_si128((__m128i *)(Dest + End), Tail);
+}
+
+static void
+CopyBackward(unsigned char *Dest, const unsigned char *Src, size_t Count)
+{
+    __m128i Head = _mm_loadu_si128((const __m128i *)Src);
+    __m128i Tail = _mm_loadu_si128((const __m128i *)(Src + Count - 16));
+    ptrdiff_t i = Count - 16 - ((size_t)(Dest + Count) & 15);
+
+    /* i is the offset of the next 16 byte block, going down to the head */
+    for (; i >= 48; i -= 64)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(Src + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(Src + i - 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(Src + i - 32));
+        __m128i d = _mm_loadu_si128((const __m128i *)(Src + i - 48));
+        _mm_store_si128((__m128i *)(Dest + i), a);
+        _mm_store_si128((__m128i *)(Dest + i - 16), b);
+        _mm_store_si128((__m128i *)(Dest + i - 32), c);
+        _mm_store_si128((__m128i *)(Dest + i - 48), d);
+    }
+
+    for (; i > 0; i -= 16)
+    {
+        _mm_store_si128((__m128i *)(Dest + i),
+                        _mm_loadu_si128((const __m128i *)(Src + i)));
+    }
+
+    _mm_storeu_si128((__m128i *)(Dest + Count - 16), Tail);
+    _mm_storeu_si128((__m128i *)Dest, Head);
+}
+
+void * __cdecl memmove(void *dest, const void *src, size_t count)
+{
+    unsigned char *Dest = dest;
+    const unsigned char *Src = src;
+
+    if (count <= 32)
+    {
+        CopySmall(Dest, Src, count);
+    }
+    else if ((size_t)(Dest - Src) >= count)
+    {
+        /* Destination below the source or no overlap at all */
+        if (count >= MOVSB_THRESHOLD && (size_t)(Src - Dest) >= count)
+            __movsb(Dest, Src, count);
+        else
+            CopyForward(Dest, Src, count);
+    }
+    else
+    {
+        CopyBackward(Dest, Src, count);
+    }
+
+    return dest;
+}
+
+void * __cdecl memcpy(void *dest, const void *src, size_t count)
+{
+    /* Like the generic one, memcpy handles overlapping buffers as well */
+    return memmove(dest, src, count);
+}
@@ -0,0 +1,83 @@
+/*
+ * PROJECT:     ReactOS CRT library
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     SSE2 implementation of memset for amd64
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <string.h>
+#include <intrin.h>
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#pragma function(memset)
+#endif /* _MSC_VER */
+
+/* From this size on, rep stosb is used */
+#define STOSB_THRESHOLD 2048
+
+void* __cdecl memset(void* src, int val, size_t count)
+{
+    unsigned char *Dest = src;
+    __m128i Fill = _mm_set1_epi8((char)val);
+    size_t i, End;
+
+    if (count <= 32)
+    {
+        /* Two overlapping stores of the right size cover everything */
+        if (count >= 16)
+        {
+            _mm_storeu_si128((__m128i *)Dest, Fill);
+            _mm_storeu_si128((__m128i *)(Dest + count - 16), Fill);
+        }
+        else if (count >= 8)
+        {
+            _mm_storel_epi64((__m128i *)Dest, Fill);
+            _mm_storel_epi64((__m128i *)(Dest + count - 8), Fill);
+        }
+        else if (count >= 4)
+        {
+            unsigned int Value = (unsigned int)_mm_cvtsi128_si32(Fill);
+            *(unsigned int *)Dest = Value;
+            *(unsigned int *)(Dest + count - 4) = Value;
+        }
+        else if (count >= 2)
+        {
+            unsigned short Value = (unsigned short)_mm_cvtsi128_si32(Fill);
+            *(unsigned short *)Dest = Value;
+            *(unsigned short *)(Dest + count - 2) = Value;
+        }
+        else if (count)
+        {
+            *Dest = (unsigned char)val;
+        }
+
+        return src;
+    }
+
+    if (count >= STOSB_THRESHOLD)
+    {
+        __stosb(Dest, (unsigned char)val, count);
+        return src;
+    }
+
+    /* Unaligned head and tail, aligned stores in between */
+    _mm_storeu_si128((__m128i *)Dest, Fill);
+    i = 16 - ((size_t)Dest & 15);
+    End = count - 16;
+
+    for (; i + 64 <= End; i += 64)
+    {
+        _mm_store_si128((__m128i *)(Dest + i), Fill);
+        _mm_store_si128((__m128i *)(Dest + i + 16), Fill);
+        _mm_store_si128((__m128i *)(Dest + i + 32), Fill);
+        _mm_store_si128((__m128i *)(Dest + i + 48), Fill);
+    }
+
+    for (; i < End; i += 16)
+        _mm_store_si128((__m128i *)(Dest + i), Fill);
+
+    _mm_storeu_si128((__m128i *)(Dest + End), Fill);
+
+    return src;
+}
@@ -1,7 +1,6 @@
 
 list(APPEND LIBCNTPR_MEM_SOURCE
     mem/memccpy.c
-    mem/memcmp.c
     mem/memicmp.c
 )
 
@@ -14,9 +13,20 @@ if(ARCH STREQUAL "i386")
     list(APPEND CRT_MEM_ASM_SOURCE
         ${LIBCNTPR_MEM_ASM_SOURCE}
     )
+    list(APPEND LIBCNTPR_MEM_SOURCE
+        mem/memcmp.c
+    )
+elseif(ARCH STREQUAL "amd64")
+    list(APPEND LIBCNTPR_MEM_SOURCE
+        mem/amd64/memchr.c
+        mem/amd64/memcmp.c
+        mem/amd64/memmove.c
+        mem/amd64/memset.c
+    )
 else()
     list(APPEND LIBCNTPR_MEM_SOURCE
         mem/memchr.c
+        mem/memcmp.c
         mem/memcpy.c
         mem/memmove.c
         mem/memset.c
@@ -0,0 +1,6 @@
+
+#define _XINT int
+#include <string.h>
+#include "tcschr.h"
+
+/* EOF */
@@ -0,0 +1,5 @@
+
+#include <string.h>
+#include "tcslen.h"
+
+/* EOF */
@@ -0,0 +1,97 @@
+/*
+ * PROJECT:     ReactOS CRT library
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     SSE2 implementation of strchr and wcschr for amd64
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <stddef.h>
+#include <tchar.h>
+#include <intrin.h>
+#include <emmintrin.h>
+
+#ifdef _UNICODE
+#define _mm_cmpeq_tchar _mm_cmpeq_epi16
+#define _mm_set1_tchar(c) _mm_set1_epi16((short)(c))
+#else
+#define _mm_cmpeq_tchar _mm_cmpeq_epi8
+#define _mm_set1_tchar(c) _mm_set1_epi8((char)(c))
+#endif
+
+/* Compare an aligned block of 16 bytes against the character and the terminator */
+static __inline __m128i
+ScanBlock(const unsigned char *Block, __m128i Match)
+{
+    __m128i Chars = _mm_load_si128((const __m128i *)Block);
+
+    return _mm_or_si128(_mm_cmpeq_tchar(Chars, Match),
+                        _mm_cmpeq_tchar(Chars, _mm_setzero_si128()));
+}
+
+/* Same aligned block scan as _tcslen, see tcslen.h */
+_TCHAR * _tcschr(const _TCHAR * s, _XINT c)
+{
+    _TCHAR cc = c;
+    const unsigned char *Block;
+    unsigned __int64 Mask;
+    unsigned long Index;
+    unsigned int Skip;
+    __m128i Match;
+
+#ifdef _UNICODE
+    if ((size_t)s & 1)
+    {
+        while(*s)
+        {
+            if(*s == cc) return (_TCHAR *)s;
+
+            s++;
+        }
+
+        if(cc == 0) return (_TCHAR *)s;
+
+        return 0;
+    }
+#endif
+
+    Match = _mm_set1_tchar(cc);
+    Skip = (unsigned int)((size_t)s & 15);
+    Block = (const unsigned char *)s - Skip;
+    Mask = (unsigned int)_mm_movemask_epi8(ScanBlock(Block, Match)) & (0xFFFFu << Skip);
+
+    if (!Mask)
+    {
+        for (Block += 16; (size_t)Block & 63; Block += 16)
+        {
+            Mask = (unsigned int)_mm_movemask_epi8(ScanBlock(Block, Match));
+            if (Mask)
+                goto Found;
+        }
+
+        for (;; Block += 64)
+        {
+            __m128i a = ScanBlock(Block, Match);
+            __m128i b = ScanBlock(Block + 16, Match);
+            __m128i c = ScanBlock(Block + 32, Match);
+            __m128i d = ScanBlock(Block + 48, Match);
+
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))))
+            {
+                Mask = (unsigned __int64)(unsigned int)_mm_movemask_epi8(a) |
+                       (unsigned __int64)(unsigned int)_mm_movemask_epi8(b) << 16 |
+                       (unsigned __int64)(unsigned int)_mm_movemask_epi8(c) << 32 |
+                       (unsigned __int64)(unsigned int)_mm_movemask_epi8(d) << 48;
+                break;
+            }
+        }
+    }
+
+Found:
+    /* Either the character or the terminator, which matches when cc is 0 */
+    _BitScanForward64(&Index, Mask);
+    s = (const _TCHAR *)(Block + Index);
+
+    return (*s == cc) ? (_TCHAR *)s : 0;
+}
+
+/* EOF */
@@ -0,0 +1,93 @@
+/*
+ * PROJECT:     ReactOS CRT library
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     SSE2 implementation of strlen and wcslen for amd64
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <stddef.h>
+#include <tchar.h>
+#include <intrin.h>
+#include <emmintrin.h>
+
+#ifdef _UNICODE
+#define _mm_cmpeq_tchar _mm_cmpeq_epi16
+#else
+#define _mm_cmpeq_tchar _mm_cmpeq_epi8
+#endif
+
+#ifdef _MSC_VER
+#pragma function(_tcslen)
+#endif /* _MSC_VER */
+
+/* Compare an aligned block of 16 bytes against the terminator */
+static __inline __m128i
+ScanBlock(const unsigned char *Block)
+{
+    return _mm_cmpeq_tchar(_mm_load_si128((const __m128i *)Block), _mm_setzero_si128());
+}
+
+/*
+ * The string is scanned in aligned 16 byte blocks. An aligned block never
+ * crosses a page boundary, so reading the bytes around the string within
+ * the first and the last block can't fault. Bytes before the start are
+ * masked out. Once at a 64 byte boundary, four blocks are scanned at a
+ * time, they're all in the same page as well.
+ */
+size_t __cdecl _tcslen(const _TCHAR * str)
+{
+    const unsigned char *Block;
+    unsigned __int64 Mask;
+    unsigned long Index;
+    unsigned int Skip;
+
+    if(str == 0) return 0;
+
+#ifdef _UNICODE
+    /* Characters would straddle the blocks */
+    if ((size_t)str & 1)
+    {
+        const _TCHAR * s;
+
+        for(s = str; *s; ++ s);
+        return s - str;
+    }
+#endif
+
+    Skip = (unsigned int)((size_t)str & 15);
+    Block = (const unsigned char *)str - Skip;
+    Mask = (unsigned int)_mm_movemask_epi8(ScanBlock(Block)) & (0xFFFFu << Skip);
+
+    if (!Mask)
+    {
+        for (Block += 16; (size_t)Block & 63; Block += 16)
+        {
+            Mask = (unsigned int)_mm_movemask_epi8(ScanBlock(Block));
+            if (Mask)
+                goto Found;
+        }
+
+        for (;; Block += 64)
+        {
+            __m128i a = ScanBlock(Block);
+            __m128i b = ScanBlock(Block + 16);
+            __m128i c = ScanBlock(Block + 32);
+            __m128i d = ScanBlock(Block + 48);
+
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))))
+            {
+                Mask = (unsigned __int64)(unsigned int)_mm_movemask_epi8(a) |
+                       (unsigned __int64)(unsigned int)_mm_movemask_epi8(b) << 16 |
+                       (unsigned __int64)(unsigned int)_mm_movemask_epi8(c) << 32 |
+                       (unsigned __int64)(unsigned int)_mm_movemask_epi8(d) << 48;
+                break;
+            }
+        }
+    }
+
+Found:
+    _BitScanForward64(&Index, Mask);
+    return (const _TCHAR *)(Block + Index) - str;
+}
+
+/* EOF */
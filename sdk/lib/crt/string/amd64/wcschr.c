@@ -0,0 +1,7 @@
+
+#define _UNICODE
+#define _XINT wchar_t
+#include <wchar.h>
+#include "tcschr.h"
+
+/* EOF */
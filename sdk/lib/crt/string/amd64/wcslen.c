@@ -0,0 +1,6 @@
+
+#define _UNICODE
+#include <wchar.h>
+#include "tcslen.h"
+
+/* EOF */
@@ -58,6 +58,29 @@ if(ARCH STREQUAL "i386")
         string/i386/wcsnlen_asm.s
         string/i386/wcsrchr_asm.s
     )
+elseif(ARCH STREQUAL "amd64")
+    list(APPEND LIBCNTPR_STRING_SOURCE
+        string/amd64/strchr.c
+        string/amd64/strlen.c
+        string/amd64/wcschr.c
+        string/amd64/wcslen.c
+        string/strcat.c
+        string/strcmp.c
+        string/strcpy.c
+        string/strncat.c
+        string/strncmp.c
+        string/strncpy.c
+        string/strnlen.c
+        string/strrchr.c
+        string/wcscat.c
+        string/wcscmp.c
+        string/wcscpy.c
+        string/wcsncat.c
+        string/wcsncmp.c
+        string/wcsncpy.c
+        string/wcsnlen.c
+        string/wcsrchr.c
+    )
 else()
     list(APPEND LIBCNTPR_STRING_SOURCE
         string/strcat.c
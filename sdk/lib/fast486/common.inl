@@ -145,16 +145,120 @@ Fast486GetPageTableEntry(PFAST486_STATE State,
     return TableEntry.Value;
 }
 
+FORCEINLINE
+VOID
+FASTCALL
+Fast486FlushMemoryTlb(PFAST486_STATE State)
+{
+    ULONG i;
+
+    if (!State->MemoryTlb || State->MemoryTlbEmpty) return;
+
+    for (i = 0; i < FAST486_MEMORY_TLB_SIZE; i++)
+    {
+        State->MemoryTlb[i].Tag = 0;
+    }
+
+    State->MemoryTlbEmpty = TRUE;
+}
+
 FORCEINLINE
 VOID
 FASTCALL
 Fast486FlushTlb(PFAST486_STATE State)
 {
+    /* The memory TLB caches translations too */
+    Fast486FlushMemoryTlb(State);
+
     if (!State->Tlb || State->TlbEmpty) return;
     RtlFillMemory(State->Tlb, NUM_TLB_ENTRIES * sizeof(ULONG), 0xFF);
     State->TlbEmpty = TRUE;
 }
 
+/*
+ * With paging, the permissions of a page depend on whether the CPU runs at
+ * CPL 0 or not, so the privilege is part of the memory TLB tag.
+ */
+FORCEINLINE
+ULONG
+FASTCALL
+Fast486GetMemoryTlbTag(PFAST486_STATE State,
+                       ULONG LinearAddress)
+{
+    ULONG Tag = PAGE_ALIGN(LinearAddress) | FAST486_MEMORY_TLB_VALID;
+
+    if ((State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
+        && (Fast486GetCurrentPrivLevel(State) > 0))
+    {
+        Tag |= FAST486_MEMORY_TLB_USER;
+    }
+
+    return Tag;
+}
+
+/*
+ * Returns the host address of the given linear range if it's in a single
+ * directly mapped page that was already accessed this way, or NULL.
+ */
+FORCEINLINE
+PUCHAR
+FASTCALL
+Fast486GetHostAddress(PFAST486_STATE State,
+                      ULONG LinearAddress,
+                      ULONG Size,
+                      BOOLEAN Write)
+{
+    PFAST486_MEMORY_TLB_ENTRY Entry;
+    PUCHAR Page;
+
+    if (!State->MemoryTlb) return NULL;
+
+    Entry = &State->MemoryTlb[(LinearAddress >> 12) & (FAST486_MEMORY_TLB_SIZE - 1)];
+    if (Entry->Tag != Fast486GetMemoryTlbTag(State, LinearAddress)) return NULL;
+    if ((PAGE_OFFSET(LinearAddress) + Size) > FAST486_PAGE_SIZE) return NULL;
+
+    Page = Write ? Entry->Write : Entry->Read;
+    if (Page == NULL) return NULL;
+
+    return Page + PAGE_OFFSET(LinearAddress);
+}
+
+/*
+ * Called once an access to a page has passed all the checks, so that
+ * the next ones can be done directly if the host maps that page.
+ */
+FORCEINLINE
+VOID
+FASTCALL
+Fast486FillMemoryTlb(PFAST486_STATE State,
+                     ULONG LinearAddress,
+                     ULONG PhysicalAddress,
+                     BOOLEAN Write)
+{
+    PFAST486_MEMORY_TLB_ENTRY Entry;
+    ULONG Tag;
+
+    if (!State->MemoryTlb) return;
+
+    Tag = Fast486GetMemoryTlbTag(State, LinearAddress);
+    Entry = &State->MemoryTlb[(LinearAddress >> 12) & (FAST486_MEMORY_TLB_SIZE - 1)];
+
+    if (Entry->Tag != Tag)
+    {
+        Entry->Tag = Tag;
+        Entry->Read = State->MemMapCallback(State, PAGE_ALIGN(PhysicalAddress), FALSE);
+        Entry->Write = NULL;
+        Entry->WriteChecked = FALSE;
+        State->MemoryTlbEmpty = FALSE;
+    }
+
+    if (Write && !Entry->WriteChecked)
+    {
+        Entry->Write = State->MemMapCallback(State, PAGE_ALIGN(PhysicalAddress), TRUE);
+        Entry->WriteChecked = TRUE;
+    }
+}
+
 FORCEINLINE
 BOOLEAN
 FASTCALL
@@ -164,6 +268,15 @@ Fast486ReadLinearMemory(PFAST486_STATE State,
                         ULONG Size,
                         BOOLEAN CheckPrivilege)
 {
+    PUCHAR HostAddress = Fast486GetHostAddress(State, LinearAddress, Size, FALSE);
+
+    if (HostAddress != NULL)
+    {
+        /* Fast path, the page is plain memory and was already checked */
+        RtlCopyMemory(Buffer, HostAddress, Size);
+        return TRUE;
+    }
+
     /* Check if paging is enabled */
     if (State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
     {
@@ -213,6 +326,12 @@ Fast486ReadLinearMemory(PFAST486_STATE State,
                                    (PVOID)((ULONG_PTR)Buffer + BufferOffset),
                                    PageLength);
 
+            if (CheckPrivilege)
+            {
+                /* The privilege checks passed, cache the page */
+                Fast486FillMemoryTlb(State, Page, TableEntry.Address << 12, FALSE);
+            }
+
             BufferOffset += PageLength;
         }
     }
@@ -220,6 +339,12 @@ Fast486ReadLinearMemory(PFAST486_STATE State,
     {
         /* Read the memory */
         State->MemReadCallback(State, LinearAddress, Buffer, Size);
+
+        if (PAGE_ALIGN(LinearAddress) == PAGE_ALIGN(LinearAddress + Size - 1))
+        {
+            /* Without paging, there is nothing else to check */
+            Fast486FillMemoryTlb(State, LinearAddress, LinearAddress, FALSE);
+        }
     }
 
     return TRUE;
@@ -234,6 +359,15 @@ Fast486WriteLinearMemory(PFAST486_STATE State,
                          ULONG Size,
                          BOOLEAN CheckPrivilege)
 {
+    PUCHAR HostAddress = Fast486GetHostAddress(State, LinearAddress, Size, TRUE);
+
+    if (HostAddress != NULL)
+    {
+        /* Fast path, the page is plain memory and was already checked */
+        RtlCopyMemory(HostAddress, Buffer, Size);
+        return TRUE;
+    }
+
     /* Check if paging is enabled */
     if (State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
     {
@@ -286,6 +420,12 @@ Fast486WriteLinearMemory(PFAST486_STATE State,
                                     (PVOID)((ULONG_PTR)Buffer + BufferOffset),
                                     PageLength);
 
+            if (CheckPrivilege)
+            {
+                /* The privilege checks passed and the page is dirty, cache it */
+                Fast486FillMemoryTlb(State, Page, TableEntry.Address << 12, TRUE);
+            }
+
             BufferOffset += PageLength;
         }
     }
@@ -293,6 +433,12 @@ Fast486WriteLinearMemory(PFAST486_STATE State,
     {
         /* Write the memory */
         State->MemWriteCallback(State, LinearAddress, Buffer, Size);
+
+        if (PAGE_ALIGN(LinearAddress) == PAGE_ALIGN(LinearAddress + Size - 1))
+        {
+            /* Without paging, there is nothing else to check */
+            Fast486FillMemoryTlb(State, LinearAddress, LinearAddress, TRUE);
+        }
     }
 
     return TRUE;
@@ -640,7 +640,12 @@ FAST486_OPCODE_HANDLER(Fast486ExtOpcodeLoadControlReg)
     State->PrefetchValid = FALSE;
 #endif
 
-    if (ModRegRm.Register == (FAST486_GEN_REGS)FAST486_REG_CR3)
+    if (ModRegRm.Register == (FAST486_GEN_REGS)FAST486_REG_CR0)
+    {
+        /* Paging or write protection may be toggled */
+        Fast486FlushMemoryTlb(State);
+    }
+    else if (ModRegRm.Register == (FAST486_GEN_REGS)FAST486_REG_CR3)
     {
         /* Flush the TLB */
         Fast486FlushTlb(State);
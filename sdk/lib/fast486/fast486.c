@@ -49,6 +49,18 @@ Fast486MemWriteCallback(PFAST486_STATE State, ULONG Address, PVOID Buffer, ULONG
     RtlMoveMemory(UlongToPtr(Address), Buffer, Size);
 }
 
+static PVOID
+FASTCALL
+Fast486MemMapCallback(PFAST486_STATE State, ULONG Address, BOOLEAN Write)
+{
+    UNREFERENCED_PARAMETER(State);
+    UNREFERENCED_PARAMETER(Address);
+    UNREFERENCED_PARAMETER(Write);
+
+    /* Always go through the memory callbacks */
+    return NULL;
+}
+
 static VOID
 FASTCALL
 Fast486IoReadCallback(PFAST486_STATE State, USHORT Port, PVOID Buffer, ULONG DataCount, UCHAR DataSize)
@@ -103,24 +115,28 @@ NTAPI
 Fast486Initialize(PFAST486_STATE         State,
                   FAST486_MEM_READ_PROC  MemReadCallback,
                   FAST486_MEM_WRITE_PROC MemWriteCallback,
+                  FAST486_MEM_MAP_PROC   MemMapCallback,
                   FAST486_IO_READ_PROC   IoReadCallback,
                   FAST486_IO_WRITE_PROC  IoWriteCallback,
                   FAST486_BOP_PROC       BopCallback,
                   FAST486_INT_ACK_PROC   IntAckCallback,
                   FAST486_FPU_PROC       FpuCallback,
-                  PULONG                 Tlb)
+                  PULONG                 Tlb,
+                  PFAST486_MEMORY_TLB_ENTRY MemoryTlb)
 {
     /* Set the callbacks (or use default ones if some are NULL) */
     State->MemReadCallback  = (MemReadCallback  ? MemReadCallback  : Fast486MemReadCallback );
     State->MemWriteCallback = (MemWriteCallback ? MemWriteCallback : Fast486MemWriteCallback);
+    State->MemMapCallback   = (MemMapCallback   ? MemMapCallback   : Fast486MemMapCallback  );
     State->IoReadCallback   = (IoReadCallback   ? IoReadCallback   : Fast486IoReadCallback  );
     State->IoWriteCallback  = (IoWriteCallback  ? IoWriteCallback  : Fast486IoWriteCallback );
     State->BopCallback      = (BopCallback      ? BopCallback      : Fast486BopCallback     );
     State->IntAckCallback   = (IntAckCallback   ? IntAckCallback   : Fast486IntAckCallback  );
     State->FpuCallback      = (FpuCallback      ? FpuCallback      : Fast486FpuCallback     );
 
-    /* Set the TLB (if given) */
+    /* Set the TLB and the memory TLB (if given) */
     State->Tlb = Tlb;
+    State->MemoryTlb = MemoryTlb;
 
     /* Reset the CPU */
     Fast486Reset(State);
@@ -135,12 +151,14 @@ Fast486Reset(PFAST486_STATE State)
     /* Save the callbacks and TLB */
     FAST486_MEM_READ_PROC  MemReadCallback  = State->MemReadCallback;
     FAST486_MEM_WRITE_PROC MemWriteCallback = State->MemWriteCallback;
+    FAST486_MEM_MAP_PROC   MemMapCallback   = State->MemMapCallback;
     FAST486_IO_READ_PROC   IoReadCallback   = State->IoReadCallback;
     FAST486_IO_WRITE_PROC  IoWriteCallback  = State->IoWriteCallback;
     FAST486_BOP_PROC       BopCallback      = State->BopCallback;
     FAST486_INT_ACK_PROC   IntAckCallback   = State->IntAckCallback;
     FAST486_FPU_PROC       FpuCallback      = State->FpuCallback;
     PULONG                 Tlb              = State->Tlb;
+    PFAST486_MEMORY_TLB_ENTRY MemoryTlb     = State->MemoryTlb;
 
     /* Clear the entire structure */
     RtlZeroMemory(State, sizeof(*State));
@@ -189,14 +207,17 @@ Fast486Reset(PFAST486_STATE State)
     /* Restore the callbacks and TLB */
     State->MemReadCallback  = MemReadCallback;
     State->MemWriteCallback = MemWriteCallback;
+    State->MemMapCallback   = MemMapCallback;
     State->IoReadCallback   = IoReadCallback;
     State->IoWriteCallback  = IoWriteCallback;
     State->BopCallback      = BopCallback;
     State->IntAckCallback   = IntAckCallback;
     State->FpuCallback      = FpuCallback;
     State->Tlb              = Tlb;
+    State->MemoryTlb        = MemoryTlb;
 
-    /* Flush the TLB */
+    /* Flush the TLB, along with the memory TLB */
+    State->MemoryTlbEmpty = FALSE;
     Fast486FlushTlb(State);
 }
 
@@ -260,4 +281,16 @@ Fast486Rewind(PFAST486_STATE State)
 #endif
 }
 
+VOID
+NTAPI
+Fast486FlushCache(PFAST486_STATE State)
+{
+    /* This function is used when the host has modified the memory directly */
+    Fast486FlushMemoryTlb(State);
+
+#ifndef FAST486_NO_PREFETCH
+    State->PrefetchValid = FALSE;
+#endif
+}
+
 /* EOF */
@@ -2284,6 +2284,9 @@ FAST486_OPCODE_HANDLER(Fast486ExtOpcodeGroup0F01)
                 State->Tlb[ModRegRm.MemoryAddress >> 12] = INVALID_TLB_FIELD;
             }
 
+            /* The memory TLB is small, just flush all of it */
+            Fast486FlushMemoryTlb(State);
+
             break;
         }
 
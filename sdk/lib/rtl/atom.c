@@ -19,6 +19,8 @@ extern NTSTATUS RtlpInitAtomTableLock(PRTL_ATOM_TABLE AtomTable);
 extern VOID RtlpDestroyAtomTableLock(PRTL_ATOM_TABLE AtomTable);
 extern BOOLEAN RtlpLockAtomTable(PRTL_ATOM_TABLE AtomTable);
 extern VOID RtlpUnlockAtomTable(PRTL_ATOM_TABLE AtomTable);
+extern VOID RtlpLockAtomTableShared(PRTL_ATOM_TABLE AtomTable);
+extern VOID RtlpUnlockAtomTableShared(PRTL_ATOM_TABLE AtomTable);
 
 extern BOOLEAN RtlpCreateAtomHandleTable(PRTL_ATOM_TABLE AtomTable);
 extern VOID RtlpDestroyAtomHandleTable(PRTL_ATOM_TABLE AtomTable);
@@ -32,6 +34,16 @@ extern BOOLEAN RtlpCreateAtomHandle(PRTL_ATOM_TABLE AtomTable, PRTL_ATOM_TABLE_E
 extern VOID RtlpFreeAtomHandle(PRTL_ATOM_TABLE AtomTable, PRTL_ATOM_TABLE_ENTRY Entry);
 extern PRTL_ATOM_TABLE_ENTRY RtlpGetAtomEntry(PRTL_ATOM_TABLE AtomTable, ULONG Index);
 
+/* GLOBALS *******************************************************************/
+
+/* Grow the hash table once the chains get longer than this on average */
+#define RTL_ATOM_TABLE_LOAD_FACTOR  4
+
+/* There can't be more than 0x4000 string atoms anyway, don't go beyond that */
+#define RTL_ATOM_TABLE_MAX_BUCKETS  0x1001
+
+#define TAG_ATMB    'BotA'
+
 /* FUNCTIONS *****************************************************************/
 
 static
@@ -55,7 +67,7 @@ RtlpHashAtomName(
         PRTL_ATOM_TABLE_ENTRY Current;
         PRTL_ATOM_TABLE_ENTRY *Link;
 
-        Link = &AtomTable->Buckets[Hash % AtomTable->NumberOfBuckets];
+        Link = &AtomTable->HashBuckets[Hash % AtomTable->NumberOfBuckets];
 
         /* search for an existing entry */
         Current = *Link;
@@ -81,6 +93,67 @@ RtlpHashAtomName(
     return NULL;
 }
 
+static
+VOID
+RtlpGrowAtomTable(
+    IN PRTL_ATOM_TABLE AtomTable)
+{
+    PRTL_ATOM_TABLE_ENTRY *NewBuckets, *OldBuckets;
+    PRTL_ATOM_TABLE_ENTRY Current, Next;
+    UNICODE_STRING Name;
+    ULONG NewNumberOfBuckets, Bucket, Hash;
+
+    if (AtomTable->NumberOfBuckets >= RTL_ATOM_TABLE_MAX_BUCKETS)
+        return;
+
+    /* Roughly double the bucket count, keeping it odd */
+    NewNumberOfBuckets = min(AtomTable->NumberOfBuckets * 2 + 1,
+                             RTL_ATOM_TABLE_MAX_BUCKETS);
+
+    NewBuckets = RtlpAllocateMemory(NewNumberOfBuckets * sizeof(PRTL_ATOM_TABLE_ENTRY),
+                                    TAG_ATMB);
+    if (NewBuckets == NULL)
+    {
+        /* Not fatal, we just keep using the longer chains */
+        DPRINT1("Failed to grow atom table %p to %lu buckets\n",
+                AtomTable, NewNumberOfBuckets);
+        return;
+    }
+
+    RtlZeroMemory(NewBuckets, NewNumberOfBuckets * sizeof(PRTL_ATOM_TABLE_ENTRY));
+
+    /* Rehash all the entries into the new buckets */
+    OldBuckets = AtomTable->HashBuckets;
+    for (Bucket = 0; Bucket < AtomTable->NumberOfBuckets; Bucket++)
+    {
+        Current = OldBuckets[Bucket];
+        while (Current != NULL)
+        {
+            Next = Current->HashLink;
+
+            Name.Buffer = Current->Name;
+            Name.Length = Current->NameLength * sizeof(WCHAR);
+            Name.MaximumLength = Name.Length;
+
+            /* Entries always have a non-empty name, so this can't fail */
+            Hash = 0;
+            RtlHashUnicodeString(&Name, TRUE, HASH_STRING_ALGORITHM_X65599, &Hash);
+
+            Current->HashLink = NewBuckets[Hash % NewNumberOfBuckets];
+            NewBuckets[Hash % NewNumberOfBuckets] = Current;
+
+            Current = Next;
+        }
+    }
+
+    AtomTable->HashBuckets = NewBuckets;
+    AtomTable->NumberOfBuckets = NewNumberOfBuckets;
+
+    /* The initial buckets are part of the table itself */
+    if (OldBuckets != AtomTable->Buckets)
+        RtlpFreeMemory(OldBuckets, TAG_ATMB);
+}
+
 static
 BOOLEAN
 RtlpCheckIntegerAtom(
@@ -175,6 +248,8 @@ RtlCreateAtomTable(
 
     /* initialize atom table */
     Table->NumberOfBuckets = TableSize;
+    Table->HashBuckets = Table->Buckets;
+    Table->NumberOfAtoms = 0;
 
     Status = RtlpInitAtomTableLock(Table);
     if (!NT_SUCCESS(Status))
@@ -214,8 +289,8 @@ RtlDestroyAtomTable(
     }
 
     /* delete all atoms */
-    LastBucket = AtomTable->Buckets + AtomTable->NumberOfBuckets;
-    for (CurrentBucket = AtomTable->Buckets;
+    LastBucket = AtomTable->HashBuckets + AtomTable->NumberOfBuckets;
+    for (CurrentBucket = AtomTable->HashBuckets;
             CurrentBucket != LastBucket;
             CurrentBucket++)
     {
@@ -236,6 +311,12 @@ RtlDestroyAtomTable(
 
     RtlpDestroyAtomHandleTable(AtomTable);
 
+    if (AtomTable->HashBuckets != AtomTable->Buckets)
+    {
+        RtlpFreeMemory(AtomTable->HashBuckets, TAG_ATMB);
+        AtomTable->HashBuckets = AtomTable->Buckets;
+    }
+
     RtlpUnlockAtomTable(AtomTable);
 
     RtlpDestroyAtomTableLock(AtomTable);
@@ -267,8 +348,8 @@ RtlEmptyAtomTable(
     }
 
     /* delete all atoms */
-    LastBucket = AtomTable->Buckets + AtomTable->NumberOfBuckets;
-    for (CurrentBucket = AtomTable->Buckets;
+    LastBucket = AtomTable->HashBuckets + AtomTable->NumberOfBuckets;
+    for (CurrentBucket = AtomTable->HashBuckets;
          CurrentBucket != LastBucket;
          CurrentBucket++)
     {
@@ -287,6 +368,8 @@ RtlEmptyAtomTable(
                 RtlpFreeAtomHandle(AtomTable, CurrentEntry);
 
                 RtlpFreeAtomTableEntry(CurrentEntry);
+
+                AtomTable->NumberOfAtoms--;
             }
             else
             {
@@ -393,6 +476,14 @@ RtlAddAtomToAtomTable(IN PRTL_ATOM_TABLE AtomTable,
                     {
                         *Atom = (RTL_ATOM)Entry->Atom;
                     }
+
+                    /* grow the table if the chains got too long. This
+                       invalidates HashLink, so it must come last! */
+                    if (++AtomTable->NumberOfAtoms >
+                        AtomTable->NumberOfBuckets * RTL_ATOM_TABLE_LOAD_FACTOR)
+                    {
+                        RtlpGrowAtomTable(AtomTable);
+                    }
                 }
                 else
                 {
@@ -461,6 +552,8 @@ RtlDeleteAtomFromAtomTable(
                         RtlpFreeAtomHandle(AtomTable, Entry);
 
                         RtlpFreeAtomTableEntry(Entry);
+
+                        AtomTable->NumberOfAtoms--;
                     }
                     else
                     {
@@ -519,7 +612,8 @@ RtlLookupAtomInAtomTable(IN PRTL_ATOM_TABLE AtomTable,
         return Status;
     }
 
-    RtlpLockAtomTable(AtomTable);
+    /* lookups don't modify the table, so they can run concurrently */
+    RtlpLockAtomTableShared(AtomTable);
     Status = STATUS_OBJECT_NAME_NOT_FOUND;
 
     /* string atom */
@@ -530,7 +624,7 @@ RtlLookupAtomInAtomTable(IN PRTL_ATOM_TABLE AtomTable,
         FoundAtom = (RTL_ATOM)Entry->Atom;
     }
 
-    RtlpUnlockAtomTable(AtomTable);
+    RtlpUnlockAtomTableShared(AtomTable);
     if (NT_SUCCESS(Status) && Atom != NULL)
     {
         *Atom = FoundAtom;
@@ -631,7 +725,7 @@ RtlQueryAtomInAtomTable(
     }
     else
     {
-        RtlpLockAtomTable(AtomTable);
+        RtlpLockAtomTableShared(AtomTable);
         Unlock = TRUE;
 
         Entry = RtlpGetAtomEntry(AtomTable, (ULONG)((USHORT)Atom - 0xC000));
@@ -690,7 +784,7 @@ RtlQueryAtomInAtomTable(
         Status = STATUS_INVALID_HANDLE;
     }
 
-    if (Unlock) RtlpUnlockAtomTable(AtomTable);
+    if (Unlock) RtlpUnlockAtomTableShared(AtomTable);
 
     return Status;
 }
@@ -712,10 +806,10 @@ RtlQueryAtomListInAtomTable(
     ULONG Atoms = 0;
     NTSTATUS Status = STATUS_SUCCESS;
 
-    RtlpLockAtomTable(AtomTable);
+    RtlpLockAtomTableShared(AtomTable);
 
-    LastBucket = AtomTable->Buckets + AtomTable->NumberOfBuckets;
-    for (CurrentBucket = AtomTable->Buckets;
+    LastBucket = AtomTable->HashBuckets + AtomTable->NumberOfBuckets;
+    for (CurrentBucket = AtomTable->HashBuckets;
          CurrentBucket != LastBucket;
          CurrentBucket++)
     {
@@ -742,7 +836,7 @@ RtlQueryAtomListInAtomTable(
 
     *AtomCount = Atoms;
 
-    RtlpUnlockAtomTable(AtomTable);
+    RtlpUnlockAtomTableShared(AtomTable);
 
     return Status;
 }
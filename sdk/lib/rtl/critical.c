@@ -25,6 +25,22 @@ static BOOLEAN RtlpDebugInfoFreeList[MAX_STATIC_CS_DEBUG_OBJECTS];
 LARGE_INTEGER RtlpTimeout;
 BOOLEAN RtlpTimeoutDisable;
 
+/*
+ * Spin limit for critical sections initialized without a spin count.
+ * It adapts to how long the locks are usually held: it moves towards
+ * twice the spins a successful acquire needed, and decays when spinning
+ * doesn't pay off. Nobody synchronizes the updates, a stale value only
+ * costs a few spins.
+ */
+#define RTL_CRITSECT_MIN_SPIN       16
+#define RTL_CRITSECT_MAX_SPIN       4000
+#define RTL_CRITSECT_DEFAULT_SPIN   256
+
+static LONG RtlpCriticalSectionSpinLimit = RTL_CRITSECT_DEFAULT_SPIN;
+
+/* Process wide contention counters, see RtlpQueryCriticalSectionStatistics */
+static RTL_PROCESS_LOCK_STATISTICS RtlpCriticalSectionStatistics;
+
 extern BOOLEAN LdrpShutdownInProgress;
 extern HANDLE LdrpShutdownThreadId;
 
@@ -128,6 +144,8 @@ RtlpWaitForCriticalSection(PRTL_CRITICAL_SECTION CriticalSection)
     if (CRITSECT_HAS_DEBUG_INFO(CriticalSection))
         CriticalSection->DebugInfo->EntryCount++;
 
+    InterlockedIncrement((PLONG)&RtlpCriticalSectionStatistics.CriticalSectionWaits);
+
     /*
      * If we're shutting down the process, we're allowed to acquire any
      * critical sections by force (the loader lock in particular)
@@ -224,6 +242,9 @@ RtlpUnWaitCriticalSection(PRTL_CRITICAL_SECTION CriticalSection)
         RtlpCreateCriticalSectionSem(CriticalSection);
     }
 
+    /* The waiter gets the ownership directly, nobody can barge in */
+    InterlockedIncrement((PLONG)&RtlpCriticalSectionStatistics.CriticalSectionHandoffs);
+
     /* Signal the Event */
     DPRINT("Signaling Critical Section Event: %p, %p\n",
             CriticalSection,
@@ -466,6 +487,84 @@ RtlSetCriticalSectionSpinCount(PRTL_CRITICAL_SECTION CriticalSection,
     return OldCount;
 }
 
+/*++
+ * RtlpSpinOnCriticalSection
+ *
+ *     Spins for a while, trying to acquire a busy critical section
+ *     before RtlEnterCriticalSection goes the waiting way.
+ *
+ * Params:
+ *     CriticalSection - Critical section to acquire.
+ *
+ * Returns:
+ *     TRUE if the critical section has been acquired, FALSE otherwise.
+ *
+ * Remarks:
+ *     Spinning only goes on while the owner has nobody queued behind it.
+ *     Queued waiters get the ownership handed over on release, so they
+ *     can't be starved by spinners.
+ *
+ *--*/
+static
+BOOLEAN
+RtlpSpinOnCriticalSection(PRTL_CRITICAL_SECTION CriticalSection)
+{
+    ULONG_PTR SpinCount = CriticalSection->SpinCount & ~RTL_CRITICAL_SECTION_ALL_FLAG_BITS;
+    BOOLEAN Adaptive = FALSE;
+    LONG Limit;
+    LONG Spins;
+
+    if (SpinCount == 0)
+    {
+        /* No spin count given, spinning is pointless on a single processor */
+        if (NtCurrentPeb()->NumberOfProcessors <= 1)
+            return FALSE;
+
+        SpinCount = (ULONG_PTR)RtlpCriticalSectionSpinLimit;
+        Adaptive = TRUE;
+    }
+
+    for (Spins = 0; (ULONG_PTR)Spins < SpinCount; Spins++)
+    {
+        LONG LockCount = *(volatile LONG *)&CriticalSection->LockCount;
+
+        if (LockCount == -1)
+        {
+            if (InterlockedCompareExchange(&CriticalSection->LockCount, 0, -1) == -1)
+            {
+                InterlockedIncrement((PLONG)&RtlpCriticalSectionStatistics.CriticalSectionSpinAcquires);
+
+                if (Adaptive)
+                {
+                    Limit = RtlpCriticalSectionSpinLimit;
+                    Limit += (2 * Spins + RTL_CRITSECT_MIN_SPIN - Limit) / 8;
+                    RtlpCriticalSectionSpinLimit = min(max(Limit, RTL_CRITSECT_MIN_SPIN),
+                                                       RTL_CRITSECT_MAX_SPIN);
+                }
+                return TRUE;
+            }
+        }
+        else if (LockCount > 0)
+        {
+            /* There are waiters already, they will get it first */
+            break;
+        }
+
+        YieldProcessor();
+    }
+
+    InterlockedIncrement((PLONG)&RtlpCriticalSectionStatistics.CriticalSectionSpinFailures);
+
+    if (Adaptive)
+    {
+        Limit = RtlpCriticalSectionSpinLimit;
+        Limit -= Limit / 8;
+        RtlpCriticalSectionSpinLimit = max(Limit, RTL_CRITSECT_MIN_SPIN);
+    }
+
+    return FALSE;
+}
+
 /*++
  * RtlEnterCriticalSection
  * @implemented NT4
@@ -488,6 +587,14 @@ RtlEnterCriticalSection(PRTL_CRITICAL_SECTION CriticalSection)
 {
     HANDLE Thread = (HANDLE)NtCurrentTeb()->ClientId.UniqueThread;
 
+    /* If it's busy and we don't own it, spin a bit before queuing up */
+    if ((*(volatile LONG *)&CriticalSection->LockCount != -1) &&
+        (Thread != CriticalSection->OwningThread) &&
+        RtlpSpinOnCriticalSection(CriticalSection))
+    {
+        goto Acquired;
+    }
+
     /* Try to lock it */
     if (InterlockedIncrement(&CriticalSection->LockCount) != 0)
     {
@@ -514,6 +621,7 @@ RtlEnterCriticalSection(PRTL_CRITICAL_SECTION CriticalSection)
         RtlpWaitForCriticalSection(CriticalSection);
     }
 
+Acquired:
     /*
      * Lock successful. Changing this information has not to be serialized
      * because only one thread at a time can actually change it (the one who
@@ -885,4 +993,98 @@ RtlpNotOwnerCriticalSection(PRTL_CRITICAL_SECTION CriticalSection)
     RtlRaiseStatus(STATUS_RESOURCE_NOT_OWNED);
 }
 
+/*++
+ * RtlpQueryProcessLocks
+ *
+ *     Fills in the lock information of RtlQueryProcessDebugInformation
+ *     with the critical sections of the current process.
+ *
+ * Params:
+ *     Buffer - Debug information buffer to commit the lock list in.
+ *
+ * Returns:
+ *     STATUS_SUCCESS or STATUS_NO_MEMORY.
+ *
+ * Remarks:
+ *     Only critical sections with debug information are known.
+ *
+ *--*/
+NTSTATUS
+NTAPI
+RtlpQueryProcessLocks(IN OUT PRTL_DEBUG_INFORMATION Buffer)
+{
+    PRTL_PROCESS_LOCKS Locks;
+    PRTL_PROCESS_LOCK_INFORMATION LockInfo;
+    PRTL_CRITICAL_SECTION_DEBUG DebugInfo;
+    PRTL_CRITICAL_SECTION CriticalSection;
+    PLIST_ENTRY Entry;
+    NTSTATUS Status = STATUS_SUCCESS;
+
+    Locks = RtlpDebugBufferCommit(Buffer, FIELD_OFFSET(RTL_PROCESS_LOCKS, Locks));
+    if (!Locks)
+        return STATUS_NO_MEMORY;
+
+    Locks->NumberOfLocks = 0;
+    Buffer->Locks = Locks;
+
+    RtlEnterCriticalSection(&RtlCriticalSectionLock);
+
+    for (Entry = RtlCriticalSectionList.Flink;
+         Entry != &RtlCriticalSectionList;
+         Entry = Entry->Flink)
+    {
+        DebugInfo = CONTAINING_RECORD(Entry, RTL_CRITICAL_SECTION_DEBUG, ProcessLocksList);
+        CriticalSection = DebugInfo->CriticalSection;
+
+        /* The entries are contiguous, they follow the header */
+        LockInfo = RtlpDebugBufferCommit(Buffer, sizeof(*LockInfo));
+        if (!LockInfo)
+        {
+            Status = STATUS_NO_MEMORY;
+            break;
+        }
+
+        LockInfo->Address = CriticalSection;
+        LockInfo->Type = DebugInfo->Type;
+        LockInfo->CreatorBackTraceIndex = DebugInfo->CreatorBackTraceIndex;
+        LockInfo->OwnerThreadId = HandleToUlong(CriticalSection->OwningThread);
+        LockInfo->ActiveCount = CriticalSection->LockCount;
+        LockInfo->ContentionCount = DebugInfo->ContentionCount;
+        LockInfo->EntryCount = DebugInfo->EntryCount;
+        LockInfo->RecursionCount = CriticalSection->RecursionCount;
+        LockInfo->NumberOfSharedWaiters = 0;
+        LockInfo->NumberOfExclusiveWaiters = max(CriticalSection->LockCount, 0);
+        Locks->NumberOfLocks++;
+    }
+
+    RtlLeaveCriticalSection(&RtlCriticalSectionLock);
+
+    return Status;
+}
+
+/*++
+ * RtlpQueryCriticalSectionStatistics
+ *
+ *     Returns the process wide critical section contention counters.
+ *
+ * Params:
+ *     Statistics - Receives the counters.
+ *
+ * Returns:
+ *     None.
+ *
+ * Remarks:
+ *     Only the critical section fields are touched.
+ *
+ *--*/
+VOID
+NTAPI
+RtlpQueryCriticalSectionStatistics(OUT PRTL_PROCESS_LOCK_STATISTICS Statistics)
+{
+    Statistics->CriticalSectionSpinAcquires = RtlpCriticalSectionStatistics.CriticalSectionSpinAcquires;
+    Statistics->CriticalSectionSpinFailures = RtlpCriticalSectionStatistics.CriticalSectionSpinFailures;
+    Statistics->CriticalSectionWaits = RtlpCriticalSectionStatistics.CriticalSectionWaits;
+    Statistics->CriticalSectionHandoffs = RtlpCriticalSectionStatistics.CriticalSectionHandoffs;
+}
+
 /* EOF */
@@ -361,13 +361,26 @@ RtlQueryProcessDebugInformation(IN ULONG ProcessId,
 
             if (DebugInfoMask & RTL_DEBUG_QUERY_LOCKS)
             {
-                PRTL_PROCESS_LOCKS Lp;
-                ULONG LSize;
+                Status = RtlpQueryProcessLocks(Buf);
+                if (!NT_SUCCESS(Status))
+                {
+                    return Status;
+                }
+            }
 
-                Lp = (PRTL_PROCESS_LOCKS)((PUCHAR)Buf + Buf->OffsetFree);
-                LSize = sizeof(RTL_PROCESS_LOCKS);
-                Buf->Locks = Lp;
-                Buf->OffsetFree = Buf->OffsetFree + LSize;
+            if (DebugInfoMask & RTL_DEBUG_QUERY_LOCK_STATISTICS)
+            {
+                PRTL_PROCESS_LOCK_STATISTICS Ls;
+
+                Ls = RtlpDebugBufferCommit(Buf, sizeof(*Ls));
+                if (!Ls)
+                {
+                    return STATUS_NO_MEMORY;
+                }
+
+                RtlpQueryCriticalSectionStatistics(Ls);
+                RtlpQuerySRWLockStatistics(Ls);
+                Buf->LockStatistics = Ls;
             }
 
             DPRINT("QueryProcessDebugInformation end\n");
@@ -10,6 +10,10 @@
 
 #include <rtl.h>
 
+#if defined(_M_AMD64)
+#include <emmintrin.h>
+#endif
+
 #define NDEBUG
 #include <debug.h>
 
@@ -35,9 +39,189 @@ PUSHORT NlsOemLeadByteInfo = NULL; /* exported */
 USHORT NlsOemDefaultChar = '\0';
 USHORT NlsUnicodeDefaultChar = 0;
 
+/* Whether the code pages map 0x00-0x7F to the same Unicode characters and back */
+static BOOLEAN NlsAnsiAsciiCompatible = FALSE;
+static BOOLEAN NlsOemAsciiCompatible = FALSE;
+
 
 /* FUNCTIONS *****************************************************************/
 
+/*
+ * ASCII fast paths. Path names and most other strings handed to the
+ * conversion routines are plain 7-bit ASCII, which converts without
+ * looking at the code page tables. The helpers below convert the
+ * leading ASCII run of a string and return its length, the callers
+ * handle the first non-ASCII character through the tables.
+ *
+ * On amd64 SSE2 is always available, including in kernel mode, and
+ * handles 16 characters per iteration. Other architectures use a
+ * plain loop.
+ */
+
+ULONG
+NTAPI
+RtlpAsciiToUnicodeRun(OUT PWCHAR UnicodeString,
+                      IN PCUCHAR AsciiString,
+                      IN ULONG Count)
+{
+    ULONG i = 0;
+
+#if defined(_M_AMD64)
+    const __m128i Zero = _mm_setzero_si128();
+
+    for (; i + 16 <= Count; i += 16)
+    {
+        __m128i Chars = _mm_loadu_si128((const __m128i *)&AsciiString[i]);
+
+        /* Any byte with the high bit set ends the run */
+        if (_mm_movemask_epi8(Chars))
+            break;
+
+        _mm_storeu_si128((__m128i *)&UnicodeString[i], _mm_unpacklo_epi8(Chars, Zero));
+        _mm_storeu_si128((__m128i *)&UnicodeString[i + 8], _mm_unpackhi_epi8(Chars, Zero));
+    }
+#endif
+
+    for (; i < Count; i++)
+    {
+        if (AsciiString[i] >= 0x80)
+            break;
+
+        UnicodeString[i] = AsciiString[i];
+    }
+
+    return i;
+}
+
+ULONG
+NTAPI
+RtlpUnicodeToAsciiRun(OUT PCHAR AsciiString,
+                      IN PCWCH UnicodeString,
+                      IN ULONG Count,
+                      IN BOOLEAN Upcase)
+{
+    ULONG i = 0;
+    WCHAR Char;
+
+#if defined(_M_AMD64)
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i NonAscii = _mm_set1_epi16((SHORT)0xFF80);
+    const __m128i BeforeA = _mm_set1_epi16('a' - 1);
+    const __m128i AfterZ = _mm_set1_epi16('z' + 1);
+    const __m128i CaseBit = _mm_set1_epi16('a' - 'A');
+
+    for (; i + 16 <= Count; i += 16)
+    {
+        __m128i Low = _mm_loadu_si128((const __m128i *)&UnicodeString[i]);
+        __m128i High = _mm_loadu_si128((const __m128i *)&UnicodeString[i + 8]);
+        __m128i Test = _mm_and_si128(_mm_or_si128(Low, High), NonAscii);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(Test, Zero)) != 0xFFFF)
+            break;
+
+        if (Upcase)
+        {
+            /* All characters are below 0x80, signed compares are fine */
+            __m128i Mask;
+
+            Mask = _mm_and_si128(_mm_cmpgt_epi16(Low, BeforeA), _mm_cmplt_epi16(Low, AfterZ));
+            Low = _mm_sub_epi16(Low, _mm_and_si128(Mask, CaseBit));
+            Mask = _mm_and_si128(_mm_cmpgt_epi16(High, BeforeA), _mm_cmplt_epi16(High, AfterZ));
+            High = _mm_sub_epi16(High, _mm_and_si128(Mask, CaseBit));
+        }
+
+        _mm_storeu_si128((__m128i *)&AsciiString[i], _mm_packus_epi16(Low, High));
+    }
+#endif
+
+    for (; i < Count; i++)
+    {
+        Char = UnicodeString[i];
+        if (Char >= 0x80)
+            break;
+
+        if (Upcase && Char >= 'a' && Char <= 'z')
+            Char -= 'a' - 'A';
+
+        AsciiString[i] = (CHAR)Char;
+    }
+
+    return i;
+}
+
+ULONG
+NTAPI
+RtlpUpcaseUnicodeRun(OUT PWCHAR Destination,
+                     IN PCWCH Source,
+                     IN ULONG Count)
+{
+    ULONG i = 0;
+    WCHAR Char;
+
+#if defined(_M_AMD64)
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i NonAscii = _mm_set1_epi16((SHORT)0xFF80);
+    const __m128i BeforeA = _mm_set1_epi16('a' - 1);
+    const __m128i AfterZ = _mm_set1_epi16('z' + 1);
+    const __m128i CaseBit = _mm_set1_epi16('a' - 'A');
+
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m128i Chars = _mm_loadu_si128((const __m128i *)&Source[i]);
+        __m128i Mask;
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(Chars, NonAscii), Zero)) != 0xFFFF)
+            break;
+
+        Mask = _mm_and_si128(_mm_cmpgt_epi16(Chars, BeforeA), _mm_cmplt_epi16(Chars, AfterZ));
+        Chars = _mm_sub_epi16(Chars, _mm_and_si128(Mask, CaseBit));
+        _mm_storeu_si128((__m128i *)&Destination[i], Chars);
+    }
+#endif
+
+    for (; i < Count; i++)
+    {
+        Char = Source[i];
+        if (Char >= 0x80)
+            break;
+
+        if (Char >= 'a' && Char <= 'z')
+            Char -= 'a' - 'A';
+
+        Destination[i] = Char;
+    }
+
+    return i;
+}
+
+static BOOLEAN
+RtlpIsAsciiCompatibleCodePage(IN PCPTABLEINFO TableInfo)
+{
+    USHORT Char;
+
+    if (!TableInfo->MultiByteTable || !TableInfo->WideCharTable)
+        return FALSE;
+
+    for (Char = 0; Char < 0x80; Char++)
+    {
+        if (TableInfo->MultiByteTable[Char] != Char)
+            return FALSE;
+
+        if (TableInfo->DBCSCodePage)
+        {
+            if (((PUSHORT)TableInfo->WideCharTable)[Char] != Char)
+                return FALSE;
+        }
+        else
+        {
+            if (((PUCHAR)TableInfo->WideCharTable)[Char] != Char)
+                return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
 /*
  * @unimplemented
  */
@@ -252,6 +436,13 @@ RtlMultiByteToUnicodeN(OUT PWCHAR UnicodeString,
 
         for (i = 0; i < Size; i++)
         {
+            if (NlsAnsiAsciiCompatible)
+            {
+                i += RtlpAsciiToUnicodeRun(&UnicodeString[i], (PCUCHAR)&MbString[i], Size - i);
+                if (i == Size)
+                    break;
+            }
+
             UnicodeString[i] = NlsAnsiToUnicodeTable[(UCHAR)MbString[i]];
         }
     }
@@ -394,6 +585,17 @@ RtlOemToUnicodeN(OUT PWCHAR UnicodeString,
 
         for (i = 0; i < Size; i++)
         {
+            if (NlsOemAsciiCompatible)
+            {
+                ULONG Run = RtlpAsciiToUnicodeRun(UnicodeString, (PCUCHAR)OemString, Size - i);
+
+                UnicodeString += Run;
+                OemString += Run;
+                i += Run;
+                if (i == Size)
+                    break;
+            }
+
             *UnicodeString = NlsOemToUnicodeTable[(UCHAR)*OemString];
             UnicodeString++;
             OemString++;
@@ -473,6 +675,10 @@ RtlResetRtlTranslations(IN PNLSTABLEINFO NlsTable)
     /* set the default characters for RtlpDidUnicodeToOemWork */
     NlsOemDefaultChar = NlsTable->OemTableInfo.DefaultChar;
     NlsUnicodeDefaultChar = NlsTable->OemTableInfo.TransDefaultChar;
+
+    /* Check whether the ASCII fast paths can be used */
+    NlsAnsiAsciiCompatible = RtlpIsAsciiCompatibleCodePage(&NlsTable->AnsiTableInfo);
+    NlsOemAsciiCompatible = RtlpIsAsciiCompatibleCodePage(&NlsTable->OemTableInfo);
 }
 
 /*
@@ -545,6 +751,17 @@ RtlUnicodeToMultiByteN(OUT PCHAR MbString,
 
         for (i = 0; i < Size; i++)
         {
+            if (NlsAnsiAsciiCompatible)
+            {
+                ULONG Run = RtlpUnicodeToAsciiRun(MbString, UnicodeString, Size - i, FALSE);
+
+                MbString += Run;
+                UnicodeString += Run;
+                i += Run;
+                if (i == Size)
+                    break;
+            }
+
             *MbString++ = NlsUnicodeToAnsiTable[*UnicodeString++];
         }
     }
@@ -657,6 +874,21 @@ RtlUnicodeToOemN(OUT PCHAR OemString,
     {
         while (OemSize && UnicodeSize)
         {
+            if (NlsOemAsciiCompatible)
+            {
+                ULONG Run = RtlpUnicodeToAsciiRun(&OemString[Size],
+                                                  UnicodeString,
+                                                  min(OemSize, UnicodeSize),
+                                                  FALSE);
+
+                UnicodeString += Run;
+                Size += Run;
+                OemSize -= Run;
+                UnicodeSize -= Run;
+                if (!OemSize || !UnicodeSize)
+                    break;
+            }
+
             OemString[Size] = NlsUnicodeToOemTable[*UnicodeString++];
             Size++;
             OemSize--;
@@ -800,6 +1032,17 @@ RtlUpcaseUnicodeToMultiByteN(OUT PCHAR MbString,
 
         for (i = 0; i < Size; i++)
         {
+            if (NlsAnsiAsciiCompatible)
+            {
+                ULONG Run = RtlpUnicodeToAsciiRun(MbString, UnicodeString, Size - i, TRUE);
+
+                MbString += Run;
+                UnicodeString += Run;
+                i += Run;
+                if (i == Size)
+                    break;
+            }
+
             UpcaseChar = RtlpUpcaseUnicodeChar(*UnicodeString);
             *MbString = NlsUnicodeToAnsiTable[UpcaseChar];
             MbString++;
@@ -845,6 +1088,17 @@ RtlUpcaseUnicodeToOemN(OUT PCHAR OemString,
 
         for (i = 0; i < Size; i++)
         {
+            if (NlsOemAsciiCompatible)
+            {
+                ULONG Run = RtlpUnicodeToAsciiRun(OemString, UnicodeString, Size - i, TRUE);
+
+                OemString += Run;
+                UnicodeString += Run;
+                i += Run;
+                if (i == Size)
+                    break;
+            }
+
             UpcaseChar = RtlpUpcaseUnicodeChar(*UnicodeString);
             *OemString = NlsUnicodeToOemTable[UpcaseChar];
             OemString++;
@@ -270,6 +270,25 @@ WCHAR
 NTAPI
 RtlpDowncaseUnicodeChar(IN WCHAR Source);
 
+ULONG
+NTAPI
+RtlpAsciiToUnicodeRun(OUT PWCHAR UnicodeString,
+                      IN PCUCHAR AsciiString,
+                      IN ULONG Count);
+
+ULONG
+NTAPI
+RtlpUnicodeToAsciiRun(OUT PCHAR AsciiString,
+                      IN PCWCH UnicodeString,
+                      IN ULONG Count,
+                      IN BOOLEAN Upcase);
+
+ULONG
+NTAPI
+RtlpUpcaseUnicodeRun(OUT PWCHAR Destination,
+                     IN PCWCH Source,
+                     IN ULONG Count);
+
 #ifndef _BLDR_
 
 /* ReactOS only */
@@ -282,6 +301,18 @@ NTAPI
 RtlpDebugBufferCommit(_Inout_ PRTL_DEBUG_INFORMATION Buffer,
                       _In_ SIZE_T Size);
 
+NTSTATUS
+NTAPI
+RtlpQueryProcessLocks(_Inout_ PRTL_DEBUG_INFORMATION Buffer);
+
+VOID
+NTAPI
+RtlpQueryCriticalSectionStatistics(_Out_ PRTL_PROCESS_LOCK_STATISTICS Statistics);
+
+VOID
+NTAPI
+RtlpQuerySRWLockStatistics(_Out_ PRTL_PROCESS_LOCK_STATISTICS Statistics);
+
 #endif /* !_BLDR_ */
 
 /* EOF */
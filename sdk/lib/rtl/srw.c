@@ -79,6 +79,75 @@ typedef struct _RTLP_SRWLOCK_WAITBLOCK
     BOOLEAN Exclusive;
 } volatile RTLP_SRWLOCK_WAITBLOCK, *PRTLP_SRWLOCK_WAITBLOCK;
 
+/* Waiters spin that many times at most before they start yielding their
+   time slice. The limit adapts to the spins successful waits needed. */
+#define RTL_SRWLOCK_MIN_SPIN        16
+#define RTL_SRWLOCK_MAX_SPIN        4096
+#define RTL_SRWLOCK_DEFAULT_SPIN    512
+
+static LONG RtlpSRWLockSpinLimit = RTL_SRWLOCK_DEFAULT_SPIN;
+
+/* Process wide contention counters, see RtlpQuerySRWLockStatistics */
+static RTL_PROCESS_LOCK_STATISTICS RtlpSRWLockStatistics;
+
+
+static LONG
+RtlpSRWLockBeginWait(VOID)
+{
+    InterlockedIncrement((PLONG)&RtlpSRWLockStatistics.SRWLockWaits);
+
+    /* The owner can't make progress while we spin on a single processor */
+    if (NtCurrentPeb()->NumberOfProcessors <= 1)
+        return 0;
+
+    return RtlpSRWLockSpinLimit;
+}
+
+
+static VOID
+RtlpSRWLockBackoff(IN OUT PLONG Spins,
+                   IN LONG Limit)
+{
+    if (*Spins < Limit)
+    {
+        (*Spins)++;
+        YieldProcessor();
+        return;
+    }
+
+    if (*Spins == Limit)
+    {
+        /* Spinning didn't pay off, let the owner run */
+        (*Spins)++;
+        InterlockedIncrement((PLONG)&RtlpSRWLockStatistics.SRWLockYields);
+    }
+
+    NtYieldExecution();
+}
+
+
+static VOID
+RtlpSRWLockEndWait(IN LONG Spins,
+                   IN LONG Limit)
+{
+    LONG NewLimit;
+
+    /* Updating the limit is racy on purpose, it's only a hint */
+    NewLimit = RtlpSRWLockSpinLimit;
+    if (Spins <= Limit)
+    {
+        InterlockedIncrement((PLONG)&RtlpSRWLockStatistics.SRWLockSpinAcquires);
+        NewLimit += (2 * Spins + RTL_SRWLOCK_MIN_SPIN - NewLimit) / 8;
+    }
+    else
+    {
+        NewLimit -= NewLimit / 8;
+    }
+
+    RtlpSRWLockSpinLimit = min(max(NewLimit, RTL_SRWLOCK_MIN_SPIN), RTL_SRWLOCK_MAX_SPIN);
+}
+
+
 
 static VOID
 NTAPI
@@ -90,6 +159,9 @@ RtlpReleaseWaitBlockLockExclusive(IN OUT PRTL_SRWLOCK SRWLock,
 
     /* NOTE: We're currently in an exclusive lock in contended mode. */
 
+    /* The first wait block gets the lock handed over */
+    InterlockedIncrement((PLONG)&RtlpSRWLockStatistics.SRWLockHandoffs);
+
     Next = FirstWaitBlock->Next;
     if (Next != NULL)
     {
@@ -163,6 +235,8 @@ RtlpReleaseWaitBlockLockLastShared(IN OUT PRTL_SRWLOCK SRWLock,
     /* The next acquirer to be unwaited *must* be an exclusive lock! */
     ASSERT(FirstWaitBlock->Exclusive);
 
+    InterlockedIncrement((PLONG)&RtlpSRWLockStatistics.SRWLockHandoffs);
+
     Next = FirstWaitBlock->Next;
     if (Next != NULL)
     {
@@ -233,6 +307,8 @@ RtlpAcquireSRWLockExclusiveWait(IN OUT PRTL_SRWLOCK SRWLock,
                                 IN PRTLP_SRWLOCK_WAITBLOCK WaitBlock)
 {
     LONG_PTR CurrentValue;
+    LONG Spins = 0;
+    LONG Limit = RtlpSRWLockBeginWait();
 
     while (1)
     {
@@ -257,8 +333,10 @@ RtlpAcquireSRWLockExclusiveWait(IN OUT PRTL_SRWLOCK SRWLock,
             }
         }
 
-        YieldProcessor();
+        RtlpSRWLockBackoff(&Spins, Limit);
     }
+
+    RtlpSRWLockEndWait(Spins, Limit);
 }
 
 
@@ -268,11 +346,14 @@ RtlpAcquireSRWLockSharedWait(IN OUT PRTL_SRWLOCK SRWLock,
                              IN OUT PRTLP_SRWLOCK_WAITBLOCK FirstWait  OPTIONAL,
                              IN OUT PRTLP_SRWLOCK_SHARED_WAKE WakeChain)
 {
+    LONG Spins = 0;
+    LONG Limit = RtlpSRWLockBeginWait();
+
     if (FirstWait != NULL)
     {
         while (WakeChain->Wake == 0)
         {
-            YieldProcessor();
+            RtlpSRWLockBackoff(&Spins, Limit);
         }
     }
     else
@@ -306,9 +387,11 @@ RtlpAcquireSRWLockSharedWait(IN OUT PRTL_SRWLOCK SRWLock,
                 }
             }
 
-            YieldProcessor();
+            RtlpSRWLockBackoff(&Spins, Limit);
         }
     }
+
+    RtlpSRWLockEndWait(Spins, Limit);
 }
 
 
@@ -793,3 +876,14 @@ RtlTryAcquireSRWLockExclusive(PRTL_SRWLOCK SRWLock)
 {
     return InterlockedCompareExchangePointer(&SRWLock->Ptr, (ULONG_PTR*)RTL_SRWLOCK_OWNED, 0) == 0;
 }
+
+
+VOID
+NTAPI
+RtlpQuerySRWLockStatistics(OUT PRTL_PROCESS_LOCK_STATISTICS Statistics)
+{
+    Statistics->SRWLockSpinAcquires = RtlpSRWLockStatistics.SRWLockSpinAcquires;
+    Statistics->SRWLockYields = RtlpSRWLockStatistics.SRWLockYields;
+    Statistics->SRWLockWaits = RtlpSRWLockStatistics.SRWLockWaits;
+    Statistics->SRWLockHandoffs = RtlpSRWLockStatistics.SRWLockHandoffs;
+}
@@ -1938,6 +1938,11 @@ RtlUpcaseUnicodeString(
 
     for (i = 0; i < j; i++)
     {
+        /* Upcase ASCII runs in bulk */
+        i += RtlpUpcaseUnicodeRun(&UniDest->Buffer[i], &UniSource->Buffer[i], j - i);
+        if (i == j)
+            break;
+
         UniDest->Buffer[i] = RtlpUpcaseUnicodeChar(UniSource->Buffer[i]);
     }
 
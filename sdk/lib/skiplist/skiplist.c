@@ -46,6 +46,150 @@ _GetRandomLevel()
     return (CHAR)dwLevel;
 }
 
+/**
+ * @name _AllocateNode
+ *
+ * Allocates a node for the given level, preferably by reusing one of the deleted nodes of that level.
+ * Nodes are only allocated up to their highest level, so most of them are much smaller than a SKIPLIST_NODE.
+ *
+ * @param Skiplist
+ * Pointer to the SKIPLIST structure to operate on.
+ *
+ * @param chLevel
+ * The highest level of the node.
+ *
+ * @return
+ * Pointer to the new node or NULL if no memory could be allocated for it.
+ */
+static PSKIPLIST_NODE
+_AllocateNode(PSKIPLIST Skiplist, CHAR chLevel)
+{
+    PSKIPLIST_NODE pNode = Skiplist->FreeNodes[chLevel];
+
+    if (pNode)
+    {
+        Skiplist->FreeNodes[chLevel] = pNode->Next[0];
+        --Skiplist->FreeNodeCount[chLevel];
+    }
+    else
+    {
+        pNode = Skiplist->AllocateRoutine(FIELD_OFFSET(SKIPLIST_NODE, Next) + (chLevel + 1) * sizeof(PSKIPLIST_NODE));
+        if (!pNode)
+            return NULL;
+    }
+
+    pNode->Level = chLevel;
+    return pNode;
+}
+
+/**
+ * @name _FreeNode
+ *
+ * Keeps a deleted node for reuse by _AllocateNode or frees it if enough nodes of its level are kept already.
+ *
+ * @param Skiplist
+ * Pointer to the SKIPLIST structure to operate on.
+ *
+ * @param pNode
+ * The node to free.
+ */
+static void
+_FreeNode(PSKIPLIST Skiplist, PSKIPLIST_NODE pNode)
+{
+    CHAR chLevel = pNode->Level;
+
+    if (Skiplist->FreeNodeCount[chLevel] < SKIPLIST_NODE_CACHE_DEPTH)
+    {
+        pNode->Next[0] = Skiplist->FreeNodes[chLevel];
+        Skiplist->FreeNodes[chLevel] = pNode;
+        ++Skiplist->FreeNodeCount[chLevel];
+    }
+    else
+    {
+        Skiplist->FreeRoutine(pNode);
+    }
+}
+
+/**
+ * @name _InsertHashNode
+ *
+ * Adds a node to the hash index of the Skiplist.
+ *
+ * @param Skiplist
+ * Pointer to the SKIPLIST structure to operate on. Its hash index must have been initialized.
+ *
+ * @param pNode
+ * The node to add.
+ */
+static __inline void
+_InsertHashNode(PSKIPLIST Skiplist, PSKIPLIST_NODE pNode)
+{
+    PSKIPLIST_NODE* ppBucket = &Skiplist->HashBuckets[Skiplist->HashRoutine(pNode->Element) & (Skiplist->HashBucketCount - 1)];
+
+    pNode->HashNext = *ppBucket;
+    *ppBucket = pNode;
+}
+
+/**
+ * @name _RemoveHashNode
+ *
+ * Removes a node from the hash index of the Skiplist.
+ *
+ * @param Skiplist
+ * Pointer to the SKIPLIST structure to operate on. Its hash index must have been initialized.
+ *
+ * @param pNode
+ * The node to remove.
+ */
+static void
+_RemoveHashNode(PSKIPLIST Skiplist, PSKIPLIST_NODE pNode)
+{
+    PSKIPLIST_NODE* ppLink = &Skiplist->HashBuckets[Skiplist->HashRoutine(pNode->Element) & (Skiplist->HashBucketCount - 1)];
+
+    while (*ppLink != pNode)
+        ppLink = &(*ppLink)->HashNext;
+
+    *ppLink = pNode->HashNext;
+}
+
+/**
+ * @name _RebuildHashIndex
+ *
+ * Replaces the buckets of the hash index by a new array of the given size and adds all nodes to it.
+ *
+ * @param Skiplist
+ * Pointer to the SKIPLIST structure to operate on. Its HashRoutine must have been set.
+ *
+ * @param dwBucketCount
+ * The new number of buckets, a power of two.
+ *
+ * @return
+ * TRUE if the index was rebuilt, FALSE if no memory could be allocated for it. The previous buckets are kept in that case.
+ */
+static BOOL
+_RebuildHashIndex(PSKIPLIST Skiplist, DWORD dwBucketCount)
+{
+    PSKIPLIST_NODE pNode;
+    PSKIPLIST_NODE* pBuckets;
+
+    pBuckets = Skiplist->AllocateRoutine(dwBucketCount * sizeof(PSKIPLIST_NODE));
+    if (!pBuckets)
+        return FALSE;
+
+    ZeroMemory(pBuckets, dwBucketCount * sizeof(PSKIPLIST_NODE));
+
+    if (Skiplist->HashBuckets)
+        Skiplist->FreeRoutine(Skiplist->HashBuckets);
+
+    Skiplist->HashBuckets = pBuckets;
+    Skiplist->HashBucketCount = dwBucketCount;
+
+    for (pNode = Skiplist->Head.Next[0]; pNode; pNode = pNode->Next[0])
+        _InsertHashNode(Skiplist, pNode);
+
+    return TRUE;
+}
+
 /**
  * @name _InsertElementSkiplistWithInformation
  *
@@ -77,6 +221,13 @@ _InsertElementSkiplistWithInformation(PSKIPLIST Skiplist, PVOID Element, PSKIPLI
     // Get the highest level, on which the node shall be inserted.
     chNewLevel = _GetRandomLevel();
 
+    // Create our new Skiplist node before changing anything.
+    pNode = _AllocateNode(Skiplist, chNewLevel);
+    if (!pNode)
+        return FALSE;
+
+    pNode->Element = Element;
+
     // Check if the new level is higher than the maximum level we currently have in the Skiplist.
     if (chNewLevel > Skiplist->MaximumLevel)
     {
@@ -93,13 +244,6 @@ _InsertElementSkiplistWithInformation(PSKIPLIST Skiplist, PVOID Element, PSKIPLI
         Skiplist->MaximumLevel = chNewLevel;
     }
 
-    // Finally create our new Skiplist node.
-    pNode = Skiplist->AllocateRoutine(sizeof(SKIPLIST_NODE));
-    if (!pNode)
-        return FALSE;
-
-    pNode->Element = Element;
-
     // For each used level, insert us between the saved node for this level and its current next node.
     for (i = 0; i <= chNewLevel; i++)
     {
@@ -121,6 +265,17 @@ _InsertElementSkiplistWithInformation(PSKIPLIST Skiplist, PVOID Element, PSKIPLI
 
     // We've successfully added a node :)
     ++Skiplist->NodeCount;
+
+    // Keep the hash index up to date, and grow it when its chains get longer than two nodes on average.
+    // If it can't grow, it just stays slower.
+    if (Skiplist->HashBuckets)
+    {
+        _InsertHashNode(Skiplist, pNode);
+
+        if (Skiplist->NodeCount > 2 * Skiplist->HashBucketCount)
+            _RebuildHashIndex(Skiplist, 2 * Skiplist->HashBucketCount);
+    }
+
     return TRUE;
 }
 
@@ -186,9 +341,12 @@ DeleteElementSkiplist(PSKIPLIST Skiplist, PVOID Element)
         i++;
     }
 
+    if (Skiplist->HashBuckets)
+        _RemoveHashNode(Skiplist, pNode);
+
     // Return the deleted element (so the caller can free it if necessary) and free the memory for the node itself (allocated by us).
     pReturnValue = pNode->Element;
-    Skiplist->FreeRoutine(pNode);
+    _FreeNode(Skiplist, pNode);
 
     // Find all levels which now contain no more nodes and reduce the maximum level of the entire Skiplist accordingly.
     while (Skiplist->MaximumLevel > 0 && !Skiplist->Head.Next[Skiplist->MaximumLevel])
@@ -228,7 +386,51 @@ InitializeSkiplist(PSKIPLIST Skiplist, PSKIPLIST_ALLOCATE_ROUTINE AllocateRoutin
     // The Distance array is only used when a node is non-NULL, so it doesn't need initialization.
     Skiplist->MaximumLevel = 0;
     Skiplist->NodeCount = 0;
+    Skiplist->Head.Level = SKIPLIST_LEVELS - 1;
     ZeroMemory(Skiplist->Head.Next, sizeof(Skiplist->Head.Next));
+
+    // The hash index is optional and set up by InitializeHashIndexSkiplist.
+    Skiplist->HashRoutine = NULL;
+    Skiplist->HashBuckets = NULL;
+    Skiplist->HashBucketCount = 0;
+
+    ZeroMemory(Skiplist->FreeNodes, sizeof(Skiplist->FreeNodes));
+    ZeroMemory(Skiplist->FreeNodeCount, sizeof(Skiplist->FreeNodeCount));
+}
+
+/**
+ * @name InitializeHashIndexSkiplist
+ *
+ * Adds a hash index to a Skiplist, which makes LookupElementSkiplist O(1) on average when the caller isn't interested in the element index.
+ * The index is maintained by all other functions and grows with the Skiplist.
+ *
+ * @param Skiplist
+ * Pointer to the SKIPLIST structure to operate on.
+ *
+ * @param HashRoutine
+ * Pointer to a SKIPLIST_HASH_ROUTINE returning the same value for all elements your CompareRoutine considers equal.
+ * Like CompareRoutine, it is also called with the dummy elements passed to LookupElementSkiplist.
+ *
+ * @return
+ * TRUE if the hash index was set up, FALSE if no memory could be allocated for it.
+ */
+BOOL
+InitializeHashIndexSkiplist(PSKIPLIST Skiplist, PSKIPLIST_HASH_ROUTINE HashRoutine)
+{
+    DWORD dwBucketCount = SKIPLIST_INITIAL_HASH_BUCKETS;
+
+    // Start with enough buckets for the elements which are already in the Skiplist.
+    while (Skiplist->NodeCount > 2 * dwBucketCount)
+        dwBucketCount *= 2;
+
+    Skiplist->HashRoutine = HashRoutine;
+    if (!_RebuildHashIndex(Skiplist, dwBucketCount))
+    {
+        Skiplist->HashRoutine = NULL;
+        return FALSE;
+    }
+
+    return TRUE;
 }
 
 /**
@@ -338,7 +540,8 @@ InsertTailElementSkiplist(PSKIPLIST Skiplist, PVOID Element)
 /**
  * @name LookupElementSkiplist
  *
- * Looks up an element in the Skiplist. The efficiency of this operation is O(log N) on average.
+ * Looks up an element in the Skiplist. The efficiency of this operation is O(log N) on average,
+ * or O(1) if the Skiplist has a hash index and ElementIndex is NULL.
  *
  * @param Skiplist
  * Pointer to the SKIPLIST structure to operate on.
@@ -361,6 +564,17 @@ LookupElementSkiplist(PSKIPLIST Skiplist, PVOID Element, PDWORD ElementIndex)
     PSKIPLIST_NODE pLastComparedNode = NULL;
     PSKIPLIST_NODE pNode = &Skiplist->Head;
 
+    // The hash index finds the element without walking the Skiplist, but it can't tell its index.
+    if (Skiplist->HashBuckets && !ElementIndex)
+    {
+        pNode = Skiplist->HashBuckets[Skiplist->HashRoutine(Element) & (Skiplist->HashBucketCount - 1)];
+
+        while (pNode && Skiplist->CompareRoutine(pNode->Element, Element) != 0)
+            pNode = pNode->HashNext;
+
+        return pNode ? pNode->Element : NULL;
+    }
+
     // Do the efficient lookup in Skiplists:
     //    * Start from the maximum level.
     //    * Walk through all nodes on this level that come before the node we're looking for.
@@ -18,17 +18,28 @@
 C_ASSERT(SKIPLIST_LEVELS >= 1);
 C_ASSERT(SKIPLIST_LEVELS <= 31);
 
+// Number of deleted nodes kept per level for reuse by later insertions.
+#define SKIPLIST_NODE_CACHE_DEPTH       32
+
+// Initial number of buckets of the optional hash index.
+#define SKIPLIST_INITIAL_HASH_BUCKETS   64
+
 // Function pointer definitions
 typedef PVOID (WINAPI *PSKIPLIST_ALLOCATE_ROUTINE)(DWORD);
 typedef int (WINAPI *PSKIPLIST_COMPARE_ROUTINE)(PVOID, PVOID);
 typedef void (WINAPI *PSKIPLIST_FREE_ROUTINE)(PVOID);
+typedef DWORD (WINAPI *PSKIPLIST_HASH_ROUTINE)(PVOID);
 
 // Structure definitions
 typedef struct _SKIPLIST_NODE
 {
+    PVOID Element;
+    struct _SKIPLIST_NODE* HashNext;
+    CHAR Level;
     DWORD Distance[SKIPLIST_LEVELS];
+
+    // Nodes are only allocated up to Next[Level], so this must be the last member.
     struct _SKIPLIST_NODE* Next[SKIPLIST_LEVELS];
-    PVOID Element;
 }
 SKIPLIST_NODE, *PSKIPLIST_NODE;
 
@@ -40,11 +51,21 @@ typedef struct _SKIPLIST
     PSKIPLIST_ALLOCATE_ROUTINE AllocateRoutine;
     PSKIPLIST_COMPARE_ROUTINE CompareRoutine;
     PSKIPLIST_FREE_ROUTINE FreeRoutine;
+
+    // Optional hash index, see InitializeHashIndexSkiplist.
+    PSKIPLIST_HASH_ROUTINE HashRoutine;
+    PSKIPLIST_NODE* HashBuckets;
+    DWORD HashBucketCount;
+
+    // Deleted nodes of each level, linked through Next[0].
+    PSKIPLIST_NODE FreeNodes[SKIPLIST_LEVELS];
+    DWORD FreeNodeCount[SKIPLIST_LEVELS];
 }
 SKIPLIST, *PSKIPLIST;
 
 // Function prototypes
 void InitializeSkiplist(PSKIPLIST Skiplist, PSKIPLIST_ALLOCATE_ROUTINE AllocateRoutine, PSKIPLIST_COMPARE_ROUTINE CompareRoutine, PSKIPLIST_FREE_ROUTINE FreeRoutine);
+BOOL InitializeHashIndexSkiplist(PSKIPLIST Skiplist, PSKIPLIST_HASH_ROUTINE HashRoutine);
 BOOL InsertElementSkiplist(PSKIPLIST Skiplist, PVOID Element);
 BOOL InsertTailElementSkiplist(PSKIPLIST Skiplist, PVOID Element);
 PVOID DeleteElementSkiplist(PSKIPLIST Skiplist, PVOID Element);
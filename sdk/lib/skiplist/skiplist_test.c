@@ -60,8 +60,131 @@ MyFree(PVOID Ptr)
     HeapFree(GetProcessHeap(), 0, Ptr);
 }
 
+DWORD WINAPI
+MyHash(PVOID Element)
+{
+    return PtrToUlong(Element);
+}
+
+static double
+_GetElapsedMilliseconds(LARGE_INTEGER* Start)
+{
+    LARGE_INTEGER liFrequency;
+    LARGE_INTEGER liNow;
+
+    QueryPerformanceCounter(&liNow);
+    QueryPerformanceFrequency(&liFrequency);
+    return (double)(liNow.QuadPart - Start->QuadPart) * 1000.0 / (double)liFrequency.QuadPart;
+}
+
+// Looks up all elements from 1 to ElementCount a few times and returns how many of them were found.
+static DWORD
+_BenchmarkLookups(PSKIPLIST Skiplist, DWORD ElementCount, PCSTR Description)
+{
+    DWORD dwFound = 0;
+    DWORD i;
+    DWORD j;
+    LARGE_INTEGER liStart;
+
+    QueryPerformanceCounter(&liStart);
+
+    for (j = 0; j < 10; j++)
+    {
+        for (i = 1; i <= ElementCount; i++)
+        {
+            if (LookupElementSkiplist(Skiplist, UlongToPtr(i), NULL))
+                dwFound++;
+        }
+    }
+
+    printf("%-36s %10.2f ms\n", Description, _GetElapsedMilliseconds(&liStart));
+    return dwFound;
+}
+
+// Simulates a spooler with many queued jobs, which are looked up by ID all the time and occasionally completed and replaced by new ones.
+static int
+_Benchmark(DWORD ElementCount)
+{
+    DWORD dwNextElement;
+    DWORD i;
+    LARGE_INTEGER liStart;
+    SKIPLIST Skiplist;
+
+    printf("Benchmarking with %lu elements\n\n", ElementCount);
+    InitializeSkiplist(&Skiplist, MyAlloc, MyCompare, MyFree);
+
+    QueryPerformanceCounter(&liStart);
+    for (i = 1; i <= ElementCount; i++)
+    {
+        if (!InsertTailElementSkiplist(&Skiplist, UlongToPtr(i)))
+        {
+            printf("InsertTailElementSkiplist failed for %lu\n", i);
+            return 1;
+        }
+    }
+    printf("%-36s %10.2f ms\n", "Tail insertions", _GetElapsedMilliseconds(&liStart));
+
+    if (_BenchmarkLookups(&Skiplist, ElementCount, "Lookups") != 10 * ElementCount)
+    {
+        printf("Lookups failed\n");
+        return 1;
+    }
+
+    if (!InitializeHashIndexSkiplist(&Skiplist, MyHash))
+    {
+        printf("InitializeHashIndexSkiplist failed\n");
+        return 1;
+    }
+
+    if (_BenchmarkLookups(&Skiplist, ElementCount, "Lookups with hash index") != 10 * ElementCount)
+    {
+        printf("Lookups with hash index failed\n");
+        return 1;
+    }
+
+    // Replace the oldest half of the elements by new ones, reusing the deleted nodes.
+    QueryPerformanceCounter(&liStart);
+    dwNextElement = ElementCount + 1;
+    for (i = 1; i <= ElementCount / 2; i++)
+    {
+        if (DeleteElementSkiplist(&Skiplist, UlongToPtr(i)) != UlongToPtr(i) ||
+            !InsertTailElementSkiplist(&Skiplist, UlongToPtr(dwNextElement++)))
+        {
+            printf("Replacing element %lu failed\n", i);
+            return 1;
+        }
+    }
+    printf("%-36s %10.2f ms\n", "Deletions and tail insertions", _GetElapsedMilliseconds(&liStart));
+
+    // Verify the index and the order of what is left.
+    for (i = 0; i < ElementCount; i++)
+    {
+        DWORD dwElement = ElementCount / 2 + 1 + i;
+        DWORD dwElementIndex;
+
+        if (LookupElementSkiplist(&Skiplist, UlongToPtr(dwElement), NULL) != UlongToPtr(dwElement) ||
+            LookupElementSkiplist(&Skiplist, UlongToPtr(dwElement), &dwElementIndex) != UlongToPtr(dwElement) ||
+            dwElementIndex != i ||
+            LookupNodeByIndexSkiplist(&Skiplist, i)->Element != UlongToPtr(dwElement))
+        {
+            printf("Verification failed for element %lu\n", dwElement);
+            return 1;
+        }
+    }
+
+    if (LookupElementSkiplist(&Skiplist, UlongToPtr(ElementCount / 2), NULL) ||
+        LookupElementSkiplist(&Skiplist, UlongToPtr(dwNextElement), NULL))
+    {
+        printf("Missing element found\n");
+        return 1;
+    }
+
+    printf("\nAll checks passed\n");
+    return 0;
+}
+
 int
-main()
+main(int argc, char* argv[])
 {
     PVOID Element;
     DWORD ElementIndex;
@@ -69,6 +192,10 @@ main()
     SKIPLIST Skiplist;
     PSKIPLIST_NODE pNode;
 
+    // "skiplist_test bench [ElementCount]" measures lookups in a large Skiplist instead of dumping a small one.
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0)
+        return _Benchmark((argc >= 3) ? strtoul(argv[2], NULL, 10) : 50000);
+
     system("mode con cols=300");
     InitializeSkiplist(&Skiplist, MyAlloc, MyCompare, MyFree);
 
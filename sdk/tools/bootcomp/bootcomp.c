@@ -0,0 +1,348 @@
+/*
+ * PROJECT:     ReactOS host tools
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Compresses files so that FreeLoader can load them transparently
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+/*
+ * Usage: bootcomp [-b blockshift] inputfile outputfile
+ *
+ * The output is split in blocks of (1 << blockshift) bytes, each one an
+ * independent LZNT1 buffer, so that FreeLoader can decompress any part of
+ * the file without reading what comes before it. Install the output under
+ * the name FreeLoader looks for ("ntoskrnl.ex_" for "ntoskrnl.exe").
+ *
+ * The format is described in boot/freeldr/freeldr/include/fs/compress.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _MSC_VER
+#include <stdint.h>
+#else
+typedef unsigned __int8  uint8_t;
+typedef unsigned __int16 uint16_t;
+typedef unsigned __int32 uint32_t;
+#endif
+
+#define COMPRESSED_FILE_SIGNATURE   0x31435A46 /* "FZC1" */
+#define COMPRESSED_MIN_BLOCK_SHIFT  12
+#define COMPRESSED_MAX_BLOCK_SHIFT  20
+#define COMPRESSED_HEADER_SIZE      16
+#define COMPRESSION_FORMAT_LZNT1    2
+
+#define DEFAULT_BLOCK_SHIFT 16
+
+#define LZNT1_CHUNK_SIZE    0x1000
+#define LZNT1_MAX_CHAIN     256
+#define HASH_BITS           12
+#define HASH_SIZE           (1 << HASH_BITS)
+#define NO_POSITION         0xFFFF
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static unsigned int hash3(const uint8_t *p)
+{
+    return ((p[0] << 8) ^ (p[1] << 4) ^ p[2]) & (HASH_SIZE - 1);
+}
+
+/*
+ * Compresses one chunk of at most 4 KB, without its header, and returns the
+ * size of the data, or 0 if it does not fit in dst_size bytes. The split of
+ * a back reference between displacement and length depends on the position
+ * in the chunk, exactly as RtlDecompressBuffer() computes it.
+ */
+static size_t lznt1_compress_chunk(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_size)
+{
+    static uint16_t head[HASH_SIZE];
+    static uint16_t prev[LZNT1_CHUNK_SIZE];
+    size_t pos = 0, out = 0, flags_pos = 0;
+    unsigned int token = 8;
+    uint8_t flags = 0;
+
+    memset(head, 0xFF, sizeof(head));
+
+    while (pos < src_size)
+    {
+        unsigned int displacement_bits, length_bits;
+        size_t best_length = 0, best_displacement = 0;
+        size_t max_length, insert;
+
+        /* Start a new group of 8 entities behind its flag byte */
+        if (token == 8)
+        {
+            if (out > 0)
+                dst[flags_pos] = flags;
+            if (out + 1 + 16 > dst_size)
+                return 0;
+            flags_pos = out++;
+            flags = 0;
+            token = 0;
+        }
+
+        for (displacement_bits = 12; displacement_bits > 4; displacement_bits--)
+            if ((1u << (displacement_bits - 1)) < pos) break;
+        length_bits = 16 - displacement_bits;
+        max_length = ((size_t)1 << length_bits) + 2;
+        if (max_length > src_size - pos)
+            max_length = src_size - pos;
+
+        if (max_length >= 3)
+        {
+            unsigned int chain = LZNT1_MAX_CHAIN;
+            uint16_t candidate = head[hash3(src + pos)];
+
+            while (candidate != NO_POSITION && chain--)
+            {
+                size_t length = 0;
+
+                while (length < max_length && src[candidate + length] == src[pos + length])
+                    length++;
+                if (length > best_length)
+                {
+                    best_length = length;
+                    best_displacement = pos - candidate;
+                    if (length == max_length)
+                        break;
+                }
+                candidate = prev[candidate];
+            }
+        }
+
+        if (best_length >= 3)
+        {
+            uint16_t code = (uint16_t)(((best_displacement - 1) << length_bits) | (best_length - 3));
+
+            put16(dst + out, code);
+            out += 2;
+            flags |= 1 << token;
+            insert = best_length;
+        }
+        else
+        {
+            dst[out++] = src[pos];
+            insert = 1;
+        }
+        token++;
+
+        /* Index every position the entity covered */
+        while (insert--)
+        {
+            if (pos + 3 <= src_size)
+            {
+                unsigned int hash = hash3(src + pos);
+
+                prev[pos] = head[hash];
+                head[hash] = (uint16_t)pos;
+            }
+            pos++;
+        }
+    }
+
+    if (out > 0)
+        dst[flags_pos] = flags;
+    return out;
+}
+
+/*
+ * Compresses a block into a sequence of LZNT1 chunks and returns its size,
+ * or 0 if compressing it does not save anything.
+ */
+static size_t lznt1_compress_block(const uint8_t *src, size_t src_size, uint8_t *dst)
+{
+    size_t in = 0, out = 0;
+
+    while (in < src_size)
+    {
+        size_t chunk_size = src_size - in;
+        size_t room, data_size;
+
+        /* The block is only worth compressing if it ends up smaller */
+        if (out + 2 >= src_size)
+            return 0;
+        room = src_size - out - 2;
+
+        if (chunk_size > LZNT1_CHUNK_SIZE)
+            chunk_size = LZNT1_CHUNK_SIZE;
+
+        data_size = lznt1_compress_chunk(src + in, chunk_size, dst + out + 2,
+                                         (room < chunk_size - 1) ? room : chunk_size - 1);
+        if (data_size > 0)
+        {
+            put16(dst + out, (uint16_t)(0xB000 | (data_size - 1)));
+        }
+        else
+        {
+            /* Store the chunk, with a full size unless it is the last one */
+            if (chunk_size > room)
+                return 0;
+            data_size = chunk_size;
+            memcpy(dst + out + 2, src + in, chunk_size);
+            put16(dst + out, (uint16_t)(0x3000 | (data_size - 1)));
+        }
+
+        out += 2 + data_size;
+        in += chunk_size;
+    }
+
+    return (out < src_size) ? out : 0;
+}
+
+static void usage(void)
+{
+    printf("Usage: bootcomp [-b blockshift] inputfile outputfile\n"
+           "  -b blockshift  log2 of the block size, from %d to %d (default %d)\n",
+           COMPRESSED_MIN_BLOCK_SHIFT, COMPRESSED_MAX_BLOCK_SHIFT, DEFAULT_BLOCK_SHIFT);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int block_shift = DEFAULT_BLOCK_SHIFT;
+    uint8_t header[COMPRESSED_HEADER_SIZE];
+    uint8_t *block = NULL, *data = NULL, *table = NULL;
+    FILE *in = NULL, *out = NULL;
+    size_t block_size, table_size;
+    uint32_t block_count, i, offset;
+    long input_size;
+    int arg = 1, ret = 1;
+
+    if (arg + 1 < argc && strcmp(argv[arg], "-b") == 0)
+    {
+        block_shift = (unsigned int)atoi(argv[arg + 1]);
+        arg += 2;
+    }
+    if (argc - arg != 2 ||
+        block_shift < COMPRESSED_MIN_BLOCK_SHIFT || block_shift > COMPRESSED_MAX_BLOCK_SHIFT)
+    {
+        usage();
+        return 1;
+    }
+
+    in = fopen(argv[arg], "rb");
+    if (!in)
+    {
+        fprintf(stderr, "Unable to open '%s'\n", argv[arg]);
+        return 1;
+    }
+
+    if (fseek(in, 0, SEEK_END) != 0 || (input_size = ftell(in)) < 0 || fseek(in, 0, SEEK_SET) != 0)
+    {
+        fprintf(stderr, "Unable to get the size of '%s'\n", argv[arg]);
+        goto done;
+    }
+    if ((unsigned long)input_size > 0xFFFFFFFFUL)
+    {
+        fprintf(stderr, "'%s' is too big\n", argv[arg]);
+        goto done;
+    }
+
+    block_size = (size_t)1 << block_shift;
+    block_count = (uint32_t)(((unsigned long long)input_size + block_size - 1) >> block_shift);
+    table_size = ((size_t)block_count + 1) * 4;
+
+    block = malloc(block_size);
+    data = malloc(block_size);
+    table = malloc(table_size);
+    if (!block || !data || !table)
+    {
+        fprintf(stderr, "Out of memory\n");
+        goto done;
+    }
+
+    out = fopen(argv[arg + 1], "wb");
+    if (!out)
+    {
+        fprintf(stderr, "Unable to create '%s'\n", argv[arg + 1]);
+        goto done;
+    }
+
+    put32(header + 0, COMPRESSED_FILE_SIGNATURE);
+    put16(header + 4, COMPRESSION_FORMAT_LZNT1);
+    put16(header + 6, (uint16_t)block_shift);
+    put32(header + 8, (uint32_t)input_size);
+    put32(header + 12, block_count);
+
+    /* The offset table is written once all the blocks are known */
+    offset = (uint32_t)(COMPRESSED_HEADER_SIZE + table_size);
+    if (fwrite(header, sizeof(header), 1, out) != 1 ||
+        fseek(out, (long)offset, SEEK_SET) != 0)
+    {
+        goto write_error;
+    }
+
+    for (i = 0; i < block_count; i++)
+    {
+        size_t size = (size_t)input_size - ((size_t)i << block_shift);
+        size_t data_size;
+
+        if (size > block_size)
+            size = block_size;
+        if (fread(block, size, 1, in) != 1)
+        {
+            fprintf(stderr, "Unable to read '%s'\n", argv[arg]);
+            goto done;
+        }
+
+        data_size = lznt1_compress_block(block, size, data);
+        if (data_size == 0)
+        {
+            if (fwrite(block, size, 1, out) != 1)
+                goto write_error;
+            data_size = size;
+        }
+        else if (fwrite(data, data_size, 1, out) != 1)
+        {
+            goto write_error;
+        }
+
+        put32(table + (size_t)i * 4, offset);
+        if ((unsigned long long)offset + data_size > 0xFFFFFFFFULL)
+        {
+            fprintf(stderr, "'%s' is too big\n", argv[arg + 1]);
+            goto done;
+        }
+        offset += (uint32_t)data_size;
+    }
+    put32(table + (size_t)block_count * 4, offset);
+
+    if (fseek(out, COMPRESSED_HEADER_SIZE, SEEK_SET) != 0 ||
+        fwrite(table, table_size, 1, out) != 1)
+    {
+        goto write_error;
+    }
+
+    ret = 0;
+    goto done;
+
+write_error:
+    fprintf(stderr, "Unable to write '%s'\n", argv[arg + 1]);
+
+done:
+    if (out)
+    {
+        fclose(out);
+        if (ret != 0)
+            remove(argv[arg + 1]);
+    }
+    if (in)
+        fclose(in);
+    free(table);
+    free(data);
+    free(block);
+    return ret;
+}
@@ -836,6 +836,18 @@ CreatePrimitive(FILE *Out, unsigned Bpp, PROPINFO RopInfo)
             Output(Out, "UsesPattern = ROP4_USES_PATTERN(BltInfo->Rop4);\n");
         }
         Output(Out, "\n");
+        if (ROPCODE_GENERIC != RopInfo->RopCode &&
+                ROPCODE_SRCCOPY != RopInfo->RopCode)
+        {
+            /* Raw bits with a solid brush go a row at a time */
+            Output(Out, "if (DIB_RowBitBlt(BltInfo, Dib_RowRop_%s, %s, %s))\n",
+                   RopInfo->Name, RopInfo->UsesSource ? "TRUE" : "FALSE",
+                   RopInfo->UsesPattern ? "TRUE" : "FALSE");
+            Output(Out, "{\n");
+            Output(Out, "return;\n");
+            Output(Out, "}\n");
+            Output(Out, "\n");
+        }
         if (! RopInfo->UsesSource)
         {
             CreateBase(Out, 0, 0, Bpp);
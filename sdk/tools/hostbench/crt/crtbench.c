@@ -0,0 +1,487 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Correctness and throughput of the CRT memory and string routines
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../hostbench.h"
+
+/*
+ * The CRT sources are built twice, with their functions renamed by the
+ * preprocessor: the portable C versions get a generic_ prefix and the
+ * amd64 ones an sse2_ prefix. The host C library is the third contender.
+ */
+typedef unsigned short WCHAR16;
+
+#define DECLARE_CRT(Prefix) \
+    void *Prefix##_memcpy(void *, const void *, size_t); \
+    void *Prefix##_memmove(void *, const void *, size_t); \
+    void *Prefix##_memset(void *, int, size_t); \
+    int Prefix##_memcmp(const void *, const void *, size_t); \
+    void *Prefix##_memchr(const void *, int, size_t); \
+    size_t Prefix##_strlen(const char *); \
+    char *Prefix##_strchr(const char *, int); \
+    size_t Prefix##_wcslen(const WCHAR16 *); \
+    WCHAR16 *Prefix##_wcschr(const WCHAR16 *, WCHAR16);
+
+DECLARE_CRT(generic)
+DECLARE_CRT(sse2)
+
+typedef struct _CRT_IMPL
+{
+    const char *Name;
+    void *(*Memcpy)(void *, const void *, size_t);
+    void *(*Memmove)(void *, const void *, size_t);
+    void *(*Memset)(void *, int, size_t);
+    int (*Memcmp)(const void *, const void *, size_t);
+    void *(*Memchr)(const void *, int, size_t);
+    size_t (*Strlen)(const char *);
+    char *(*Strchr)(const char *, int);
+    size_t (*Wcslen)(const WCHAR16 *);
+    WCHAR16 *(*Wcschr)(const WCHAR16 *, WCHAR16);
+} CRT_IMPL, *PCRT_IMPL;
+
+#define CRT_IMPL_ENTRY(Prefix) \
+    { #Prefix, Prefix##_memcpy, Prefix##_memmove, Prefix##_memset, Prefix##_memcmp, \
+      Prefix##_memchr, Prefix##_strlen, Prefix##_strchr, Prefix##_wcslen, Prefix##_wcschr }
+
+static const CRT_IMPL Implementations[] =
+{
+    CRT_IMPL_ENTRY(generic),
+    CRT_IMPL_ENTRY(sse2),
+    /* The host has no 16-bit wcslen and wcschr */
+    { "host", memcpy, memmove, memset, memcmp, memchr, strlen, strchr, NULL, NULL },
+};
+
+#define IMPL_COUNT (sizeof(Implementations) / sizeof(Implementations[0]))
+
+/* Buffers are big enough for the largest size plus the misalignment */
+#define MAX_SIZE 65536
+#define BUFFER_SIZE (MAX_SIZE + 256)
+
+static unsigned char *Source;
+static unsigned char *Destination;
+static unsigned char *Reference;
+
+/* Check the stop flag every that many calls */
+#define BATCH 16
+
+/*
+ * Correctness checks
+ */
+
+static int Failures;
+
+static void
+Fail(const char *Function, size_t Size, size_t Offset1, size_t Offset2)
+{
+    if (Failures++ < 20)
+    {
+        fprintf(stderr, "crtbench: sse2 %s failed, size %zu, offsets %zu/%zu\n",
+                Function, Size, Offset1, Offset2);
+    }
+}
+
+static void
+FillPattern(unsigned char *Buffer, size_t Size, unsigned Seed)
+{
+    size_t i;
+
+    for (i = 0; i < Size; i++)
+        Buffer[i] = (unsigned char)((i * 131 + Seed * 7) % 251 + 1);
+}
+
+static void
+VerifyMemory(void)
+{
+    size_t Size, Src, Dst;
+    long Shift;
+
+    for (Size = 0; Size <= 300; Size++)
+    {
+        for (Src = 0; Src < 16; Src += 5)
+        {
+            for (Dst = 0; Dst < 16; Dst += 3)
+            {
+                /* Plain copy and fill, with guard bytes around the destination */
+                FillPattern(Source, BUFFER_SIZE, 1);
+                memset(Destination, 0xEE, BUFFER_SIZE);
+                memset(Reference, 0xEE, BUFFER_SIZE);
+                memcpy(Reference + 64 + Dst, Source + Src, Size);
+                sse2_memcpy(Destination + 64 + Dst, Source + Src, Size);
+                if (memcmp(Destination, Reference, BUFFER_SIZE))
+                    Fail("memcpy", Size, Src, Dst);
+
+                memset(Reference + 64 + Dst, 'x', Size);
+                sse2_memset(Destination + 64 + Dst, 'x', Size);
+                if (memcmp(Destination, Reference, BUFFER_SIZE))
+                    Fail("memset", Size, Src, Dst);
+
+                /* Overlapping moves in both directions */
+                for (Shift = -40; Shift <= 40; Shift += 7)
+                {
+                    FillPattern(Destination, BUFFER_SIZE, 2);
+                    FillPattern(Reference, BUFFER_SIZE, 2);
+                    memmove(Reference + 128 + Dst + Shift, Reference + 128 + Src, Size);
+                    sse2_memmove(Destination + 128 + Dst + Shift, Destination + 128 + Src, Size);
+                    if (memcmp(Destination, Reference, BUFFER_SIZE))
+                        Fail("memmove", Size, Src, Dst + Shift);
+                }
+
+                /* Equal buffers, then one difference at every position */
+                FillPattern(Destination, BUFFER_SIZE, 1);
+                if (sse2_memcmp(Destination + Src, Source + Src, Size))
+                    Fail("memcmp", Size, Src, Dst);
+                if (Size)
+                {
+                    size_t At = (Dst * 37) % Size;
+                    int Expected, Result;
+
+                    Destination[Src + At] ^= 0x80;
+                    Expected = memcmp(Destination + Src, Source + Src, Size);
+                    Result = sse2_memcmp(Destination + Src, Source + Src, Size);
+                    if ((Expected < 0) != (Result < 0) || (Expected > 0) != (Result > 0))
+                        Fail("memcmp", Size, Src, At);
+
+                    /* memchr finds the first match only */
+                    memset(Destination, 0, BUFFER_SIZE);
+                    Destination[Src + At] = 0xC3;
+                    Destination[Src + Size] = 0xC3;
+                    if (sse2_memchr(Destination + Src, 0xC3, Size) != Destination + Src + At)
+                        Fail("memchr", Size, Src, At);
+                    Destination[Src + At] = 0;
+                    if (sse2_memchr(Destination + Src, 0xC3, Size) != NULL)
+                        Fail("memchr", Size, Src, At);
+                }
+            }
+        }
+    }
+
+    /* The rep movsb/stosb paths */
+    FillPattern(Source, BUFFER_SIZE, 3);
+    sse2_memcpy(Destination + 5, Source + 9, MAX_SIZE);
+    if (memcmp(Destination + 5, Source + 9, MAX_SIZE))
+        Fail("memcpy", MAX_SIZE, 9, 5);
+    sse2_memset(Destination + 7, 0x5A, MAX_SIZE);
+    memset(Reference + 7, 0x5A, MAX_SIZE);
+    if (memcmp(Destination + 7, Reference + 7, MAX_SIZE))
+        Fail("memset", MAX_SIZE, 0, 7);
+}
+
+static void
+VerifyStrings(void)
+{
+    WCHAR16 *Wide = (WCHAR16 *)Destination;
+    size_t Length, Start, i;
+    char *Narrow = (char *)Source;
+
+    for (Length = 0; Length <= 100; Length++)
+    {
+        for (Start = 0; Start < 32; Start++)
+        {
+            /* Non-zero garbage before the start must be ignored */
+            memset(Source, '#', BUFFER_SIZE);
+            for (i = 0; i < Length; i++)
+                Narrow[Start + i] = (char)('a' + i % 26);
+            Narrow[Start + Length] = 0;
+
+            if (sse2_strlen(Narrow + Start) != Length)
+                Fail("strlen", Length, Start, 0);
+            if (sse2_strchr(Narrow + Start, 0) != Narrow + Start + Length)
+                Fail("strchr", Length, Start, 0);
+            if (sse2_strchr(Narrow + Start, 'z') != strchr(Narrow + Start, 'z'))
+                Fail("strchr", Length, Start, 'z');
+            if (sse2_strchr(Narrow + Start, '#') != NULL)
+                Fail("strchr", Length, Start, '#');
+
+            /* Odd starts take the unaligned fallback */
+            for (i = 0; i < BUFFER_SIZE / 2; i++)
+                Wide[i] = 0x4747;
+            for (i = 0; i < Length; i++)
+                Wide[Start + i] = (WCHAR16)(0x3040 + i % 50);
+            Wide[Start + Length] = 0;
+
+            if (sse2_wcslen(Wide + Start) != Length)
+                Fail("wcslen", Length, Start, 0);
+            if (sse2_wcslen((WCHAR16 *)((unsigned char *)(Wide + Start) + 1)) !=
+                generic_wcslen((WCHAR16 *)((unsigned char *)(Wide + Start) + 1)))
+            {
+                Fail("wcslen", Length, Start, 1);
+            }
+            if (sse2_wcschr(Wide + Start, 0x3071) != generic_wcschr(Wide + Start, 0x3071))
+                Fail("wcschr", Length, Start, 0x3071);
+            if (sse2_wcschr(Wide + Start, 0) != Wide + Start + Length)
+                Fail("wcschr", Length, Start, 0);
+            if (sse2_wcschr(Wide + Start, 0x4747) != NULL)
+                Fail("wcschr", Length, Start, 0x4747);
+        }
+    }
+}
+
+/*
+ * Benchmarks
+ */
+
+typedef struct _CRT_CONTEXT
+{
+    const CRT_IMPL *Impl;
+    size_t Size;
+    size_t Misalign;
+} CRT_CONTEXT, *PCRT_CONTEXT;
+
+static void
+BenchMemcpy(PHB_THREAD Thread)
+{
+    PCRT_CONTEXT Context = Thread->Context;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+            Context->Impl->Memcpy(Destination + Context->Misalign, Source + 2 * Context->Misalign, Context->Size);
+        Thread->Operations += BATCH;
+    }
+}
+
+static void
+BenchMemmove(PHB_THREAD Thread)
+{
+    PCRT_CONTEXT Context = Thread->Context;
+    unsigned i;
+
+    /* Overlapping, copying upwards */
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+            Context->Impl->Memmove(Destination + 64 + Context->Misalign, Destination, Context->Size);
+        Thread->Operations += BATCH;
+    }
+}
+
+static void
+BenchMemset(PHB_THREAD Thread)
+{
+    PCRT_CONTEXT Context = Thread->Context;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+            Context->Impl->Memset(Destination + Context->Misalign, (int)i, Context->Size);
+        Thread->Operations += BATCH;
+    }
+}
+
+static void
+BenchMemcmp(PHB_THREAD Thread)
+{
+    PCRT_CONTEXT Context = Thread->Context;
+    volatile int Sink;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+            Sink = Context->Impl->Memcmp(Reference + Context->Misalign, Source, Context->Size);
+        Thread->Operations += BATCH;
+    }
+    (void)Sink;
+}
+
+static void
+BenchMemchr(PHB_THREAD Thread)
+{
+    PCRT_CONTEXT Context = Thread->Context;
+    void *volatile Sink;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+            Sink = Context->Impl->Memchr(Source + Context->Misalign, 0, Context->Size);
+        Thread->Operations += BATCH;
+    }
+    (void)Sink;
+}
+
+static void
+BenchStrlen(PHB_THREAD Thread)
+{
+    PCRT_CONTEXT Context = Thread->Context;
+    volatile size_t Sink;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+            Sink = Context->Impl->Strlen((const char *)Source + Context->Misalign);
+        Thread->Operations += BATCH;
+    }
+    (void)Sink;
+}
+
+static void
+BenchStrchr(PHB_THREAD Thread)
+{
+    PCRT_CONTEXT Context = Thread->Context;
+    char *volatile Sink;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+            Sink = Context->Impl->Strchr((const char *)Source + Context->Misalign, '!');
+        Thread->Operations += BATCH;
+    }
+    (void)Sink;
+}
+
+static void
+BenchWcslen(PHB_THREAD Thread)
+{
+    PCRT_CONTEXT Context = Thread->Context;
+    volatile size_t Sink;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+            Sink = Context->Impl->Wcslen((const WCHAR16 *)Reference + Context->Misalign);
+        Thread->Operations += BATCH;
+    }
+    (void)Sink;
+}
+
+static void
+BenchWcschr(PHB_THREAD Thread)
+{
+    PCRT_CONTEXT Context = Thread->Context;
+    WCHAR16 *volatile Sink;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+            Sink = Context->Impl->Wcschr((const WCHAR16 *)Reference + Context->Misalign, L'!');
+        Thread->Operations += BATCH;
+    }
+    (void)Sink;
+}
+
+typedef struct _CRT_BENCHMARK
+{
+    const char *Name;
+    PHB_ROUTINE Routine;
+    /* Uses the 16-bit wide character functions */
+    int Wide;
+} CRT_BENCHMARK;
+
+static const CRT_BENCHMARK Benchmarks[] =
+{
+    { "memcpy", BenchMemcpy, 0 },
+    { "memmove", BenchMemmove, 0 },
+    { "memset", BenchMemset, 0 },
+    { "memcmp", BenchMemcmp, 0 },
+    { "memchr", BenchMemchr, 0 },
+    { "strlen", BenchStrlen, 0 },
+    { "strchr", BenchStrchr, 0 },
+    { "wcslen", BenchWcslen, 1 },
+    { "wcschr", BenchWcschr, 1 },
+};
+
+static const size_t Sizes[] = { 16, 64, 256, 4096, MAX_SIZE };
+
+/* Set the string terminators so every string is Size characters long */
+static void
+PrepareStrings(size_t Size, size_t Misalign)
+{
+    WCHAR16 *Wide = (WCHAR16 *)Reference;
+    size_t i;
+
+    memset(Source, 'a', BUFFER_SIZE);
+    Source[Misalign + Size] = 0;
+
+    for (i = 0; i < BUFFER_SIZE / 2; i++)
+        Wide[i] = L'a';
+    Wide[Misalign + Size / 2] = 0;
+}
+
+static void
+RunBenchmarks(void)
+{
+    static const size_t Misaligns[] = { 0, 3 };
+    CRT_CONTEXT Context;
+    HB_RESULT Result;
+    char Name[64];
+    size_t b, s, m, i;
+
+    HbReportHeader("CRT memory and string routines (sizes in bytes)");
+
+    for (b = 0; b < sizeof(Benchmarks) / sizeof(Benchmarks[0]); b++)
+    {
+        for (s = 0; s < sizeof(Sizes) / sizeof(Sizes[0]); s++)
+        {
+            for (m = 0; m < sizeof(Misaligns) / sizeof(Misaligns[0]); m++)
+            {
+                for (i = 0; i < IMPL_COUNT; i++)
+                {
+                    if (Benchmarks[b].Wide && !Implementations[i].Wcslen)
+                        continue;
+
+                    snprintf(Name, sizeof(Name), "%s_%zu%s_%s",
+                             Benchmarks[b].Name,
+                             Sizes[s],
+                             Misaligns[m] ? "_unaligned" : "",
+                             Implementations[i].Name);
+                    if (!HbSelected(Name))
+                        continue;
+
+                    Context.Impl = &Implementations[i];
+                    Context.Size = Sizes[s];
+                    Context.Misalign = Misaligns[m];
+
+                    PrepareStrings(Sizes[s], Misaligns[m]);
+                    if (Benchmarks[b].Routine == BenchMemcmp)
+                    {
+                        /* Equal buffers, the whole size gets compared */
+                        memcpy(Reference + Misaligns[m], Source, Sizes[s]);
+                    }
+                    else if (Benchmarks[b].Routine == BenchMemchr)
+                    {
+                        Source[Misaligns[m] + Sizes[s] - 1] = 0;
+                    }
+
+                    HbRun(Benchmarks[b].Routine, &Context, 1, HbOptions.DurationMs, &Result);
+                    HbReport(Name, &Result);
+                }
+            }
+        }
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    if (HbParseOptions(argc, argv, NULL))
+        return 1;
+
+    Source = HbAlignedAlloc(64, BUFFER_SIZE);
+    Destination = HbAlignedAlloc(64, BUFFER_SIZE);
+    Reference = HbAlignedAlloc(64, BUFFER_SIZE);
+
+    VerifyMemory();
+    VerifyStrings();
+    if (Failures)
+    {
+        fprintf(stderr, "crtbench: %d checks failed\n", Failures);
+        return 1;
+    }
+
+    RunBenchmarks();
+
+    return 0;
+}
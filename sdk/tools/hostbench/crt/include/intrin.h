@@ -0,0 +1,44 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     The few MSVC intrinsics the CRT sources use, for the host compiler
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#define __int64 long long
+
+static __inline unsigned char
+_BitScanForward(unsigned long *Index, unsigned long Mask)
+{
+    *Index = Mask ? (unsigned long)__builtin_ctzl(Mask) : 0;
+    return Mask != 0;
+}
+
+static __inline void
+__movsb(unsigned char *Destination, const unsigned char *Source, size_t Count)
+{
+    __asm__ __volatile__("rep movsb"
+                         : "+D" (Destination), "+S" (Source), "+c" (Count)
+                         :
+                         : "memory");
+}
+
+static __inline void
+__stosb(unsigned char *Dest, unsigned char Data, size_t Count)
+{
+    __asm__ __volatile__("rep stosb"
+                         : "+D" (Dest), "+c" (Count)
+                         : "a" (Data)
+                         : "memory");
+}
+
+static __inline unsigned char
+_BitScanForward64(unsigned long *Index, unsigned long long Mask)
+{
+    *Index = Mask ? (unsigned long)__builtin_ctzll(Mask) : 0;
+    return Mask != 0;
+}
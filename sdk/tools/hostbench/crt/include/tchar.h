@@ -0,0 +1,20 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Minimal tchar.h for building the CRT string sources on the host
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#include <wchar.h>
+
+#ifdef _UNICODE
+typedef wchar_t _TCHAR;
+#define _tcslen wcslen
+#define _tcschr wcschr
+#else
+typedef char _TCHAR;
+#define _tcslen strlen
+#define _tcschr strchr
+#endif
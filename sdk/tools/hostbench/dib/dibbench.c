@@ -0,0 +1,513 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Conformance and throughput of the 32bpp AlphaBlend and StretchBlt rows
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <win32k.h>
+
+#include "../hostbench.h"
+
+/*
+ * The per pixel loops of DIB_32BPP_AlphaBlend and DIB_XXBPP_StretchBlt are
+ * modelled here with the same arithmetic, going through pixel functions
+ * and a color translation like they do. The row loops are the ones win32k
+ * now uses for 32bpp surfaces without color translation. Both are run on
+ * the same random pixels, for many rectangles, constant alphas and stretch
+ * factors, and must give the same bits. Then they are timed.
+ */
+
+#define AC_SRC_ALPHA    0x01
+
+typedef struct _SURFACE
+{
+    LONG cx;
+    LONG cy;
+    LONG lDelta;
+    PVOID pvScan0;
+} SURFACE, *PSURFACE;
+
+typedef struct _RECT32
+{
+    LONG left;
+    LONG top;
+    LONG right;
+    LONG bottom;
+} RECT32;
+
+typedef ULONG (*PFN_GETPIXEL)(PSURFACE, LONG, LONG);
+typedef VOID (*PFN_PUTPIXEL)(PSURFACE, LONG, LONG, ULONG);
+typedef ULONG (*PFN_XLATE)(ULONG);
+
+typedef union
+{
+    ULONG ul;
+    struct
+    {
+        UCHAR red;
+        UCHAR green;
+        UCHAR blue;
+        UCHAR alpha;
+    } col;
+} NICEPIXEL32;
+
+static ULONG
+GetPixel32(PSURFACE Surface, LONG x, LONG y)
+{
+    return ((PULONG)((PUCHAR)Surface->pvScan0 + y * Surface->lDelta))[x];
+}
+
+static VOID
+PutPixel32(PSURFACE Surface, LONG x, LONG y, ULONG c)
+{
+    ((PULONG)((PUCHAR)Surface->pvScan0 + y * Surface->lDelta))[x] = c;
+}
+
+static ULONG
+XlateTrivial(ULONG c)
+{
+    return c;
+}
+
+/* Called through pointers, like DibFunctionsForBitmapFormat[] and XLATEOBJ_iXlate */
+static PFN_GETPIXEL volatile pfnGetPixel = GetPixel32;
+static PFN_PUTPIXEL volatile pfnPutPixel = PutPixel32;
+static PFN_XLATE volatile pfnXlate = XlateTrivial;
+
+static __inline UCHAR
+Clamp8(ULONG val)
+{
+    return (val > 255) ? 255 : (UCHAR)val;
+}
+
+/* The loop of DIB_32BPP_AlphaBlend */
+static VOID
+AlphaBlendPerPixel(PSURFACE Dest, PSURFACE Source, RECT32 *DestRect, RECT32 *SourceRect,
+                   UCHAR SourceConstantAlpha, UCHAR AlphaFormat)
+{
+    INT Rows, Cols, SrcX, SrcY;
+    PULONG Dst;
+    NICEPIXEL32 DstPixel, SrcPixel;
+    UCHAR Alpha;
+
+    Dst = (PULONG)((ULONG_PTR)Dest->pvScan0 + (DestRect->top * Dest->lDelta) + (DestRect->left << 2));
+
+    Rows = 0;
+    SrcY = SourceRect->top;
+    while (++Rows <= DestRect->bottom - DestRect->top)
+    {
+        Cols = 0;
+        SrcX = SourceRect->left;
+        while (++Cols <= DestRect->right - DestRect->left)
+        {
+            SrcPixel.ul = pfnXlate(pfnGetPixel(Source, SrcX, SrcY));
+            SrcPixel.col.red = (SrcPixel.col.red * SourceConstantAlpha) / 255;
+            SrcPixel.col.green = (SrcPixel.col.green * SourceConstantAlpha) / 255;
+            SrcPixel.col.blue = (SrcPixel.col.blue * SourceConstantAlpha) / 255;
+            SrcPixel.col.alpha = (SrcPixel.col.alpha * SourceConstantAlpha) / 255;
+
+            Alpha = ((AlphaFormat & AC_SRC_ALPHA) != 0) ? SrcPixel.col.alpha : SourceConstantAlpha;
+
+            DstPixel.ul = *Dst;
+            DstPixel.col.red = Clamp8((DstPixel.col.red * (255 - Alpha)) / 255 + SrcPixel.col.red);
+            DstPixel.col.green = Clamp8((DstPixel.col.green * (255 - Alpha)) / 255 + SrcPixel.col.green);
+            DstPixel.col.blue = Clamp8((DstPixel.col.blue * (255 - Alpha)) / 255 + SrcPixel.col.blue);
+            DstPixel.col.alpha = Clamp8((DstPixel.col.alpha * (255 - Alpha)) / 255 + SrcPixel.col.alpha);
+            *Dst++ = DstPixel.ul;
+            SrcX = SourceRect->left + (Cols * (SourceRect->right - SourceRect->left)) / (DestRect->right - DestRect->left);
+        }
+        Dst = (PULONG)((ULONG_PTR)Dest->pvScan0 + ((DestRect->top + Rows) * Dest->lDelta) + (DestRect->left << 2));
+        SrcY = SourceRect->top + (Rows * (SourceRect->bottom - SourceRect->top)) / (DestRect->bottom - DestRect->top);
+    }
+}
+
+/* DIB_32BPP_AlphaBlendRows */
+static VOID
+AlphaBlendRows(PSURFACE Dest, PSURFACE Source, RECT32 *DestRect, RECT32 *SourceRect,
+               UCHAR SourceConstantAlpha, UCHAR AlphaFormat)
+{
+    ULONG SrcBuffer[64];
+    PULONG Dst, Src;
+    INT Rows, Cols, SrcY, Chunk;
+    INT DstWidth = DestRect->right - DestRect->left;
+    INT SrcWidth = SourceRect->right - SourceRect->left;
+    BOOLEAN SrcAlpha = (AlphaFormat & AC_SRC_ALPHA) != 0;
+
+    for (Rows = 0; Rows < DestRect->bottom - DestRect->top; Rows++)
+    {
+        SrcY = SourceRect->top + (Rows * (SourceRect->bottom - SourceRect->top)) / (DestRect->bottom - DestRect->top);
+        Dst = (PULONG)((ULONG_PTR)Dest->pvScan0 + ((DestRect->top + Rows) * Dest->lDelta)) + DestRect->left;
+        Src = (PULONG)((ULONG_PTR)Source->pvScan0 + (SrcY * Source->lDelta)) + SourceRect->left;
+
+        if (SrcWidth == DstWidth)
+        {
+            DIB_32BPP_AlphaBlendRow(Dst, Src, DstWidth, SourceConstantAlpha, SrcAlpha);
+            continue;
+        }
+
+        for (Cols = 0; Cols < DstWidth; Cols += Chunk)
+        {
+            Chunk = min(DstWidth - Cols, (INT)(sizeof(SrcBuffer) / sizeof(SrcBuffer[0])));
+            DIB_32BPP_StretchRow(SrcBuffer, Src, 1, Chunk, Cols, SrcWidth, DstWidth);
+            DIB_32BPP_AlphaBlendRow(Dst + Cols, SrcBuffer, Chunk, SourceConstantAlpha, SrcAlpha);
+        }
+    }
+}
+
+/* The loop of DIB_XXBPP_StretchBlt for SRCCOPY without a mask, rects already in order */
+static VOID
+StretchPerPixel(PSURFACE Dest, PSURFACE Source, RECT32 *DestRect, RECT32 *SourceRect,
+                BOOLEAN bTopToBottom, BOOLEAN bLeftToRight)
+{
+    LONG DesX, DesY, sx, sy;
+    LONG DstHeight = DestRect->bottom - DestRect->top;
+    LONG DstWidth = DestRect->right - DestRect->left;
+    LONG SrcHeight = SourceRect->bottom - SourceRect->top;
+    LONG SrcWidth = SourceRect->right - SourceRect->left;
+
+    for (DesY = DestRect->top; DesY < DestRect->bottom; DesY++)
+    {
+        if (bTopToBottom)
+            sy = SourceRect->bottom - (DesY - DestRect->top) * SrcHeight / DstHeight;
+        else
+            sy = SourceRect->top + (DesY - DestRect->top) * SrcHeight / DstHeight;
+
+        for (DesX = DestRect->left; DesX < DestRect->right; DesX++)
+        {
+            if (bLeftToRight)
+                sx = SourceRect->right - (DesX - DestRect->left) * SrcWidth / DstWidth;
+            else
+                sx = SourceRect->left + (DesX - DestRect->left) * SrcWidth / DstWidth;
+
+            if (sx >= 0 && sy >= 0 && Source->cx > sx && Source->cy > sy)
+            {
+                (VOID)pfnGetPixel(Dest, DesX, DesY);
+                pfnPutPixel(Dest, DesX, DesY, pfnXlate(pfnGetPixel(Source, sx, sy)));
+            }
+        }
+    }
+}
+
+/* DIB_32BPP_StretchSrcCopy */
+static VOID
+StretchRows(PSURFACE DestSurf, PSURFACE SourceSurf, RECT32 *DestRect, RECT32 *SourceRect,
+            BOOLEAN bTopToBottom, BOOLEAN bLeftToRight)
+{
+    LONG DesY, sy, PrevSy = -1;
+    PULONG Dst, Src, PrevDst = NULL;
+    LONG DstHeight = DestRect->bottom - DestRect->top;
+    LONG DstWidth = DestRect->right - DestRect->left;
+    LONG SrcHeight = SourceRect->bottom - SourceRect->top;
+    LONG SrcWidth = SourceRect->right - SourceRect->left;
+
+    for (DesY = DestRect->top; DesY < DestRect->bottom; DesY++)
+    {
+        if (bTopToBottom)
+            sy = SourceRect->bottom - (DesY - DestRect->top) * SrcHeight / DstHeight;
+        else
+            sy = SourceRect->top + (DesY - DestRect->top) * SrcHeight / DstHeight;
+
+        Dst = (PULONG)((ULONG_PTR)DestSurf->pvScan0 + DesY * DestSurf->lDelta) + DestRect->left;
+
+        if (sy == PrevSy)
+        {
+            RtlCopyMemory(Dst, PrevDst, DstWidth * sizeof(ULONG));
+        }
+        else
+        {
+            Src = (PULONG)((ULONG_PTR)SourceSurf->pvScan0 + sy * SourceSurf->lDelta);
+
+            if (!bLeftToRight && SrcWidth == DstWidth)
+                RtlCopyMemory(Dst, Src + SourceRect->left, DstWidth * sizeof(ULONG));
+            else if (bLeftToRight)
+                DIB_32BPP_StretchRow(Dst, Src + SourceRect->right, -1, DstWidth, 0, SrcWidth, DstWidth);
+            else
+                DIB_32BPP_StretchRow(Dst, Src + SourceRect->left, 1, DstWidth, 0, SrcWidth, DstWidth);
+        }
+
+        PrevSy = sy;
+        PrevDst = Dst;
+    }
+}
+
+static ULONG RandomState = 0x12345678;
+
+static ULONG
+Random(void)
+{
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+    return RandomState;
+}
+
+/* Premultiplied pixels with alpha 0 and 255 mixed in, and some that are not premultiplied */
+static ULONG
+RandomPixel(void)
+{
+    ULONG r = Random(), Alpha, i, ul;
+
+    switch (r & 7)
+    {
+        case 0: return 0;
+        case 1: return r | 0xFF000000;
+        case 2: return r;
+        default:
+            Alpha = (r >> 8) & 0xFF;
+            ul = Alpha << 24;
+            for (i = 0; i < 24; i += 8)
+                ul |= ((Random() & 0xFF) * Alpha / 255) << i;
+            return ul;
+    }
+}
+
+static VOID
+SurfaceCreate(PSURFACE Surface, LONG cx, LONG cy)
+{
+    Surface->cx = cx;
+    Surface->cy = cy;
+    Surface->lDelta = cx * 4;
+    Surface->pvScan0 = malloc(cx * cy * 4);
+}
+
+static VOID
+SurfaceFill(PSURFACE Surface)
+{
+    ULONG i;
+
+    for (i = 0; i < (ULONG)(Surface->cx * Surface->cy); i++)
+        ((PULONG)Surface->pvScan0)[i] = RandomPixel();
+}
+
+#define VERIFY_CX 200
+#define VERIFY_CY 24
+
+static int
+Verify(void)
+{
+    static const UCHAR Alphas[] = { 0, 1, 77, 128, 200, 254, 255 };
+    static const LONG Widths[] = { 1, 3, 4, 5, 7, 8, 15, 16, 17, 63, 64, 65, 130 };
+    SURFACE Dst, Src, Expected;
+    RECT32 DestRect, SourceRect;
+    ULONG Count = 0, a, w, sw, f, x, i;
+    int Failures = 0;
+    PVOID pvSaved;
+
+    SurfaceCreate(&Dst, VERIFY_CX, VERIFY_CY);
+    SurfaceCreate(&Src, VERIFY_CX, VERIFY_CY);
+    SurfaceCreate(&Expected, VERIFY_CX, VERIFY_CY);
+    pvSaved = malloc(VERIFY_CX * VERIFY_CY * 4);
+
+    /* The blend itself, every constant alpha over all kinds of pixels */
+    for (a = 0; a < 256; a++)
+    {
+        for (f = 0; f <= AC_SRC_ALPHA; f++)
+        {
+            SurfaceFill(&Dst);
+            SurfaceFill(&Src);
+            memcpy(Expected.pvScan0, Dst.pvScan0, VERIFY_CX * VERIFY_CY * 4);
+
+            DestRect.left = 0; DestRect.top = 0; DestRect.right = VERIFY_CX; DestRect.bottom = VERIFY_CY;
+            SourceRect = DestRect;
+            AlphaBlendPerPixel(&Expected, &Src, &DestRect, &SourceRect, (UCHAR)a, (UCHAR)f);
+            AlphaBlendRows(&Dst, &Src, &DestRect, &SourceRect, (UCHAR)a, (UCHAR)f);
+
+            if (memcmp(Expected.pvScan0, Dst.pvScan0, VERIFY_CX * VERIFY_CY * 4))
+            {
+                printf("AlphaBlend differs: SourceConstantAlpha %u, AlphaFormat %u\n", a, f);
+                Failures++;
+            }
+            Count++;
+        }
+    }
+
+    /* Rectangles, offsets and stretching, for both */
+    for (a = 0; a < sizeof(Alphas); a++)
+    {
+        for (w = 0; w < sizeof(Widths) / sizeof(Widths[0]); w++)
+        {
+            for (sw = 0; sw < sizeof(Widths) / sizeof(Widths[0]); sw++)
+            {
+                for (x = 0; x < 3; x++)
+                {
+                    for (f = 0; f < 4; f++)
+                    {
+                        SurfaceFill(&Dst);
+                        SurfaceFill(&Src);
+                        memcpy(pvSaved, Dst.pvScan0, VERIFY_CX * VERIFY_CY * 4);
+                        memcpy(Expected.pvScan0, Dst.pvScan0, VERIFY_CX * VERIFY_CY * 4);
+
+                        DestRect.left = x * 5;
+                        DestRect.right = DestRect.left + Widths[w];
+                        DestRect.top = 1 + x;
+                        DestRect.bottom = DestRect.top + 5 + f * 3;
+                        SourceRect.left = x * 7 + 1;
+                        SourceRect.right = SourceRect.left + Widths[sw];
+                        SourceRect.top = 2;
+                        SourceRect.bottom = SourceRect.top + 3 + x * 4;
+
+                        AlphaBlendPerPixel(&Expected, &Src, &DestRect, &SourceRect, Alphas[a], f & 1);
+                        AlphaBlendRows(&Dst, &Src, &DestRect, &SourceRect, Alphas[a], f & 1);
+                        if (memcmp(Expected.pvScan0, Dst.pvScan0, VERIFY_CX * VERIFY_CY * 4))
+                        {
+                            printf("AlphaBlend differs: %d to %d wide, alpha %u\n",
+                                   Widths[sw], Widths[w], Alphas[a]);
+                            Failures++;
+                        }
+                        Count++;
+
+                        /* The stretch only once per size */
+                        if (a != 0)
+                            continue;
+
+                        memcpy(Dst.pvScan0, pvSaved, VERIFY_CX * VERIFY_CY * 4);
+                        memcpy(Expected.pvScan0, pvSaved, VERIFY_CX * VERIFY_CY * 4);
+                        StretchPerPixel(&Expected, &Src, &DestRect, &SourceRect, (f & 2) != 0, (f & 1) != 0);
+                        StretchRows(&Dst, &Src, &DestRect, &SourceRect, (f & 2) != 0, (f & 1) != 0);
+                        if (memcmp(Expected.pvScan0, Dst.pvScan0, VERIFY_CX * VERIFY_CY * 4))
+                        {
+                            printf("StretchBlt differs: %d to %d wide, flips %u\n",
+                                   Widths[sw], Widths[w], f);
+                            Failures++;
+                        }
+                        Count++;
+                    }
+                }
+            }
+        }
+    }
+
+    /* Stretch pieces that start anywhere, like the AlphaBlend ones do */
+    for (i = 0; i < 10000; i++)
+    {
+        ULONG cxSource = Random() % 300, cxDest = 1 + Random() % 300;
+        ULONG ulFirst = Random() % cxDest, cx = Random() % (cxDest - ulFirst + 1), k;
+        ULONG Source[300], Dest[300];
+
+        for (k = 0; k < 300; k++)
+            Source[k] = k;
+
+        DIB_32BPP_StretchRow(Dest, Source, 1, cx, ulFirst, cxSource, cxDest);
+        for (k = 0; k < cx; k++)
+        {
+            if (Dest[k] != (ulFirst + k) * cxSource / cxDest)
+            {
+                printf("StretchRow differs: %u to %u from %u\n", cxSource, cxDest, ulFirst);
+                Failures++;
+                break;
+            }
+        }
+        Count++;
+    }
+
+    free(pvSaved);
+    free(Expected.pvScan0);
+    free(Src.pvScan0);
+    free(Dst.pvScan0);
+
+    printf("%u blts checked, %d differ\n", Count, Failures);
+    return Failures;
+}
+
+typedef struct _BENCH_CONTEXT
+{
+    PSURFACE Dst;
+    PSURFACE Src;
+    RECT32 DestRect;
+    RECT32 SourceRect;
+    BOOLEAN bStretchBlt;
+    BOOLEAN bPerPixel;
+} BENCH_CONTEXT;
+
+static void
+BenchRoutine(PHB_THREAD Thread)
+{
+    BENCH_CONTEXT *Context = Thread->Context;
+    ULONG cPixels = (Context->DestRect.right - Context->DestRect.left) *
+                    (Context->DestRect.bottom - Context->DestRect.top);
+
+    do
+    {
+        if (Context->bStretchBlt && Context->bPerPixel)
+            StretchPerPixel(Context->Dst, Context->Src, &Context->DestRect, &Context->SourceRect, FALSE, FALSE);
+        else if (Context->bStretchBlt)
+            StretchRows(Context->Dst, Context->Src, &Context->DestRect, &Context->SourceRect, FALSE, FALSE);
+        else if (Context->bPerPixel)
+            AlphaBlendPerPixel(Context->Dst, Context->Src, &Context->DestRect, &Context->SourceRect, 255, AC_SRC_ALPHA);
+        else
+            AlphaBlendRows(Context->Dst, Context->Src, &Context->DestRect, &Context->SourceRect, 255, AC_SRC_ALPHA);
+
+        Thread->Operations += cPixels;
+    } while (!HbShouldStop(Thread));
+}
+
+static void
+RunBenchmarks(void)
+{
+    static const struct
+    {
+        const char *Name;
+        BOOLEAN bStretchBlt;
+        LONG cxSource, cySource, cxDest, cyDest;
+    } Benches[] =
+    {
+        { "AlphaBlend 256x256",             FALSE, 256, 256, 256, 256 },
+        { "AlphaBlend 48x48 to 256x256",    FALSE, 48, 48, 256, 256 },
+        { "StretchBlt 640x480 to 1024x768", TRUE, 640, 480, 1024, 768 },
+        { "StretchBlt 1024x768 to 800x600", TRUE, 1024, 768, 800, 600 },
+    };
+    BENCH_CONTEXT Context;
+    SURFACE Dst, Src;
+    HB_RESULT Result;
+    char Name[64];
+    ULONG b, i;
+
+    HbReportHeader("32bpp AlphaBlend and StretchBlt (operations are dest pixels)");
+
+    SurfaceCreate(&Dst, 1024, 768);
+    SurfaceCreate(&Src, 1024, 768);
+    SurfaceFill(&Dst);
+    SurfaceFill(&Src);
+
+    for (b = 0; b < sizeof(Benches) / sizeof(Benches[0]); b++)
+    {
+        Context.Dst = &Dst;
+        Context.Src = &Src;
+        Context.bStretchBlt = Benches[b].bStretchBlt;
+        Context.SourceRect.left = Context.SourceRect.top = 0;
+        Context.SourceRect.right = Benches[b].cxSource;
+        Context.SourceRect.bottom = Benches[b].cySource;
+        Context.DestRect.left = Context.DestRect.top = 0;
+        Context.DestRect.right = Benches[b].cxDest;
+        Context.DestRect.bottom = Benches[b].cyDest;
+
+        for (i = 0; i < 2; i++)
+        {
+            Context.bPerPixel = (i == 0);
+            snprintf(Name, sizeof(Name), "%s %s", Benches[b].Name,
+                     Context.bPerPixel ? "per pixel" : "rows");
+            if (!HbSelected(Name))
+                continue;
+
+            HbRun(BenchRoutine, &Context, 1, HbOptions.DurationMs, &Result);
+            HbReport(Name, &Result);
+        }
+    }
+
+    free(Src.pvScan0);
+    free(Dst.pvScan0);
+}
+
+int
+main(int argc, char **argv)
+{
+    if (HbParseOptions(argc, argv, NULL))
+        return 1;
+
+    if (Verify())
+        return 1;
+
+    RunBenchmarks();
+    return 0;
+}
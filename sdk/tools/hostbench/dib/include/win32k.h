@@ -0,0 +1,29 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     What the 32bpp row functions use from win32k.h, for the host compiler
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The row functions pick their amd64 code with the MSVC architecture macro */
+#if defined(__x86_64__)
+#define _M_AMD64 1
+#endif
+
+#include <typedefs.h>
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+VOID
+DIB_32BPP_AlphaBlendRow(PULONG, PULONG, ULONG, UCHAR, BOOLEAN);
+
+VOID
+DIB_32BPP_StretchRow(PULONG, PULONG, LONG, ULONG, ULONG, ULONG, ULONG);
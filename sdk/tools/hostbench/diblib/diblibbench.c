@@ -0,0 +1,479 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Conformance and throughput of the DibLib BitBlt functions
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include "DibLib.h"
+
+#include "../hostbench.h"
+
+/*
+ * The blts are set up the way EngBitBlt() does it for a single rectangle,
+ * including the special formats it uses when source and target are the
+ * same surface, and go through gapfnDibFunction[] like it does.
+ *
+ * Every ROP is first checked against a per pixel model built on gapfnRop[],
+ * for many widths and offsets, between two surfaces and within one. Then the
+ * per pixel functions, which a non-trivial XLATEOBJ still gets, are timed
+ * against what a trivial one gets now.
+ */
+
+#define VERIFY_CX       160
+#define VERIFY_CY       8
+#define BENCH_CX        1024
+#define BENCH_CY        768
+
+typedef struct _SURFACE
+{
+    ULONG iFormat;
+    LONG cx;
+    LONG cy;
+    LONG lDelta;
+    PBYTE pvBits;
+} SURFACE, *PSURFACE;
+
+typedef struct _BENCH_ROP
+{
+    const char *Name;
+    ULONG Rop;
+    BOOL bUsesSource;
+    BOOL bUsesBrush;
+    PFN_DIBFUNCTION (*papfnGeneric)[7];     /* [dst][src], with a source */
+    PFN_DIBFUNCTION *apfnGeneric;           /* [dst], without one */
+} BENCH_ROP;
+
+typedef struct _BENCH_CONTEXT
+{
+    const BENCH_ROP *Rop;
+    PSURFACE Dst;
+    PSURFACE Src;
+    BOOL bGeneric;
+} BENCH_CONTEXT;
+
+extern PFN_DIBFUNCTION gapfnBitBlt_SRCCOPY[7][7];
+extern PFN_DIBFUNCTION gapfnBitBlt_NOTSRCCOPY[7][7];
+extern PFN_DIBFUNCTION gapfnBitBlt_SRCAND[7][7];
+extern PFN_DIBFUNCTION gapfnBitBlt_SRCPAINT[7][7];
+extern PFN_DIBFUNCTION gapfnBitBlt_SRCINVERT[7][7];
+extern PFN_DIBFUNCTION gapfnBitBlt_SRCERASE[7][7];
+extern PFN_DIBFUNCTION gapfnBitBlt_NOTSRCERASE[7][7];
+extern PFN_DIBFUNCTION gapfnBitBlt_MERGEPAINT[7][7];
+extern PFN_DIBFUNCTION gapfnBitBlt_MERGECOPY_Solid[7][7];
+extern PFN_DIBFUNCTION gapfnBitBlt_PATPAINT_Solid[7][7];
+extern PFN_DIBFUNCTION gapfnBitBlt_PATCOPY_Solid[7];
+extern PFN_DIBFUNCTION gapfnBitBlt_PATINVERT_Solid[7];
+extern PFN_DIBFUNCTION gapfnBitBlt_DSTINVERT[7];
+
+static const BENCH_ROP Rops[] =
+{
+    { "SRCCOPY",     0xCC, TRUE,  FALSE, gapfnBitBlt_SRCCOPY,         NULL },
+    { "NOTSRCCOPY",  0x33, TRUE,  FALSE, gapfnBitBlt_NOTSRCCOPY,      NULL },
+    { "SRCAND",      0x88, TRUE,  FALSE, gapfnBitBlt_SRCAND,          NULL },
+    { "SRCPAINT",    0xEE, TRUE,  FALSE, gapfnBitBlt_SRCPAINT,        NULL },
+    { "SRCINVERT",   0x66, TRUE,  FALSE, gapfnBitBlt_SRCINVERT,       NULL },
+    { "SRCERASE",    0x44, TRUE,  FALSE, gapfnBitBlt_SRCERASE,        NULL },
+    { "NOTSRCERASE", 0x11, TRUE,  FALSE, gapfnBitBlt_NOTSRCERASE,     NULL },
+    { "MERGEPAINT",  0xBB, TRUE,  FALSE, gapfnBitBlt_MERGEPAINT,      NULL },
+    { "MERGECOPY",   0xC0, TRUE,  TRUE,  gapfnBitBlt_MERGECOPY_Solid, NULL },
+    { "PATPAINT",    0xFB, TRUE,  TRUE,  gapfnBitBlt_PATPAINT_Solid,  NULL },
+    { "PATCOPY",     0xF0, FALSE, TRUE,  NULL, gapfnBitBlt_PATCOPY_Solid },
+    { "PATINVERT",   0x5A, FALSE, TRUE,  NULL, gapfnBitBlt_PATINVERT_Solid },
+    { "DSTINVERT",   0x55, FALSE, FALSE, NULL, gapfnBitBlt_DSTINVERT },
+    { "NOTPATCOPY",  0x0F, FALSE, TRUE,  NULL, NULL },
+    { "BLACKNESS",   0x00, FALSE, FALSE, NULL, NULL },
+    { "WHITENESS",   0xFF, FALSE, FALSE, NULL, NULL },
+};
+
+static const BYTE BitsPerFormat[7] = { 0, 1, 4, 8, 16, 24, 32 };
+
+/* The bit packing of 1 and 4 bpp is not modeled, these are the formats checked */
+static const ULONG Formats[] = { BMF_8BPP, BMF_16BPP, BMF_24BPP, BMF_32BPP };
+
+#define SOLID_COLOR 0x5AC3E10F
+
+static XLATEOBJ XlateTrivial = { 0, XO_TRIVIAL, 0, 0, 0, NULL };
+
+/* Does the same, but the DIB functions can't know that */
+static XLATEOBJ XlateIdentity = { 0, 0, 0, 0, 0, NULL };
+
+ULONG APIENTRY
+XLATEOBJ_iXlate(XLATEOBJ *pxlo, ULONG iColor)
+{
+    UNREFERENCED_PARAMETER(pxlo);
+    return iColor;
+}
+
+static ULONG FASTCALL
+XlateIdentityColor(XLATEOBJ *pxlo, ULONG ulColor)
+{
+    UNREFERENCED_PARAMETER(pxlo);
+    return ulColor;
+}
+
+static ULONG
+Random32(void)
+{
+    static ULONG Seed = 0x12345678;
+
+    /* xorshift32 */
+    Seed ^= Seed << 13;
+    Seed ^= Seed >> 17;
+    Seed ^= Seed << 5;
+    return Seed;
+}
+
+static void
+SurfaceCreate(PSURFACE Surface, ULONG iFormat, LONG cx, LONG cy)
+{
+    LONG i;
+
+    Surface->iFormat = iFormat;
+    Surface->cx = cx;
+    Surface->cy = cy;
+    Surface->lDelta = ((cx * BitsPerFormat[iFormat] + 31) & ~31) / 8;
+    Surface->pvBits = malloc((size_t)Surface->lDelta * cy);
+    if (!Surface->pvBits)
+    {
+        fprintf(stderr, "diblibbench: out of memory\n");
+        exit(1);
+    }
+
+    for (i = 0; i < Surface->lDelta * cy; i++)
+        Surface->pvBits[i] = (BYTE)Random32();
+}
+
+static ULONG
+SurfaceGetPixel(const SURFACE *Surface, const BYTE *pvBits, LONG x, LONG y)
+{
+    const BYTE *pj = pvBits + y * Surface->lDelta + x * BitsPerFormat[Surface->iFormat] / 8;
+
+    switch (Surface->iFormat)
+    {
+        case BMF_8BPP: return pj[0];
+        case BMF_16BPP: return pj[0] | (pj[1] << 8);
+        case BMF_24BPP: return pj[0] | (pj[1] << 8) | (pj[2] << 16);
+        default: return pj[0] | (pj[1] << 8) | (pj[2] << 16) | ((ULONG)pj[3] << 24);
+    }
+}
+
+static void
+SurfacePutPixel(const SURFACE *Surface, BYTE *pvBits, LONG x, LONG y, ULONG ulColor)
+{
+    BYTE *pj = pvBits + y * Surface->lDelta + x * BitsPerFormat[Surface->iFormat] / 8;
+    ULONG i;
+
+    for (i = 0; i < BitsPerFormat[Surface->iFormat] / 8u; i++)
+        pj[i] = (BYTE)(ulColor >> (i * 8));
+}
+
+/*
+ * Sets up pBltData for one rectangle like EngBitBlt() and CalculateCoordinates()
+ * do, and returns the function EngBitBlt() would call
+ */
+static PFN_DIBFUNCTION
+SetupBlt(
+    PBLTDATA pBltData,
+    const BENCH_ROP *Rop,
+    PSURFACE Dst,
+    LONG x, LONG y, LONG cx, LONG cy,
+    PSURFACE Src,
+    LONG xSrc, LONG ySrc,
+    XLATEOBJ *pxlo)
+{
+    LONG xOrg, yOrg;
+
+    memset(pBltData, 0, sizeof(*pBltData));
+    pBltData->dy = 1;
+    pBltData->rop4 = Rop->Rop | (Rop->Rop << 8);
+    pBltData->apfnDoRop[0] = gapfnRop[Rop->Rop];
+    pBltData->apfnDoRop[1] = gapfnRop[Rop->Rop];
+    pBltData->pxlo = pxlo;
+    pBltData->pfnXlate = XlateIdentityColor;
+    pBltData->ulSolidColor = Rop->bUsesBrush ? SOLID_COLOR : 0xFFFFFFFF;
+    pBltData->siDst.iFormat = Dst->iFormat;
+
+    if (Rop->bUsesSource)
+    {
+        if (Src == Dst)
+        {
+            if (y > ySrc)
+                pBltData->dy = -1;
+
+            if (y == ySrc && x > xSrc)
+            {
+                /* Right to left */
+                pBltData->siDst.iFormat = 0;
+                pBltData->siSrc.iFormat = Src->iFormat;
+            }
+            else
+            {
+                pBltData->siDst.iFormat = Dst->iFormat;
+                pBltData->siSrc.iFormat = 0;
+            }
+        }
+        else
+        {
+            pBltData->siSrc.iFormat = Src->iFormat;
+        }
+
+        pBltData->siSrc.pvScan0 = Src->pvBits;
+        pBltData->siSrc.lDelta = Src->lDelta;
+        pBltData->siSrc.cjAdvanceY = pBltData->dy * Src->lDelta;
+        pBltData->siSrc.jBpp = BitsPerFormat[Src->iFormat];
+    }
+
+    pBltData->siDst.pvScan0 = Dst->pvBits;
+    pBltData->siDst.lDelta = Dst->lDelta;
+    pBltData->siDst.cjAdvanceY = pBltData->dy * Dst->lDelta;
+    pBltData->siDst.jBpp = BitsPerFormat[Dst->iFormat];
+
+    pBltData->ulWidth = cx;
+    pBltData->ulHeight = cy;
+
+    xOrg = (pBltData->siDst.iFormat == 0) ? cx - 1 : 0;
+    yOrg = (pBltData->dy < 0) ? cy - 1 : 0;
+
+    pBltData->siDst.ptOrig.x = x + xOrg;
+    pBltData->siDst.ptOrig.y = y + yOrg;
+    pBltData->siDst.pjBase = pBltData->siDst.pvScan0 +
+                             pBltData->siDst.ptOrig.y * pBltData->siDst.lDelta +
+                             pBltData->siDst.ptOrig.x * pBltData->siDst.jBpp / 8;
+
+    if (Rop->bUsesSource)
+    {
+        pBltData->siSrc.ptOrig.x = xSrc + xOrg;
+        pBltData->siSrc.ptOrig.y = ySrc + yOrg;
+        pBltData->siSrc.pjBase = pBltData->siSrc.pvScan0 +
+                                 pBltData->siSrc.ptOrig.y * pBltData->siSrc.lDelta +
+                                 pBltData->siSrc.ptOrig.x * pBltData->siSrc.jBpp / 8;
+    }
+
+    return gapfnDibFunction[gajIndexPerRop[Rop->Rop]];
+}
+
+static PFN_DIBFUNCTION
+GetGenericFunction(const BENCH_ROP *Rop, const BLTDATA *pBltData)
+{
+    if (Rop->papfnGeneric)
+        return Rop->papfnGeneric[pBltData->siDst.iFormat][pBltData->siSrc.iFormat];
+    return Rop->apfnGeneric[pBltData->siDst.iFormat];
+}
+
+/* Applies the ROP to a copy of the surfaces, one pixel at a time */
+static void
+ModelBlt(
+    const BENCH_ROP *Rop,
+    PSURFACE Dst, BYTE *pvExpected,
+    LONG x, LONG y, LONG cx, LONG cy,
+    PSURFACE Src, const BYTE *pvSrcBefore,
+    LONG xSrc, LONG ySrc)
+{
+    ULONG ulMask = (Dst->iFormat == BMF_32BPP) ? 0xFFFFFFFF : (1u << BitsPerFormat[Dst->iFormat]) - 1;
+    ULONG D, S = 0, P = SOLID_COLOR, ulColor;
+    LONG i, j;
+
+    for (j = 0; j < cy; j++)
+    {
+        for (i = 0; i < cx; i++)
+        {
+            D = SurfaceGetPixel(Dst, Dst->pvBits, x + i, y + j);
+            if (Rop->bUsesSource)
+                S = SurfaceGetPixel(Src, pvSrcBefore, xSrc + i, ySrc + j);
+
+            /* ROP_1 is 1, WHITENESS fills with the translated white */
+            if (Rop->Rop == 0xFF)
+                ulColor = XLATEOBJ_iXlate(&XlateTrivial, 0xFFFFFF);
+            else
+                ulColor = gapfnRop[Rop->Rop](D, S, P);
+
+            SurfacePutPixel(Dst, pvExpected, x + i, y + j, ulColor & ulMask);
+        }
+    }
+}
+
+static int
+VerifyBlt(
+    const BENCH_ROP *Rop,
+    PSURFACE Dst,
+    LONG x, LONG y, LONG cx, LONG cy,
+    PSURFACE Src,
+    LONG xSrc, LONG ySrc,
+    XLATEOBJ *pxlo,
+    BYTE *pvExpected,
+    BYTE *pvSrcBefore)
+{
+    size_t cjDst = (size_t)Dst->lDelta * Dst->cy;
+    PFN_DIBFUNCTION pfnBitBlt;
+    BLTDATA BltData;
+
+    if (Rop->bUsesSource)
+        memcpy(pvSrcBefore, Src->pvBits, (size_t)Src->lDelta * Src->cy);
+
+    memcpy(pvExpected, Dst->pvBits, cjDst);
+    ModelBlt(Rop, Dst, pvExpected, x, y, cx, cy, Src, pvSrcBefore, xSrc, ySrc);
+
+    pfnBitBlt = SetupBlt(&BltData, Rop, Dst, x, y, cx, cy, Src, xSrc, ySrc, pxlo);
+    pfnBitBlt(&BltData);
+
+    if (memcmp(pvExpected, Dst->pvBits, cjDst) != 0)
+    {
+        fprintf(stderr, "diblibbench: %s %ubpp%s%s at (%ld,%ld) %ldx%ld from (%ld,%ld) differs\n",
+                Rop->Name, BitsPerFormat[Dst->iFormat],
+                (Src == Dst) ? " same surface" : "",
+                (pxlo == &XlateTrivial) ? "" : " non-trivial xlate",
+                (long)x, (long)y, (long)cx, (long)cy, (long)xSrc, (long)ySrc);
+
+        /* Start over from a known state */
+        memcpy(Dst->pvBits, pvExpected, cjDst);
+        return 1;
+    }
+
+    return 0;
+}
+
+static int
+VerifyRops(void)
+{
+    static const LONG Widths[] = { 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33,
+                                   47, 63, 64, 65, 100, 127, 128, 129, 150 };
+    SURFACE Dst, Src;
+    BYTE *pvExpected, *pvSrcBefore;
+    ULONG f, r, w;
+    LONG dx, sx, sy;
+    int Failures = 0;
+    unsigned long Count = 0;
+
+    for (f = 0; f < sizeof(Formats) / sizeof(Formats[0]); f++)
+    {
+        SurfaceCreate(&Dst, Formats[f], VERIFY_CX, VERIFY_CY);
+        SurfaceCreate(&Src, Formats[f], VERIFY_CX, VERIFY_CY);
+        pvExpected = malloc((size_t)Dst.lDelta * Dst.cy);
+        pvSrcBefore = malloc((size_t)Src.lDelta * Src.cy);
+        if (!pvExpected || !pvSrcBefore)
+        {
+            fprintf(stderr, "diblibbench: out of memory\n");
+            exit(1);
+        }
+
+        for (r = 0; r < sizeof(Rops) / sizeof(Rops[0]); r++)
+        {
+            for (w = 0; w < sizeof(Widths) / sizeof(Widths[0]); w++)
+            {
+                for (dx = 0; dx < 4; dx++)
+                {
+                    /* Between two surfaces, with and without color translation */
+                    for (sx = 0; sx < 4; sx++)
+                    {
+                        Failures += VerifyBlt(&Rops[r], &Dst, dx, 1, Widths[w], 5,
+                                              &Src, sx, 2, &XlateTrivial, pvExpected, pvSrcBefore);
+                        Failures += VerifyBlt(&Rops[r], &Dst, dx, 1, Widths[w], 5,
+                                              &Src, sx, 2, &XlateIdentity, pvExpected, pvSrcBefore);
+                        Count += 2;
+                    }
+
+                    if (!Rops[r].bUsesSource)
+                        continue;
+
+                    /* Within one surface: up, down, left and right */
+                    for (sx = 0; sx < 4; sx++)
+                    {
+                        for (sy = 0; sy < 3; sy++)
+                        {
+                            Failures += VerifyBlt(&Rops[r], &Dst, dx, 1, Widths[w], 5,
+                                                  &Dst, sx, sy, &XlateTrivial, pvExpected, pvSrcBefore);
+                            Count++;
+                        }
+                    }
+                }
+            }
+        }
+
+        free(pvSrcBefore);
+        free(pvExpected);
+        free(Src.pvBits);
+        free(Dst.pvBits);
+    }
+
+    printf("%lu blts checked, %d differ\n", Count, Failures);
+    return Failures;
+}
+
+static void
+BenchRoutine(PHB_THREAD Thread)
+{
+    BENCH_CONTEXT *Context = Thread->Context;
+    PFN_DIBFUNCTION pfnBitBlt;
+    BLTDATA BltData;
+
+    do
+    {
+        pfnBitBlt = SetupBlt(&BltData, Context->Rop, Context->Dst, 0, 0, BENCH_CX, BENCH_CY,
+                             Context->Src, 0, 0, &XlateTrivial);
+        if (Context->bGeneric)
+            pfnBitBlt = GetGenericFunction(Context->Rop, &BltData);
+
+        pfnBitBlt(&BltData);
+        Thread->Operations += (uint64_t)BENCH_CX * BENCH_CY;
+    } while (!HbShouldStop(Thread));
+}
+
+static void
+RunBenchmarks(void)
+{
+    static const ULONG BenchFormats[] = { BMF_16BPP, BMF_32BPP };
+    BENCH_CONTEXT Context;
+    SURFACE Dst, Src;
+    HB_RESULT Result;
+    char Name[64];
+    ULONG f, r, i;
+
+    HbReportHeader("DibLib BitBlt, 1024x768 (operations are pixels)");
+
+    for (f = 0; f < sizeof(BenchFormats) / sizeof(BenchFormats[0]); f++)
+    {
+        SurfaceCreate(&Dst, BenchFormats[f], BENCH_CX, BENCH_CY);
+        SurfaceCreate(&Src, BenchFormats[f], BENCH_CX, BENCH_CY);
+
+        for (r = 0; r < sizeof(Rops) / sizeof(Rops[0]); r++)
+        {
+            /* Only the ROPs that have their own per pixel functions */
+            if (!Rops[r].papfnGeneric && !Rops[r].apfnGeneric)
+                continue;
+
+            Context.Rop = &Rops[r];
+            Context.Dst = &Dst;
+            Context.Src = &Src;
+
+            for (i = 0; i < 2; i++)
+            {
+                Context.bGeneric = (i == 0);
+                snprintf(Name, sizeof(Name), "%s %ubpp %s", Rops[r].Name,
+                         BitsPerFormat[BenchFormats[f]],
+                         Context.bGeneric ? "per pixel" : "now");
+                if (!HbSelected(Name))
+                    continue;
+
+                HbRun(BenchRoutine, &Context, 1, HbOptions.DurationMs, &Result);
+                HbReport(Name, &Result);
+            }
+        }
+
+        free(Src.pvBits);
+        free(Dst.pvBits);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    if (HbParseOptions(argc, argv, NULL))
+        return 1;
+
+    if (VerifyRops())
+        return 1;
+
+    RunBenchmarks();
+    return 0;
+}
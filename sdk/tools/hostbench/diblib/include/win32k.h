@@ -0,0 +1,11 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     What the raw bit row functions use from win32k.h, for the host compiler
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+/* The row functions are declared there as well */
+#include "DibLib.h"
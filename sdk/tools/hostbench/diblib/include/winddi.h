@@ -0,0 +1,31 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     The few DDI definitions DibLib uses, for the host compiler
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#define BMF_1BPP    1
+#define BMF_4BPP    2
+#define BMF_8BPP    3
+#define BMF_16BPP   4
+#define BMF_24BPP   5
+#define BMF_32BPP   6
+
+#define XO_TRIVIAL  0x00000001
+
+typedef struct _XLATEOBJ
+{
+    ULONG iUniq;
+    FLONG flXlate;
+    USHORT iSrcType;
+    USHORT iDstType;
+    ULONG cEntries;
+    ULONG *pulXlate;
+} XLATEOBJ;
+
+/* Provided by the benchmark */
+ULONG APIENTRY
+XLATEOBJ_iXlate(XLATEOBJ *pxlo, ULONG iColor);
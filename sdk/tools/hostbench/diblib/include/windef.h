@@ -0,0 +1,51 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Minimal Windows environment for building DibLib on the host
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/* DibLib picks its x86 and amd64 code with the MSVC architecture macros */
+#if defined(__x86_64__)
+#define _M_AMD64 1
+#define _WIN64 1
+#elif defined(__i386__)
+#define _M_IX86 1
+#endif
+
+#include <typedefs.h>
+
+/* DibLib uses the host calling convention everywhere */
+#undef __fastcall
+#define __fastcall
+
+#define APIENTRY
+#define UNALIGNED
+#define UNREFERENCED_PARAMETER(P) ((void)(P))
+
+typedef BYTE *PBYTE;
+typedef ULONG FLONG;
+
+typedef struct _POINTL
+{
+    LONG x;
+    LONG y;
+} POINTL, *PPOINTL;
+
+#if defined(__x86_64__) || defined(__i386__)
+static __inline void
+__movsd(ULONG *Destination, const ULONG *Source, size_t Count)
+{
+    __asm__ __volatile__("rep movsl"
+                         : "+D" (Destination), "+S" (Source), "+c" (Count)
+                         :
+                         : "memory");
+}
+#endif
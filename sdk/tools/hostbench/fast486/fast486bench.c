@@ -0,0 +1,780 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Conformance and throughput of the Fast486 CPU emulator
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <windef.h>
+#include <fast486.h>
+
+#include "../hostbench.h"
+
+/*
+ * Every test is a small program that runs on a flat memory machine and ends
+ * with HLT. It is first run once and its final state compared with what a C
+ * model of the same loop computes, then run over and over for the timing.
+ * The operations reported are the instructions stepped by the host, REP
+ * string instructions can take more than one step.
+ */
+
+#define RAM_SIZE        (4 * 1024 * 1024)
+
+/* Real mode layout */
+#define CODE_SEGMENT    0x1000
+#define STACK_SEGMENT   0x2000
+#define DATA_SEGMENT    0x3000
+
+/* Protected mode layout, everything is identity mapped */
+#define GDTR_ADDRESS    0x800
+#define GDT_ADDRESS     0x880
+#define PAGE_DIRECTORY  0x100000
+#define PAGE_TABLE      0x101000
+#define PM_STACK        0x90000
+#define PM_DATA         0x200000
+
+/* Tests that don't halt after that many instructions have failed */
+#define MAX_STEPS       10000000
+
+typedef struct _MACHINE
+{
+    FAST486_STATE State;
+    FAST486_MEMORY_TLB_ENTRY MemoryTlb[FAST486_MEMORY_TLB_SIZE];
+    PUCHAR Memory;
+    ULONGLONG Steps;
+    ULONGLONG MemoryCallbacks;
+} MACHINE, *PMACHINE;
+
+typedef struct _F486_TEST
+{
+    const char *Name;
+    const UCHAR *Code;
+    ULONG CodeSize;
+    VOID (*Setup)(PMACHINE Machine);
+    BOOLEAN (*Verify)(PMACHINE Machine);
+} F486_TEST, *PF486_TEST;
+
+/*
+ * The test programs. The real mode ones are loaded at 1000:0000, with
+ * DS = ES = 0 unless the setup routine says otherwise, and SS:SP = 2000:FFFE.
+ */
+
+static const UCHAR AluCode[] =
+{
+    0xB9, 0x10, 0x27,                        /* 0000: mov cx,0x2710 */
+    0x31, 0xC0,                              /* 0003: xor ax,ax */
+    0x31, 0xDB,                              /* 0005: xor bx,bx */
+    0x31, 0xD2,                              /* 0007: xor dx,dx */
+    0xBE, 0x34, 0x12,                        /* 0009: mov si,0x1234 */
+    0x01, 0xC8,                              /* 000C: add ax,cx */
+    0x83, 0xD2, 0x00,                        /* 000E: adc dx,0x0 */
+    0x31, 0xC6,                              /* 0011: xor si,ax */
+    0xC1, 0xC6, 0x03,                        /* 0013: rol si,0x3 */
+    0x43,                                    /* 0016: inc bx */
+    0xE2, 0xF3,                              /* 0017: loop 0xc */
+    0xF4,                                    /* 0019: hlt */
+};
+
+static const UCHAR MulDivCode[] =
+{
+    0xB9, 0xD0, 0x07,                        /* 0000: mov cx,0x7d0 */
+    0xBB, 0x07, 0x00,                        /* 0003: mov bx,0x7 */
+    0x31, 0xFF,                              /* 0006: xor di,di */
+    0x31, 0xED,                              /* 0008: xor bp,bp */
+    0x89, 0xC8,                              /* 000A: mov ax,cx */
+    0xF7, 0xE3,                              /* 000C: mul bx */
+    0x83, 0xC0, 0x03,                        /* 000E: add ax,0x3 */
+    0x83, 0xD2, 0x00,                        /* 0011: adc dx,0x0 */
+    0xF7, 0xF3,                              /* 0014: div bx */
+    0x01, 0xC7,                              /* 0016: add di,ax */
+    0x01, 0xD5,                              /* 0018: add bp,dx */
+    0x6B, 0xC1, 0xFB,                        /* 001A: imul ax,cx,0xfffb */
+    0x99,                                    /* 001D: cwd */
+    0xF7, 0xFB,                              /* 001E: idiv bx */
+    0x29, 0xC7,                              /* 0020: sub di,ax */
+    0xE2, 0xE6,                              /* 0022: loop 0xa */
+    0xF4,                                    /* 0024: hlt */
+};
+
+static const UCHAR StringCode[] =
+{
+    0xBD, 0xC8, 0x00,                        /* 0000: mov bp,0xc8 */
+    0xFC,                                    /* 0003: cld */
+    0x31, 0xF6,                              /* 0004: xor si,si */
+    0xBF, 0x00, 0x80,                        /* 0006: mov di,0x8000 */
+    0xB9, 0x00, 0x01,                        /* 0009: mov cx,0x100 */
+    0xF3, 0xA5,                              /* 000C: rep movs WORD PTR es:[di],WORD PTR ds:[si] */
+    0x89, 0xE8,                              /* 000E: mov ax,bp */
+    0xBF, 0x00, 0x40,                        /* 0010: mov di,0x4000 */
+    0xB9, 0x00, 0x02,                        /* 0013: mov cx,0x200 */
+    0xF3, 0xAA,                              /* 0016: rep stos BYTE PTR es:[di],al */
+    0xBE, 0x00, 0x80,                        /* 0018: mov si,0x8000 */
+    0xAD,                                    /* 001B: lods ax,WORD PTR ds:[si] */
+    0x01, 0xC3,                              /* 001C: add bx,ax */
+    0x4D,                                    /* 001E: dec bp */
+    0x75, 0xE3,                              /* 001F: jne 0x4 */
+    0xF4,                                    /* 0021: hlt */
+};
+
+static const UCHAR BranchCode[] =
+{
+    0xB9, 0x88, 0x13,                        /* 0000: mov cx,0x1388 */
+    0x31, 0xC0,                              /* 0003: xor ax,ax */
+    0x31, 0xD2,                              /* 0005: xor dx,dx */
+    0xE8, 0x0A, 0x00,                        /* 0007: call 0x14 */
+    0xF7, 0xC1, 0x01, 0x00,                  /* 000A: test cx,0x1 */
+    0x74, 0x01,                              /* 000E: je 0x11 */
+    0x42,                                    /* 0010: inc dx */
+    0xE2, 0xF4,                              /* 0011: loop 0x7 */
+    0xF4,                                    /* 0013: hlt */
+    0x40,                                    /* 0014: inc ax */
+    0xC3,                                    /* 0015: ret */
+};
+
+static const UCHAR MemoryCode[] =
+{
+    0xB9, 0xB8, 0x0B,                        /* 0000: mov cx,0xbb8 */
+    0xBB, 0x00, 0x01,                        /* 0003: mov bx,0x100 */
+    0x89, 0xCE,                              /* 0006: mov si,cx */
+    0x81, 0xE6, 0xFE, 0x00,                  /* 0008: and si,0xfe */
+    0x8B, 0x00,                              /* 000C: mov ax,WORD PTR [bx+si] */
+    0x01, 0xC8,                              /* 000E: add ax,cx */
+    0x89, 0x00,                              /* 0010: mov WORD PTR [bx+si],ax */
+    0x50,                                    /* 0012: push ax */
+    0x5A,                                    /* 0013: pop dx */
+    0x87, 0x50, 0x02,                        /* 0014: xchg WORD PTR [bx+si+0x2],dx */
+    0xE2, 0xED,                              /* 0017: loop 0x6 */
+    0xF4,                                    /* 0019: hlt */
+};
+
+static const UCHAR FpuCode[] =
+{
+    0xDB, 0xE3,                              /* 0000: fninit */
+    0xD9, 0xEE,                              /* 0002: fldz */
+    0xB9, 0xE8, 0x03,                        /* 0004: mov cx,0x3e8 */
+    0xD9, 0xE8,                              /* 0007: fld1 */
+    0xDE, 0xC1,                              /* 0009: faddp st(1),st */
+    0xE2, 0xFA,                              /* 000B: loop 0x7 */
+    0xDF, 0x1E, 0x00, 0x05,                  /* 000D: fistp WORD PTR ds:0x500 */
+    0xF4,                                    /* 0011: hlt */
+};
+
+static const UCHAR SelfModCode[] =
+{
+    0xB9, 0x64, 0x00,                        /* 0000: mov cx,0x64 */
+    0x31, 0xDB,                              /* 0003: xor bx,bx */
+    0x83, 0xC3, 0x01,                        /* 0005: add bx,0x1 */
+    0x2E, 0xFE, 0x06, 0x07, 0x00,            /* 0008: inc BYTE PTR cs:0x7 */
+    0xE2, 0xF6,                              /* 000D: loop 0x5 */
+    0xF4,                                    /* 000F: hlt */
+};
+
+static const UCHAR Pm32Code[] =
+{
+    0xFA,                                    /* 0000: cli */
+    0x66, 0x0F, 0x01, 0x16, 0x00, 0x08,      /* 0001: lgdtd ds:0x800 */
+    0x0F, 0x20, 0xC0,                        /* 0007: mov eax,cr0 */
+    0x0C, 0x01,                              /* 000A: or al,0x1 */
+    0x0F, 0x22, 0xC0,                        /* 000C: mov cr0,eax */
+    0x66, 0xEA, 0x17, 0x00, 0x01, 0x00, 0x08, 0x00, /* 000F: jmp 0x8:0x10017 */
+    0x66, 0xB8, 0x10, 0x00,                  /* 0017: mov ax,0x10 */
+    0x8E, 0xD8,                              /* 001B: mov ds,ax */
+    0x8E, 0xC0,                              /* 001D: mov es,ax */
+    0x8E, 0xD0,                              /* 001F: mov ss,ax */
+    0xBC, 0x00, 0x00, 0x09, 0x00,            /* 0021: mov esp,0x90000 */
+    0xB9, 0x10, 0x27, 0x00, 0x00,            /* 0026: mov ecx,0x2710 */
+    0x31, 0xC0,                              /* 002B: xor eax,eax */
+    0x31, 0xD2,                              /* 002D: xor edx,edx */
+    0xBE, 0x00, 0x00, 0x20, 0x00,            /* 002F: mov esi,0x200000 */
+    0x01, 0xC8,                              /* 0034: add eax,ecx */
+    0x89, 0x04, 0x96,                        /* 0036: mov DWORD PTR [esi+edx*4],eax */
+    0x42,                                    /* 0039: inc edx */
+    0x81, 0xE2, 0xFF, 0x0F, 0x00, 0x00,      /* 003A: and edx,0xfff */
+    0x51,                                    /* 0040: push ecx */
+    0x5B,                                    /* 0041: pop ebx */
+    0x49,                                    /* 0042: dec ecx */
+    0x75, 0xEF,                              /* 0043: jne 0x34 */
+    0xF4,                                    /* 0045: hlt */
+};
+
+static const UCHAR PagingCode[] =
+{
+    0xFA,                                    /* 0000: cli */
+    0x66, 0x0F, 0x01, 0x16, 0x00, 0x08,      /* 0001: lgdtd ds:0x800 */
+    0x0F, 0x20, 0xC0,                        /* 0007: mov eax,cr0 */
+    0x0C, 0x01,                              /* 000A: or al,0x1 */
+    0x0F, 0x22, 0xC0,                        /* 000C: mov cr0,eax */
+    0x66, 0xEA, 0x17, 0x00, 0x01, 0x00, 0x08, 0x00, /* 000F: jmp 0x8:0x10017 */
+    0x66, 0xB8, 0x10, 0x00,                  /* 0017: mov ax,0x10 */
+    0x8E, 0xD8,                              /* 001B: mov ds,ax */
+    0x8E, 0xC0,                              /* 001D: mov es,ax */
+    0x8E, 0xD0,                              /* 001F: mov ss,ax */
+    0xBC, 0x00, 0x00, 0x09, 0x00,            /* 0021: mov esp,0x90000 */
+    0xB8, 0x00, 0x00, 0x10, 0x00,            /* 0026: mov eax,0x100000 */
+    0x0F, 0x22, 0xD8,                        /* 002B: mov cr3,eax */
+    0x0F, 0x20, 0xC0,                        /* 002E: mov eax,cr0 */
+    0x0D, 0x00, 0x00, 0x00, 0x80,            /* 0031: or eax,0x80000000 */
+    0x0F, 0x22, 0xC0,                        /* 0036: mov cr0,eax */
+    0xEB, 0x00,                              /* 0039: jmp 0x3b */
+    0xB9, 0x10, 0x27, 0x00, 0x00,            /* 003B: mov ecx,0x2710 */
+    0x31, 0xC0,                              /* 0040: xor eax,eax */
+    0x31, 0xD2,                              /* 0042: xor edx,edx */
+    0xBE, 0x00, 0x00, 0x20, 0x00,            /* 0044: mov esi,0x200000 */
+    0x01, 0xC8,                              /* 0049: add eax,ecx */
+    0x89, 0x04, 0x96,                        /* 004B: mov DWORD PTR [esi+edx*4],eax */
+    0x42,                                    /* 004E: inc edx */
+    0x81, 0xE2, 0xFF, 0x0F, 0x00, 0x00,      /* 004F: and edx,0xfff */
+    0x51,                                    /* 0055: push ecx */
+    0x5B,                                    /* 0056: pop ebx */
+    0x49,                                    /* 0057: dec ecx */
+    0x75, 0xEF,                              /* 0058: jne 0x49 */
+    0xF4,                                    /* 005A: hlt */
+};
+
+/*
+ * The machine
+ */
+
+static VOID
+FASTCALL
+MachineReadMemory(PFAST486_STATE State, ULONG Address, PVOID Buffer, ULONG Size)
+{
+    PMACHINE Machine = CONTAINING_RECORD(State, MACHINE, State);
+
+    Machine->MemoryCallbacks++;
+
+    if (Address >= RAM_SIZE || Size > RAM_SIZE - Address)
+    {
+        /* Open bus */
+        memset(Buffer, 0xFF, Size);
+        return;
+    }
+
+    memcpy(Buffer, Machine->Memory + Address, Size);
+}
+
+static VOID
+FASTCALL
+MachineWriteMemory(PFAST486_STATE State, ULONG Address, PVOID Buffer, ULONG Size)
+{
+    PMACHINE Machine = CONTAINING_RECORD(State, MACHINE, State);
+
+    Machine->MemoryCallbacks++;
+
+    if (Address >= RAM_SIZE || Size > RAM_SIZE - Address)
+        return;
+
+    memcpy(Machine->Memory + Address, Buffer, Size);
+}
+
+/* All of the RAM can be accessed directly */
+static PVOID
+FASTCALL
+MachineMapMemory(PFAST486_STATE State, ULONG Address, BOOLEAN Write)
+{
+    PMACHINE Machine = CONTAINING_RECORD(State, MACHINE, State);
+
+    if (Address >= RAM_SIZE)
+        return NULL;
+
+    return Machine->Memory + (Address & ~0xFFF);
+}
+
+static PMACHINE
+MachineCreate(BOOLEAN MapMemory)
+{
+    PMACHINE Machine = calloc(1, sizeof(*Machine));
+
+    if (!Machine)
+        return NULL;
+
+    Machine->Memory = calloc(1, RAM_SIZE);
+    if (!Machine->Memory)
+    {
+        free(Machine);
+        return NULL;
+    }
+
+    /* Ports and BOPs are not used by the tests */
+    Fast486Initialize(&Machine->State,
+                      MachineReadMemory,
+                      MachineWriteMemory,
+                      MachineMapMemory,
+                      NULL,
+                      NULL,
+                      NULL,
+                      NULL,
+                      NULL,
+                      NULL,
+                      MapMemory ? Machine->MemoryTlb : NULL);
+
+    return Machine;
+}
+
+static VOID
+MachineDestroy(PMACHINE Machine)
+{
+    free(Machine->Memory);
+    free(Machine);
+}
+
+static VOID
+MachineLoad(PMACHINE Machine, const F486_TEST *Test)
+{
+    Fast486Reset(&Machine->State);
+    Machine->Steps = 0;
+    Machine->MemoryCallbacks = 0;
+
+    memcpy(Machine->Memory + CODE_SEGMENT * 16, Test->Code, Test->CodeSize);
+
+    Fast486SetSegment(&Machine->State, FAST486_REG_DS, 0);
+    Fast486SetSegment(&Machine->State, FAST486_REG_ES, 0);
+    Fast486SetStack(&Machine->State, STACK_SEGMENT, 0xFFFE);
+
+    if (Test->Setup)
+        Test->Setup(Machine);
+
+    Fast486ExecuteAt(&Machine->State, CODE_SEGMENT, 0);
+}
+
+/* Run until HLT, returns FALSE if the program doesn't get there */
+static BOOLEAN
+MachineRun(PMACHINE Machine)
+{
+    while (!Machine->State.Halted)
+    {
+        if (Machine->Steps >= MAX_STEPS)
+            return FALSE;
+
+        Fast486StepInto(&Machine->State);
+        Machine->Steps++;
+    }
+
+    return TRUE;
+}
+
+#define REG16(Machine, Reg) ((Machine)->State.GeneralRegs[FAST486_REG_##Reg].LowWord)
+#define REG32(Machine, Reg) ((Machine)->State.GeneralRegs[FAST486_REG_##Reg].Long)
+
+static BOOLEAN
+Check(const char *What, ULONG Value, ULONG Expected)
+{
+    if (Value == Expected)
+        return TRUE;
+
+    fprintf(stderr, "fast486bench: %s is 0x%X, expected 0x%X\n",
+            What, (unsigned)Value, (unsigned)Expected);
+    return FALSE;
+}
+
+static USHORT
+ReadWord(PMACHINE Machine, ULONG Address)
+{
+    return (USHORT)(Machine->Memory[Address] | (Machine->Memory[Address + 1] << 8));
+}
+
+static ULONG
+ReadDword(PMACHINE Machine, ULONG Address)
+{
+    return ReadWord(Machine, Address) | ((ULONG)ReadWord(Machine, Address + 2) << 16);
+}
+
+/*
+ * Setup and C models of the test programs
+ */
+
+static BOOLEAN
+VerifyAlu(PMACHINE Machine)
+{
+    USHORT Ax = 0, Bx = 0, Dx = 0, Si = 0x1234, Cx;
+    BOOLEAN Ok = TRUE;
+
+    for (Cx = 10000; Cx != 0; Cx--)
+    {
+        ULONG Sum = (ULONG)Ax + Cx;
+
+        Ax = (USHORT)Sum;
+        Dx += (USHORT)(Sum >> 16);
+        Si ^= Ax;
+        Si = (USHORT)((Si << 3) | (Si >> 13));
+        Bx++;
+    }
+
+    Ok &= Check("AX", REG16(Machine, EAX), Ax);
+    Ok &= Check("BX", REG16(Machine, EBX), Bx);
+    Ok &= Check("CX", REG16(Machine, ECX), 0);
+    Ok &= Check("DX", REG16(Machine, EDX), Dx);
+    Ok &= Check("SI", REG16(Machine, ESI), Si);
+    return Ok;
+}
+
+static BOOLEAN
+VerifyMulDiv(PMACHINE Machine)
+{
+    USHORT Di = 0, Bp = 0, Cx;
+    SHORT Quotient = 0, Remainder = 0;
+    BOOLEAN Ok = TRUE;
+
+    for (Cx = 2000; Cx != 0; Cx--)
+    {
+        /* (CX * 7 + 3) / 7 */
+        Di += Cx;
+        Bp += 3;
+
+        /* CX * -5 / 7, truncated toward zero like IDIV */
+        Quotient = (SHORT)(Cx * -5) / 7;
+        Remainder = (SHORT)(Cx * -5) % 7;
+        Di -= Quotient;
+    }
+
+    Ok &= Check("AX", REG16(Machine, EAX), (USHORT)Quotient);
+    Ok &= Check("DX", REG16(Machine, EDX), (USHORT)Remainder);
+    Ok &= Check("DI", REG16(Machine, EDI), Di);
+    Ok &= Check("BP", REG16(Machine, EBP), Bp);
+    return Ok;
+}
+
+static VOID
+SetupString(PMACHINE Machine)
+{
+    ULONG i;
+
+    for (i = 0; i < 256; i++)
+    {
+        Machine->Memory[DATA_SEGMENT * 16 + i * 2] = (UCHAR)(i * 3 + 1);
+        Machine->Memory[DATA_SEGMENT * 16 + i * 2 + 1] = (UCHAR)i;
+    }
+
+    Fast486SetSegment(&Machine->State, FAST486_REG_DS, DATA_SEGMENT);
+    Fast486SetSegment(&Machine->State, FAST486_REG_ES, DATA_SEGMENT);
+}
+
+static BOOLEAN
+VerifyString(PMACHINE Machine)
+{
+    PUCHAR Data = Machine->Memory + DATA_SEGMENT * 16;
+    BOOLEAN Ok = TRUE;
+    ULONG i;
+
+    /* The last fill was done with BP = 1, and the first word is always 1 */
+    Ok &= Check("BX", REG16(Machine, EBX), 200);
+    Ok &= Check("SI", REG16(Machine, ESI), 0x8002);
+    Ok &= Check("DI", REG16(Machine, EDI), 0x4200);
+    Ok &= Check("copy", memcmp(Data + 0x8000, Data, 512), 0);
+
+    for (i = 0; i < 512 && Ok; i++)
+        Ok &= Check("fill", Data[0x4000 + i], 1);
+
+    return Ok;
+}
+
+static BOOLEAN
+VerifyBranch(PMACHINE Machine)
+{
+    BOOLEAN Ok = TRUE;
+
+    Ok &= Check("AX", REG16(Machine, EAX), 5000);
+    Ok &= Check("DX", REG16(Machine, EDX), 2500);
+    Ok &= Check("SP", REG16(Machine, ESP), 0xFFFE);
+    return Ok;
+}
+
+static VOID
+SetupMemory(PMACHINE Machine)
+{
+    memset(Machine->Memory + 0x100, 0, 0x104);
+}
+
+static BOOLEAN
+VerifyMemory(PMACHINE Machine)
+{
+    USHORT Words[0x82] = { 0 };
+    USHORT Ax = 0, Dx = 0, Cx, Temp;
+    BOOLEAN Ok = TRUE;
+    ULONG i;
+
+    for (Cx = 3000; Cx != 0; Cx--)
+    {
+        i = (Cx & 0xFE) / 2;
+
+        Ax = Words[i] + Cx;
+        Words[i] = Ax;
+        Dx = Ax;
+
+        Temp = Words[i + 1];
+        Words[i + 1] = Dx;
+        Dx = Temp;
+    }
+
+    Ok &= Check("AX", REG16(Machine, EAX), Ax);
+    Ok &= Check("DX", REG16(Machine, EDX), Dx);
+    Ok &= Check("SP", REG16(Machine, ESP), 0xFFFE);
+
+    for (i = 0; i < 0x82 && Ok; i++)
+        Ok &= Check("memory", ReadWord(Machine, 0x100 + i * 2), Words[i]);
+
+    return Ok;
+}
+
+static BOOLEAN
+VerifyFpu(PMACHINE Machine)
+{
+    return Check("result", ReadWord(Machine, 0x500), 1000);
+}
+
+static BOOLEAN
+VerifySelfMod(PMACHINE Machine)
+{
+    BOOLEAN Ok = TRUE;
+
+    /* Every iteration adds one more than the previous one */
+    Ok &= Check("BX", REG16(Machine, EBX), 5050);
+    Ok &= Check("immediate", Machine->Memory[CODE_SEGMENT * 16 + 7], 101);
+    return Ok;
+}
+
+static VOID
+SetupProtectedMode(PMACHINE Machine)
+{
+    /* Null, flat 32-bit code (0x08) and flat data (0x10) */
+    static const ULONGLONG Gdt[] =
+    {
+        0,
+        0x00CF9A000000FFFFULL,
+        0x00CF92000000FFFFULL,
+    };
+    ULONG i;
+
+    for (i = 0; i < sizeof(Gdt); i++)
+        Machine->Memory[GDT_ADDRESS + i] = (UCHAR)(Gdt[i / 8] >> ((i % 8) * 8));
+
+    Machine->Memory[GDTR_ADDRESS + 0] = sizeof(Gdt) - 1;
+    Machine->Memory[GDTR_ADDRESS + 1] = 0;
+    Machine->Memory[GDTR_ADDRESS + 2] = (UCHAR)GDT_ADDRESS;
+    Machine->Memory[GDTR_ADDRESS + 3] = (UCHAR)(GDT_ADDRESS >> 8);
+    Machine->Memory[GDTR_ADDRESS + 4] = 0;
+    Machine->Memory[GDTR_ADDRESS + 5] = 0;
+}
+
+static VOID
+SetupPaging(PMACHINE Machine)
+{
+    ULONG i, Entry;
+
+    SetupProtectedMode(Machine);
+
+    /* Identity map the first 4 MB with user, writable pages */
+    memset(Machine->Memory + PAGE_DIRECTORY, 0, 4096);
+    Entry = PAGE_TABLE | 7;
+    memcpy(Machine->Memory + PAGE_DIRECTORY, &Entry, sizeof(Entry));
+
+    for (i = 0; i < 1024; i++)
+    {
+        Entry = (i << 12) | 7;
+        memcpy(Machine->Memory + PAGE_TABLE + i * 4, &Entry, sizeof(Entry));
+    }
+}
+
+static BOOLEAN
+VerifyProtectedMode(PMACHINE Machine)
+{
+    static ULONG Table[4096];
+    ULONG Eax = 0, Edx = 0, Ecx;
+    BOOLEAN Ok = TRUE;
+    ULONG i;
+
+    for (Ecx = 10000; Ecx != 0; Ecx--)
+    {
+        Eax += Ecx;
+        Table[Edx] = Eax;
+        Edx = (Edx + 1) & 0xFFF;
+    }
+
+    Ok &= Check("CS", Machine->State.SegmentRegs[FAST486_REG_CS].Selector, 0x08);
+    Ok &= Check("EAX", REG32(Machine, EAX), Eax);
+    Ok &= Check("EBX", REG32(Machine, EBX), 1);
+    Ok &= Check("EDX", REG32(Machine, EDX), Edx);
+    Ok &= Check("ESP", REG32(Machine, ESP), PM_STACK);
+
+    for (i = 0; i < 4096 && Ok; i++)
+        Ok &= Check("memory", ReadDword(Machine, PM_DATA + i * 4), Table[i]);
+
+    return Ok;
+}
+
+static BOOLEAN
+VerifyPaging(PMACHINE Machine)
+{
+    BOOLEAN Ok = TRUE;
+
+    Ok &= Check("CR0.PG",
+                Machine->State.ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG,
+                FAST486_CR0_PG);
+    Ok &= VerifyProtectedMode(Machine);
+    return Ok;
+}
+
+#define TEST(Name, Code, Setup, Verify) { Name, Code, sizeof(Code), Setup, Verify }
+
+static const F486_TEST Tests[] =
+{
+    TEST("rm16/alu", AluCode, NULL, VerifyAlu),
+    TEST("rm16/muldiv", MulDivCode, NULL, VerifyMulDiv),
+    TEST("rm16/string", StringCode, SetupString, VerifyString),
+    TEST("rm16/branch", BranchCode, NULL, VerifyBranch),
+    TEST("rm16/memory", MemoryCode, SetupMemory, VerifyMemory),
+    TEST("rm16/fpu", FpuCode, NULL, VerifyFpu),
+    TEST("rm16/selfmod", SelfModCode, NULL, VerifySelfMod),
+    TEST("pm32/flat", Pm32Code, SetupProtectedMode, VerifyProtectedMode),
+    TEST("pm32/paging", PagingCode, SetupPaging, VerifyPaging),
+};
+
+#define TEST_COUNT (sizeof(Tests) / sizeof(Tests[0]))
+
+/*
+ * Every test runs with the RAM mapped for direct access, like NTVDM does,
+ * and with every access going through the memory callbacks.
+ */
+static const struct
+{
+    const char *Suffix;
+    BOOLEAN MapMemory;
+} Modes[] =
+{
+    { "", TRUE },
+    { "/callbacks", FALSE },
+};
+
+#define MODE_COUNT (sizeof(Modes) / sizeof(Modes[0]))
+
+/*
+ * Conformance
+ */
+
+static int
+RunConformance(VOID)
+{
+    PMACHINE Machine;
+    int Failures = 0;
+    char Name[64];
+    ULONG i, m;
+
+    printf("%-32s %14s %14s\n", "test", "instructions", "callbacks/inst");
+
+    for (m = 0; m < MODE_COUNT; m++)
+    {
+        Machine = MachineCreate(Modes[m].MapMemory);
+        if (!Machine)
+        {
+            fprintf(stderr, "fast486bench: out of memory\n");
+            return 1;
+        }
+
+        for (i = 0; i < TEST_COUNT; i++)
+        {
+            snprintf(Name, sizeof(Name), "%s%s", Tests[i].Name, Modes[m].Suffix);
+            if (!HbSelected(Name))
+                continue;
+
+            MachineLoad(Machine, &Tests[i]);
+            if (!MachineRun(Machine))
+            {
+                fprintf(stderr, "fast486bench: %s didn't halt\n", Name);
+                Failures++;
+                continue;
+            }
+
+            if (!Tests[i].Verify(Machine))
+            {
+                fprintf(stderr, "fast486bench: %s failed\n", Name);
+                Failures++;
+                continue;
+            }
+
+            printf("%-32s %14llu %14.2f\n",
+                   Name,
+                   (unsigned long long)Machine->Steps,
+                   (double)Machine->MemoryCallbacks / (double)Machine->Steps);
+        }
+
+        MachineDestroy(Machine);
+    }
+
+    return Failures;
+}
+
+/*
+ * Throughput
+ */
+
+typedef struct _BENCH_CONTEXT
+{
+    const F486_TEST *Test;
+    BOOLEAN MapMemory;
+} BENCH_CONTEXT, *PBENCH_CONTEXT;
+
+static void
+BenchTest(PHB_THREAD Thread)
+{
+    PBENCH_CONTEXT Context = Thread->Context;
+    PMACHINE Machine = MachineCreate(Context->MapMemory);
+
+    if (!Machine)
+        return;
+
+    do
+    {
+        MachineLoad(Machine, Context->Test);
+        MachineRun(Machine);
+        Thread->Operations += Machine->Steps;
+    } while (!HbShouldStop(Thread));
+
+    MachineDestroy(Machine);
+}
+
+static void
+RunBenchmarks(void)
+{
+    BENCH_CONTEXT Context;
+    HB_RESULT Result;
+    char Name[64];
+    ULONG i, m;
+
+    HbReportHeader("Fast486 (operations are instructions)");
+
+    for (i = 0; i < TEST_COUNT; i++)
+    {
+        for (m = 0; m < MODE_COUNT; m++)
+        {
+            snprintf(Name, sizeof(Name), "%s%s", Tests[i].Name, Modes[m].Suffix);
+            if (!HbSelected(Name))
+                continue;
+
+            Context.Test = &Tests[i];
+            Context.MapMemory = Modes[m].MapMemory;
+
+            HbRun(BenchTest, &Context, 1, HbOptions.DurationMs, &Result);
+            HbReport(Name, &Result);
+        }
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    int Failures;
+
+    if (HbParseOptions(argc, argv, NULL))
+        return 1;
+
+    Failures = RunConformance();
+    if (Failures)
+    {
+        fprintf(stderr, "fast486bench: %d tests failed\n", Failures);
+        return 1;
+    }
+
+    RunBenchmarks();
+
+    return 0;
+}
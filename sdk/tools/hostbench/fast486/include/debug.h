@@ -0,0 +1 @@
+/* DPRINT and friends come from typedefs.h */
@@ -0,0 +1,39 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Minimal Windows environment for building Fast486 on the host
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <typedefs.h>
+
+/* Fast486 uses the host calling convention everywhere */
+#undef __fastcall
+#define __fastcall
+
+#define FORCEINLINE static __inline __attribute__((always_inline))
+#define C_ASSERT(e) _Static_assert(e, #e)
+#define UNREFERENCED_PARAMETER(P) ((void)(P))
+
+#define UlongToPtr(ul) ((PVOID)(ULONG_PTR)(ULONG)(ul))
+#define DbgPrint printf
+
+#define RtlFillMemory(Destination, Length, Fill) memset(Destination, Fill, Length)
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+typedef signed char SCHAR, *PSCHAR;
+typedef ULONGLONG *PULONGLONG;
+typedef LONGLONG *PLONGLONG;
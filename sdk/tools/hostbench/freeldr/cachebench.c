@@ -0,0 +1,532 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Replay of a boot file list through the FreeLoader disk cache
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <freeldr.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "../hostbench.h"
+
+/*
+ * The boot files are laid out on the disk the way an ext2 volume would
+ * store them, and read back the way the ext2 driver of FreeLoader does:
+ * the directory and inode blocks first, then the file one file system
+ * block at a time, with an indirect block every so often. Each file
+ * system block read goes through CacheReadDiskSectors(), and every disk
+ * read the cache issues would be one INT 13h call on a real machine.
+ *
+ * Without an image the disk contents are a pattern made of the sector
+ * numbers, so every buffer returned by the cache can be checked.
+ */
+
+#define SECTOR_SIZE         512
+#define DISK_DRIVE          0x80
+#define SYNTHETIC_SECTORS   (4ULL * 1024 * 1024 * 1024 / SECTOR_SIZE)
+
+/* ext2 layout */
+#define FS_BLOCK_SIZE       4096
+#define FS_BLOCK_SECTORS    (FS_BLOCK_SIZE / SECTOR_SIZE)
+#define FS_INODES_PER_BLOCK 32
+#define FS_FILES_PER_DIR    16
+#define FS_DIRECT_BLOCKS    12
+#define FS_PTRS_PER_BLOCK   (FS_BLOCK_SIZE / sizeof(ULONG))
+#define FS_METADATA_SECTOR  2048
+#define FS_DATA_SECTOR      65536
+
+/* Same as MAX_DISKREADBUFFER_SIZE for the PC */
+#define READ_BUFFER_SIZE    0xFE00
+
+typedef struct _BOOT_FILE
+{
+    const char *Name;
+    ULONG Size;
+
+    /* Filled in by LayoutFiles */
+    ULONGLONG FirstSector;
+} BOOT_FILE, *PBOOT_FILE;
+
+/* Roughly what a ReactOS boot loads, in load order */
+static BOOT_FILE DefaultFiles[] =
+{
+    { "freeldr.ini",    2048 },
+    { "SYSTEM",         3145728 },
+    { "ntoskrnl.exe",   3936256 },
+    { "hal.dll",        245760 },
+    { "kdcom.dll",      24576 },
+    { "bootvid.dll",    49152 },
+    { "c_1252.nls",     66082 },
+    { "c_437.nls",      66082 },
+    { "l_intl.nls",     6148 },
+    { "vgaoem.fon",     5360 },
+    { "pshed.dll",      16384 },
+    { "ci.dll",         20480 },
+    { "clfs.sys",       36864 },
+    { "wmilib.sys",     16384 },
+    { "acpi.sys",       438272 },
+    { "pci.sys",        110592 },
+    { "isapnp.sys",     45056 },
+    { "pciide.sys",     16384 },
+    { "pciidex.sys",    53248 },
+    { "atapi.sys",      65536 },
+    { "uniata.sys",     331776 },
+    { "scsiport.sys",   110592 },
+    { "storport.sys",   98304 },
+    { "classpnp.sys",   110592 },
+    { "disk.sys",       61440 },
+    { "cdrom.sys",      86016 },
+    { "partmgr.sys",    69632 },
+    { "mountmgr.sys",   86016 },
+    { "volmgr.sys",     32768 },
+    { "fltmgr.sys",     135168 },
+    { "ksecdd.sys",     126976 },
+    { "cng.sys",        102400 },
+    { "fastfat.sys",    290816 },
+    { "ntfs.sys",       274432 },
+    { "btrfs.sys",      868352 },
+    { "ext2fs.sys",     262144 },
+    { "cdfs.sys",       94208 },
+    { "udfs.sys",       118784 },
+    { "npfs.sys",       49152 },
+    { "msfs.sys",       32768 },
+    { "mup.sys",        57344 },
+    { "null.sys",       12288 },
+    { "beep.sys",       12288 },
+    { "blue.sys",       36864 },
+    { "vgamp.sys",      49152 },
+    { "videoprt.sys",   172032 },
+    { "i8042prt.sys",   102400 },
+    { "kbdclass.sys",   40960 },
+    { "mouclass.sys",   40960 },
+    { "sermouse.sys",   24576 },
+    { "usbport.sys",    225280 },
+    { "usbohci.sys",    53248 },
+    { "usbuhci.sys",    61440 },
+    { "usbehci.sys",    77824 },
+    { "usbhub.sys",     135168 },
+    { "usbstor.sys",    69632 },
+    { "usbccgp.sys",    65536 },
+    { "hidclass.sys",   61440 },
+    { "hidparse.sys",   40960 },
+    { "hidusb.sys",     20480 },
+    { "kbdhid.sys",     20480 },
+    { "mouhid.sys",     20480 },
+    { "serial.sys",     81920 },
+    { "serenum.sys",    32768 },
+    { "parport.sys",    36864 },
+    { "fdc.sys",        40960 },
+    { "flpydisk.sys",   32768 },
+    { "afd.sys",        135168 },
+    { "tcpip.sys",      798720 },
+    { "ndis.sys",       192512 },
+    { "tdi.sys",        24576 },
+    { "netio.sys",      45056 },
+    { "portcls.sys",    270336 },
+    { "ks.sys",         155648 },
+    { "sysaudio.sys",   61440 },
+    { "wdmaud.sys",     69632 },
+    { "win32k.sys",     2490368 },
+};
+
+#define DEFAULT_FILE_COUNT (sizeof(DefaultFiles) / sizeof(DefaultFiles[0]))
+
+static PBOOT_FILE Files = DefaultFiles;
+static ULONG FileCount = DEFAULT_FILE_COUNT;
+
+/*
+ * The emulated machine
+ */
+
+PFN_NUMBER TotalPagesInLookupTable = (256 * 1024 * 1024) / MM_PAGE_SIZE;
+
+static UCHAR ReadBuffer[READ_BUFFER_SIZE];
+PVOID DiskReadBuffer = ReadBuffer;
+SIZE_T DiskReadBufferSize = sizeof(ReadBuffer);
+
+static int ImageFd = -1;
+static ULONGLONG DiskSectors = SYNTHETIC_SECTORS;
+static ULONG DiskBlockSize;
+
+static VOID
+FillSectors(ULONGLONG SectorNumber, ULONG SectorCount, PUCHAR Buffer)
+{
+    PULONG Words = (PULONG)Buffer;
+    ULONG i;
+
+    for (i = 0; i < SectorCount * SECTOR_SIZE / sizeof(ULONG); i++)
+        Words[i] = (ULONG)(SectorNumber * (SECTOR_SIZE / sizeof(ULONG))) + i;
+}
+
+static BOOLEAN
+ReadSectors(ULONGLONG SectorNumber, ULONG SectorCount, PVOID Buffer)
+{
+    if (SectorNumber + SectorCount > DiskSectors)
+        return FALSE;
+
+    if (ImageFd < 0)
+    {
+        FillSectors(SectorNumber, SectorCount, Buffer);
+        return TRUE;
+    }
+
+    return pread(ImageFd, Buffer, (size_t)SectorCount * SECTOR_SIZE,
+                 (off_t)(SectorNumber * SECTOR_SIZE)) == (ssize_t)SectorCount * SECTOR_SIZE;
+}
+
+BOOLEAN
+MachDiskGetDriveGeometry(UCHAR DriveNumber, PGEOMETRY DriveGeometry)
+{
+    RtlZeroMemory(DriveGeometry, sizeof(*DriveGeometry));
+    DriveGeometry->BytesPerSector = SECTOR_SIZE;
+    DriveGeometry->Sectors = DiskSectors;
+    return TRUE;
+}
+
+ULONG
+MachDiskGetCacheableBlockCount(UCHAR DriveNumber)
+{
+    return DiskBlockSize;
+}
+
+BOOLEAN
+MachDiskReadLogicalSectors(UCHAR DriveNumber, ULONGLONG SectorNumber, ULONG SectorCount, PVOID Buffer)
+{
+    /* Like INT 13h, a single read must fit in the disk read buffer */
+    if ((SIZE_T)SectorCount * SECTOR_SIZE > DiskReadBufferSize)
+        return FALSE;
+
+    return ReadSectors(SectorNumber, SectorCount, Buffer);
+}
+
+/*
+ * The boot file list
+ */
+
+static ULONG
+FileBlocks(PBOOT_FILE File)
+{
+    return (File->Size + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
+}
+
+/* Number of indirect blocks the file uses, stored right before its data */
+static ULONG
+FileIndirectBlocks(PBOOT_FILE File)
+{
+    ULONG Blocks = FileBlocks(File);
+
+    if (Blocks <= FS_DIRECT_BLOCKS)
+        return 0;
+
+    return (Blocks - FS_DIRECT_BLOCKS + FS_PTRS_PER_BLOCK - 1) / FS_PTRS_PER_BLOCK;
+}
+
+/*
+ * Files are not stored in load order: place them in a scrambled order,
+ * so that only the reads within a file are sequential.
+ */
+static VOID
+LayoutFiles(VOID)
+{
+    ULONGLONG Sector = FS_DATA_SECTOR;
+    ULONG i, Index;
+
+    for (i = 0; i < FileCount; i++)
+    {
+        Index = (ULONG)(((ULONGLONG)i * 37) % FileCount);
+        if (FileCount % 37 == 0)
+            Index = i;
+
+        Files[Index].FirstSector = Sector;
+        Sector += (ULONGLONG)(FileIndirectBlocks(&Files[Index]) + FileBlocks(&Files[Index])) * FS_BLOCK_SECTORS;
+
+        /* Leave some free space between the files */
+        Sector += 8 * FS_BLOCK_SECTORS;
+    }
+}
+
+static BOOLEAN
+LoadFileList(const char *Path)
+{
+    FILE *List;
+    char Name[256];
+    unsigned long Size;
+    ULONG Count = 0;
+
+    List = fopen(Path, "r");
+    if (!List)
+    {
+        perror(Path);
+        return FALSE;
+    }
+
+    Files = NULL;
+    while (fscanf(List, "%255s %lu", Name, &Size) == 2)
+    {
+        Files = realloc(Files, (Count + 1) * sizeof(BOOT_FILE));
+        if (!Files)
+            break;
+
+        Files[Count].Name = strdup(Name);
+        Files[Count].Size = (ULONG)Size;
+        Count++;
+    }
+    fclose(List);
+
+    if (!Files || Count == 0)
+    {
+        fprintf(stderr, "cachebench: no files in %s\n", Path);
+        return FALSE;
+    }
+
+    FileCount = Count;
+    return TRUE;
+}
+
+/*
+ * Replay
+ */
+
+typedef struct _REPLAY_CONFIG
+{
+    const char *Name;
+    ULONG BlockSize;
+    ULONG ReadAheadBlocks;
+} REPLAY_CONFIG, *PREPLAY_CONFIG;
+
+static const REPLAY_CONFIG Configs[] =
+{
+    { "block32k",           64, 0 },
+    { "block8k",            16, 0 },
+    { "block8k/readahead",  16, CACHE_READ_AHEAD_BLOCKS },
+};
+
+#define CONFIG_COUNT (sizeof(Configs) / sizeof(Configs[0]))
+
+typedef struct _REPLAY_STATE
+{
+    UCHAR Block[FS_BLOCK_SIZE];
+    UCHAR Expected[FS_BLOCK_SIZE];
+    BOOLEAN Verify;
+    ULONG FsReads;
+    ULONG Mismatches;
+} REPLAY_STATE, *PREPLAY_STATE;
+
+static BOOLEAN
+ReplayRead(PREPLAY_STATE State, ULONGLONG Sector)
+{
+    State->FsReads++;
+
+    if (!CacheReadDiskSectors(DISK_DRIVE, Sector, FS_BLOCK_SECTORS, State->Block))
+        return FALSE;
+
+    if (State->Verify)
+    {
+        ReadSectors(Sector, FS_BLOCK_SECTORS, State->Expected);
+        if (memcmp(State->Block, State->Expected, FS_BLOCK_SIZE))
+            State->Mismatches++;
+    }
+
+    return TRUE;
+}
+
+static BOOLEAN
+Replay(const REPLAY_CONFIG *Config, PREPLAY_STATE State)
+{
+    ULONG i, Block, Indirect;
+    ULONGLONG Sector;
+
+    /* Start with a cold cache */
+    DiskBlockSize = Config->BlockSize;
+    CacheReadAheadBlocks = Config->ReadAheadBlocks;
+    CacheInvalidateCacheData();
+    if (!CacheInitializeDrive(DISK_DRIVE))
+        return FALSE;
+
+    for (i = 0; i < FileCount; i++)
+    {
+        /* Directory entry, then inode */
+        Sector = FS_METADATA_SECTOR + (ULONGLONG)(i / FS_FILES_PER_DIR) * FS_BLOCK_SECTORS;
+        if (!ReplayRead(State, Sector))
+            return FALSE;
+
+        Sector = FS_METADATA_SECTOR + 1024 * FS_BLOCK_SECTORS
+                 + (ULONGLONG)(i / FS_INODES_PER_BLOCK) * FS_BLOCK_SECTORS;
+        if (!ReplayRead(State, Sector))
+            return FALSE;
+
+        /* The data, with the indirect blocks stored before it */
+        Sector = Files[i].FirstSector;
+        Indirect = 0;
+
+        for (Block = 0; Block < FileBlocks(&Files[i]); Block++)
+        {
+            if (Block >= FS_DIRECT_BLOCKS &&
+                (Block - FS_DIRECT_BLOCKS) % FS_PTRS_PER_BLOCK == 0)
+            {
+                if (!ReplayRead(State, Files[i].FirstSector + (ULONGLONG)Indirect * FS_BLOCK_SECTORS))
+                    return FALSE;
+                Indirect++;
+            }
+
+            if (!ReplayRead(State,
+                            Files[i].FirstSector
+                            + (ULONGLONG)(FileIndirectBlocks(&Files[i]) + Block) * FS_BLOCK_SECTORS))
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+static int
+RunReplay(VOID)
+{
+    PREPLAY_STATE State;
+    int Failures = 0;
+    ULONG c, Accesses;
+
+    State = malloc(sizeof(*State));
+    if (!State)
+        return 1;
+
+    printf("%-24s %10s %10s %12s %10s %10s\n",
+           "config", "fs reads", "disk reads", "bytes read", "hit rate", "read ahead");
+
+    for (c = 0; c < CONFIG_COUNT; c++)
+    {
+        if (!HbSelected(Configs[c].Name))
+            continue;
+
+        RtlZeroMemory(State, sizeof(*State));
+        RtlZeroMemory(&CacheStatistics, sizeof(CacheStatistics));
+        State->Verify = TRUE;
+
+        if (!Replay(&Configs[c], State) || State->Mismatches)
+        {
+            fprintf(stderr, "cachebench: %s failed, %lu bad blocks\n",
+                    Configs[c].Name, (unsigned long)State->Mismatches);
+            Failures++;
+            continue;
+        }
+
+        Accesses = CacheStatistics.BlockHits + CacheStatistics.BlockMisses;
+        printf("%-24s %10lu %10lu %12llu %9.1f%% %10lu\n",
+               Configs[c].Name,
+               (unsigned long)State->FsReads,
+               (unsigned long)CacheStatistics.ReadsIssued,
+               (unsigned long long)CacheStatistics.BytesRead,
+               Accesses ? 100.0 * CacheStatistics.BlockHits / Accesses : 0.0,
+               (unsigned long)CacheStatistics.BlocksReadAhead);
+    }
+
+    free(State);
+    return Failures;
+}
+
+static void
+BenchReplay(PHB_THREAD Thread)
+{
+    const REPLAY_CONFIG *Config = Thread->Context;
+    PREPLAY_STATE State = calloc(1, sizeof(*State));
+
+    if (!State)
+        return;
+
+    do
+    {
+        State->FsReads = 0;
+        if (!Replay(Config, State))
+            break;
+        Thread->Operations += State->FsReads;
+    } while (!HbShouldStop(Thread));
+
+    free(State);
+}
+
+static void
+RunBenchmarks(void)
+{
+    HB_RESULT Result;
+    ULONG c;
+
+    HbReportHeader("FreeLoader disk cache (operations are file system block reads)");
+
+    for (c = 0; c < CONFIG_COUNT; c++)
+    {
+        if (!HbSelected(Configs[c].Name))
+            continue;
+
+        /* The cache is global, so a single thread only */
+        HbRun(BenchReplay, (void *)&Configs[c], 1, HbOptions.DurationMs, &Result);
+        HbReport(Configs[c].Name, &Result);
+    }
+}
+
+static const char Usage[] =
+    "  -i image   replay against this disk image instead of a synthetic disk\n"
+    "  -l list    boot file list, one \"name size\" per line\n";
+
+int
+main(int argc, char **argv)
+{
+    struct stat Stat;
+    char **Args;
+    int ArgCount = 1;
+    int i, Failures;
+
+    /* Take out our own options, leave the common ones to HbParseOptions */
+    Args = calloc(argc + 1, sizeof(char *));
+    if (!Args)
+        return 1;
+    Args[0] = argv[0];
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-i") && i + 1 < argc)
+        {
+            ImageFd = open(argv[++i], O_RDONLY);
+            if (ImageFd < 0 || fstat(ImageFd, &Stat))
+            {
+                perror(argv[i]);
+                return 1;
+            }
+            DiskSectors = (ULONGLONG)Stat.st_size / SECTOR_SIZE;
+        }
+        else if (!strcmp(argv[i], "-l") && i + 1 < argc)
+        {
+            if (!LoadFileList(argv[++i]))
+                return 1;
+        }
+        else
+        {
+            Args[ArgCount++] = argv[i];
+        }
+    }
+
+    if (HbParseOptions(ArgCount, Args, Usage))
+        return 1;
+
+    LayoutFiles();
+
+    Failures = RunReplay();
+    if (Failures)
+    {
+        fprintf(stderr, "cachebench: %d replays failed\n", Failures);
+        return 1;
+    }
+
+    RunBenchmarks();
+
+    free(Args);
+    if (ImageFd >= 0)
+        close(ImageFd);
+
+    return 0;
+}
@@ -0,0 +1,14 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     FreeLoader debug output, discarded on the host
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#define DBG_DEFAULT_CHANNEL(ch)
+
+#define ERR(...)    do { } while (0)
+#define WARN(...)   do { } while (0)
+#define TRACE(...)  do { } while (0)
@@ -0,0 +1,51 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Minimal FreeLoader environment for building the disk cache on the host
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <typedefs.h>
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+#define MM_PAGE_SIZE    4096
+#define TEMP_HEAP_SIZE  (32 * 1024 * 1024)
+
+typedef ULONG_PTR PFN_NUMBER;
+
+typedef struct _GEOMETRY
+{
+    ULONG Cylinders;
+    ULONG Heads;
+    ULONG SectorsPerTrack;
+    ULONG BytesPerSector;
+    ULONGLONG Sectors;
+} GEOMETRY, *PGEOMETRY;
+
+/* Provided by the benchmark */
+extern PFN_NUMBER TotalPagesInLookupTable;
+extern PVOID DiskReadBuffer;
+extern SIZE_T DiskReadBufferSize;
+
+BOOLEAN MachDiskGetDriveGeometry(UCHAR DriveNumber, PGEOMETRY DriveGeometry);
+ULONG MachDiskGetCacheableBlockCount(UCHAR DriveNumber);
+BOOLEAN MachDiskReadLogicalSectors(UCHAR DriveNumber, ULONGLONG SectorNumber, ULONG SectorCount, PVOID Buffer);
+
+#define FrLdrTempAlloc(Size, Tag)   malloc(Size)
+#define FrLdrTempFree(Ptr, Tag)     free(Ptr)
+
+#define BugCheck(...)   do { fprintf(stderr, __VA_ARGS__); abort(); } while (0)
+
+#include <cache.h>
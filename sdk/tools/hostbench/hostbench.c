@@ -0,0 +1,240 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Common timing, threading and reporting helpers
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "hostbench.h"
+
+HB_OPTIONS HbOptions =
+{
+    200,            /* DurationMs */
+    HB_MAX_THREADS, /* MaxThreads */
+    NULL            /* Filter */
+};
+
+typedef struct _HB_START
+{
+    pthread_mutex_t Mutex;
+    pthread_cond_t Cond;
+    unsigned Ready;
+    unsigned Count;
+    int Go;
+} HB_START;
+
+typedef struct _HB_WORKER
+{
+    HB_THREAD Thread;
+    PHB_ROUTINE Routine;
+    HB_START *Start;
+    pthread_t Handle;
+} HB_WORKER;
+
+uint64_t
+HbNow(void)
+{
+    struct timespec Ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &Ts);
+    return (uint64_t)Ts.tv_sec * 1000000000ull + (uint64_t)Ts.tv_nsec;
+}
+
+unsigned
+HbProcessorCount(void)
+{
+    long Count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (Count > 0) ? (unsigned)Count : 1;
+}
+
+void *
+HbAlignedAlloc(size_t Alignment, size_t Size)
+{
+    void *Memory;
+
+    /* aligned_alloc is C11, the host tools are built as C99 */
+    if (Alignment < sizeof(void *))
+        Alignment = sizeof(void *);
+    if (posix_memalign(&Memory, Alignment, Size) != 0)
+        return NULL;
+
+    return Memory;
+}
+
+int
+HbParseOptions(int argc, char **argv, const char *Usage)
+{
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-d") && i + 1 < argc)
+        {
+            HbOptions.DurationMs = (unsigned)strtoul(argv[++i], NULL, 0);
+        }
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+        {
+            HbOptions.MaxThreads = (unsigned)strtoul(argv[++i], NULL, 0);
+            if (HbOptions.MaxThreads == 0)
+                HbOptions.MaxThreads = 1;
+            if (HbOptions.MaxThreads > HB_MAX_THREADS)
+                HbOptions.MaxThreads = HB_MAX_THREADS;
+        }
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+        {
+            HbOptions.Filter = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr,
+                    "Usage: %s [-d duration_ms] [-t max_threads] [-f filter]\n%s",
+                    argv[0], Usage ? Usage : "");
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int
+HbSelected(const char *Name)
+{
+    return !HbOptions.Filter || strstr(Name, HbOptions.Filter);
+}
+
+static void *
+HbWorker(void *Parameter)
+{
+    HB_WORKER *Worker = Parameter;
+    HB_START *Start = Worker->Start;
+
+    /* Wait until all threads are created, so they all start together */
+    pthread_mutex_lock(&Start->Mutex);
+    if (++Start->Ready == Start->Count)
+        pthread_cond_broadcast(&Start->Cond);
+    while (!Start->Go)
+        pthread_cond_wait(&Start->Cond, &Start->Mutex);
+    pthread_mutex_unlock(&Start->Mutex);
+
+    Worker->Routine(&Worker->Thread);
+    return NULL;
+}
+
+void
+HbRun(
+    PHB_ROUTINE Routine,
+    void *Context,
+    unsigned ThreadCount,
+    unsigned DurationMs,
+    PHB_RESULT Result)
+{
+    HB_WORKER Workers[HB_MAX_THREADS];
+    HB_START Start;
+    volatile int Stop = 0;
+    uint64_t StartTime;
+    struct timespec Delay;
+    unsigned i;
+
+    if (ThreadCount > HB_MAX_THREADS)
+        ThreadCount = HB_MAX_THREADS;
+
+    pthread_mutex_init(&Start.Mutex, NULL);
+    pthread_cond_init(&Start.Cond, NULL);
+    Start.Ready = 0;
+    Start.Count = ThreadCount;
+    Start.Go = 0;
+
+    for (i = 0; i < ThreadCount; i++)
+    {
+        Workers[i].Thread.Index = i;
+        Workers[i].Thread.ThreadCount = ThreadCount;
+        Workers[i].Thread.Context = Context;
+        Workers[i].Thread.Operations = 0;
+        Workers[i].Thread.Stop = &Stop;
+        Workers[i].Routine = Routine;
+        Workers[i].Start = &Start;
+
+        if (pthread_create(&Workers[i].Handle, NULL, HbWorker, &Workers[i]))
+        {
+            fprintf(stderr, "Failed to create benchmark thread %u\n", i);
+            exit(1);
+        }
+    }
+
+    /* Release all the threads at once */
+    pthread_mutex_lock(&Start.Mutex);
+    while (Start.Ready != Start.Count)
+        pthread_cond_wait(&Start.Cond, &Start.Mutex);
+    Start.Go = 1;
+    StartTime = HbNow();
+    pthread_cond_broadcast(&Start.Cond);
+    pthread_mutex_unlock(&Start.Mutex);
+
+    if (DurationMs)
+    {
+        Delay.tv_sec = DurationMs / 1000;
+        Delay.tv_nsec = (long)(DurationMs % 1000) * 1000000;
+        nanosleep(&Delay, NULL);
+        __atomic_store_n(&Stop, 1, __ATOMIC_RELEASE);
+    }
+
+    Result->ThreadCount = ThreadCount;
+    Result->Operations = 0;
+    for (i = 0; i < ThreadCount; i++)
+    {
+        pthread_join(Workers[i].Handle, NULL);
+        Result->Operations += Workers[i].Thread.Operations;
+    }
+    Result->ElapsedNs = HbNow() - StartTime;
+
+    pthread_cond_destroy(&Start.Cond);
+    pthread_mutex_destroy(&Start.Mutex);
+}
+
+void
+HbReportHeader(const char *Title)
+{
+    printf("\n%s\n", Title);
+    printf("%-32s %7s %14s %14s %12s\n",
+           "benchmark", "threads", "operations", "ops/s", "ns/op/thread");
+}
+
+void
+HbReport(const char *Name, const HB_RESULT *Result)
+{
+    double Seconds = (double)Result->ElapsedNs / 1e9;
+    double Rate = Result->Operations ? (double)Result->Operations / Seconds : 0.0;
+    double Latency = Result->Operations ?
+        (double)Result->ElapsedNs * Result->ThreadCount / (double)Result->Operations : 0.0;
+
+    printf("%-32s %7u %14llu %14.0f %12.1f\n",
+           Name,
+           Result->ThreadCount,
+           (unsigned long long)Result->Operations,
+           Rate,
+           Latency);
+    fflush(stdout);
+}
+
+void
+HbRunScaling(const char *Name, PHB_ROUTINE Routine, void *Context)
+{
+    HB_RESULT Result;
+    unsigned Threads;
+
+    if (!HbSelected(Name))
+        return;
+
+    for (Threads = 1; Threads <= HbOptions.MaxThreads; Threads *= 2)
+    {
+        HbRun(Routine, Context, Threads, HbOptions.DurationMs, &Result);
+        HbReport(Name, &Result);
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Common timing, threading and reporting helpers
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+
+/* Maximum number of threads a benchmark can be run with */
+#define HB_MAX_THREADS 64
+
+typedef struct _HB_THREAD
+{
+    /* Index of this thread, 0 to ThreadCount - 1 */
+    unsigned Index;
+    unsigned ThreadCount;
+
+    /* Opaque benchmark context, shared by all threads */
+    void *Context;
+
+    /* Number of operations done, filled in by the benchmark routine */
+    uint64_t Operations;
+
+    /* Private */
+    volatile int *Stop;
+} HB_THREAD, *PHB_THREAD;
+
+typedef void (*PHB_ROUTINE)(PHB_THREAD Thread);
+
+typedef struct _HB_RESULT
+{
+    unsigned ThreadCount;
+    uint64_t Operations;
+    uint64_t ElapsedNs;
+} HB_RESULT, *PHB_RESULT;
+
+typedef struct _HB_OPTIONS
+{
+    /* How long each timed benchmark runs, in milliseconds */
+    unsigned DurationMs;
+
+    /* Highest thread count for scaling runs */
+    unsigned MaxThreads;
+
+    /* Only run the benchmarks whose name contains this string */
+    const char *Filter;
+} HB_OPTIONS, *PHB_OPTIONS;
+
+extern HB_OPTIONS HbOptions;
+
+/* Monotonic time in nanoseconds */
+uint64_t
+HbNow(void);
+
+/* Number of processors available on the host */
+unsigned
+HbProcessorCount(void);
+
+/* Allocate memory aligned to Alignment, a power of two, free it with free() */
+void *
+HbAlignedAlloc(size_t Alignment, size_t Size);
+
+/* Parse the common command line options, returns 0 on success */
+int
+HbParseOptions(int argc, char **argv, const char *Usage);
+
+/* Returns nonzero if the benchmark matches the name filter */
+int
+HbSelected(const char *Name);
+
+/*
+ * Run Routine on ThreadCount threads, released at the same time.
+ * With a non-zero DurationMs the routine must loop until HbShouldStop()
+ * returns nonzero, otherwise it runs a fixed amount of work.
+ */
+void
+HbRun(
+    PHB_ROUTINE Routine,
+    void *Context,
+    unsigned ThreadCount,
+    unsigned DurationMs,
+    PHB_RESULT Result);
+
+static inline int
+HbShouldStop(PHB_THREAD Thread)
+{
+    return *Thread->Stop;
+}
+
+/* Print the table header and a result line */
+void
+HbReportHeader(const char *Title);
+
+void
+HbReport(const char *Name, const HB_RESULT *Result);
+
+/* Run a timed benchmark at 1, 2, 4 ... MaxThreads threads and report it */
+void
+HbRunScaling(const char *Name, PHB_ROUTINE Routine, void *Context);
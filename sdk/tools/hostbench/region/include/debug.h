@@ -0,0 +1,3 @@
+#pragma once
+
+/* typedefs.h already has DPRINT and ASSERT */
@@ -0,0 +1,209 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     What region.c uses from win32k.h, for the host compiler
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+
+#include <typedefs.h>
+
+/* region.c uses the host calling convention */
+#define FASTCALL
+#define APIENTRY
+#define __kernel_entry
+#define CONST const
+#define FORCEINLINE static __inline
+#define UNREFERENCED_PARAMETER(P) ((void)(P))
+#define ARRAYSIZE(a) (sizeof(a) / sizeof((a)[0]))
+#define NT_ASSERT(x) assert(x)
+#define NT_VERIFY(x) ((void)(x))
+#define _PRAGMA_WARNING_SUPPRESS(x)
+
+#define MAXLONG 0x7FFFFFFF
+#define MINLONG (-MAXLONG - 1)
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+
+#define _In_
+#define _In_opt_
+#define _In_reads_(x)
+#define _In_reads_bytes_(x)
+#define _Out_
+#define _Out_opt_
+#define _Out_writes_bytes_to_opt_(x, y)
+#define _Inout_
+#define _Notnull_
+#define _Success_(x)
+#define _Check_return_
+#define _Ret_opt_bytecap_(x)
+
+#define ERROR_NOT_ENOUGH_MEMORY 8L
+#define ERROR_INVALID_HANDLE 6L
+#define ERROR_INVALID_PARAMETER 87L
+#define STATUS_SUCCESS ((NTSTATUS)0)
+#define STATUS_INVALID_PARAMETER ((NTSTATUS)0xC000000DL)
+
+typedef BYTE *PBYTE;
+typedef ULONG FLONG;
+typedef LONG FIX;
+typedef FLOAT FLOATOBJ;
+typedef PVOID HGDIOBJ;
+typedef HGDIOBJ HRGN;
+typedef INT *PINT, *LPINT;
+
+typedef struct _RECTL
+{
+    LONG left;
+    LONG top;
+    LONG right;
+    LONG bottom;
+} RECTL, *PRECTL, *LPRECTL, RECT, *PRECT, *LPRECT;
+typedef const RECT *LPCRECT;
+
+typedef struct _POINTL
+{
+    LONG x;
+    LONG y;
+} POINTL, *PPOINTL, POINT, *PPOINT, *LPPOINT;
+
+typedef struct _RGNDATAHEADER
+{
+    DWORD dwSize;
+    DWORD iType;
+    DWORD nCount;
+    DWORD nRgnSize;
+    RECT rcBound;
+} RGNDATAHEADER, *PRGNDATAHEADER;
+
+typedef struct _RGNDATA
+{
+    RGNDATAHEADER rdh;
+    char Buffer[1];
+} RGNDATA, *PRGNDATA, *LPRGNDATA;
+
+typedef struct _XFORML
+{
+    FLOAT eM11, eM12, eM21, eM22, eDx, eDy;
+} XFORML, *PXFORML, XFORM, *LPXFORM;
+
+#define RDH_RECTANGLES 1
+
+#define ERROR 0
+#define NULLREGION 1
+#define SIMPLEREGION 2
+#define COMPLEXREGION 3
+
+#define RGN_AND 1
+#define RGN_OR 2
+#define RGN_XOR 3
+#define RGN_DIFF 4
+#define RGN_COPY 5
+
+#define ALTERNATE 1
+#define WINDING 2
+
+typedef struct _RGN_ATTR
+{
+    ULONG AttrFlags;
+    ULONG iComplexity;
+    RECTL Rect;
+} RGN_ATTR, *PRGN_ATTR;
+
+#define ATTR_RGN_VALID 0x00000010
+#define ATTR_RGN_DIRTY 0x00000020
+
+/* The objects of the bench have no handle, they are only allocated */
+typedef struct _BASEOBJECT
+{
+    HGDIOBJ hHmgr;
+    ULONG ulShareCount;
+    USHORT cExclusiveLock;
+    USHORT BaseFlags;
+} BASEOBJECT, *POBJ;
+
+#define GDIObjType_RGN_TYPE 4
+#define BASEFLAG_LOOKASIDE 0x80
+#define GDI_OBJ_HMGR_POWNED 0x80000002
+#define GDI_OBJ_HMGR_PUBLIC 0
+#define GDILoObjType_LO_REGION_TYPE 0x40000
+#define GDI_HANDLE_GET_TYPE(h) GDILoObjType_LO_REGION_TYPE
+
+typedef struct _MATRIX
+{
+    FLOATOBJ efM11, efM12, efM21, efM22, efDx, efDy;
+    FIX fxDx, fxDy;
+    FLONG flAccel;
+} MATRIX, *PMATRIX;
+
+typedef struct _XFORMOBJ
+{
+    ULONG ulUnused;
+    PMATRIX pmx;
+} XFORMOBJ;
+
+#define XF_LTOL 0
+#define XFORM_SCALE 1
+#define XFORM_UNITY 2
+
+#define MIN_COORD (INT_MIN / 16)
+#define MAX_COORD (INT_MAX / 16)
+#define DDI_ERROR 0xFFFFFFFF
+
+typedef struct _PROCESSINFO
+{
+    PVOID pPoolRgnAttr;
+} PROCESSINFO, *PPROCESSINFO;
+
+#define TAG_REGION 'NGER'
+#define PagedPool 1
+#define NonPagedPool 0
+
+/* No SEH on the host, the bench passes only valid buffers */
+#define _SEH2_TRY {
+#define _SEH2_EXCEPT(x) } if (0) {
+#define _SEH2_END }
+#define _SEH2_LEAVE
+#define _SEH2_GetExceptionCode() STATUS_SUCCESS
+#define EXCEPTION_EXECUTE_HANDLER 1
+#define ProbeForRead(p, cj, a)
+#define ProbeForWrite(p, cj, a)
+
+#define ExAllocatePoolWithTag(PoolType, NumberOfBytes, Tag) malloc(NumberOfBytes)
+#define ExFreePoolWithTag(P, Tag) free(P)
+#define DbgPrint printf
+
+#include <region.h>
+
+/* The rest of win32k, see regionshim.c */
+HRGN APIENTRY NtGdiCreateRoundRectRgn(INT left, INT top, INT right, INT bottom, INT ellipse_width, INT ellipse_height);
+POBJ NTAPI GDIOBJ_AllocateObject(UCHAR objt, ULONG cjSize, FLONG fl);
+VOID NTAPI GDIOBJ_vFreeObject(POBJ pobj);
+HGDIOBJ NTAPI GDIOBJ_hInsertObject(POBJ pobj, ULONG ulOwner);
+VOID NTAPI GDIOBJ_vDeleteObject(POBJ pobj);
+PVOID NTAPI GDIOBJ_LockObject(HGDIOBJ hobj, UCHAR objt);
+VOID NTAPI GDIOBJ_vUnlockObject(POBJ pobj);
+BOOL NTAPI GDIOBJ_bLockMultipleObjects(ULONG ulCount, HGDIOBJ *ahObj, PVOID *apObj, UCHAR uchType);
+VOID NTAPI GDIOBJ_vSetObjectAttr(POBJ pobj, PVOID pvObjAttr);
+BOOL NTAPI GreSetObjectOwner(HGDIOBJ hobj, ULONG ulOwner);
+ULONG NTAPI GreGetObjectOwner(HGDIOBJ hobj);
+BOOL NTAPI GreIsHandleValid(HGDIOBJ hobj);
+BOOL NTAPI GreDeleteObject(HGDIOBJ hobj);
+PPROCESSINFO NTAPI PsGetCurrentProcessWin32Process(VOID);
+PVOID NTAPI GdiPoolAllocate(PVOID pPool);
+VOID NTAPI GdiPoolFree(PVOID pPool, PVOID pvAlloc);
+VOID FASTCALL EngSetLastError(ULONG iError);
+VOID NTAPI SetLastNtError(NTSTATUS Status);
+VOID FASTCALL XFORMOBJ_vInit(XFORMOBJ *pxo, PMATRIX pmx);
+ULONG FASTCALL XFORMOBJ_iSetXform(XFORMOBJ *pxo, const XFORML *pxform);
+BOOL FASTCALL XFORMOBJ_bApplyXform(XFORMOBJ *pxo, ULONG iMode, ULONG cPoints, PVOID pvIn, PVOID pvOut);
+VOID FASTCALL RECTL_vSetEmptyRect(RECTL *prcl);
+VOID FASTCALL RECTL_vMakeWellOrdered(RECTL *prcl);
+BOOL FASTCALL RECTL_bUnionRect(RECTL *prclDst, const RECTL *prcl1, const RECTL *prcl2);
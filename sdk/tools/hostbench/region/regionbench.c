@@ -0,0 +1,425 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Conformance and throughput of the region combine and hit tests
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <win32k.h>
+
+#include "../hostbench.h"
+
+/*
+ * The traces below are what win32k does to regions when windows move: the
+ * visible region of each window is its rectangle minus the ones above it,
+ * one window at a time, and the update region grows by the small rectangles
+ * that get invalidated. Each step is replayed with IntGdiCombineRgn on the
+ * region itself, which takes the in place path for single rectangles, and
+ * into a second region, which rebuilds all the bands like before. Both must
+ * give the same rectangles. The binary searches of REGION_PtInRegion and
+ * REGION_RectInRegion are checked against linear scans of the regions.
+ */
+
+typedef struct _TRACE_OP
+{
+    INT iMode; /* RGN_COPY sets the region to the rectangle */
+    RECTL rcl;
+} TRACE_OP;
+
+typedef struct _TRACE
+{
+    const char *Name;
+    TRACE_OP *pop;
+    ULONG cOps;
+} TRACE;
+
+static ULONG gulSeed = 1;
+
+static ULONG
+Random(void)
+{
+    gulSeed = gulSeed * 1103515245 + 12345;
+    return (gulSeed >> 8) & 0xFFFFFF;
+}
+
+static VOID
+AddOp(TRACE *pTrace, INT iMode, LONG left, LONG top, LONG right, LONG bottom)
+{
+    TRACE_OP *pop;
+
+    pTrace->pop = realloc(pTrace->pop, (pTrace->cOps + 1) * sizeof(TRACE_OP));
+    pop = &pTrace->pop[pTrace->cOps++];
+    pop->iMode = iMode;
+    pop->rcl.left = left;
+    pop->rcl.top = top;
+    pop->rcl.right = right;
+    pop->rcl.bottom = bottom;
+}
+
+#define SCREEN_CX 1920
+#define SCREEN_CY 1200
+#define WINDOWS 48
+
+/* The visible regions of a stack of overlapping windows, and of the desktop */
+static VOID
+MakeVisibilityTrace(TRACE *pTrace)
+{
+    RECTL arcl[WINDOWS];
+    ULONG i, j;
+
+    for (i = 0; i < WINDOWS; i++)
+    {
+        arcl[i].left = Random() % (SCREEN_CX - 200);
+        arcl[i].top = Random() % (SCREEN_CY - 150);
+        arcl[i].right = min(arcl[i].left + 200 + Random() % 900, SCREEN_CX);
+        arcl[i].bottom = min(arcl[i].top + 150 + Random() % 700, SCREEN_CY);
+    }
+
+    /* Window 0 is the top one */
+    for (i = 0; i < WINDOWS; i++)
+    {
+        AddOp(pTrace, RGN_COPY, arcl[i].left, arcl[i].top, arcl[i].right, arcl[i].bottom);
+        for (j = 0; j < i; j++)
+            AddOp(pTrace, RGN_DIFF, arcl[j].left, arcl[j].top, arcl[j].right, arcl[j].bottom);
+    }
+
+    AddOp(pTrace, RGN_COPY, 0, 0, SCREEN_CX, SCREEN_CY);
+    for (j = 0; j < WINDOWS; j++)
+        AddOp(pTrace, RGN_DIFF, arcl[j].left, arcl[j].top, arcl[j].right, arcl[j].bottom);
+}
+
+/* An update region growing by text cells and the odd control */
+static VOID
+MakeUpdateTrace(TRACE *pTrace)
+{
+    ULONG i, cRepaints;
+    LONG x, y;
+
+    for (cRepaints = 0; cRepaints < 8; cRepaints++)
+    {
+        AddOp(pTrace, RGN_COPY, 0, 0, 0, 0);
+        for (i = 0; i < 400; i++)
+        {
+            if (Random() % 8)
+            {
+                x = (Random() % (SCREEN_CX / 8)) * 8;
+                y = (Random() % (SCREEN_CY / 16)) * 16;
+                AddOp(pTrace, RGN_OR, x, y, x + 8 * (1 + Random() % 12), y + 16);
+            }
+            else
+            {
+                x = Random() % (SCREEN_CX - 100);
+                y = Random() % (SCREEN_CY - 30);
+                AddOp(pTrace, RGN_OR, x, y, x + 20 + Random() % 80, y + 10 + Random() % 20);
+            }
+        }
+    }
+}
+
+/* Small random rectangles on a small grid, to hit the corner cases */
+static VOID
+MakeRandomTrace(TRACE *pTrace)
+{
+    ULONG i;
+    LONG x, y;
+    static const INT aiModes[] = { RGN_OR, RGN_OR, RGN_DIFF, RGN_DIFF, RGN_AND, RGN_XOR };
+
+    for (i = 0; i < 100000; i++)
+    {
+        x = Random() % 40;
+        y = Random() % 40;
+        if (Random() % 200 == 0)
+            AddOp(pTrace, RGN_COPY, x, y, x + Random() % 24, y + Random() % 24);
+        else
+            AddOp(pTrace, aiModes[Random() % ARRAYSIZE(aiModes)], x, y, x + Random() % 24, y + Random() % 24);
+    }
+}
+
+static TRACE gaTraces[] =
+{
+    { "window visibility", NULL, 0 },
+    { "update region", NULL, 0 },
+    { "random", NULL, 0 },
+};
+
+static VOID
+MakeTraces(void)
+{
+    MakeVisibilityTrace(&gaTraces[0]);
+    MakeUpdateTrace(&gaTraces[1]);
+    MakeRandomTrace(&gaTraces[2]);
+}
+
+/* Replays one step of a trace on prgn, in place or through prgnTmp */
+static INT
+ReplayOp(PREGION *pprgn, PREGION *pprgnTmp, PREGION prgnRect, const TRACE_OP *pop, BOOL bInPlace)
+{
+    PREGION prgnSwap;
+    INT iComplexity;
+
+    if (pop->iMode == RGN_COPY)
+    {
+        REGION_SetRectRgn(*pprgn, pop->rcl.left, pop->rcl.top, pop->rcl.right, pop->rcl.bottom);
+        return REGION_Complexity(*pprgn);
+    }
+
+    REGION_SetRectRgn(prgnRect, pop->rcl.left, pop->rcl.top, pop->rcl.right, pop->rcl.bottom);
+    if (bInPlace)
+        return IntGdiCombineRgn(*pprgn, *pprgn, prgnRect, pop->iMode);
+
+    iComplexity = IntGdiCombineRgn(*pprgnTmp, *pprgn, prgnRect, pop->iMode);
+    prgnSwap = *pprgn;
+    *pprgn = *pprgnTmp;
+    *pprgnTmp = prgnSwap;
+    return iComplexity;
+}
+
+/* The linear scans REGION_PtInRegion and REGION_RectInRegion did before */
+static BOOL
+RefPtInRegion(PREGION prgn, INT X, INT Y)
+{
+    ULONG i;
+
+    for (i = 0; i < prgn->rdh.nCount; i++)
+    {
+        if (prgn->Buffer[i].left <= X && X < prgn->Buffer[i].right &&
+            prgn->Buffer[i].top <= Y && Y < prgn->Buffer[i].bottom)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static BOOL
+RefRectInRegion(PREGION prgn, const RECTL *prcl)
+{
+    RECTL rcl = *prcl;
+    ULONG i;
+
+    RECTL_vMakeWellOrdered(&rcl);
+    for (i = 0; i < prgn->rdh.nCount; i++)
+    {
+        if (prgn->Buffer[i].left < rcl.right && rcl.left < prgn->Buffer[i].right &&
+            prgn->Buffer[i].top < rcl.bottom && rcl.top < prgn->Buffer[i].bottom)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static int
+Verify(void)
+{
+    PREGION prgnInPlace, prgnCopy, prgnTmp, prgnRect;
+    ULONG t, i, k, cOps = 0, cQueries = 0;
+    INT iInPlace, iCopy, X, Y;
+    RECTL rcl;
+    int Failures = 0;
+
+    prgnInPlace = IntSysCreateRectpRgn(0, 0, 0, 0);
+    prgnCopy = IntSysCreateRectpRgn(0, 0, 0, 0);
+    prgnTmp = IntSysCreateRectpRgn(0, 0, 0, 0);
+    prgnRect = IntSysCreateRectpRgn(0, 0, 0, 0);
+
+    for (t = 0; t < ARRAYSIZE(gaTraces); t++)
+    {
+        for (i = 0; i < gaTraces[t].cOps; i++)
+        {
+            iInPlace = ReplayOp(&prgnInPlace, NULL, prgnRect, &gaTraces[t].pop[i], TRUE);
+            iCopy = ReplayOp(&prgnCopy, &prgnTmp, prgnRect, &gaTraces[t].pop[i], FALSE);
+            cOps++;
+
+            if (iInPlace != iCopy ||
+                prgnInPlace->rdh.nCount != prgnCopy->rdh.nCount ||
+                memcmp(&prgnInPlace->rdh.rcBound, &prgnCopy->rdh.rcBound, sizeof(RECTL)) ||
+                memcmp(prgnInPlace->Buffer, prgnCopy->Buffer, prgnCopy->rdh.nCount * sizeof(RECTL)))
+            {
+                printf("%s: step %u differs, %u rects in place, %u rebuilt\n",
+                       gaTraces[t].Name, i, prgnInPlace->rdh.nCount, prgnCopy->rdh.nCount);
+                Failures++;
+
+                /* Start over from the same region */
+                IntGdiCombineRgn(prgnInPlace, prgnCopy, NULL, RGN_COPY);
+            }
+
+            /* Hit test around and inside the region */
+            for (k = 0; k < 4; k++)
+            {
+                X = prgnCopy->rdh.rcBound.left - 4 +
+                    Random() % (prgnCopy->rdh.rcBound.right - prgnCopy->rdh.rcBound.left + 8);
+                Y = prgnCopy->rdh.rcBound.top - 4 +
+                    Random() % (prgnCopy->rdh.rcBound.bottom - prgnCopy->rdh.rcBound.top + 8);
+                rcl.left = X;
+                rcl.top = Y;
+                rcl.right = X + Random() % 24 - 4;
+                rcl.bottom = Y + Random() % 24 - 4;
+
+                if (REGION_PtInRegion(prgnInPlace, X, Y) != RefPtInRegion(prgnCopy, X, Y))
+                {
+                    printf("%s: step %u, point %d,%d differs\n", gaTraces[t].Name, i, X, Y);
+                    Failures++;
+                }
+
+                if (REGION_RectInRegion(prgnInPlace, &rcl) != RefRectInRegion(prgnCopy, &rcl))
+                {
+                    printf("%s: step %u, rect %d,%d-%d,%d differs\n",
+                           gaTraces[t].Name, i, rcl.left, rcl.top, rcl.right, rcl.bottom);
+                    Failures++;
+                }
+                cQueries += 2;
+            }
+
+            if (Failures > 20)
+                break;
+        }
+    }
+
+    REGION_Delete(prgnRect);
+    REGION_Delete(prgnTmp);
+    REGION_Delete(prgnCopy);
+    REGION_Delete(prgnInPlace);
+
+    printf("%u combines and %u hit tests checked, %d differ\n", cOps, cQueries, Failures);
+    return Failures;
+}
+
+typedef struct _BENCH_CONTEXT
+{
+    TRACE *pTrace;
+    BOOL bInPlace;
+    PREGION prgn;
+    POINTL *ppt;
+} BENCH_CONTEXT;
+
+static void
+BenchTrace(PHB_THREAD Thread)
+{
+    BENCH_CONTEXT *Context = Thread->Context;
+    PREGION prgn, prgnTmp, prgnRect;
+    ULONG i;
+
+    prgn = IntSysCreateRectpRgn(0, 0, 0, 0);
+    prgnTmp = IntSysCreateRectpRgn(0, 0, 0, 0);
+    prgnRect = IntSysCreateRectpRgn(0, 0, 0, 0);
+
+    do
+    {
+        for (i = 0; i < Context->pTrace->cOps; i++)
+            ReplayOp(&prgn, &prgnTmp, prgnRect, &Context->pTrace->pop[i], Context->bInPlace);
+
+        Thread->Operations += Context->pTrace->cOps;
+    } while (!HbShouldStop(Thread));
+
+    REGION_Delete(prgnRect);
+    REGION_Delete(prgnTmp);
+    REGION_Delete(prgn);
+}
+
+#define BENCH_POINTS 4096
+
+static void
+BenchPtInRegion(PHB_THREAD Thread)
+{
+    BENCH_CONTEXT *Context = Thread->Context;
+    ULONG i, cHits = 0;
+
+    do
+    {
+        for (i = 0; i < BENCH_POINTS; i++)
+        {
+            if (Context->bInPlace)
+                cHits += REGION_PtInRegion(Context->prgn, Context->ppt[i].x, Context->ppt[i].y);
+            else
+                cHits += RefPtInRegion(Context->prgn, Context->ppt[i].x, Context->ppt[i].y);
+        }
+
+        Thread->Operations += BENCH_POINTS;
+    } while (!HbShouldStop(Thread));
+
+    /* Keep the loop */
+    if (cHits == MAXULONG)
+        printf("\n");
+}
+
+static void
+RunBenchmarks(void)
+{
+    BENCH_CONTEXT Context;
+    HB_RESULT Result;
+    PREGION prgnTmp, prgnRect;
+    char Name[64];
+    ULONG t, i;
+
+    HbReportHeader("Region combines (operations are trace steps) and hit tests");
+
+    for (t = 0; t < ARRAYSIZE(gaTraces); t++)
+    {
+        Context.pTrace = &gaTraces[t];
+
+        snprintf(Name, sizeof(Name), "%s, rebuilt", gaTraces[t].Name);
+        Context.bInPlace = FALSE;
+        if (HbSelected(Name))
+        {
+            HbRun(BenchTrace, &Context, 1, HbOptions.DurationMs, &Result);
+            HbReport(Name, &Result);
+        }
+
+        snprintf(Name, sizeof(Name), "%s, in place", gaTraces[t].Name);
+        Context.bInPlace = TRUE;
+        if (HbSelected(Name))
+        {
+            HbRun(BenchTrace, &Context, 1, HbOptions.DurationMs, &Result);
+            HbReport(Name, &Result);
+        }
+    }
+
+    /* Hit test the update region at the end of its trace */
+    Context.prgn = IntSysCreateRectpRgn(0, 0, 0, 0);
+    prgnTmp = IntSysCreateRectpRgn(0, 0, 0, 0);
+    prgnRect = IntSysCreateRectpRgn(0, 0, 0, 0);
+    for (i = 0; i < gaTraces[1].cOps; i++)
+        ReplayOp(&Context.prgn, &prgnTmp, prgnRect, &gaTraces[1].pop[i], TRUE);
+
+    Context.ppt = malloc(BENCH_POINTS * sizeof(POINTL));
+    for (i = 0; i < BENCH_POINTS; i++)
+    {
+        Context.ppt[i].x = Random() % SCREEN_CX;
+        Context.ppt[i].y = Random() % SCREEN_CY;
+    }
+
+    snprintf(Name, sizeof(Name), "PtInRegion %u rects, linear", Context.prgn->rdh.nCount);
+    Context.bInPlace = FALSE;
+    if (HbSelected(Name))
+    {
+        HbRun(BenchPtInRegion, &Context, 1, HbOptions.DurationMs, &Result);
+        HbReport(Name, &Result);
+    }
+
+    snprintf(Name, sizeof(Name), "PtInRegion %u rects, binary", Context.prgn->rdh.nCount);
+    Context.bInPlace = TRUE;
+    if (HbSelected(Name))
+    {
+        HbRun(BenchPtInRegion, &Context, 1, HbOptions.DurationMs, &Result);
+        HbReport(Name, &Result);
+    }
+
+    free(Context.ppt);
+    REGION_Delete(prgnRect);
+    REGION_Delete(prgnTmp);
+    REGION_Delete(Context.prgn);
+}
+
+int
+main(int argc, char **argv)
+{
+    if (HbParseOptions(argc, argv, NULL))
+        return 1;
+
+    MakeTraces();
+
+    if (Verify())
+        return 1;
+
+    RunBenchmarks();
+    return 0;
+}
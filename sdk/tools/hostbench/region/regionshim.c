@@ -0,0 +1,214 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     The parts of win32k region.c calls, for the host compiler
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <win32k.h>
+
+/*
+ * Objects are plain heap blocks and their handles are their addresses,
+ * which is all the bench needs: it only works on regions without a handle,
+ * through IntSysCreateRectpRgn, IntGdiCombineRgn and REGION_Delete.
+ */
+
+static PROCESSINFO gProcessInfo;
+
+POBJ
+NTAPI
+GDIOBJ_AllocateObject(UCHAR objt, ULONG cjSize, FLONG fl)
+{
+    POBJ pobj = calloc(1, cjSize);
+
+    if (pobj)
+        pobj->BaseFlags = (USHORT)fl;
+    return pobj;
+}
+
+VOID
+NTAPI
+GDIOBJ_vFreeObject(POBJ pobj)
+{
+    free(pobj);
+}
+
+HGDIOBJ
+NTAPI
+GDIOBJ_hInsertObject(POBJ pobj, ULONG ulOwner)
+{
+    pobj->hHmgr = pobj;
+    return pobj->hHmgr;
+}
+
+VOID
+NTAPI
+GDIOBJ_vDeleteObject(POBJ pobj)
+{
+    REGION_vCleanup(pobj);
+    free(pobj);
+}
+
+PVOID
+NTAPI
+GDIOBJ_LockObject(HGDIOBJ hobj, UCHAR objt)
+{
+    return hobj;
+}
+
+VOID
+NTAPI
+GDIOBJ_vUnlockObject(POBJ pobj)
+{
+}
+
+BOOL
+NTAPI
+GDIOBJ_bLockMultipleObjects(ULONG ulCount, HGDIOBJ *ahObj, PVOID *apObj, UCHAR uchType)
+{
+    ULONG i;
+
+    for (i = 0; i < ulCount; i++)
+        apObj[i] = ahObj[i];
+    return TRUE;
+}
+
+VOID
+NTAPI
+GDIOBJ_vSetObjectAttr(POBJ pobj, PVOID pvObjAttr)
+{
+}
+
+BOOL
+NTAPI
+GreSetObjectOwner(HGDIOBJ hobj, ULONG ulOwner)
+{
+    return TRUE;
+}
+
+ULONG
+NTAPI
+GreGetObjectOwner(HGDIOBJ hobj)
+{
+    return GDI_OBJ_HMGR_POWNED;
+}
+
+BOOL
+NTAPI
+GreIsHandleValid(HGDIOBJ hobj)
+{
+    return hobj != NULL;
+}
+
+BOOL
+NTAPI
+GreDeleteObject(HGDIOBJ hobj)
+{
+    GDIOBJ_vDeleteObject(hobj);
+    return TRUE;
+}
+
+PPROCESSINFO
+NTAPI
+PsGetCurrentProcessWin32Process(VOID)
+{
+    return &gProcessInfo;
+}
+
+PVOID
+NTAPI
+GdiPoolAllocate(PVOID pPool)
+{
+    return calloc(1, sizeof(RGN_ATTR));
+}
+
+VOID
+NTAPI
+GdiPoolFree(PVOID pPool, PVOID pvAlloc)
+{
+    free(pvAlloc);
+}
+
+VOID
+FASTCALL
+EngSetLastError(ULONG iError)
+{
+}
+
+VOID
+NTAPI
+SetLastNtError(NTSTATUS Status)
+{
+}
+
+/* No transforms on the host */
+VOID
+FASTCALL
+XFORMOBJ_vInit(XFORMOBJ *pxo, PMATRIX pmx)
+{
+    pxo->pmx = pmx;
+}
+
+ULONG
+FASTCALL
+XFORMOBJ_iSetXform(XFORMOBJ *pxo, const XFORML *pxform)
+{
+    return DDI_ERROR;
+}
+
+BOOL
+FASTCALL
+XFORMOBJ_bApplyXform(XFORMOBJ *pxo, ULONG iMode, ULONG cPoints, PVOID pvIn, PVOID pvOut)
+{
+    return FALSE;
+}
+
+VOID
+FASTCALL
+RECTL_vSetEmptyRect(RECTL *prcl)
+{
+    prcl->left = prcl->top = prcl->right = prcl->bottom = 0;
+}
+
+VOID
+FASTCALL
+RECTL_vMakeWellOrdered(RECTL *prcl)
+{
+    LONG lTmp;
+
+    if (prcl->left > prcl->right)
+    {
+        lTmp = prcl->left;
+        prcl->left = prcl->right;
+        prcl->right = lTmp;
+    }
+    if (prcl->top > prcl->bottom)
+    {
+        lTmp = prcl->top;
+        prcl->top = prcl->bottom;
+        prcl->bottom = lTmp;
+    }
+}
+
+BOOL
+FASTCALL
+RECTL_bUnionRect(RECTL *prclDst, const RECTL *prcl1, const RECTL *prcl2)
+{
+    if (prcl1->left >= prcl1->right || prcl1->top >= prcl1->bottom)
+    {
+        *prclDst = *prcl2;
+    }
+    else if (prcl2->left >= prcl2->right || prcl2->top >= prcl2->bottom)
+    {
+        *prclDst = *prcl1;
+    }
+    else
+    {
+        prclDst->left = min(prcl1->left, prcl2->left);
+        prclDst->top = min(prcl1->top, prcl2->top);
+        prclDst->right = max(prcl1->right, prcl2->right);
+        prclDst->bottom = max(prcl1->bottom, prcl2->bottom);
+    }
+
+    return prclDst->left < prclDst->right && prclDst->top < prclDst->bottom;
+}
@@ -0,0 +1,308 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Throughput of the RTL multibyte/Unicode conversion routines
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <string.h>
+
+#include "rtlshim.h"
+#include "../hostbench.h"
+
+/* Check the stop flag every that many conversions */
+#define BATCH 16
+
+/* Longest string in the corpus, in characters */
+#define MAX_STRING 512
+
+VOID
+HbNlsEnableAsciiFastPaths(BOOLEAN Enable);
+
+NTSTATUS NTAPI RtlMultiByteToUnicodeN(PWCHAR, ULONG, PULONG, PCSTR, ULONG);
+NTSTATUS NTAPI RtlUnicodeToMultiByteN(PCHAR, ULONG, PULONG, PCWCH, ULONG);
+NTSTATUS NTAPI RtlUpcaseUnicodeToOemN(PCHAR, ULONG, PULONG, PCWCH, ULONG);
+VOID NTAPI RtlResetRtlTranslations(PNLSTABLEINFO);
+WCHAR NTAPI RtlpUpcaseUnicodeChar(WCHAR);
+ULONG NTAPI RtlpUpcaseUnicodeRun(PWCHAR, PCWCH, ULONG);
+
+/*
+ * What the conversions mostly see: paths, registry keys and short names.
+ * The last ones have Latin-1 characters, where the fast paths stop and
+ * the tables take over.
+ */
+static const char *Corpus[] =
+{
+    "\\SystemRoot\\System32\\drivers\\etc\\hosts",
+    "\\Registry\\Machine\\System\\CurrentControlSet\\Services\\Tcpip\\Parameters\\Interfaces",
+    "C:\\ReactOS\\system32\\kernel32.dll",
+    "\\Device\\HarddiskVolume1\\Documents and Settings\\Administrator\\Application Data\\Microsoft\\Crypto\\RSA",
+    "NtQueryInformationProcess",
+    "\\??\\C:\\Program Files\\Common Files\\System\\ado\\msado15.dll",
+    "C:\\Dokumente und Einstellungen\\J\xfcrgen\\Eigene Dateien\\\xdc" "bersicht.txt",
+    "\\Registry\\User\\.DEFAULT\\Control Panel\\International\\Sorting\\Fran\xe7" "ais",
+};
+
+#define CORPUS_SIZE (sizeof(Corpus) / sizeof(Corpus[0]))
+
+typedef struct _NLS_CONTEXT
+{
+    CHAR Ansi[CORPUS_SIZE][MAX_STRING];
+    WCHAR Unicode[CORPUS_SIZE][MAX_STRING];
+    ULONG Length[CORPUS_SIZE];
+} NLS_CONTEXT, *PNLS_CONTEXT;
+
+static NLS_CONTEXT Nls;
+
+/* Latin-1 as a single byte code page, and an upcase table that only maps a-z */
+static USHORT MultiByteTable[256];
+static UCHAR WideCharTable[65536];
+static USHORT UpcaseTable[256 + 16 + 16];
+
+static VOID
+InitializeTables(VOID)
+{
+    NLSTABLEINFO TableInfo;
+    ULONG i;
+
+    for (i = 0; i < 256; i++)
+        MultiByteTable[i] = (USHORT)i;
+
+    memset(WideCharTable, '?', sizeof(WideCharTable));
+    for (i = 0; i < 256; i++)
+        WideCharTable[i] = (UCHAR)i;
+
+    /* Three levels, every character ends up on the same all-zero leaf */
+    for (i = 0; i < 256; i++)
+        UpcaseTable[i] = 256;
+    for (i = 256; i < 256 + 16; i++)
+        UpcaseTable[i] = 256 + 16;
+
+    memset(&TableInfo, 0, sizeof(TableInfo));
+    TableInfo.AnsiTableInfo.CodePage = 1252;
+    TableInfo.AnsiTableInfo.MaximumCharacterSize = 1;
+    TableInfo.AnsiTableInfo.DefaultChar = '?';
+    TableInfo.AnsiTableInfo.UniDefaultChar = '?';
+    TableInfo.AnsiTableInfo.TransDefaultChar = '?';
+    TableInfo.AnsiTableInfo.TransUniDefaultChar = '?';
+    TableInfo.AnsiTableInfo.MultiByteTable = MultiByteTable;
+    TableInfo.AnsiTableInfo.WideCharTable = WideCharTable;
+    TableInfo.OemTableInfo = TableInfo.AnsiTableInfo;
+    TableInfo.OemTableInfo.CodePage = 850;
+    TableInfo.UpperCaseTable = UpcaseTable;
+    TableInfo.LowerCaseTable = UpcaseTable;
+
+    RtlResetRtlTranslations(&TableInfo);
+}
+
+static VOID
+InitializeCorpus(VOID)
+{
+    ULONG i, j, Length;
+
+    for (i = 0; i < CORPUS_SIZE; i++)
+    {
+        Length = (ULONG)strlen(Corpus[i]);
+        for (j = 0; j < Length; j++)
+        {
+            Nls.Ansi[i][j] = Corpus[i][j];
+            Nls.Unicode[i][j] = (UCHAR)Corpus[i][j];
+        }
+        Nls.Length[i] = Length;
+    }
+}
+
+/* Compare the results of the fast paths with the plain table lookups */
+static int
+Verify(VOID)
+{
+    WCHAR Unicode[MAX_STRING];
+    CHAR Ansi[MAX_STRING];
+    ULONG i, j, Size;
+    UCHAR Expected;
+
+    for (i = 0; i < CORPUS_SIZE; i++)
+    {
+        RtlMultiByteToUnicodeN(Unicode, sizeof(Unicode), &Size, Nls.Ansi[i], Nls.Length[i]);
+        if (Size != Nls.Length[i] * sizeof(WCHAR))
+            return 0;
+        for (j = 0; j < Nls.Length[i]; j++)
+        {
+            if (Unicode[j] != MultiByteTable[(UCHAR)Nls.Ansi[i][j]])
+                return 0;
+        }
+
+        RtlUnicodeToMultiByteN(Ansi, sizeof(Ansi), &Size, Nls.Unicode[i], Nls.Length[i] * sizeof(WCHAR));
+        if (Size != Nls.Length[i] || memcmp(Ansi, Nls.Ansi[i], Size))
+            return 0;
+
+        RtlUpcaseUnicodeToOemN(Ansi, sizeof(Ansi), &Size, Nls.Unicode[i], Nls.Length[i] * sizeof(WCHAR));
+        if (Size != Nls.Length[i])
+            return 0;
+        for (j = 0; j < Nls.Length[i]; j++)
+        {
+            Expected = WideCharTable[RtlpUpcaseUnicodeChar(Nls.Unicode[i][j])];
+            if ((UCHAR)Ansi[j] != Expected)
+                return 0;
+        }
+
+        Size = RtlpUpcaseUnicodeRun(Unicode, Nls.Unicode[i], Nls.Length[i]);
+        for (j = 0; j < Size; j++)
+        {
+            if (Unicode[j] != RtlpUpcaseUnicodeChar(Nls.Unicode[i][j]) || Nls.Unicode[i][j] >= 0x80)
+                return 0;
+        }
+        if (Size != Nls.Length[i] && Nls.Unicode[i][Size] < 0x80)
+            return 0;
+    }
+
+    return 1;
+}
+
+static void
+MultiByteToUnicode(PHB_THREAD Thread)
+{
+    WCHAR Unicode[MAX_STRING];
+    ULONG Size;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            ULONG n = (ULONG)(Thread->Operations + i) % CORPUS_SIZE;
+
+            RtlMultiByteToUnicodeN(Unicode, sizeof(Unicode), &Size, Nls.Ansi[n], Nls.Length[n]);
+        }
+        Thread->Operations += BATCH;
+    }
+}
+
+static void
+UnicodeToMultiByte(PHB_THREAD Thread)
+{
+    CHAR Ansi[MAX_STRING];
+    ULONG Size;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            ULONG n = (ULONG)(Thread->Operations + i) % CORPUS_SIZE;
+
+            RtlUnicodeToMultiByteN(Ansi, sizeof(Ansi), &Size, Nls.Unicode[n], Nls.Length[n] * sizeof(WCHAR));
+        }
+        Thread->Operations += BATCH;
+    }
+}
+
+static void
+UpcaseUnicodeToOem(PHB_THREAD Thread)
+{
+    CHAR Oem[MAX_STRING];
+    ULONG Size;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            ULONG n = (ULONG)(Thread->Operations + i) % CORPUS_SIZE;
+
+            RtlUpcaseUnicodeToOemN(Oem, sizeof(Oem), &Size, Nls.Unicode[n], Nls.Length[n] * sizeof(WCHAR));
+        }
+        Thread->Operations += BATCH;
+    }
+}
+
+/* What RtlUpcaseUnicodeString does, with and without the ASCII runs */
+static void
+UpcaseUnicode(PHB_THREAD Thread)
+{
+    BOOLEAN FastPath = (BOOLEAN)(ULONG_PTR)Thread->Context;
+    WCHAR Unicode[MAX_STRING];
+    unsigned i;
+    ULONG j;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            ULONG n = (ULONG)(Thread->Operations + i) % CORPUS_SIZE;
+
+            for (j = 0; j < Nls.Length[n]; j++)
+            {
+                if (FastPath)
+                {
+                    j += RtlpUpcaseUnicodeRun(&Unicode[j], &Nls.Unicode[n][j], Nls.Length[n] - j);
+                    if (j == Nls.Length[n])
+                        break;
+                }
+                Unicode[j] = RtlpUpcaseUnicodeChar(Nls.Unicode[n][j]);
+            }
+        }
+        Thread->Operations += BATCH;
+    }
+}
+
+static void
+RunConversions(BOOLEAN FastPath)
+{
+    HB_RESULT Result;
+    char Name[64];
+    const char *Suffix = FastPath ? "ascii" : "table";
+
+    HbNlsEnableAsciiFastPaths(FastPath);
+
+    /* These are per-thread work, a single thread says it all */
+    snprintf(Name, sizeof(Name), "mb_to_unicode_%s", Suffix);
+    if (HbSelected(Name))
+    {
+        HbRun(MultiByteToUnicode, &Nls, 1, HbOptions.DurationMs, &Result);
+        HbReport(Name, &Result);
+    }
+
+    snprintf(Name, sizeof(Name), "unicode_to_mb_%s", Suffix);
+    if (HbSelected(Name))
+    {
+        HbRun(UnicodeToMultiByte, &Nls, 1, HbOptions.DurationMs, &Result);
+        HbReport(Name, &Result);
+    }
+
+    snprintf(Name, sizeof(Name), "upcase_unicode_to_oem_%s", Suffix);
+    if (HbSelected(Name))
+    {
+        HbRun(UpcaseUnicodeToOem, &Nls, 1, HbOptions.DurationMs, &Result);
+        HbReport(Name, &Result);
+    }
+
+    snprintf(Name, sizeof(Name), "upcase_unicode_%s", Suffix);
+    if (HbSelected(Name))
+    {
+        HbRun(UpcaseUnicode, (void *)(ULONG_PTR)FastPath, 1, HbOptions.DurationMs, &Result);
+        HbReport(Name, &Result);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    if (HbParseOptions(argc, argv, NULL))
+        return 1;
+
+    InitializeTables();
+    InitializeCorpus();
+
+    if (!Verify())
+    {
+        fprintf(stderr, "nlsbench: conversion results don't match the tables\n");
+        return 1;
+    }
+
+    HbReportHeader("NLS conversions (operations are strings)");
+    RunConversions(FALSE);
+    RunConversions(TRUE);
+
+    return 0;
+}
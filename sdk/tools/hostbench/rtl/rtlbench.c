@@ -0,0 +1,394 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Throughput of RTL SRW locks, critical sections, condition variables and SLists
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include "rtlshim.h"
+#include "../hostbench.h"
+
+/* Check the stop flag every that many operations */
+#define BATCH 64
+
+/* Work done while holding a lock, so the hold time isn't zero */
+#define HOLD_WORK 16
+
+/* Entries pushed per thread and round in the SList benchmark */
+#define SLIST_ENTRIES_PER_THREAD 4096
+#define SLIST_ROUNDS 32
+
+typedef struct _LOCK_CONTEXT
+{
+    RTL_SRWLOCK SRWLock;
+    RTL_CRITICAL_SECTION CriticalSection;
+    RTL_CONDITION_VARIABLE ConditionVariable;
+    volatile ULONG64 Counter;
+
+    /* Percentage of exclusive acquires in the reader/writer mix */
+    unsigned WritePercent;
+
+    /* Ping-pong state for the condition variable benchmark */
+    volatile LONG Turn;
+} LOCK_CONTEXT, *PLOCK_CONTEXT;
+
+static LOCK_CONTEXT Lock;
+
+static inline void
+HoldLock(PLOCK_CONTEXT Context)
+{
+    unsigned i;
+
+    for (i = 0; i < HOLD_WORK; i++)
+        Context->Counter++;
+}
+
+/* Cheap per-thread pseudo random generator */
+static inline ULONG
+NextRandom(ULONG *State)
+{
+    *State = *State * 1103515245 + 12345;
+    return *State >> 16;
+}
+
+static void
+SRWExclusive(PHB_THREAD Thread)
+{
+    PLOCK_CONTEXT Context = Thread->Context;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            RtlAcquireSRWLockExclusive(&Context->SRWLock);
+            HoldLock(Context);
+            RtlReleaseSRWLockExclusive(&Context->SRWLock);
+        }
+        Thread->Operations += BATCH;
+    }
+}
+
+static void
+SRWShared(PHB_THREAD Thread)
+{
+    PLOCK_CONTEXT Context = Thread->Context;
+    ULONG64 Sum = 0;
+    unsigned i, j;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            RtlAcquireSRWLockShared(&Context->SRWLock);
+            for (j = 0; j < HOLD_WORK; j++)
+                Sum += Context->Counter;
+            RtlReleaseSRWLockShared(&Context->SRWLock);
+        }
+        Thread->Operations += BATCH;
+    }
+
+    /* Don't let the compiler drop the reads */
+    if (Sum == 1)
+        printf(" ");
+}
+
+static void
+SRWMixed(PHB_THREAD Thread)
+{
+    PLOCK_CONTEXT Context = Thread->Context;
+    ULONG Seed = Thread->Index + 1;
+    ULONG64 Sum = 0;
+    unsigned i, j;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            if (NextRandom(&Seed) % 100 < Context->WritePercent)
+            {
+                RtlAcquireSRWLockExclusive(&Context->SRWLock);
+                HoldLock(Context);
+                RtlReleaseSRWLockExclusive(&Context->SRWLock);
+            }
+            else
+            {
+                RtlAcquireSRWLockShared(&Context->SRWLock);
+                for (j = 0; j < HOLD_WORK; j++)
+                    Sum += Context->Counter;
+                RtlReleaseSRWLockShared(&Context->SRWLock);
+            }
+        }
+        Thread->Operations += BATCH;
+    }
+
+    if (Sum == 1)
+        printf(" ");
+}
+
+static void
+CriticalSection(PHB_THREAD Thread)
+{
+    PLOCK_CONTEXT Context = Thread->Context;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            RtlEnterCriticalSection(&Context->CriticalSection);
+            HoldLock(Context);
+            RtlLeaveCriticalSection(&Context->CriticalSection);
+        }
+        Thread->Operations += BATCH;
+    }
+}
+
+static void
+CriticalSectionRecursive(PHB_THREAD Thread)
+{
+    PLOCK_CONTEXT Context = Thread->Context;
+    unsigned i;
+
+    while (!HbShouldStop(Thread))
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            RtlEnterCriticalSection(&Context->CriticalSection);
+            RtlEnterCriticalSection(&Context->CriticalSection);
+            HoldLock(Context);
+            RtlLeaveCriticalSection(&Context->CriticalSection);
+            RtlLeaveCriticalSection(&Context->CriticalSection);
+        }
+        Thread->Operations += BATCH;
+    }
+}
+
+/* Threads take turns, each handoff goes through a condition variable wait */
+static void
+ConditionVariablePingPong(PHB_THREAD Thread)
+{
+    PLOCK_CONTEXT Context = Thread->Context;
+    LONG Me = (LONG)Thread->Index;
+    LONG Next = (LONG)((Thread->Index + 1) % Thread->ThreadCount);
+
+    RtlAcquireSRWLockExclusive(&Context->SRWLock);
+    while (!HbShouldStop(Thread))
+    {
+        if (Context->Turn != Me)
+        {
+            LARGE_INTEGER Timeout;
+
+            /* Wake up now and then to notice the stop flag */
+            Timeout.QuadPart = -10 * 1000 * 10;
+            RtlSleepConditionVariableSRW(&Context->ConditionVariable,
+                                         &Context->SRWLock,
+                                         &Timeout,
+                                         0);
+            continue;
+        }
+
+        Context->Turn = Next;
+        Thread->Operations++;
+        RtlWakeAllConditionVariable(&Context->ConditionVariable);
+    }
+    RtlReleaseSRWLockExclusive(&Context->SRWLock);
+
+    /* Let the others notice the stop flag */
+    RtlWakeAllConditionVariable(&Context->ConditionVariable);
+}
+
+typedef struct _SLIST_CONTEXT
+{
+    SLIST_HEADER Head;
+    PSLIST_ENTRY Entries[HB_MAX_THREADS];
+    unsigned Batch;
+    volatile LONG Arrived;
+    volatile LONG Generation;
+} SLIST_CONTEXT, *PSLIST_CONTEXT;
+
+static void
+SListBarrier(PSLIST_CONTEXT Context, PHB_THREAD Thread)
+{
+    LONG Generation = Context->Generation;
+
+    if (InterlockedIncrement(&Context->Arrived) == (LONG)Thread->ThreadCount)
+    {
+        /* Last one in starts the next round with an empty list */
+        RtlInitializeSListHead(&Context->Head);
+        Context->Arrived = 0;
+        InterlockedIncrement(&Context->Generation);
+    }
+    else
+    {
+        while (Context->Generation == Generation)
+            YieldProcessor();
+    }
+}
+
+static void
+SListPush(PHB_THREAD Thread)
+{
+    PSLIST_CONTEXT Context = Thread->Context;
+    PSLIST_ENTRY Entries = Context->Entries[Thread->Index];
+    unsigned Round, i;
+
+    for (Round = 0; Round < SLIST_ROUNDS; Round++)
+    {
+        for (i = 0; i + Context->Batch <= SLIST_ENTRIES_PER_THREAD; i += Context->Batch)
+        {
+            unsigned j;
+
+            /* Chain the batch, then publish it with a single exchange */
+            for (j = 0; j + 1 < Context->Batch; j++)
+                Entries[i + j].Next = &Entries[i + j + 1];
+
+            RtlInterlockedPushListSList(&Context->Head,
+                                        &Entries[i],
+                                        &Entries[i + Context->Batch - 1],
+                                        Context->Batch);
+        }
+        Thread->Operations += SLIST_ENTRIES_PER_THREAD;
+
+        SListBarrier(Context, Thread);
+    }
+}
+
+static void
+RunSRW(void)
+{
+    static const unsigned WritePercents[] = { 1, 10, 50 };
+    char Name[64];
+    unsigned i;
+
+    HbReportHeader("SRW locks");
+
+    RtlInitializeSRWLock(&Lock.SRWLock);
+    HbRunScaling("srw_exclusive", SRWExclusive, &Lock);
+    HbRunScaling("srw_shared", SRWShared, &Lock);
+
+    for (i = 0; i < sizeof(WritePercents) / sizeof(WritePercents[0]); i++)
+    {
+        Lock.WritePercent = WritePercents[i];
+        snprintf(Name, sizeof(Name), "srw_mixed_%u%%_writes", WritePercents[i]);
+        HbRunScaling(Name, SRWMixed, &Lock);
+    }
+}
+
+static void
+RunCriticalSection(void)
+{
+    HbReportHeader("Critical sections");
+
+    RtlInitializeCriticalSection(&Lock.CriticalSection);
+    HbRunScaling("cs_enter_leave", CriticalSection, &Lock);
+    HbRunScaling("cs_recursive", CriticalSectionRecursive, &Lock);
+    RtlDeleteCriticalSection(&Lock.CriticalSection);
+
+    RtlInitializeCriticalSectionAndSpinCount(&Lock.CriticalSection, 4000);
+    HbRunScaling("cs_enter_leave_spin4000", CriticalSection, &Lock);
+    RtlDeleteCriticalSection(&Lock.CriticalSection);
+}
+
+static void
+RunConditionVariable(void)
+{
+    HB_RESULT Result;
+    unsigned Threads;
+
+    if (!HbSelected("condvar_pingpong"))
+        return;
+
+    HbReportHeader("Condition variables");
+
+    RtlInitializeSRWLock(&Lock.SRWLock);
+    RtlInitializeConditionVariable(&Lock.ConditionVariable);
+
+    /* Handoffs need at least two threads */
+    for (Threads = 2; Threads <= HbOptions.MaxThreads; Threads *= 2)
+    {
+        Lock.Turn = 0;
+        HbRun(ConditionVariablePingPong, &Lock, Threads, HbOptions.DurationMs, &Result);
+        HbReport("condvar_pingpong", &Result);
+    }
+}
+
+static void
+RunSList(void)
+{
+    static const unsigned Batches[] = { 1, 16 };
+    SLIST_CONTEXT *Context;
+    HB_RESULT Result;
+    char Name[64];
+    unsigned Threads, i, b;
+
+    if (!HbSelected("slist"))
+        return;
+
+    HbReportHeader("SLists");
+
+    Context = HbAlignedAlloc(16, sizeof(*Context));
+    for (i = 0; i < HB_MAX_THREADS; i++)
+        Context->Entries[i] = HbAlignedAlloc(16, SLIST_ENTRIES_PER_THREAD * sizeof(SLIST_ENTRY));
+
+    for (b = 0; b < sizeof(Batches) / sizeof(Batches[0]); b++)
+    {
+        snprintf(Name, sizeof(Name), "slist_push_batch%u", Batches[b]);
+
+        for (Threads = 1; Threads <= HbOptions.MaxThreads; Threads *= 2)
+        {
+            RtlInitializeSListHead(&Context->Head);
+            Context->Batch = Batches[b];
+            Context->Arrived = 0;
+            Context->Generation = 0;
+
+            /* Fixed amount of work, timed from start to the last thread */
+            HbRun(SListPush, Context, Threads, 0, &Result);
+            HbReport(Name, &Result);
+        }
+    }
+
+    for (i = 0; i < HB_MAX_THREADS; i++)
+        free(Context->Entries[i]);
+    free(Context);
+}
+
+/* Contention counters the RTL keeps, accumulated over all the runs */
+static void
+ReportLockStatistics(void)
+{
+    RTL_PROCESS_LOCK_STATISTICS Statistics;
+
+    RtlpQueryCriticalSectionStatistics(&Statistics);
+    RtlpQuerySRWLockStatistics(&Statistics);
+
+    printf("\nLock statistics\n");
+    printf("%-32s %14lu\n", "cs_spin_acquires", (unsigned long)Statistics.CriticalSectionSpinAcquires);
+    printf("%-32s %14lu\n", "cs_spin_failures", (unsigned long)Statistics.CriticalSectionSpinFailures);
+    printf("%-32s %14lu\n", "cs_waits", (unsigned long)Statistics.CriticalSectionWaits);
+    printf("%-32s %14lu\n", "cs_handoffs", (unsigned long)Statistics.CriticalSectionHandoffs);
+    printf("%-32s %14lu\n", "srw_spin_acquires", (unsigned long)Statistics.SRWLockSpinAcquires);
+    printf("%-32s %14lu\n", "srw_yields", (unsigned long)Statistics.SRWLockYields);
+    printf("%-32s %14lu\n", "srw_waits", (unsigned long)Statistics.SRWLockWaits);
+    printf("%-32s %14lu\n", "srw_handoffs", (unsigned long)Statistics.SRWLockHandoffs);
+}
+
+int
+main(int argc, char **argv)
+{
+    if (HbParseOptions(argc, argv, NULL))
+        return 1;
+
+    HbRtlInitialize();
+
+    RunSRW();
+    RunCriticalSection();
+    RunConditionVariable();
+#if defined(_M_AMD64) || defined(_M_IX86)
+    RunSList();
+#endif
+
+    ReportLockStatistics();
+
+    return 0;
+}
@@ -0,0 +1,18 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Builds the RTL NLS conversion code against the host shim
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include "rtlshim.h"
+
+#include <nls.c>
+
+/* Lets the benchmark compare the ASCII fast paths against the table walks */
+VOID
+HbNlsEnableAsciiFastPaths(BOOLEAN Enable)
+{
+    NlsAnsiAsciiCompatible = Enable;
+    NlsOemAsciiCompatible = Enable;
+}
@@ -0,0 +1,393 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     NT event, keyed event, heap and environment emulation
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "rtlshim.h"
+
+extern BOOLEAN RtlpTimeoutDisable;
+
+BOOLEAN LdrpShutdownInProgress = FALSE;
+HANDLE LdrpShutdownThreadId = NULL;
+
+static PEB HbPeb;
+static __thread TEB HbTeb;
+static LONG HbNextThreadId = 0;
+
+#define HB_OBJECT_EVENT         1
+#define HB_OBJECT_KEYED_EVENT   2
+
+typedef struct _HB_OBJECT
+{
+    ULONG Type;
+    pthread_mutex_t Mutex;
+    pthread_cond_t Cond;
+    EVENT_TYPE EventType;
+    BOOLEAN Signaled;
+    LIST_ENTRY Waiters;
+} HB_OBJECT, *PHB_OBJECT;
+
+/* A thread blocked in NtWaitForKeyedEvent or NtReleaseKeyedEvent */
+typedef struct _HB_KEYED_WAITER
+{
+    LIST_ENTRY ListEntry;
+    PVOID Key;
+    BOOLEAN Release;
+    BOOLEAN Matched;
+    pthread_cond_t Cond;
+} HB_KEYED_WAITER, *PHB_KEYED_WAITER;
+
+/* Used for the NULL keyed event handle, like the kernel's global one */
+static HB_OBJECT HbGlobalKeyedEvent;
+
+PTEB
+NtCurrentTeb(VOID)
+{
+    if (!HbTeb.ClientId.UniqueThread)
+    {
+        /* Lazily give every host thread a unique, non-zero id */
+        HbTeb.ClientId.UniqueProcess = (HANDLE)(ULONG_PTR)getpid();
+        HbTeb.ClientId.UniqueThread =
+            (HANDLE)(ULONG_PTR)(ULONG)(InterlockedIncrement(&HbNextThreadId) * 4);
+        HbTeb.RealClientId = HbTeb.ClientId;
+    }
+
+    return &HbTeb;
+}
+
+PPEB
+NtCurrentPeb(VOID)
+{
+    return &HbPeb;
+}
+
+static VOID
+HbInitializeObject(PHB_OBJECT Object, ULONG Type)
+{
+    Object->Type = Type;
+    pthread_mutex_init(&Object->Mutex, NULL);
+    pthread_cond_init(&Object->Cond, NULL);
+    Object->EventType = NotificationEvent;
+    Object->Signaled = FALSE;
+    InitializeListHead(&Object->Waiters);
+}
+
+/* Convert an NT timeout into an absolute CLOCK_REALTIME deadline */
+static VOID
+HbTimeoutToDeadline(PLARGE_INTEGER Timeout, struct timespec *Deadline)
+{
+    LONGLONG Ns;
+
+    clock_gettime(CLOCK_REALTIME, Deadline);
+
+    /* Negative values are relative, in 100ns units. Absolute ones are
+       treated as "now", nothing here waits for a wall clock time. */
+    Ns = (Timeout->QuadPart < 0) ? -Timeout->QuadPart * 100 : 0;
+    Deadline->tv_sec += Ns / 1000000000;
+    Deadline->tv_nsec += Ns % 1000000000;
+    if (Deadline->tv_nsec >= 1000000000)
+    {
+        Deadline->tv_sec++;
+        Deadline->tv_nsec -= 1000000000;
+    }
+}
+
+NTSTATUS
+NTAPI
+NtCreateEvent(
+    PHANDLE EventHandle,
+    ACCESS_MASK DesiredAccess,
+    POBJECT_ATTRIBUTES ObjectAttributes,
+    EVENT_TYPE EventType,
+    BOOLEAN InitialState)
+{
+    PHB_OBJECT Event = malloc(sizeof(*Event));
+
+    if (!Event)
+        return STATUS_NO_MEMORY;
+
+    HbInitializeObject(Event, HB_OBJECT_EVENT);
+    Event->EventType = EventType;
+    Event->Signaled = InitialState;
+
+    *EventHandle = Event;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+NTAPI
+NtSetEvent(
+    HANDLE EventHandle,
+    PLONG PreviousState)
+{
+    PHB_OBJECT Event = EventHandle;
+
+    if (!Event || Event->Type != HB_OBJECT_EVENT)
+        return STATUS_INVALID_HANDLE;
+
+    pthread_mutex_lock(&Event->Mutex);
+    if (PreviousState)
+        *PreviousState = Event->Signaled;
+    Event->Signaled = TRUE;
+    if (Event->EventType == SynchronizationEvent)
+        pthread_cond_signal(&Event->Cond);
+    else
+        pthread_cond_broadcast(&Event->Cond);
+    pthread_mutex_unlock(&Event->Mutex);
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+NTAPI
+NtWaitForSingleObject(
+    HANDLE Handle,
+    BOOLEAN Alertable,
+    PLARGE_INTEGER Timeout)
+{
+    PHB_OBJECT Event = Handle;
+    struct timespec Deadline;
+    NTSTATUS Status = STATUS_SUCCESS;
+
+    if (!Event || Event->Type != HB_OBJECT_EVENT)
+        return STATUS_INVALID_HANDLE;
+
+    if (Timeout)
+        HbTimeoutToDeadline(Timeout, &Deadline);
+
+    pthread_mutex_lock(&Event->Mutex);
+    while (!Event->Signaled)
+    {
+        if (!Timeout)
+        {
+            pthread_cond_wait(&Event->Cond, &Event->Mutex);
+        }
+        else if (pthread_cond_timedwait(&Event->Cond, &Event->Mutex, &Deadline) == ETIMEDOUT)
+        {
+            Status = STATUS_TIMEOUT;
+            break;
+        }
+    }
+    if (Status == STATUS_SUCCESS && Event->EventType == SynchronizationEvent)
+        Event->Signaled = FALSE;
+    pthread_mutex_unlock(&Event->Mutex);
+
+    return Status;
+}
+
+NTSTATUS
+NTAPI
+NtCreateKeyedEvent(
+    PHANDLE EventHandle,
+    ACCESS_MASK DesiredAccess,
+    POBJECT_ATTRIBUTES ObjectAttributes,
+    ULONG Flags)
+{
+    PHB_OBJECT KeyedEvent = malloc(sizeof(*KeyedEvent));
+
+    if (!KeyedEvent)
+        return STATUS_NO_MEMORY;
+
+    HbInitializeObject(KeyedEvent, HB_OBJECT_KEYED_EVENT);
+
+    *EventHandle = KeyedEvent;
+    return STATUS_SUCCESS;
+}
+
+/*
+ * Keyed events are a rendezvous: a wait blocks until a release with the
+ * same key comes in, and a release blocks until a waiter shows up.
+ */
+static NTSTATUS
+HbKeyedEventRendezvous(
+    HANDLE EventHandle,
+    PVOID Key,
+    BOOLEAN Release,
+    PLARGE_INTEGER Timeout)
+{
+    PHB_OBJECT KeyedEvent = EventHandle ? EventHandle : &HbGlobalKeyedEvent;
+    HB_KEYED_WAITER Self;
+    PHB_KEYED_WAITER Other;
+    PLIST_ENTRY Entry;
+    struct timespec Deadline;
+    NTSTATUS Status = STATUS_SUCCESS;
+
+    if (KeyedEvent->Type != HB_OBJECT_KEYED_EVENT)
+        return STATUS_INVALID_HANDLE;
+
+    if (Timeout)
+        HbTimeoutToDeadline(Timeout, &Deadline);
+
+    pthread_mutex_lock(&KeyedEvent->Mutex);
+
+    /* Look for a counterpart that's already waiting */
+    for (Entry = KeyedEvent->Waiters.Flink;
+         Entry != &KeyedEvent->Waiters;
+         Entry = Entry->Flink)
+    {
+        Other = CONTAINING_RECORD(Entry, HB_KEYED_WAITER, ListEntry);
+        if (Other->Key == Key && Other->Release != Release)
+        {
+            RemoveEntryList(&Other->ListEntry);
+            Other->Matched = TRUE;
+            pthread_cond_signal(&Other->Cond);
+            pthread_mutex_unlock(&KeyedEvent->Mutex);
+            return STATUS_SUCCESS;
+        }
+    }
+
+    /* None, queue ourselves */
+    Self.Key = Key;
+    Self.Release = Release;
+    Self.Matched = FALSE;
+    pthread_cond_init(&Self.Cond, NULL);
+    InsertTailList(&KeyedEvent->Waiters, &Self.ListEntry);
+
+    while (!Self.Matched)
+    {
+        if (!Timeout)
+        {
+            pthread_cond_wait(&Self.Cond, &KeyedEvent->Mutex);
+        }
+        else if (pthread_cond_timedwait(&Self.Cond, &KeyedEvent->Mutex, &Deadline) == ETIMEDOUT &&
+                 !Self.Matched)
+        {
+            RemoveEntryList(&Self.ListEntry);
+            Status = STATUS_TIMEOUT;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&KeyedEvent->Mutex);
+    pthread_cond_destroy(&Self.Cond);
+
+    return Status;
+}
+
+NTSTATUS
+NTAPI
+NtWaitForKeyedEvent(
+    HANDLE EventHandle,
+    PVOID Key,
+    BOOLEAN Alertable,
+    PLARGE_INTEGER Timeout)
+{
+    return HbKeyedEventRendezvous(EventHandle, Key, FALSE, Timeout);
+}
+
+NTSTATUS
+NTAPI
+NtReleaseKeyedEvent(
+    HANDLE EventHandle,
+    PVOID Key,
+    BOOLEAN Alertable,
+    PLARGE_INTEGER Timeout)
+{
+    return HbKeyedEventRendezvous(EventHandle, Key, TRUE, Timeout);
+}
+
+NTSTATUS
+NTAPI
+NtClose(
+    HANDLE Handle)
+{
+    PHB_OBJECT Object = Handle;
+
+    if (!Object || Object == INVALID_HANDLE_VALUE || Object == &HbGlobalKeyedEvent)
+        return STATUS_INVALID_HANDLE;
+
+    pthread_cond_destroy(&Object->Cond);
+    pthread_mutex_destroy(&Object->Mutex);
+    free(Object);
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+NTAPI
+NtYieldExecution(VOID)
+{
+    sched_yield();
+    return STATUS_SUCCESS;
+}
+
+PVOID
+NTAPI
+RtlAllocateHeap(
+    HANDLE HeapHandle,
+    ULONG Flags,
+    SIZE_T Size)
+{
+    return (Flags & HEAP_ZERO_MEMORY) ? calloc(1, Size) : malloc(Size);
+}
+
+BOOLEAN
+NTAPI
+RtlFreeHeap(
+    HANDLE HeapHandle,
+    ULONG Flags,
+    PVOID BaseAddress)
+{
+    free(BaseAddress);
+    return TRUE;
+}
+
+VOID
+NTAPI
+RtlRaiseStatus(
+    NTSTATUS Status)
+{
+    fprintf(stderr, "RtlRaiseStatus(0x%08x)\n", (unsigned)Status);
+    abort();
+}
+
+VOID
+NTAPI
+RtlRaiseException(
+    PEXCEPTION_RECORD ExceptionRecord)
+{
+    fprintf(stderr, "RtlRaiseException(0x%08x)\n", (unsigned)ExceptionRecord->ExceptionCode);
+    abort();
+}
+
+PVOID
+NTAPI
+RtlpDebugBufferCommit(
+    PRTL_DEBUG_INFORMATION Buffer,
+    SIZE_T Size)
+{
+    PVOID Result;
+
+    /* The buffer is allocated up front, it doesn't grow */
+    if (Buffer->CommitSize - Buffer->OffsetFree < Size)
+        return NULL;
+
+    Result = (PUCHAR)Buffer->ViewBaseClient + Buffer->OffsetFree;
+    Buffer->OffsetFree += Size;
+    return Result;
+}
+
+VOID
+HbRtlInitialize(VOID)
+{
+    HbPeb.ProcessHeap = (HANDLE)&HbPeb;
+    HbPeb.NumberOfProcessors = (ULONG)sysconf(_SC_NPROCESSORS_ONLN);
+    HbPeb.OSMajorVersion = 5;
+    HbPeb.OSMinorVersion = 2;
+
+    HbInitializeObject(&HbGlobalKeyedEvent, HB_OBJECT_KEYED_EVENT);
+
+    /* Like LdrpInitializeProcess does for the default (huge) timeout */
+    RtlpTimeoutDisable = TRUE;
+
+    RtlpInitDeferredCriticalSection();
+    RtlpInitializeKeyedEvent();
+}
@@ -0,0 +1,517 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Minimal NT environment for building RTL code on the host
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+#include <typedefs.h>
+
+/* Pick the same code paths as the target would */
+#if defined(__x86_64__)
+#define _M_AMD64
+#define _WIN64
+#elif defined(__i386__)
+#define _M_IX86
+#endif
+
+#define FASTCALL
+#define CONST const
+#define FORCEINLINE static __inline __attribute__((always_inline))
+#define DECLSPEC_ALIGN(x) __attribute__((aligned(x)))
+#define __ALIGNED(x) __attribute__((aligned(x)))
+
+/* SAL annotations used by the RTL sources */
+#define _In_
+#define _In_opt_
+#define _Out_
+#define _Inout_
+#define _At_(Target, Annotation)
+#define _Post_notnull_
+#define __drv_aliasesMem
+
+#define LongToPtr(l) ((PVOID)(LONG_PTR)(LONG)(l))
+#define INVALID_HANDLE_VALUE ((HANDLE)(LONG_PTR)-1)
+
+#define ERROR_DBGBREAK(...) do { printf(__VA_ARGS__); } while (0)
+#define PAGED_CODE_RTL()
+
+#if defined(__i386__) || defined(__x86_64__)
+#define YieldProcessor() __builtin_ia32_pause()
+#else
+#define YieldProcessor() __asm__ __volatile__("" ::: "memory")
+#endif
+
+#define _WIN32_WINNT_WIN7 0x0601
+
+/* Types typedefs.h doesn't provide */
+typedef HANDLE *PHANDLE;
+typedef LONGLONG *PLONGLONG, *PLONG64;
+typedef const UCHAR *PCUCHAR;
+typedef const CHAR *PCCH;
+typedef const WCHAR *PCWCH;
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+#define HandleToUlong(h) ((ULONG)(ULONG_PTR)(h))
+
+/* Status codes */
+#define STATUS_SUCCESS                   ((NTSTATUS)0x00000000)
+#define STATUS_TIMEOUT                   ((NTSTATUS)0x00000102)
+#define STATUS_DATATYPE_MISALIGNMENT     ((NTSTATUS)0x80000002)
+#define STATUS_BUFFER_OVERFLOW           ((NTSTATUS)0x80000005)
+#define STATUS_UNSUCCESSFUL              ((NTSTATUS)0xC0000001)
+#define STATUS_INVALID_HANDLE            ((NTSTATUS)0xC0000008)
+#define STATUS_INVALID_PARAMETER         ((NTSTATUS)0xC000000D)
+#define STATUS_NO_MEMORY                 ((NTSTATUS)0xC0000017)
+#define STATUS_INVALID_PARAMETER_2       ((NTSTATUS)0xC00000F0)
+#define STATUS_INVALID_PARAMETER_3       ((NTSTATUS)0xC00000F1)
+#define STATUS_POSSIBLE_DEADLOCK         ((NTSTATUS)0xC0000194)
+#define STATUS_RESOURCE_NOT_OWNED        ((NTSTATUS)0xC0000264)
+
+/* Interlocked operations */
+#define InterlockedIncrement(p)              __atomic_add_fetch((volatile LONG *)(p), 1, __ATOMIC_SEQ_CST)
+#define InterlockedDecrement(p)              __atomic_sub_fetch((volatile LONG *)(p), 1, __ATOMIC_SEQ_CST)
+#define InterlockedExchangeAdd(p, v)         __atomic_fetch_add((volatile LONG *)(p), (LONG)(v), __ATOMIC_SEQ_CST)
+#define InterlockedAdd(p, v)                 __atomic_add_fetch((volatile LONG *)(p), (LONG)(v), __ATOMIC_SEQ_CST)
+#define InterlockedAnd(p, v)                 __atomic_fetch_and((volatile LONG *)(p), (LONG)(v), __ATOMIC_SEQ_CST)
+#define InterlockedOr(p, v)                  __atomic_fetch_or((volatile LONG *)(p), (LONG)(v), __ATOMIC_SEQ_CST)
+#define InterlockedExchange(p, v)            __atomic_exchange_n((volatile LONG *)(p), (LONG)(v), __ATOMIC_SEQ_CST)
+#define InterlockedAdd64(p, v)               __atomic_add_fetch((volatile LONGLONG *)(p), (LONGLONG)(v), __ATOMIC_SEQ_CST)
+#define InterlockedAnd64(p, v)               __atomic_fetch_and((volatile LONGLONG *)(p), (LONGLONG)(v), __ATOMIC_SEQ_CST)
+#define InterlockedOr64(p, v)                __atomic_fetch_or((volatile LONGLONG *)(p), (LONGLONG)(v), __ATOMIC_SEQ_CST)
+#define InterlockedExchangePointer(p, v)     __atomic_exchange_n((PVOID volatile *)(p), (PVOID)(v), __ATOMIC_SEQ_CST)
+
+FORCEINLINE
+LONG
+InterlockedCompareExchange(volatile LONG *Destination, LONG Exchange, LONG Comperand)
+{
+    __atomic_compare_exchange_n(Destination, &Comperand, Exchange, 0,
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return Comperand;
+}
+
+FORCEINLINE
+LONGLONG
+InterlockedCompareExchange64(volatile LONGLONG *Destination, LONGLONG Exchange, LONGLONG Comperand)
+{
+    __atomic_compare_exchange_n(Destination, &Comperand, Exchange, 0,
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return Comperand;
+}
+
+FORCEINLINE
+PVOID
+HbInterlockedCompareExchangePointer(PVOID volatile *Destination, PVOID Exchange, PVOID Comperand, int Order)
+{
+    __atomic_compare_exchange_n(Destination, &Comperand, Exchange, 0,
+                                Order, __ATOMIC_RELAXED);
+    return Comperand;
+}
+
+#define InterlockedCompareExchangePointer(p, e, c) \
+    HbInterlockedCompareExchangePointer((PVOID volatile *)(p), (PVOID)(e), (PVOID)(c), __ATOMIC_SEQ_CST)
+#define InterlockedCompareExchangePointerAcquire(p, e, c) \
+    HbInterlockedCompareExchangePointer((PVOID volatile *)(p), (PVOID)(e), (PVOID)(c), __ATOMIC_ACQUIRE)
+#define InterlockedCompareExchangePointerRelease(p, e, c) \
+    HbInterlockedCompareExchangePointer((PVOID volatile *)(p), (PVOID)(e), (PVOID)(c), __ATOMIC_RELEASE)
+
+#define InterlockedBitTestAndSet(p, b) \
+    ((BOOLEAN)((__atomic_fetch_or((volatile LONG *)(p), (LONG)1 << (b), __ATOMIC_SEQ_CST) >> (b)) & 1))
+#define InterlockedBitTestAndSet64(p, b) \
+    ((BOOLEAN)((__atomic_fetch_or((volatile LONGLONG *)(p), (LONGLONG)1 << (b), __ATOMIC_SEQ_CST) >> (b)) & 1))
+
+#ifdef _WIN64
+FORCEINLINE
+BOOLEAN
+_InterlockedCompareExchange128(volatile LONG64 *Destination,
+                               LONG64 ExchangeHigh,
+                               LONG64 ExchangeLow,
+                               LONG64 *ComparandResult)
+{
+    unsigned __int128 Exchange = ((unsigned __int128)(ULONG64)ExchangeHigh << 64) | (ULONG64)ExchangeLow;
+    unsigned __int128 Comperand = ((unsigned __int128)(ULONG64)ComparandResult[1] << 64) | (ULONG64)ComparandResult[0];
+    unsigned __int128 Old;
+
+    Old = __sync_val_compare_and_swap((volatile unsigned __int128 *)Destination, Comperand, Exchange);
+    ComparandResult[0] = (LONG64)(ULONG64)Old;
+    ComparandResult[1] = (LONG64)(ULONG64)(Old >> 64);
+    return Old == Comperand;
+}
+#endif
+
+/* Objects */
+typedef ULONG ACCESS_MASK;
+typedef struct _OBJECT_ATTRIBUTES *POBJECT_ATTRIBUTES;
+
+#define EVENT_ALL_ACCESS 0x1F0003
+
+typedef enum _EVENT_TYPE
+{
+    NotificationEvent,
+    SynchronizationEvent
+} EVENT_TYPE;
+
+/* Thread and process environment, only what the RTL sources look at */
+typedef struct _CLIENT_ID
+{
+    HANDLE UniqueProcess;
+    HANDLE UniqueThread;
+} CLIENT_ID, *PCLIENT_ID;
+
+typedef struct _TEB
+{
+    CLIENT_ID ClientId;
+    CLIENT_ID RealClientId;
+    ULONG CountOfOwnedCriticalSections;
+} TEB, *PTEB;
+
+typedef struct _PEB
+{
+    HANDLE ProcessHeap;
+    ULONG NumberOfProcessors;
+    ULONG OSMajorVersion;
+    ULONG OSMinorVersion;
+} PEB, *PPEB;
+
+PTEB
+NtCurrentTeb(VOID);
+
+PPEB
+NtCurrentPeb(VOID);
+
+#define RtlGetProcessHeap() (NtCurrentPeb()->ProcessHeap)
+
+#define HEAP_ZERO_MEMORY 0x00000008
+
+/* Exceptions */
+#define EXCEPTION_MAXIMUM_PARAMETERS 15
+
+typedef struct _EXCEPTION_RECORD
+{
+    NTSTATUS ExceptionCode;
+    ULONG ExceptionFlags;
+    struct _EXCEPTION_RECORD *ExceptionRecord;
+    PVOID ExceptionAddress;
+    ULONG NumberParameters;
+    ULONG_PTR ExceptionInformation[EXCEPTION_MAXIMUM_PARAMETERS];
+} EXCEPTION_RECORD, *PEXCEPTION_RECORD;
+
+/* Synchronization types */
+typedef struct _RTL_SRWLOCK
+{
+    PVOID Ptr;
+} RTL_SRWLOCK, *PRTL_SRWLOCK;
+
+typedef struct _RTL_CONDITION_VARIABLE
+{
+    PVOID Ptr;
+} RTL_CONDITION_VARIABLE, *PRTL_CONDITION_VARIABLE;
+
+#define RTL_CONDITION_VARIABLE_LOCKMODE_SHARED 0x1
+
+#define RTL_CRITSECT_TYPE 0
+
+#define RTL_CRITICAL_SECTION_FLAG_NO_DEBUG_INFO    0x01000000
+#define RTL_CRITICAL_SECTION_FLAG_DYNAMIC_SPIN     0x02000000
+#define RTL_CRITICAL_SECTION_FLAG_STATIC_INIT      0x04000000
+#define RTL_CRITICAL_SECTION_FLAG_RESOURCE_TYPE    0x08000000
+#define RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO 0x10000000
+#define RTL_CRITICAL_SECTION_ALL_FLAG_BITS         0xFF000000
+
+typedef struct _RTL_CRITICAL_SECTION_DEBUG
+{
+    WORD Type;
+    WORD CreatorBackTraceIndex;
+    struct _RTL_CRITICAL_SECTION *CriticalSection;
+    LIST_ENTRY ProcessLocksList;
+    DWORD EntryCount;
+    DWORD ContentionCount;
+    DWORD Flags;
+    WORD CreatorBackTraceIndexHigh;
+    WORD SpareWORD;
+} RTL_CRITICAL_SECTION_DEBUG, *PRTL_CRITICAL_SECTION_DEBUG;
+
+typedef struct _RTL_CRITICAL_SECTION
+{
+    PRTL_CRITICAL_SECTION_DEBUG DebugInfo;
+    LONG LockCount;
+    LONG RecursionCount;
+    HANDLE OwningThread;
+    HANDLE LockSemaphore;
+    ULONG_PTR SpinCount;
+} RTL_CRITICAL_SECTION, *PRTL_CRITICAL_SECTION;
+
+/* SLists, same layout as the target */
+#ifdef _WIN64
+typedef struct DECLSPEC_ALIGN(16) _SLIST_ENTRY
+{
+    struct _SLIST_ENTRY *Next;
+} SLIST_ENTRY, *PSLIST_ENTRY;
+
+typedef union DECLSPEC_ALIGN(16) _SLIST_HEADER
+{
+    struct
+    {
+        ULONGLONG Alignment;
+        ULONGLONG Region;
+    };
+    struct
+    {
+        ULONGLONG Depth:16;
+        ULONGLONG Sequence:9;
+        ULONGLONG NextEntry:39;
+        ULONGLONG HeaderType:1;
+        ULONGLONG Init:1;
+        ULONGLONG Reserved:59;
+        ULONGLONG Region:3;
+    } Header8;
+    struct
+    {
+        ULONGLONG Depth:16;
+        ULONGLONG Sequence:48;
+        ULONGLONG HeaderType:1;
+        ULONGLONG Init:1;
+        ULONGLONG Reserved:2;
+        ULONGLONG NextEntry:60;
+    } Header16;
+} SLIST_HEADER, *PSLIST_HEADER;
+#else
+typedef struct _SLIST_ENTRY
+{
+    struct _SLIST_ENTRY *Next;
+} SLIST_ENTRY, *PSLIST_ENTRY;
+
+typedef union _SLIST_HEADER
+{
+    ULONGLONG Alignment;
+    struct
+    {
+        SLIST_ENTRY Next;
+        WORD Depth;
+        WORD Sequence;
+    };
+} SLIST_HEADER, *PSLIST_HEADER;
+#endif
+
+/* Code page tables, see ntnls.h */
+#define MAXIMUM_LEADBYTES 12
+
+typedef struct _CPTABLEINFO
+{
+    USHORT CodePage;
+    USHORT MaximumCharacterSize;
+    USHORT DefaultChar;
+    USHORT UniDefaultChar;
+    USHORT TransDefaultChar;
+    USHORT TransUniDefaultChar;
+    USHORT DBCSCodePage;
+    UCHAR LeadByte[MAXIMUM_LEADBYTES];
+    PUSHORT MultiByteTable;
+    PVOID WideCharTable;
+    PUSHORT DBCSRanges;
+    PUSHORT DBCSOffsets;
+} CPTABLEINFO, *PCPTABLEINFO;
+
+typedef struct _NLSTABLEINFO
+{
+    CPTABLEINFO OemTableInfo;
+    CPTABLEINFO AnsiTableInfo;
+    PUSHORT UpperCaseTable;
+    PUSHORT LowerCaseTable;
+} NLSTABLEINFO, *PNLSTABLEINFO;
+
+typedef struct _NLS_FILE_HEADER
+{
+    USHORT HeaderSize;
+    USHORT CodePage;
+    USHORT MaximumCharacterSize;
+    USHORT DefaultChar;
+    USHORT UniDefaultChar;
+    USHORT TransDefaultChar;
+    USHORT TransUniDefaultChar;
+    UCHAR LeadByte[MAXIMUM_LEADBYTES];
+} NLS_FILE_HEADER, *PNLS_FILE_HEADER;
+
+/* Lock information of RtlQueryProcessDebugInformation */
+typedef struct _RTL_PROCESS_LOCK_INFORMATION
+{
+    PVOID Address;
+    USHORT Type;
+    USHORT CreatorBackTraceIndex;
+    ULONG OwnerThreadId;
+    ULONG ActiveCount;
+    ULONG ContentionCount;
+    ULONG EntryCount;
+    ULONG RecursionCount;
+    ULONG NumberOfSharedWaiters;
+    ULONG NumberOfExclusiveWaiters;
+} RTL_PROCESS_LOCK_INFORMATION, *PRTL_PROCESS_LOCK_INFORMATION;
+
+typedef struct _RTL_PROCESS_LOCKS
+{
+    ULONG NumberOfLocks;
+    RTL_PROCESS_LOCK_INFORMATION Locks[1];
+} RTL_PROCESS_LOCKS, *PRTL_PROCESS_LOCKS;
+
+typedef struct _RTL_PROCESS_LOCK_STATISTICS
+{
+    ULONG CriticalSectionSpinAcquires;
+    ULONG CriticalSectionSpinFailures;
+    ULONG CriticalSectionWaits;
+    ULONG CriticalSectionHandoffs;
+    ULONG SRWLockSpinAcquires;
+    ULONG SRWLockYields;
+    ULONG SRWLockWaits;
+    ULONG SRWLockHandoffs;
+} RTL_PROCESS_LOCK_STATISTICS, *PRTL_PROCESS_LOCK_STATISTICS;
+
+/* Only what the RTL sources use, backed by a malloc'ed block */
+typedef struct _RTL_DEBUG_INFORMATION
+{
+    PVOID ViewBaseClient;
+    ULONG_PTR OffsetFree;
+    SIZE_T CommitSize;
+    PRTL_PROCESS_LOCKS Locks;
+    PRTL_PROCESS_LOCK_STATISTICS LockStatistics;
+} RTL_DEBUG_INFORMATION, *PRTL_DEBUG_INFORMATION;
+
+/* NT services emulated on top of pthreads */
+NTSTATUS
+NTAPI
+NtCreateEvent(
+    PHANDLE EventHandle,
+    ACCESS_MASK DesiredAccess,
+    POBJECT_ATTRIBUTES ObjectAttributes,
+    EVENT_TYPE EventType,
+    BOOLEAN InitialState);
+
+NTSTATUS
+NTAPI
+NtSetEvent(
+    HANDLE EventHandle,
+    PLONG PreviousState);
+
+NTSTATUS
+NTAPI
+NtWaitForSingleObject(
+    HANDLE Handle,
+    BOOLEAN Alertable,
+    PLARGE_INTEGER Timeout);
+
+NTSTATUS
+NTAPI
+NtCreateKeyedEvent(
+    PHANDLE EventHandle,
+    ACCESS_MASK DesiredAccess,
+    POBJECT_ATTRIBUTES ObjectAttributes,
+    ULONG Flags);
+
+NTSTATUS
+NTAPI
+NtWaitForKeyedEvent(
+    HANDLE EventHandle,
+    PVOID Key,
+    BOOLEAN Alertable,
+    PLARGE_INTEGER Timeout);
+
+NTSTATUS
+NTAPI
+NtReleaseKeyedEvent(
+    HANDLE EventHandle,
+    PVOID Key,
+    BOOLEAN Alertable,
+    PLARGE_INTEGER Timeout);
+
+NTSTATUS
+NTAPI
+NtClose(
+    HANDLE Handle);
+
+NTSTATUS
+NTAPI
+NtYieldExecution(VOID);
+
+PVOID
+NTAPI
+RtlAllocateHeap(
+    HANDLE HeapHandle,
+    ULONG Flags,
+    SIZE_T Size);
+
+BOOLEAN
+NTAPI
+RtlFreeHeap(
+    HANDLE HeapHandle,
+    ULONG Flags,
+    PVOID BaseAddress);
+
+VOID
+NTAPI
+RtlRaiseStatus(
+    NTSTATUS Status);
+
+VOID
+NTAPI
+RtlRaiseException(
+    PEXCEPTION_RECORD ExceptionRecord);
+
+PVOID
+NTAPI
+RtlpDebugBufferCommit(
+    PRTL_DEBUG_INFORMATION Buffer,
+    SIZE_T Size);
+
+/* Functions built from the RTL sources */
+VOID NTAPI RtlInitializeSRWLock(PRTL_SRWLOCK SRWLock);
+VOID NTAPI RtlAcquireSRWLockShared(PRTL_SRWLOCK SRWLock);
+VOID NTAPI RtlReleaseSRWLockShared(PRTL_SRWLOCK SRWLock);
+VOID NTAPI RtlAcquireSRWLockExclusive(PRTL_SRWLOCK SRWLock);
+VOID NTAPI RtlReleaseSRWLockExclusive(PRTL_SRWLOCK SRWLock);
+BOOLEAN NTAPI RtlTryAcquireSRWLockShared(PRTL_SRWLOCK SRWLock);
+BOOLEAN NTAPI RtlTryAcquireSRWLockExclusive(PRTL_SRWLOCK SRWLock);
+
+VOID NTAPI RtlpInitializeKeyedEvent(VOID);
+VOID NTAPI RtlInitializeConditionVariable(PRTL_CONDITION_VARIABLE ConditionVariable);
+VOID NTAPI RtlWakeConditionVariable(PRTL_CONDITION_VARIABLE ConditionVariable);
+VOID NTAPI RtlWakeAllConditionVariable(PRTL_CONDITION_VARIABLE ConditionVariable);
+NTSTATUS NTAPI RtlSleepConditionVariableCS(PRTL_CONDITION_VARIABLE ConditionVariable,
+                                           PRTL_CRITICAL_SECTION CriticalSection,
+                                           PLARGE_INTEGER TimeOut);
+NTSTATUS NTAPI RtlSleepConditionVariableSRW(PRTL_CONDITION_VARIABLE ConditionVariable,
+                                            PRTL_SRWLOCK SRWLock,
+                                            PLARGE_INTEGER TimeOut,
+                                            ULONG Flags);
+
+VOID NTAPI RtlpInitDeferredCriticalSection(VOID);
+NTSTATUS NTAPI RtlInitializeCriticalSection(PRTL_CRITICAL_SECTION CriticalSection);
+NTSTATUS NTAPI RtlInitializeCriticalSectionAndSpinCount(PRTL_CRITICAL_SECTION CriticalSection, ULONG SpinCount);
+NTSTATUS NTAPI RtlInitializeCriticalSectionEx(PRTL_CRITICAL_SECTION CriticalSection, ULONG SpinCount, ULONG Flags);
+NTSTATUS NTAPI RtlDeleteCriticalSection(PRTL_CRITICAL_SECTION CriticalSection);
+NTSTATUS NTAPI RtlEnterCriticalSection(PRTL_CRITICAL_SECTION CriticalSection);
+NTSTATUS NTAPI RtlLeaveCriticalSection(PRTL_CRITICAL_SECTION CriticalSection);
+BOOLEAN NTAPI RtlTryEnterCriticalSection(PRTL_CRITICAL_SECTION CriticalSection);
+
+NTSTATUS NTAPI RtlpQueryProcessLocks(PRTL_DEBUG_INFORMATION Buffer);
+VOID NTAPI RtlpQueryCriticalSectionStatistics(PRTL_PROCESS_LOCK_STATISTICS Statistics);
+VOID NTAPI RtlpQuerySRWLockStatistics(PRTL_PROCESS_LOCK_STATISTICS Statistics);
+
+VOID NTAPI RtlInitializeSListHead(PSLIST_HEADER SListHead);
+PSLIST_ENTRY NTAPI RtlFirstEntrySList(const SLIST_HEADER *SListHead);
+WORD NTAPI RtlQueryDepthSList(PSLIST_HEADER SListHead);
+PSLIST_ENTRY FASTCALL RtlInterlockedPushListSList(PSLIST_HEADER SListHead,
+                                                  PSLIST_ENTRY List,
+                                                  PSLIST_ENTRY ListEnd,
+                                                  ULONG Count);
+
+/* Set up the emulated process environment, call before anything else */
+VOID
+HbRtlInitialize(VOID);
@@ -0,0 +1,18 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Builds the RTL synchronization sources against the host shim
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include "rtlshim.h"
+
+/* The sources below are compiled unmodified, the include path points at sdk/lib/rtl */
+#include <srw.c>
+#include <critical.c>
+#include <condvar.c>
+
+#if defined(_M_AMD64) || defined(_M_IX86)
+/* Only the C parts, the push/pop/flush primitives are assembly on x86 */
+#include <slist.c>
+#endif
@@ -0,0 +1,72 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     What the xlate row functions use from win32k.h, for the host compiler
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The row functions pick their amd64 code with the MSVC architecture macro */
+#if defined(__x86_64__)
+#define _M_AMD64 1
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+static __inline unsigned int
+_rotl(unsigned int value, int shift)
+{
+    shift &= 31;
+    return shift ? (value << shift) | (value >> (32 - shift)) : value;
+}
+#endif
+
+#include <typedefs.h>
+
+/* The row functions use the host calling convention */
+#define FASTCALL
+#define FORCEINLINE static __inline
+#define UNALIGNED
+#define UNREFERENCED_PARAMETER(P) ((void)(P))
+#define ARRAYSIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+#define _In_
+#define _In_opt_
+#define _Out_
+#define _Inout_
+#define _Notnull_
+#define _Function_class_(x)
+
+typedef BYTE *PBYTE;
+typedef ULONG FLONG;
+typedef ULONG COLORREF;
+typedef struct _PALETTE *PPALETTE;
+typedef struct _DC *PDC;
+
+#define BMF_1BPP    1
+#define BMF_4BPP    2
+#define BMF_8BPP    3
+#define BMF_16BPP   4
+#define BMF_24BPP   5
+#define BMF_32BPP   6
+
+#define XO_TRIVIAL  0x00000001
+#define XO_TABLE    0x00000002
+
+typedef struct _XLATEOBJ
+{
+    ULONG iUniq;
+    FLONG flXlate;
+    USHORT iSrcType;
+    USHORT iDstType;
+    ULONG cEntries;
+    ULONG *pulXlate;
+} XLATEOBJ;
+
+#include <xlateobj.h>
@@ -0,0 +1,507 @@
+/*
+ * PROJECT:     ReactOS host benchmarks
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Conformance and throughput of the XLATEOBJ row functions
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <win32k.h>
+
+#include "../hostbench.h"
+
+/*
+ * The iXlate functions below are the ones of xlateobj.c, which the row
+ * functions of xlaterow.c find by address. Every row function is run on
+ * random pixels, with different lengths and alignments, random tables and
+ * masks, and must give what a per pixel call of the iXlate function gives.
+ * Then rows of a typical width are timed both ways.
+ */
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateTrivial(PEXLATEOBJ pexlo, ULONG iColor)
+{
+    return iColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateTable(PEXLATEOBJ pexlo, ULONG iColor)
+{
+    if (iColor >= pexlo->xlo.cEntries) return 0;
+    return pexlo->xlo.pulXlate[iColor];
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateRGBtoBGR(PEXLATEOBJ pxlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iNewColor = iColor & 0xff00ff00;
+    iColor &= 0x00ff00ff;
+    iNewColor |= iColor >> 16;
+    iNewColor |= iColor << 16;
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateRGBto555(PEXLATEOBJ pxlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iColor <<= 7;
+    iNewColor = iColor & 0x7C00;
+    iColor >>= 13;
+    iNewColor |= iColor & 0x3E0;
+    iColor >>= 13;
+    iNewColor |= iColor & 0x1F;
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateBGRto555(PEXLATEOBJ pxlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iColor >>= 3;
+    iNewColor = iColor & 0x1f;
+    iColor >>= 3;
+    iNewColor |= (iColor & 0x3E0);
+    iColor >>= 3;
+    iNewColor |= (iColor & 0x7C00);
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateRGBto565(PEXLATEOBJ pxlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iColor <<= 8;
+    iNewColor = iColor & 0xF800;
+    iColor >>= 13;
+    iNewColor |= iColor & 0x7E0;
+    iColor >>= 14;
+    iNewColor |= iColor & 0x1F;
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateBGRto565(PEXLATEOBJ pxlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iColor >>= 3;
+    iNewColor = iColor & 0x1f;
+    iColor >>= 2;
+    iNewColor |= (iColor & 0x7E0);
+    iColor >>= 3;
+    iNewColor |= (iColor & 0xF800);
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlate555toRGB(PEXLATEOBJ pxlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iNewColor = gajXlate5to8[iColor & 0x1F] << 16;
+    iColor >>= 5;
+    iNewColor |= gajXlate5to8[iColor & 0x1F] << 8;
+    iColor >>= 5;
+    iNewColor |= gajXlate5to8[iColor & 0x1F];
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlate555toBGR(PEXLATEOBJ pxlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iNewColor = gajXlate5to8[iColor & 0x1F];
+    iColor >>= 5;
+    iNewColor |= gajXlate5to8[iColor & 0x1F] << 8;
+    iColor >>= 5;
+    iNewColor |= gajXlate5to8[iColor & 0x1F] << 16;
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlate555to565(PEXLATEOBJ pxlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iNewColor = iColor & 0x1f;
+    iColor <<= 1;
+    iNewColor |= iColor & 0xFFC0;
+    iColor >>= 5;
+    iNewColor |= (iColor & 0x20);
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlate565to555(PEXLATEOBJ pxlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iNewColor = iColor & 0x1f;
+    iColor >>= 1;
+    iNewColor |= iColor & 0x7FE0;
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlate565toRGB(PEXLATEOBJ pexlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iNewColor = gajXlate5to8[iColor & 0x1F] << 16;
+    iColor >>= 5;
+    iNewColor |= gajXlate6to8[iColor & 0x3F] << 8;
+    iColor >>= 6;
+    iNewColor |= gajXlate5to8[iColor & 0x1F];
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlate565toBGR(PEXLATEOBJ pexlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iNewColor = gajXlate5to8[iColor & 0x1F];
+    iColor >>= 5;
+    iNewColor |= gajXlate6to8[iColor & 0x3F] << 8;
+    iColor >>= 6;
+    iNewColor |= gajXlate5to8[iColor & 0x1F] << 16;
+
+    return iNewColor;
+}
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateShiftAndMask(PEXLATEOBJ pexlo, ULONG iColor)
+{
+    ULONG iNewColor;
+
+    iNewColor = _rotl(iColor, pexlo->ulRedShift) & pexlo->ulRedMask;
+    iNewColor |= _rotl(iColor, pexlo->ulGreenShift) & pexlo->ulGreenMask;
+    iNewColor |= _rotl(iColor, pexlo->ulBlueShift) & pexlo->ulBlueMask;
+
+    return iNewColor;
+}
+
+static const struct
+{
+    const char *Name;
+    PFN_XLATE pfnXlate;
+    ULONG iSrcFormat;
+    ULONG iDstFormat;
+} gaXlates[] =
+{
+    { "Table 8 to 8",           EXLATEOBJ_iXlateTable,          BMF_8BPP,  BMF_8BPP },
+    { "Table 8 to 16",          EXLATEOBJ_iXlateTable,          BMF_8BPP,  BMF_16BPP },
+    { "Table 8 to 32",          EXLATEOBJ_iXlateTable,          BMF_8BPP,  BMF_32BPP },
+    { "ShiftAndMask 32 to 32",  EXLATEOBJ_iXlateShiftAndMask,   BMF_32BPP, BMF_32BPP },
+    { "ShiftAndMask 32 to 16",  EXLATEOBJ_iXlateShiftAndMask,   BMF_32BPP, BMF_16BPP },
+    { "ShiftAndMask 16 to 32",  EXLATEOBJ_iXlateShiftAndMask,   BMF_16BPP, BMF_32BPP },
+    { "ShiftAndMask 16 to 16",  EXLATEOBJ_iXlateShiftAndMask,   BMF_16BPP, BMF_16BPP },
+    { "RGB to BGR",             EXLATEOBJ_iXlateRGBtoBGR,       BMF_32BPP, BMF_32BPP },
+    { "RGB to 555",             EXLATEOBJ_iXlateRGBto555,       BMF_32BPP, BMF_16BPP },
+    { "RGB to 565",             EXLATEOBJ_iXlateRGBto565,       BMF_32BPP, BMF_16BPP },
+    { "BGR to 555",             EXLATEOBJ_iXlateBGRto555,       BMF_32BPP, BMF_16BPP },
+    { "BGR to 565",             EXLATEOBJ_iXlateBGRto565,       BMF_32BPP, BMF_16BPP },
+    { "555 to RGB",             EXLATEOBJ_iXlate555toRGB,       BMF_16BPP, BMF_32BPP },
+    { "555 to BGR",             EXLATEOBJ_iXlate555toBGR,       BMF_16BPP, BMF_32BPP },
+    { "565 to RGB",             EXLATEOBJ_iXlate565toRGB,       BMF_16BPP, BMF_32BPP },
+    { "565 to BGR",             EXLATEOBJ_iXlate565toBGR,       BMF_16BPP, BMF_32BPP },
+    { "555 to 565",             EXLATEOBJ_iXlate555to565,       BMF_16BPP, BMF_16BPP },
+    { "565 to 555",             EXLATEOBJ_iXlate565to555,       BMF_16BPP, BMF_16BPP },
+};
+
+static const ULONG gajBytesPerFormat[] = { 0, 0, 0, 1, 2, 3, 4 };
+
+static ULONG gaulTable[256];
+
+static ULONG RandomState = 0x12345678;
+
+static ULONG
+Random(void)
+{
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+    return RandomState;
+}
+
+/* Bitfields the way EXLATEOBJ_vInitialize sets them up, or just random */
+static VOID
+SetupXlate(PEXLATEOBJ pexlo, PFN_XLATE pfnXlate, ULONG iDstFormat)
+{
+    static const ULONG aulMasks[][3] =
+    {
+        { 0x00FF0000, 0x0000FF00, 0x000000FF },
+        { 0x000000FF, 0x0000FF00, 0x00FF0000 },
+        { 0x00007C00, 0x000003E0, 0x0000001F },
+        { 0x0000F800, 0x000007E0, 0x0000001F },
+        { 0x3FF00000, 0x000FFC00, 0x000003FF },
+    };
+    ULONG i, iMasks, iMasksSrc;
+
+    memset(pexlo, 0, sizeof(*pexlo));
+    pexlo->pfnXlate = pfnXlate;
+
+    if (pfnXlate == EXLATEOBJ_iXlateTable)
+    {
+        static const ULONG acEntries[] = { 2, 16, 100, 256 };
+
+        for (i = 0; i < 256; i++)
+            gaulTable[i] = Random();
+        pexlo->xlo.flXlate = XO_TABLE;
+        pexlo->xlo.cEntries = acEntries[Random() % 4];
+        pexlo->xlo.pulXlate = gaulTable;
+    }
+    else if (pfnXlate == EXLATEOBJ_iXlateShiftAndMask)
+    {
+        iMasks = Random() % 6;
+        iMasksSrc = Random() % 5;
+        for (i = 0; i < 3; i++)
+        {
+            if (iMasks == 5)
+            {
+                pexlo->aulXlate[i] = Random() & ((iDstFormat == BMF_16BPP) ? 0xFFFF : 0xFFFFFFFF);
+                pexlo->aulXlate[3 + i] = Random() % 32;
+            }
+            else
+            {
+                pexlo->aulXlate[i] = aulMasks[iMasks][i];
+                pexlo->aulXlate[3 + i] = (31 - __builtin_clz(aulMasks[iMasks][i]) -
+                                          (31 - __builtin_clz(aulMasks[iMasksSrc][i]))) & 31;
+            }
+        }
+    }
+}
+
+static ULONG
+ReadPixel(PBYTE pj, ULONG cj)
+{
+    if (cj == 1) return *pj;
+    if (cj == 2) return *(USHORT *)pj;
+    return *(ULONG *)pj;
+}
+
+static VOID
+WritePixel(PBYTE pj, ULONG cj, ULONG iColor)
+{
+    if (cj == 1) *pj = (BYTE)iColor;
+    else if (cj == 2) *(USHORT *)pj = (USHORT)iColor;
+    else *(ULONG *)pj = iColor;
+}
+
+#define VERIFY_PIXELS 80
+
+static int
+Verify(void)
+{
+    EXLATEOBJ exlo;
+    PFN_XLATEROW pfnXlateRow;
+    ULONG aulSrc[VERIFY_PIXELS + 4], aulDst[VERIFY_PIXELS + 4], aulExpected[VERIFY_PIXELS + 4];
+    ULONG Count = 0, x, i, cPixels, iOffset, cjSrc, cjDst, k;
+    int Failures = 0;
+
+    /* Everything else is left to the per pixel functions */
+    exlo.pfnXlate = EXLATEOBJ_iXlateTrivial;
+    if (EXLATEOBJ_pfnXlateRow(NULL, BMF_32BPP, BMF_32BPP) ||
+        EXLATEOBJ_pfnXlateRow(&exlo.xlo, BMF_32BPP, BMF_32BPP))
+    {
+        printf("Row function for a trivial xlate\n");
+        Failures++;
+    }
+    exlo.pfnXlate = EXLATEOBJ_iXlateRGBtoBGR;
+    if (EXLATEOBJ_pfnXlateRow(&exlo.xlo, BMF_24BPP, BMF_32BPP))
+    {
+        printf("Row function for a 24bpp source\n");
+        Failures++;
+    }
+
+    for (x = 0; x < ARRAYSIZE(gaXlates); x++)
+    {
+        cjSrc = gajBytesPerFormat[gaXlates[x].iSrcFormat];
+        cjDst = gajBytesPerFormat[gaXlates[x].iDstFormat];
+
+        for (i = 0; i < 2000; i++)
+        {
+            SetupXlate(&exlo, gaXlates[x].pfnXlate, gaXlates[x].iDstFormat);
+            pfnXlateRow = EXLATEOBJ_pfnXlateRow(&exlo.xlo, gaXlates[x].iSrcFormat, gaXlates[x].iDstFormat);
+            if (!pfnXlateRow)
+            {
+                printf("%s: no row function\n", gaXlates[x].Name);
+                Failures++;
+                break;
+            }
+
+            cPixels = Random() % (VERIFY_PIXELS + 1);
+            iOffset = Random() % 4;
+            for (k = 0; k < ARRAYSIZE(aulSrc); k++)
+                aulSrc[k] = Random();
+            for (k = 0; k < ARRAYSIZE(aulDst); k++)
+                aulDst[k] = aulExpected[k] = Random();
+
+            for (k = 0; k < cPixels; k++)
+            {
+                WritePixel((PBYTE)aulExpected + iOffset + k * cjDst, cjDst,
+                           gaXlates[x].pfnXlate(&exlo, ReadPixel((PBYTE)aulSrc + iOffset + k * cjSrc, cjSrc)));
+            }
+
+            pfnXlateRow(&exlo, (PBYTE)aulDst + iOffset, (PBYTE)aulSrc + iOffset, cPixels);
+            if (memcmp(aulDst, aulExpected, sizeof(aulDst)))
+            {
+                printf("%s differs: %u pixels at offset %u\n", gaXlates[x].Name, cPixels, iOffset);
+                Failures++;
+            }
+            Count++;
+        }
+    }
+
+    printf("%u rows checked, %d differ\n", Count, Failures);
+    return Failures;
+}
+
+#define BENCH_CX 1024
+#define BENCH_CY 64
+
+typedef struct _BENCH_CONTEXT
+{
+    EXLATEOBJ exlo;
+    PFN_XLATEROW pfnXlateRow;
+    ULONG cjSrc;
+    ULONG cjDst;
+    PBYTE pjSrc;
+    PBYTE pjDst;
+} BENCH_CONTEXT;
+
+/* Called through a pointer, like XLATEOBJ_iXlate */
+static PFN_XLATE volatile pfnXlatePerPixel;
+
+static void
+BenchPerPixel(PHB_THREAD Thread)
+{
+    BENCH_CONTEXT *Context = Thread->Context;
+    PBYTE pjSrc, pjDst;
+    ULONG x, y;
+
+    do
+    {
+        for (y = 0; y < BENCH_CY; y++)
+        {
+            pjSrc = Context->pjSrc + y * BENCH_CX * 4;
+            pjDst = Context->pjDst + y * BENCH_CX * 4;
+            for (x = 0; x < BENCH_CX; x++)
+            {
+                WritePixel(pjDst, Context->cjDst, pfnXlatePerPixel(&Context->exlo, ReadPixel(pjSrc, Context->cjSrc)));
+                pjSrc += Context->cjSrc;
+                pjDst += Context->cjDst;
+            }
+        }
+
+        Thread->Operations += BENCH_CX * BENCH_CY;
+    } while (!HbShouldStop(Thread));
+}
+
+static void
+BenchRows(PHB_THREAD Thread)
+{
+    BENCH_CONTEXT *Context = Thread->Context;
+    ULONG y;
+
+    do
+    {
+        for (y = 0; y < BENCH_CY; y++)
+        {
+            Context->pfnXlateRow(&Context->exlo,
+                                 Context->pjDst + y * BENCH_CX * 4,
+                                 Context->pjSrc + y * BENCH_CX * 4,
+                                 BENCH_CX);
+        }
+
+        Thread->Operations += BENCH_CX * BENCH_CY;
+    } while (!HbShouldStop(Thread));
+}
+
+static void
+RunBenchmarks(void)
+{
+    BENCH_CONTEXT Context;
+    HB_RESULT Result;
+    char Name[64];
+    ULONG x, k;
+
+    HbReportHeader("XLATEOBJ color translation (operations are pixels)");
+
+    Context.pjSrc = malloc(BENCH_CX * BENCH_CY * 4);
+    Context.pjDst = malloc(BENCH_CX * BENCH_CY * 4);
+    for (k = 0; k < BENCH_CX * BENCH_CY; k++)
+        ((PULONG)Context.pjSrc)[k] = Random();
+
+    for (x = 0; x < ARRAYSIZE(gaXlates); x++)
+    {
+        SetupXlate(&Context.exlo, gaXlates[x].pfnXlate, gaXlates[x].iDstFormat);
+        Context.exlo.xlo.cEntries = 256;
+        Context.pfnXlateRow = EXLATEOBJ_pfnXlateRow(&Context.exlo.xlo,
+                                                    gaXlates[x].iSrcFormat,
+                                                    gaXlates[x].iDstFormat);
+        Context.cjSrc = gajBytesPerFormat[gaXlates[x].iSrcFormat];
+        Context.cjDst = gajBytesPerFormat[gaXlates[x].iDstFormat];
+        pfnXlatePerPixel = gaXlates[x].pfnXlate;
+
+        snprintf(Name, sizeof(Name), "%s per pixel", gaXlates[x].Name);
+        if (HbSelected(Name))
+        {
+            HbRun(BenchPerPixel, &Context, 1, HbOptions.DurationMs, &Result);
+            HbReport(Name, &Result);
+        }
+
+        snprintf(Name, sizeof(Name), "%s rows", gaXlates[x].Name);
+        if (HbSelected(Name))
+        {
+            HbRun(BenchRows, &Context, 1, HbOptions.DurationMs, &Result);
+            HbReport(Name, &Result);
+        }
+    }
+
+    free(Context.pjDst);
+    free(Context.pjSrc);
+}
+
+int
+main(int argc, char **argv)
+{
+    if (HbParseOptions(argc, argv, NULL))
+        return 1;
+
+    if (Verify())
+        return 1;
+
+    RunBenchmarks();
+    return 0;
+}
@@ -35,13 +35,22 @@
 /* Processor speed */
 #define STEPS_PER_CYCLE 1024
 
+/*
+ * Maximum number of steps run without looking at the clock,
+ * when the nearest timer deadline is far enough.
+ */
+#define MAX_STEPS_PER_UPDATE (16 * STEPS_PER_CYCLE)
+
 /* VARIABLES ******************************************************************/
 
+/*
+ * The enabled timers, sorted by their next deadline in performance counter
+ * ticks. Timers with a zero delay have no deadline and are always first.
+ */
 static LIST_ENTRY Timers;
 static LARGE_INTEGER StartPerfCount, Frequency;
 // static ULONG StartTickCount;
 static LARGE_INTEGER Counter;
-static ULONG CurrentTickCount;
 static ULONGLONG LastCycles = 0ULL;
 static PHARDWARE_TIMER IpsTimer;
 
@@ -71,56 +80,104 @@ static VOID FASTCALL IpsCallback(ULONGLONG ElapsedTime)
     LastCycles = CurrentCycleCount;
 }
 
+static VOID InsertTimer(PHARDWARE_TIMER Timer)
+{
+    PLIST_ENTRY Entry;
+    PHARDWARE_TIMER Current;
+
+    /* Compute the next deadline */
+    Timer->NextTick.QuadPart = Timer->Delay ? (Timer->LastTick.QuadPart + Timer->Delay) : 0LL;
+
+    /* Find the first timer expiring later, keeping timers with equal deadlines in order */
+    for (Entry = Timers.Flink; Entry != &Timers; Entry = Entry->Flink)
+    {
+        Current = CONTAINING_RECORD(Entry, HARDWARE_TIMER, Link);
+        if (Current->NextTick.QuadPart > Timer->NextTick.QuadPart) break;
+    }
+
+    /* Insert the timer before it */
+    InsertTailList(Entry, &Timer->Link);
+}
+
+static ULONG GetStepsToDeadline(VOID)
+{
+    PHARDWARE_TIMER Timer;
+    ULONGLONG Steps;
+
+    if (IsListEmpty(&Timers)) return MAX_STEPS_PER_UPDATE;
+
+    /* The first timer has the nearest deadline */
+    Timer = CONTAINING_RECORD(Timers.Flink, HARDWARE_TIMER, Link);
+    if (Timer->NextTick.QuadPart <= Counter.QuadPart) return STEPS_PER_CYCLE;
+
+    /* Estimate how many instructions run until then */
+    Steps = (ULONGLONG)(Timer->NextTick.QuadPart - Counter.QuadPart) * CurrentIps
+            / (ULONGLONG)Frequency.QuadPart;
+
+    if (Steps < STEPS_PER_CYCLE) return STEPS_PER_CYCLE;
+    if (Steps > MAX_STEPS_PER_UPDATE) return MAX_STEPS_PER_UPDATE;
+    return (ULONG)Steps;
+}
+
 /* PUBLIC FUNCTIONS ***********************************************************/
 
 VOID ClockUpdate(VOID)
 {
     extern BOOLEAN CpuRunning;
-    UINT i;
-    PLIST_ENTRY Entry;
+    UINT i, Steps;
+    LIST_ENTRY Expired;
     PHARDWARE_TIMER Timer;
 
     while (VdmRunning && CpuRunning)
     {
-        /* Get the current counters */
+        /* Get the current counter */
         /// DWORD_PTR oldmask = SetThreadAffinityMask(GetCurrentThread(), 0);
-        CurrentTickCount = GetTickCount();
         NtQueryPerformanceCounter(&Counter, NULL);
         /// SetThreadAffinityMask(GetCurrentThread(), oldmask);
 
-        /* Continue CPU emulation */
-        for (i = 0; VdmRunning && CpuRunning && (i < STEPS_PER_CYCLE); i++)
+        /* Continue CPU emulation until the nearest timer deadline */
+        Steps = GetStepsToDeadline();
+        for (i = 0; VdmRunning && CpuRunning && (i < Steps); i++)
         {
             CpuStep();
             ++CurrentCycleCount;
         }
 
-        Entry = Timers.Flink;
-        while (Entry != &Timers)
+        /*
+         * Move the expired timers to a separate list first, since the
+         * callbacks can enable, disable or reschedule any timer.
+         */
+        InitializeListHead(&Expired);
+        while (!IsListEmpty(&Timers))
+        {
+            Timer = CONTAINING_RECORD(Timers.Flink, HARDWARE_TIMER, Link);
+            if (Timer->NextTick.QuadPart > Counter.QuadPart) break;
+
+            RemoveEntryList(&Timer->Link);
+            InsertTailList(&Expired, &Timer->Link);
+        }
+
+        while (!IsListEmpty(&Expired))
         {
             ULONGLONG Ticks = (ULONGLONG)-1;
 
-            Timer = CONTAINING_RECORD(Entry, HARDWARE_TIMER, Link);
-            Entry = Entry->Flink;
+            Timer = CONTAINING_RECORD(RemoveHeadList(&Expired), HARDWARE_TIMER, Link);
+            InitializeListHead(&Timer->Link);
 
             ASSERT((Timer->EnableCount > 0) && (Timer->Flags & HARDWARE_TIMER_ENABLED));
 
             if (Timer->Delay)
             {
-                if (Timer->Flags & HARDWARE_TIMER_PRECISE)
-                {
-                    /* Use the performance counter for precise timers */
-                    if (Counter.QuadPart <= Timer->LastTick.QuadPart) continue;
-                    Ticks = (Counter.QuadPart - Timer->LastTick.QuadPart) / Timer->Delay;
-                }
-                else
+                Ticks = (Counter.QuadPart > Timer->LastTick.QuadPart)
+                        ? (Counter.QuadPart - Timer->LastTick.QuadPart) / Timer->Delay
+                        : 0ULL;
+
+                if (Ticks == 0)
                 {
-                    /* Use the regular tick count for normal timers */
-                    if (CurrentTickCount <= Timer->LastTick.LowPart) continue;
-                    Ticks = (CurrentTickCount - Timer->LastTick.LowPart) / (ULONG)Timer->Delay;
+                    /* The timer was rescheduled in the meantime */
+                    InsertTimer(Timer);
+                    continue;
                 }
-
-                if (Ticks == 0) continue;
             }
 
             Timer->Callback(Ticks);
@@ -133,6 +190,12 @@ VOID ClockUpdate(VOID)
 
             /* Update the time of the last timer tick */
             Timer->LastTick.QuadPart += Ticks * Timer->Delay;
+
+            /* Schedule the next tick, unless the callback already did */
+            if ((Timer->Flags & HARDWARE_TIMER_ENABLED) && IsListEmpty(&Timer->Link))
+            {
+                InsertTimer(Timer);
+            }
         }
 
         /* Yield execution to other threads */
@@ -152,6 +215,7 @@ PHARDWARE_TIMER CreateHardwareTimer(ULONG Flags, ULONGLONG Delay, PHARDWARE_TIME
     Timer->EnableCount = 0;
     Timer->Callback = Callback;
     Timer->LastTick.QuadPart = 0;
+    InitializeListHead(&Timer->Link);
     SetHardwareTimerDelay(Timer, Delay);
 
     if (Flags & HARDWARE_TIMER_ENABLED) EnableHardwareTimer(Timer);
@@ -166,17 +230,10 @@ VOID EnableHardwareTimer(PHARDWARE_TIMER Timer)
     /* Check if the count is above 0 but the timer isn't enabled */
     if ((Timer->EnableCount > 0) && !(Timer->Flags & HARDWARE_TIMER_ENABLED))
     {
-        if (Timer->Flags & HARDWARE_TIMER_PRECISE)
-        {
-            NtQueryPerformanceCounter(&Timer->LastTick, NULL);
-        }
-        else
-        {
-            Timer->LastTick.LowPart = GetTickCount();
-        }
+        NtQueryPerformanceCounter(&Timer->LastTick, NULL);
 
         Timer->Flags |= HARDWARE_TIMER_ENABLED;
-        InsertTailList(&Timers, &Timer->Link);
+        InsertTimer(Timer);
     }
 }
 
@@ -191,19 +248,26 @@ VOID DisableHardwareTimer(PHARDWARE_TIMER Timer)
         /* Disable the timer */
         Timer->Flags &= ~HARDWARE_TIMER_ENABLED;
         RemoveEntryList(&Timer->Link);
+        InitializeListHead(&Timer->Link);
     }
 }
 
 VOID SetHardwareTimerDelay(PHARDWARE_TIMER Timer, ULONGLONG NewDelay)
 {
-    if (Timer->Flags & HARDWARE_TIMER_PRECISE)
+    if (!(Timer->Flags & HARDWARE_TIMER_PRECISE))
     {
-        /* Convert the delay from nanoseconds to performance counter ticks */
-        Timer->Delay = (NewDelay * Frequency.QuadPart + 500000000ULL) / 1000000000ULL;
+        /* Normal timers only have a millisecond resolution */
+        NewDelay -= NewDelay % 1000000ULL;
     }
-    else
+
+    /* Convert the delay from nanoseconds to performance counter ticks */
+    Timer->Delay = (NewDelay * Frequency.QuadPart + 500000000ULL) / 1000000000ULL;
+
+    if (Timer->Flags & HARDWARE_TIMER_ENABLED)
     {
-        Timer->Delay = NewDelay / 1000000ULL;
+        /* Move the timer to its new deadline */
+        RemoveEntryList(&Timer->Link);
+        InsertTimer(Timer);
     }
 }
 
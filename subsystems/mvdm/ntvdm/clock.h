@@ -28,6 +28,7 @@ typedef struct _HARDWARE_TIMER
     LONG EnableCount;
     ULONGLONG Delay;
     LARGE_INTEGER LastTick;
+    LARGE_INTEGER NextTick;
     PHARDWARE_TIMER_PROC Callback;
 } HARDWARE_TIMER, *PHARDWARE_TIMER;
 
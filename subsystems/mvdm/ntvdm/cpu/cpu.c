@@ -39,6 +39,8 @@
 FAST486_STATE EmulatorContext;
 BOOLEAN CpuRunning = FALSE;
 
+static FAST486_MEMORY_TLB_ENTRY EmulatorMemoryTlb[FAST486_MEMORY_TLB_SIZE];
+
 /* No more than 'MaxCpuCallLevel' recursive CPU calls are allowed */
 static const INT MaxCpuCallLevel = 32;
 static INT CpuCallLevel = 0; // == 0: CPU stopped; >= 1: CPU running or halted
@@ -226,12 +228,14 @@ BOOLEAN CpuInitialize(VOID)
     Fast486Initialize(&EmulatorContext,
                       EmulatorReadMemory,
                       EmulatorWriteMemory,
+                      EmulatorMapMemory,
                       EmulatorReadIo,
                       EmulatorWriteIo,
                       EmulatorBiosOperation,
                       EmulatorIntAcknowledge,
                       EmulatorFpu,
-                      NULL /* TODO: Use a TLB */);
+                      NULL /* TODO: Use a TLB */,
+                      EmulatorMemoryTlb);
 
     /* Initialize the software callback system and register the emulator BOPs */
     // RegisterBop(BOP_DEBUGGER  , EmulatorDebugBreakBop);
@@ -489,6 +489,9 @@ DWORD DmaRequest(IN WORD      iChannel,
                 }
             }
 
+            /* The transfer may have overwritten cached code */
+            Fast486FlushCache(&EmulatorContext);
+
             break;
         }
 
@@ -34,6 +34,9 @@ static CONST DWORD MemorySize[] = { 0x20000, 0x10000, 0x08000, 0x08000 };
 #define USE_REACTOS_COLORS
 // #define USE_DOSBOX_COLORS
 
+/* Uncomment to print the display refresh rate and cost once per second */
+// #define VGA_DISPLAY_STATISTICS
+
 #if defined(USE_REACTOS_COLORS)
 
 // ReactOS colors
@@ -243,6 +246,54 @@ static PBYTE GraphicsFramebuffer = NULL;
  */
 static BYTE VgaMemory[VGA_NUM_BANKS * SVGA_BANK_SIZE];
 
+/*
+ * Dirty tracking of the video memory, one bit for each block of VgaMemory
+ * written since the last display refresh. Scanlines only reading clean
+ * blocks are not converted again, unless the display settings changed.
+ */
+#define VGA_DIRTY_BLOCK_SHIFT   6
+#define VGA_DIRTY_BLOCKS        (sizeof(VgaMemory) >> VGA_DIRTY_BLOCK_SHIFT)
+
+static ULONG VgaDirtyBitmap[VGA_DIRTY_BLOCKS / 32];
+static BOOLEAN VgaMemoryDirty = FALSE;
+static BOOLEAN VgaFullRefresh = TRUE;
+
+/* The display settings used for the last refresh */
+typedef struct _VGA_DISPLAY_STATE
+{
+    PVOID Framebuffer;
+    COORD Resolution;
+    DWORD StartAddress;
+    DWORD ScanlineSize;
+    BOOLEAN PaletteDisabled;
+    BYTE GcMode;
+    BYTE GcMisc;
+    BYTE SeqExtMode;
+    BYTE AcRegisters[VGA_AC_MAX_REG];
+    BYTE CrtcRegisters[SVGA_CRTC_MAX_REG];
+} VGA_DISPLAY_STATE, *PVGA_DISPLAY_STATE;
+
+static VGA_DISPLAY_STATE VgaDisplayState;
+
+/*
+ * Scanline conversion. The widest scanline is 256 characters of 9 pixels,
+ * plus room for the horizontal panning and a whole byte of planar data.
+ */
+#define VGA_MAX_SCANLINE_WIDTH  (256 * 9)
+
+static BYTE VgaLineBuffer[VGA_MAX_SCANLINE_WIDTH + 16];
+
+/* The 8 pixels of a planar byte, one per byte, with the bit of plane 0 */
+static ULONGLONG VgaPlanarTable[256];
+
+#ifdef VGA_DISPLAY_STATISTICS
+static LARGE_INTEGER VgaCounterFrequency;
+static LARGE_INTEGER VgaRefreshTime;
+static DWORD VgaStatisticsStart = 0;
+static ULONG VgaFrameCount = 0;
+static ULONG VgaScanlineCount = 0;
+#endif
+
 static BYTE VgaLatchRegisters[VGA_NUM_BANKS] = {0, 0, 0, 0};
 
 static BYTE VgaMiscRegister;
@@ -710,10 +761,165 @@ Quit:
     UpdateRectangle.Right  = CurrResolution.X;
     UpdateRectangle.Bottom = CurrResolution.Y;
 
+    /* The framebuffer must be converted again entirely */
+    VgaFullRefresh = TRUE;
+
     /* Reset the mode change flag */
     ModeChanged = FALSE;
 }
 
+static inline VOID VgaMarkMemoryDirty(DWORD Offset, DWORD Size)
+{
+    DWORD Block = Offset >> VGA_DIRTY_BLOCK_SHIFT;
+    DWORD LastBlock = (Offset + Size - 1) >> VGA_DIRTY_BLOCK_SHIFT;
+
+    /* Set the bits of all the blocks in the range */
+    for (; (Block <= LastBlock) && (Block < VGA_DIRTY_BLOCKS); Block++)
+    {
+        VgaDirtyBitmap[Block / 32] |= 1 << (Block % 32);
+    }
+
+    VgaMemoryDirty = TRUE;
+}
+
+static BOOLEAN VgaIsMemoryDirty(DWORD Start, DWORD End)
+{
+    DWORD Block, LastBlock;
+
+    /* A range wrapping around the video memory is always redrawn */
+    if (End <= Start) return TRUE;
+
+    Block = Start >> VGA_DIRTY_BLOCK_SHIFT;
+    LastBlock = min((End - 1) >> VGA_DIRTY_BLOCK_SHIFT, VGA_DIRTY_BLOCKS - 1);
+
+    for (; Block <= LastBlock; Block++)
+    {
+        if (VgaDirtyBitmap[Block / 32] & (1 << (Block % 32))) return TRUE;
+    }
+
+    return FALSE;
+}
+
+static BOOLEAN VgaIsScanlineDirty(DWORD Address, DWORD AddressSize, BOOLEAN Panned)
+{
+    DWORD FirstUnit, LastUnit;
+
+    if (VgaSeqRegisters[SVGA_SEQ_EXT_MODE_REG] & SVGA_SEQ_EXT_MODE_HIGH_RES)
+    {
+        /* Packed pixels, one byte per pixel */
+        FirstUnit = Address ? (Address - 1) : 0;
+        return VgaIsMemoryDirty(FirstUnit, Address + CurrResolution.X + 8);
+    }
+
+    /*
+     * Planar modes store at least 4 pixels per address unit. The panning
+     * reads at most one more unit, before the start address if negative.
+     */
+    FirstUnit = Panned ? (Address - 1) : Address;
+    LastUnit = Address + (CurrResolution.X + 8) / 4 + 1;
+
+    return VgaIsMemoryDirty(WRAP_OFFSET(FirstUnit * AddressSize) * VGA_NUM_BANKS,
+                            (WRAP_OFFSET(LastUnit * AddressSize) + AddressSize) * VGA_NUM_BANKS);
+}
+
+static BOOLEAN VgaDisplayStateChanged(VOID)
+{
+    VGA_DISPLAY_STATE State;
+
+    /* Gather everything VgaUpdateFramebuffer depends on, besides the memory */
+    RtlZeroMemory(&State, sizeof(State));
+    State.Framebuffer = ActiveFramebuffer;
+    State.Resolution = CurrResolution;
+    State.StartAddress = StartAddressLatch;
+    State.ScanlineSize = ScanlineSizeLatch;
+    State.PaletteDisabled = VgaAcPalDisable;
+    State.GcMode = VgaGcRegisters[VGA_GC_MODE_REG]
+                   & (VGA_GC_MODE_OE | VGA_GC_MODE_SHIFTREG | VGA_GC_MODE_SHIFT256);
+    State.GcMisc = VgaGcRegisters[VGA_GC_MISC_REG] & (VGA_GC_MISC_NOALPHA | VGA_GC_MISC_OE);
+    State.SeqExtMode = VgaSeqRegisters[SVGA_SEQ_EXT_MODE_REG] & SVGA_SEQ_EXT_MODE_HIGH_RES;
+    RtlCopyMemory(State.AcRegisters, VgaAcRegisters, sizeof(State.AcRegisters));
+    RtlCopyMemory(State.CrtcRegisters, VgaCrtcRegisters, sizeof(State.CrtcRegisters));
+
+    if (RtlEqualMemory(&State, &VgaDisplayState, sizeof(State))) return FALSE;
+
+    RtlCopyMemory(&VgaDisplayState, &State, sizeof(State));
+    return TRUE;
+}
+
+static VOID VgaInitializePlanarTable(VOID)
+{
+    UINT i, j;
+
+    for (i = 0; i < ARRAYSIZE(VgaPlanarTable); i++)
+    {
+        VgaPlanarTable[i] = 0ULL;
+
+        /* The most significant bit is the leftmost pixel */
+        for (j = 0; j < 8; j++)
+        {
+            if (i & (0x80 >> j)) VgaPlanarTable[i] |= 1ULL << (j * 8);
+        }
+    }
+}
+
+static PBYTE VgaConvertScanline(DWORD Address, DWORD AddressSize, BYTE PixelShift)
+{
+    DWORD i, Units, Offset;
+    ULONGLONG Pixels;
+
+    if (VgaSeqRegisters[SVGA_SEQ_EXT_MODE_REG] & SVGA_SEQ_EXT_MODE_HIGH_RES)
+    {
+        /* Only the 256 color packed pixel mode is handled here */
+        if (!(VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)) return NULL;
+
+        RtlCopyMemory(VgaLineBuffer,
+                      &VgaMemory[Address + ((PixelShift >> 1) & 0x03)],
+                      CurrResolution.X);
+        return VgaLineBuffer;
+    }
+
+    if ((VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_SHIFT256)
+        && (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT))
+    {
+        /* 256 color mode, 4 pixels per address unit, one on each plane */
+        PixelShift = (PixelShift >> 1) & 0x03;
+        Units = (PixelShift + CurrResolution.X + 3) / 4;
+
+        for (i = 0; i < Units; i++)
+        {
+            Offset = WRAP_OFFSET((Address + i) * AddressSize) * VGA_NUM_BANKS;
+            *(PULONG)&VgaLineBuffer[i * 4] = *(PULONG)&VgaMemory[Offset];
+        }
+
+        return &VgaLineBuffer[PixelShift];
+    }
+
+    if (!(VgaGcRegisters[VGA_GC_MODE_REG] & (VGA_GC_MODE_SHIFT256 | VGA_GC_MODE_SHIFTREG))
+        && !(VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
+        && (PixelShift < 8))
+    {
+        /* 16 color mode, 8 pixels per address unit, one bit on each plane */
+        Units = (PixelShift + CurrResolution.X + 7) / 8;
+
+        for (i = 0; i < Units; i++)
+        {
+            Offset = WRAP_OFFSET((Address + i) * AddressSize) * VGA_NUM_BANKS;
+
+            Pixels = VgaPlanarTable[VgaMemory[Offset]]
+                     | (VgaPlanarTable[VgaMemory[Offset + 1]] << 1)
+                     | (VgaPlanarTable[VgaMemory[Offset + 2]] << 2)
+                     | (VgaPlanarTable[VgaMemory[Offset + 3]] << 3);
+
+            *(PULONGLONG)&VgaLineBuffer[i * 8] = Pixels;
+        }
+
+        return &VgaLineBuffer[PixelShift];
+    }
+
+    /* Other modes are converted one pixel at a time */
+    return NULL;
+}
+
 static inline VOID VgaMarkForUpdate(SHORT Row, SHORT Column)
 {
     /* Check if this is the first time the rectangle is updated */
@@ -733,6 +939,52 @@ static inline VOID VgaMarkForUpdate(SHORT Row, SHORT Column)
     NeedsUpdate = TRUE;
 }
 
+static VOID VgaWriteScanline(PBYTE GraphicsBuffer, SHORT Row, PBYTE Line)
+{
+    SHORT j, First, Last;
+    DWORD Step = DoubleWidth ? 2 : 1;
+    DWORD Width = CurrResolution.X * Step;
+    PBYTE Scanline = &GraphicsBuffer[Row * (DoubleHeight ? 2 : 1) * Width];
+
+    /* Find the first and last pixels that changed */
+    for (First = 0; First < CurrResolution.X; First++)
+    {
+        if (Scanline[First * Step] != Line[First]) break;
+    }
+
+    /* Nothing to do if the scanline is unchanged */
+    if (First == CurrResolution.X) return;
+
+    for (Last = CurrResolution.X - 1; Last > First; Last--)
+    {
+        if (Scanline[Last * Step] != Line[Last]) break;
+    }
+
+    /* Write the new values, taking into account DoubleVision mode */
+    if (DoubleWidth)
+    {
+        for (j = First; j <= Last; j++)
+        {
+            Scanline[j * 2] = Scanline[j * 2 + 1] = Line[j];
+        }
+    }
+    else
+    {
+        RtlCopyMemory(&Scanline[First], &Line[First], Last - First + 1);
+    }
+
+    if (DoubleHeight)
+    {
+        RtlCopyMemory(&Scanline[Width + First * Step],
+                      &Scanline[First * Step],
+                      (Last - First + 1) * Step);
+    }
+
+    /* Mark the changed pixels */
+    VgaMarkForUpdate(Row, First);
+    VgaMarkForUpdate(Row, Last);
+}
+
 static VOID VgaUpdateFramebuffer(VOID)
 {
     SHORT i, j, k;
@@ -756,8 +1008,41 @@ static VOID VgaUpdateFramebuffer(VOID)
         /* Graphics mode */
         PBYTE GraphicsBuffer = (PBYTE)ActiveFramebuffer;
         DWORD InterlaceHighBit = VGA_INTERLACE_HIGH_BIT;
+        BOOLEAN FullRefresh = VgaDisplayStateChanged() || VgaFullRefresh;
+        BYTE AcPalette[VGA_AC_PAL_F_REG + 1];
         SHORT X;
 
+        /* Nothing to do if neither the video memory nor the settings changed */
+        if (!FullRefresh && !VgaMemoryDirty) return;
+
+        /*
+         * In 16 color mode, the value is an index to the AC registers
+         * if external palette access is disabled, otherwise (in case
+         * of palette loading) it is a blank pixel.
+         */
+        for (k = 0; k <= VGA_AC_PAL_F_REG; k++)
+        {
+            if (VgaAcPalDisable)
+            {
+                if (!(VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_P54S))
+                {
+                    /* Bits 4 and 5 are taken from the palette register */
+                    AcPalette[k] = ((VgaAcRegisters[VGA_AC_COLOR_SEL_REG] << 4) & 0xC0)
+                                   | (VgaAcRegisters[k] & 0x3F);
+                }
+                else
+                {
+                    /* Bits 4 and 5 are taken from the color select register */
+                    AcPalette[k] = (VgaAcRegisters[VGA_AC_COLOR_SEL_REG] << 4)
+                                   | (VgaAcRegisters[k] & 0x0F);
+                }
+            }
+            else
+            {
+                AcPalette[k] = 0;
+            }
+        }
+
         /*
          * Synchronize access to the graphics framebuffer
          * with the console framebuffer mutex.
@@ -806,211 +1091,153 @@ static VOID VgaUpdateFramebuffer(VOID)
                 Address |= InterlaceHighBit;
             }
 
-            /* Loop through the pixels */
-            for (j = 0; j < CurrResolution.X; j++)
+            if (FullRefresh || VgaIsScanlineDirty(Address, AddressSize, PixelShift >= 8))
             {
-                BYTE PixelData = 0;
+                /* Convert whole bytes at a time when the mode allows it */
+                PBYTE Line = VgaConvertScanline(Address, AddressSize, PixelShift);
 
-                /* Apply horizontal pixel panning */
-                if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
+                if (Line == NULL)
                 {
-                    X = j + ((PixelShift >> 1) & 0x03);
-                }
-                else
-                {
-                    X = j + ((PixelShift < 8) ? PixelShift : -1);
-                }
+                    Line = VgaLineBuffer;
 
-                if (VgaSeqRegisters[SVGA_SEQ_EXT_MODE_REG] & SVGA_SEQ_EXT_MODE_HIGH_RES)
-                {
-                    // TODO: Check for high color modes
-
-                    /* 256 color mode */
-                    PixelData = VgaMemory[Address + X];
-                }
-                else
-                {
-                    /* Check the shifting mode */
-                    if (VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_SHIFT256)
+                    /* Loop through the pixels */
+                    for (j = 0; j < CurrResolution.X; j++)
                     {
-                        /* 4 bits shifted from each plane */
+                        BYTE PixelData = 0;
 
-                        /* Check if this is 16 or 256 color mode */
+                        /* Apply horizontal pixel panning */
                         if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
                         {
-                            /* One byte per pixel */
-                            PixelData = VgaMemory[WRAP_OFFSET((Address + (X / VGA_NUM_BANKS)) * AddressSize)
-                                                  * VGA_NUM_BANKS + (X % VGA_NUM_BANKS)];
+                            X = j + ((PixelShift >> 1) & 0x03);
                         }
                         else
                         {
-                            /* 4-bits per pixel */
-
-                            PixelData = VgaMemory[WRAP_OFFSET((Address + (X / (VGA_NUM_BANKS * 2))) * AddressSize)
-                                                  * VGA_NUM_BANKS + ((X / 2) % VGA_NUM_BANKS)];
-
-                            /* Check if we should use the highest 4 bits or lowest 4 */
-                            if ((X % 2) == 0)
-                            {
-                                /* Highest 4 */
-                                PixelData >>= 4;
-                            }
-                            else
-                            {
-                                /* Lowest 4 */
-                                PixelData &= 0x0F;
-                            }
-                        }
-                    }
-                    else if (VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_SHIFTREG)
-                    {
-                        /* Check if this is 16 or 256 color mode */
-                        if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
-                        {
-                            // TODO: NOT IMPLEMENTED
-                            DPRINT1("8-bit interleaved mode is not implemented!\n");
-                        }
-                        else
-                        {
-                            /*
-                             * 2 bits shifted from plane 0 and 2 for the first 4 pixels,
-                             * then 2 bits shifted from plane 1 and 3 for the next 4
-                             */
-                            DWORD BankNumber = (X / 4) % 2;
-                            DWORD Offset = Address + (X / 8);
-                            BYTE LowPlaneData = VgaMemory[WRAP_OFFSET(Offset * AddressSize) * VGA_NUM_BANKS + BankNumber];
-                            BYTE HighPlaneData = VgaMemory[WRAP_OFFSET(Offset * AddressSize) * VGA_NUM_BANKS + (BankNumber + 2)];
-
-                            /* Extract the two bits from each plane */
-                            LowPlaneData  = (LowPlaneData  >> (6 - ((X % 4) * 2))) & 0x03;
-                            HighPlaneData = (HighPlaneData >> (6 - ((X % 4) * 2))) & 0x03;
-
-                            /* Combine them into the pixel */
-                            PixelData = LowPlaneData | (HighPlaneData << 2);
+                            X = j + ((PixelShift < 8) ? PixelShift : -1);
                         }
-                    }
-                    else
-                    {
-                        /* 1 bit shifted from each plane */
 
-                        /* Check if this is 16 or 256 color mode */
-                        if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
+                        if (VgaSeqRegisters[SVGA_SEQ_EXT_MODE_REG] & SVGA_SEQ_EXT_MODE_HIGH_RES)
                         {
-                            /* 8 bits per pixel, 2 on each plane */
-
-                            for (k = 0; k < VGA_NUM_BANKS; k++)
-                            {
-                                /* The data is on plane k, 4 pixels per byte */
-                                BYTE PlaneData = VgaMemory[WRAP_OFFSET((Address + (X >> 2)) * AddressSize) * VGA_NUM_BANKS + k];
-
-                                /* The mask of the first bit in the pair */
-                                BYTE BitMask = 1 << (((3 - (X % VGA_NUM_BANKS)) * 2) + 1);
-
-                                /* Bits 0, 1, 2 and 3 come from the first bit of the pair */
-                                if (PlaneData & BitMask) PixelData |= 1 << k;
+                            // TODO: Check for high color modes
 
-                                /* Bits 4, 5, 6 and 7 come from the second bit of the pair */
-                                if (PlaneData & (BitMask >> 1)) PixelData |= 1 << (k + 4);
-                            }
+                            /* 256 color mode */
+                            PixelData = VgaMemory[Address + X];
                         }
                         else
                         {
-                            /* 4 bits per pixel, 1 on each plane */
-
-                            for (k = 0; k < VGA_NUM_BANKS; k++)
+                            /* Check the shifting mode */
+                            if (VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_SHIFT256)
                             {
-                                BYTE PlaneData = VgaMemory[WRAP_OFFSET((Address + (X >> 3)) * AddressSize) * VGA_NUM_BANKS + k];
-
-                                /* If the bit on that plane is set, set it */
-                                if (PlaneData & (1 << (7 - (X % 8)))) PixelData |= 1 << k;
+                                /* 4 bits shifted from each plane */
+
+                                /* Check if this is 16 or 256 color mode */
+                                if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
+                                {
+                                    /* One byte per pixel */
+                                    PixelData = VgaMemory[WRAP_OFFSET((Address + (X / VGA_NUM_BANKS)) * AddressSize)
+                                                          * VGA_NUM_BANKS + (X % VGA_NUM_BANKS)];
+                                }
+                                else
+                                {
+                                    /* 4-bits per pixel */
+
+                                    PixelData = VgaMemory[WRAP_OFFSET((Address + (X / (VGA_NUM_BANKS * 2))) * AddressSize)
+                                                          * VGA_NUM_BANKS + ((X / 2) % VGA_NUM_BANKS)];
+
+                                    /* Check if we should use the highest 4 bits or lowest 4 */
+                                    if ((X % 2) == 0)
+                                    {
+                                        /* Highest 4 */
+                                        PixelData >>= 4;
+                                    }
+                                    else
+                                    {
+                                        /* Lowest 4 */
+                                        PixelData &= 0x0F;
+                                    }
+                                }
+                            }
+                            else if (VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_SHIFTREG)
+                            {
+                                /* Check if this is 16 or 256 color mode */
+                                if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
+                                {
+                                    // TODO: NOT IMPLEMENTED
+                                    DPRINT1("8-bit interleaved mode is not implemented!\n");
+                                }
+                                else
+                                {
+                                    /*
+                                     * 2 bits shifted from plane 0 and 2 for the first 4 pixels,
+                                     * then 2 bits shifted from plane 1 and 3 for the next 4
+                                     */
+                                    DWORD BankNumber = (X / 4) % 2;
+                                    DWORD Offset = Address + (X / 8);
+                                    BYTE LowPlaneData = VgaMemory[WRAP_OFFSET(Offset * AddressSize) * VGA_NUM_BANKS + BankNumber];
+                                    BYTE HighPlaneData = VgaMemory[WRAP_OFFSET(Offset * AddressSize) * VGA_NUM_BANKS + (BankNumber + 2)];
+
+                                    /* Extract the two bits from each plane */
+                                    LowPlaneData  = (LowPlaneData  >> (6 - ((X % 4) * 2))) & 0x03;
+                                    HighPlaneData = (HighPlaneData >> (6 - ((X % 4) * 2))) & 0x03;
+
+                                    /* Combine them into the pixel */
+                                    PixelData = LowPlaneData | (HighPlaneData << 2);
+                                }
+                            }
+                            else
+                            {
+                                /* 1 bit shifted from each plane */
+
+                                /* Check if this is 16 or 256 color mode */
+                                if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
+                                {
+                                    /* 8 bits per pixel, 2 on each plane */
+
+                                    for (k = 0; k < VGA_NUM_BANKS; k++)
+                                    {
+                                        /* The data is on plane k, 4 pixels per byte */
+                                        BYTE PlaneData = VgaMemory[WRAP_OFFSET((Address + (X >> 2)) * AddressSize) * VGA_NUM_BANKS + k];
+
+                                        /* The mask of the first bit in the pair */
+                                        BYTE BitMask = 1 << (((3 - (X % VGA_NUM_BANKS)) * 2) + 1);
+
+                                        /* Bits 0, 1, 2 and 3 come from the first bit of the pair */
+                                        if (PlaneData & BitMask) PixelData |= 1 << k;
+
+                                        /* Bits 4, 5, 6 and 7 come from the second bit of the pair */
+                                        if (PlaneData & (BitMask >> 1)) PixelData |= 1 << (k + 4);
+                                    }
+                                }
+                                else
+                                {
+                                    /* 4 bits per pixel, 1 on each plane */
+
+                                    for (k = 0; k < VGA_NUM_BANKS; k++)
+                                    {
+                                        BYTE PlaneData = VgaMemory[WRAP_OFFSET((Address + (X >> 3)) * AddressSize) * VGA_NUM_BANKS + k];
+
+                                        /* If the bit on that plane is set, set it */
+                                        if (PlaneData & (1 << (7 - (X % 8)))) PixelData |= 1 << k;
+                                    }
+                                }
                             }
                         }
-                    }
-                }
 
-                if (!(VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT))
-                {
-                    /*
-                     * In 16 color mode, the value is an index to the AC registers
-                     * if external palette access is disabled, otherwise (in case
-                     * of palette loading) it is a blank pixel.
-                     */
-
-                    if (VgaAcPalDisable)
-                    {
-                        if (!(VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_P54S))
-                        {
-                            /* Bits 4 and 5 are taken from the palette register */
-                            PixelData = ((VgaAcRegisters[VGA_AC_COLOR_SEL_REG] << 4) & 0xC0)
-                                        | (VgaAcRegisters[PixelData & 0x0F] & 0x3F);
-                        }
-                        else
-                        {
-                            /* Bits 4 and 5 are taken from the color select register */
-                            PixelData = (VgaAcRegisters[VGA_AC_COLOR_SEL_REG] << 4)
-                                        | (VgaAcRegisters[PixelData & 0x0F] & 0x0F);
-                        }
-                    }
-                    else
-                    {
-                        PixelData = 0;
+                        Line[j] = PixelData;
                     }
                 }
 
-                /* Take into account DoubleVision mode when checking for pixel updates */
-                if (DoubleWidth && DoubleHeight)
-                {
-                    /* Now check if the resulting pixel data has changed */
-                    if (GraphicsBuffer[(i * 2 * CurrResolution.X * 2) + (j * 2)] != PixelData)
-                    {
-                        /* Yes, write the new value */
-                        GraphicsBuffer[(i * 2 * CurrResolution.X * 2) + (j * 2)] = PixelData;
-                        GraphicsBuffer[(i * 2 * CurrResolution.X * 2) + (j * 2 + 1)] = PixelData;
-                        GraphicsBuffer[((i * 2 + 1) * CurrResolution.X * 2) + (j * 2)] = PixelData;
-                        GraphicsBuffer[((i * 2 + 1) * CurrResolution.X * 2) + (j * 2 + 1)] = PixelData;
-
-                        /* Mark the specified pixel as changed */
-                        VgaMarkForUpdate(i, j);
-                    }
-                }
-                else if (DoubleWidth && !DoubleHeight)
+                if (!(VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT))
                 {
-                    /* Now check if the resulting pixel data has changed */
-                    if (GraphicsBuffer[(i * CurrResolution.X * 2) + (j * 2)] != PixelData)
-                    {
-                        /* Yes, write the new value */
-                        GraphicsBuffer[(i * CurrResolution.X * 2) + (j * 2)] = PixelData;
-                        GraphicsBuffer[(i * CurrResolution.X * 2) + (j * 2 + 1)] = PixelData;
-
-                        /* Mark the specified pixel as changed */
-                        VgaMarkForUpdate(i, j);
-                    }
+                    /* In 16 color mode, the value is an index to the AC registers */
+                    for (j = 0; j < CurrResolution.X; j++) Line[j] = AcPalette[Line[j] & 0x0F];
                 }
-                else if (!DoubleWidth && DoubleHeight)
-                {
-                    /* Now check if the resulting pixel data has changed */
-                    if (GraphicsBuffer[(i * 2 * CurrResolution.X) + j] != PixelData)
-                    {
-                        /* Yes, write the new value */
-                        GraphicsBuffer[(i * 2 * CurrResolution.X) + j] = PixelData;
-                        GraphicsBuffer[((i * 2 + 1) * CurrResolution.X) + j] = PixelData;
 
-                        /* Mark the specified pixel as changed */
-                        VgaMarkForUpdate(i, j);
-                    }
-                }
-                else // if (!DoubleWidth && !DoubleHeight)
-                {
-                    /* Now check if the resulting pixel data has changed */
-                    if (GraphicsBuffer[i * CurrResolution.X + j] != PixelData)
-                    {
-                        /* Yes, write the new value */
-                        GraphicsBuffer[i * CurrResolution.X + j] = PixelData;
+                /* Copy the changed pixels to the framebuffer */
+                VgaWriteScanline(GraphicsBuffer, i, Line);
 
-                        /* Mark the specified pixel as changed */
-                        VgaMarkForUpdate(i, j);
-                    }
-                }
+#ifdef VGA_DISPLAY_STATISTICS
+                VgaScanlineCount++;
+#endif
             }
 
             if ((VgaGcRegisters[VGA_GC_MISC_REG] & VGA_GC_MISC_OE) && (i & 1))
@@ -1075,6 +1302,15 @@ static VOID VgaUpdateFramebuffer(VOID)
             Address += ScanlineSizeLatch;
         }
     }
+
+    /* Everything written to the video memory so far is now displayed */
+    if (VgaMemoryDirty)
+    {
+        RtlZeroMemory(VgaDirtyBitmap, sizeof(VgaDirtyBitmap));
+        VgaMemoryDirty = FALSE;
+    }
+
+    VgaFullRefresh = FALSE;
 }
 
 static VOID VgaUpdateTextCursor(VOID)
@@ -1612,6 +1848,13 @@ static VOID WINAPI VgaWritePort(USHORT Port, BYTE Data)
 
 static inline VOID VgaVerticalRetrace(VOID)
 {
+#ifdef VGA_DISPLAY_STATISTICS
+    LARGE_INTEGER RefreshStart, RefreshEnd;
+    DWORD Elapsed;
+
+    NtQueryPerformanceCounter(&RefreshStart, NULL);
+#endif
+
     /* If nothing has changed, just return */
     // if (!ModeChanged && !CursorChanged && !PaletteChanged && !NeedsUpdate)
         // return;
@@ -1638,18 +1881,40 @@ static inline VOID VgaVerticalRetrace(VOID)
     VgaUpdateFramebuffer();
 
     /* Ignore if there's nothing to update */
-    if (!NeedsUpdate) return;
+    if (NeedsUpdate)
+    {
+        DPRINT("Updating screen rectangle (%d, %d, %d, %d)\n",
+               UpdateRectangle.Left,
+               UpdateRectangle.Top,
+               UpdateRectangle.Right,
+               UpdateRectangle.Bottom);
 
-    DPRINT("Updating screen rectangle (%d, %d, %d, %d)\n",
-           UpdateRectangle.Left,
-           UpdateRectangle.Top,
-           UpdateRectangle.Right,
-           UpdateRectangle.Bottom);
+        VgaConsoleRepaintScreen(&UpdateRectangle);
 
-    VgaConsoleRepaintScreen(&UpdateRectangle);
+        /* Clear the update flag */
+        NeedsUpdate = FALSE;
+    }
 
-    /* Clear the update flag */
-    NeedsUpdate = FALSE;
+#ifdef VGA_DISPLAY_STATISTICS
+    NtQueryPerformanceCounter(&RefreshEnd, NULL);
+    VgaRefreshTime.QuadPart += RefreshEnd.QuadPart - RefreshStart.QuadPart;
+    VgaFrameCount++;
+
+    /* Report the frame rate and the time spent refreshing once per second */
+    Elapsed = GetTickCount() - VgaStatisticsStart;
+    if (Elapsed >= 1000)
+    {
+        DPRINT1("VGA: %lu frames/s, %lu scanlines redrawn/s, %lu%% of the time spent refreshing\n",
+                VgaFrameCount * 1000 / Elapsed,
+                VgaScanlineCount * 1000 / Elapsed,
+                (ULONG)(VgaRefreshTime.QuadPart * 100000 / VgaCounterFrequency.QuadPart / Elapsed));
+
+        VgaRefreshTime.QuadPart = 0LL;
+        VgaFrameCount = 0;
+        VgaScanlineCount = 0;
+        VgaStatisticsStart += Elapsed;
+    }
+#endif
 }
 
 static VOID FASTCALL VgaHorizontalRetrace(ULONGLONG ElapsedTime)
@@ -2028,6 +2293,9 @@ BOOLEAN FASTCALL VgaWriteMemory(ULONG Address, PVOID Buffer, ULONG Size)
                 /* Copy the value to the VGA memory */
                 VgaMemory[VideoAddress * VGA_NUM_BANKS + j] = VgaTranslateByteForWriting(BufPtr[i], j);
             }
+
+            /* The scanlines showing this address must be redrawn */
+            VgaMarkMemoryDirty(VideoAddress * VGA_NUM_BANKS, VGA_NUM_BANKS);
         }
     }
     else
@@ -2040,6 +2308,7 @@ BOOLEAN FASTCALL VgaWriteMemory(ULONG Address, PVOID Buffer, ULONG Size)
         /* Just copy to the video memory */
         VideoAddress = VgaTranslateAddress(Address);
         VideoMemory = &VgaMemory[VideoAddress + (Address & 3)];
+        VgaMarkMemoryDirty(VideoAddress + (Address & 3), Size);
 
         switch (Size)
         {
@@ -2074,6 +2343,7 @@ BOOLEAN FASTCALL VgaWriteMemory(ULONG Address, PVOID Buffer, ULONG Size)
 VOID VgaClearMemory(VOID)
 {
     RtlZeroMemory(VgaMemory, sizeof(VgaMemory));
+    VgaFullRefresh = TRUE;
 }
 
 VOID VgaWriteTextModeFont(UINT FontNumber, CONST UCHAR* FontData, UINT Height)
@@ -2095,6 +2365,8 @@ VOID VgaWriteTextModeFont(UINT FontNumber, CONST UCHAR* FontData, UINT Height)
             VgaMemory[(i * VGA_MAX_FONT_HEIGHT + j) * VGA_NUM_BANKS + VGA_FONT_BANK] = 0;
         }
     }
+
+    VgaFullRefresh = TRUE;
 }
 
 BOOLEAN VgaInitialize(HANDLE TextHandle)
@@ -2117,6 +2389,15 @@ BOOLEAN VgaInitialize(HANDLE TextHandle)
     /* Clear the VGA memory */
     VgaClearMemory();
 
+    /* Build the planar to chunky conversion table */
+    VgaInitializePlanarTable();
+
+#ifdef VGA_DISPLAY_STATISTICS
+    NtQueryPerformanceCounter(&VgaRefreshTime, &VgaCounterFrequency);
+    VgaRefreshTime.QuadPart = 0LL;
+    VgaStatisticsStart = GetTickCount();
+#endif
+
     /* Register the I/O Ports */
     RegisterIoPort(0x3CC, VgaReadPort,         NULL);   // VGA_MISC_READ
     RegisterIoPort(0x3C2, VgaReadPort, VgaWritePort);   // VGA_MISC_WRITE, VGA_INSTAT0_READ
@@ -216,6 +216,24 @@ VOID FASTCALL EmulatorWriteMemory(PFAST486_STATE State, ULONG Address, PVOID Buf
     }
 }
 
+PVOID FASTCALL EmulatorMapMemory(PFAST486_STATE State, ULONG Address, BOOLEAN Write)
+{
+    UNREFERENCED_PARAMETER(State);
+    UNREFERENCED_PARAMETER(Write);
+
+    /* If the A20 line is disabled, mask bit 20 */
+    if (!A20Line) Address &= ~(1 << 20);
+
+    /* Hooked pages must go through EmulatorReadMemory and EmulatorWriteMemory */
+    if (Address >= MAX_ADDRESS || PageTable[Address >> 12] != NULL) return NULL;
+
+    /*
+     * Let the CPU access this page directly. It must be flushed
+     * whenever the page table or the A20 line change.
+     */
+    return REAL_TO_PHYS(Address & ~(PAGE_SIZE - 1));
+}
+
 VOID FASTCALL EmulatorCopyMemory(PFAST486_STATE State, ULONG DestAddress, ULONG SrcAddress, ULONG Size)
 {
     /*
@@ -274,7 +292,11 @@ VOID FASTCALL EmulatorCopyMemory(PFAST486_STATE State, ULONG DestAddress, ULONG
 
 VOID EmulatorSetA20(BOOLEAN Enabled)
 {
+    if (A20Line == Enabled) return;
     A20Line = Enabled;
+
+    /* The memory above 1 MB just changed, and the CPU caches code by address */
+    Fast486FlushCache(&EmulatorContext);
 }
 
 BOOLEAN EmulatorGetA20(VOID)
@@ -346,6 +368,9 @@ MemInstallFastMemoryHook(PVOID Address,
     /* Add the hook entry to the page table */
     for (i = FirstPage; i <= LastPage; i++) PageTable[i] = Hook;
 
+    /* The CPU may have cached code from these pages */
+    Fast486FlushCache(&EmulatorContext);
+
     return TRUE;
 }
 
@@ -374,6 +399,9 @@ MemRemoveFastMemoryHook(PVOID Address, ULONG Size)
         PageTable[i] = NULL;
     }
 
+    /* The CPU may have cached code from these pages */
+    Fast486FlushCache(&EmulatorContext);
+
     return TRUE;
 }
 
@@ -442,8 +470,13 @@ VdmFlushCache(IN USHORT   Segment,
               IN ULONG    Size,
               IN VDM_MODE Mode)
 {
-    // FIXME
-    UNIMPLEMENTED;
+    UNREFERENCED_PARAMETER(Segment);
+    UNREFERENCED_PARAMETER(Offset);
+    UNREFERENCED_PARAMETER(Size);
+    UNREFERENCED_PARAMETER(Mode);
+
+    /* Flushing the whole code cache is cheap, don't bother with the range */
+    Fast486FlushCache(&EmulatorContext);
     return TRUE;
 }
 
@@ -542,6 +575,9 @@ VDDInstallMemoryHook(IN HANDLE hVdd,
     /* Add the hook entry to the page table */
     for (i = FirstPage; i <= LastPage; i++) PageTable[i] = Hook;
 
+    /* The CPU may have cached code from these pages */
+    Fast486FlushCache(&EmulatorContext);
+
     return TRUE;
 }
 
@@ -598,6 +634,9 @@ VDDDeInstallMemoryHook(IN HANDLE hVdd,
         PageTable[i] = NULL;
     }
 
+    /* The CPU may have cached code from these pages */
+    Fast486FlushCache(&EmulatorContext);
+
     return TRUE;
 }
 
@@ -55,6 +55,15 @@ EmulatorWriteMemory
     ULONG Size
 );
 
+PVOID
+FASTCALL
+EmulatorMapMemory
+(
+    PFAST486_STATE State,
+    ULONG Address,
+    BOOLEAN Write
+);
+
 VOID
 FASTCALL
 EmulatorCopyMemory
@@ -191,6 +191,100 @@ static const ULONG ExpandDest[16] =
   return(Result);
 }
 
+/*
+ * Does the blt of a DIB_xBPP_BitBlt primitive a row at a time with
+ * RowRop, when the pixels can be combined as raw bits: an 8, 16 or 32bpp
+ * destination, a solid brush, and a source of the same format without
+ * color translation. Returns FALSE if the per pixel code has to do it.
+ */
+BOOLEAN
+DIB_RowBitBlt(PBLTINFO BltInfo, PFN_DIB_RowRop RowRop, BOOLEAN UsesSource, BOOLEAN UsesPattern)
+{
+  SURFOBJ *DestSurface = BltInfo->DestSurface;
+  SURFOBJ *SourceSurface = BltInfo->SourceSurface;
+  ULONG Bpp, LineCount, RowBytes, Pattern = 0;
+  PBYTE DestBase, SourceBase;
+  LONG DestDelta, SourceDelta;
+
+  switch (DestSurface->iBitmapFormat)
+  {
+    case BMF_8BPP:  Bpp = 8;  break;
+    case BMF_16BPP: Bpp = 16; break;
+    case BMF_32BPP: Bpp = 32; break;
+    default: return FALSE;
+  }
+
+  if (UsesPattern)
+  {
+    /* Pattern brushes are left to the per pixel code */
+    if (BltInfo->PatternSurface)
+      return FALSE;
+
+    /* Replicate the brush color to 32 bits, like the per pixel code */
+    if (BltInfo->Brush)
+      Pattern = BltInfo->Brush->iSolidColor;
+    if (Bpp == 8)
+      Pattern = (Pattern & 0xFF) * 0x01010101;
+    else if (Bpp == 16)
+      Pattern = (Pattern & 0xFFFF) * 0x00010001;
+  }
+
+  DestDelta = DestSurface->lDelta;
+  DestBase = (PBYTE)DestSurface->pvScan0 +
+             BltInfo->DestRect.top * DestDelta +
+             BltInfo->DestRect.left * Bpp / 8;
+
+  if (UsesSource)
+  {
+    if (SourceSurface->iBitmapFormat != DestSurface->iBitmapFormat ||
+        (BltInfo->XlateSourceToDest &&
+         !(BltInfo->XlateSourceToDest->flXlate & XO_TRIVIAL)))
+    {
+      return FALSE;
+    }
+
+    /* The rows go left to right, so within a line the source must not be left of the dest */
+    if (SourceSurface->pvScan0 == DestSurface->pvScan0 &&
+        BltInfo->SourcePoint.y == BltInfo->DestRect.top &&
+        BltInfo->SourcePoint.x < BltInfo->DestRect.left)
+    {
+      return FALSE;
+    }
+
+    SourceDelta = SourceSurface->lDelta;
+    SourceBase = (PBYTE)SourceSurface->pvScan0 +
+                 BltInfo->SourcePoint.y * SourceDelta +
+                 BltInfo->SourcePoint.x * Bpp / 8;
+  }
+  else
+  {
+    /* Row functions without a source just walk along the dest */
+    SourceDelta = DestDelta;
+    SourceBase = DestBase;
+  }
+
+  LineCount = BltInfo->DestRect.bottom - BltInfo->DestRect.top;
+  RowBytes = (BltInfo->DestRect.right - BltInfo->DestRect.left) * Bpp / 8;
+
+  /* Same order of lines as the per pixel code, bottom up unless the source is below */
+  if (UsesSource && BltInfo->DestRect.top >= BltInfo->SourcePoint.y && LineCount)
+  {
+    DestBase += (LONG)(LineCount - 1) * DestDelta;
+    SourceBase += (LONG)(LineCount - 1) * SourceDelta;
+    DestDelta = -DestDelta;
+    SourceDelta = -SourceDelta;
+  }
+
+  while (LineCount--)
+  {
+    RowRop(DestBase, SourceBase, RowBytes, Pattern);
+    DestBase += DestDelta;
+    SourceBase += SourceDelta;
+  }
+
+  return TRUE;
+}
+
 VOID Dummy_PutPixel(SURFOBJ* SurfObj, LONG x, LONG y, ULONG c)
 {
   return;
@@ -122,11 +122,28 @@ BOOLEAN DIB_32BPP_BitBltSrcCopy(PBLTINFO);
 BOOLEAN DIB_32BPP_TransparentBlt(SURFOBJ*,SURFOBJ*,RECTL*,RECTL*,XLATEOBJ*,ULONG);
 BOOLEAN DIB_32BPP_ColorFill(SURFOBJ*, RECTL*, ULONG);
 BOOLEAN DIB_32BPP_AlphaBlend(SURFOBJ*, SURFOBJ*, RECTL*, RECTL*, CLIPOBJ*, XLATEOBJ*, BLENDOBJ*);
+VOID DIB_32BPP_AlphaBlendRow(PULONG,PULONG,ULONG,UCHAR,BOOLEAN);
+VOID DIB_32BPP_StretchRow(PULONG,PULONG,LONG,ULONG,ULONG,ULONG,ULONG);
 
 BOOLEAN DIB_XXBPP_StretchBlt(SURFOBJ*,SURFOBJ*,SURFOBJ*,SURFOBJ*,RECTL*,RECTL*,POINTL*,BRUSHOBJ*,POINTL*,XLATEOBJ*,ROP4);
 BOOLEAN DIB_XXBPP_FloodFillSolid(SURFOBJ*, BRUSHOBJ*, RECTL*, POINTL*, ULONG, UINT);
 BOOLEAN DIB_XXBPP_AlphaBlend(SURFOBJ*, SURFOBJ*, RECTL*, RECTL*, CLIPOBJ*, XLATEOBJ*, BLENDOBJ*);
 
+typedef VOID (FASTCALL *PFN_DIB_RowRop)(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_NOTSRCCOPY(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_SRCAND(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_SRCPAINT(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_SRCINVERT(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_SRCERASE(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_NOTSRCERASE(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_MERGEPAINT(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_PATCOPY(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_PATINVERT(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_DSTINVERT(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_MERGECOPY(PBYTE,PBYTE,ULONG,ULONG);
+VOID FASTCALL Dib_RowRop_PATPAINT(PBYTE,PBYTE,ULONG,ULONG);
+BOOLEAN DIB_RowBitBlt(PBLTINFO,PFN_DIB_RowRop,BOOLEAN,BOOLEAN);
+
 extern unsigned char notmask[2];
 extern unsigned char altnotmask[2];
 #define MASK1BPP(x) (1<<(7-((x)&7)))
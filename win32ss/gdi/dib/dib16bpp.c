@@ -155,6 +155,7 @@ DIB_16BPP_BitBltSrcCopy(PBLTINFO BltInfo)
   PWORD    Source32, Dest32;
   DWORD    Index, StartLeft, EndRight;
   BOOLEAN  bTopToBottom, bLeftToRight;
+  PFN_XLATEROW pfnXlateRow = NULL;
 
   DPRINT("DIB_16BPP_BitBltSrcCopy: SrcSurf cx/cy (%d/%d), DestSuft cx/cy (%d/%d) dstRect: (%d,%d)-(%d,%d)\n",
          BltInfo->SourceSurface->sizlBitmap.cx, BltInfo->SourceSurface->sizlBitmap.cy,
@@ -293,6 +294,10 @@ DIB_16BPP_BitBltSrcCopy(PBLTINFO BltInfo)
         * (BltInfo->DestRect.bottom - BltInfo->DestRect.top - 1);
     }
 
+    /* Translate whole rows if they are not flipped */
+    if (!bLeftToRight)
+      pfnXlateRow = EXLATEOBJ_pfnXlateRow(BltInfo->XlateSourceToDest, BMF_8BPP, BMF_16BPP);
+
     for (j = BltInfo->DestRect.top; j < BltInfo->DestRect.bottom; j++)
     {
       SourceBits = SourceLine;
@@ -304,12 +309,20 @@ DIB_16BPP_BitBltSrcCopy(PBLTINFO BltInfo)
         SourceBits += (BltInfo->DestRect.right - BltInfo->DestRect.left - 1);
       }
 
-      for (i = BltInfo->DestRect.left; i < BltInfo->DestRect.right; i++)
+      if (pfnXlateRow)
       {
-        *((WORD *)DestBits) = (WORD)XLATEOBJ_iXlate(
-          BltInfo->XlateSourceToDest, *SourceBits);
-        DEC_OR_INC(SourceBits, bLeftToRight, 1);
-        DestBits += 2;
+        pfnXlateRow((PEXLATEOBJ)BltInfo->XlateSourceToDest, DestBits, SourceBits,
+                    BltInfo->DestRect.right - BltInfo->DestRect.left);
+      }
+      else
+      {
+        for (i = BltInfo->DestRect.left; i < BltInfo->DestRect.right; i++)
+        {
+          *((WORD *)DestBits) = (WORD)XLATEOBJ_iXlate(
+            BltInfo->XlateSourceToDest, *SourceBits);
+          DEC_OR_INC(SourceBits, bLeftToRight, 1);
+          DestBits += 2;
+        }
       }
       DEC_OR_INC(SourceLine, bTopToBottom, BltInfo->SourceSurface->lDelta);
       DestLine += BltInfo->DestSurface->lDelta;
@@ -381,6 +394,10 @@ DIB_16BPP_BitBltSrcCopy(PBLTINFO BltInfo)
       /* **Note: Indent is purposefully less than desired to keep reviewable differences to a minimum for PR** */
     {
       DPRINT("Flip is None.\n");
+
+      /* Translates front to back like the loops below */
+      pfnXlateRow = EXLATEOBJ_pfnXlateRow(BltInfo->XlateSourceToDest, BMF_16BPP, BMF_16BPP);
+
       if (BltInfo->DestRect.top < BltInfo->SourcePoint.y)
       {
         SourceLine = (PBYTE)BltInfo->SourceSurface->pvScan0 +
@@ -393,14 +410,22 @@ DIB_16BPP_BitBltSrcCopy(PBLTINFO BltInfo)
         {
           SourceBits = SourceLine;
           DestBits = DestLine;
-          for (i = BltInfo->DestRect.left; i <
-            BltInfo->DestRect.right; i++)
+          if (pfnXlateRow)
           {
-            *((WORD *)DestBits) = (WORD)XLATEOBJ_iXlate(
-              BltInfo->XlateSourceToDest,
-              *((WORD *)SourceBits));
-            SourceBits += 2;
-            DestBits += 2;
+            pfnXlateRow((PEXLATEOBJ)BltInfo->XlateSourceToDest, DestBits, SourceBits,
+                        BltInfo->DestRect.right - BltInfo->DestRect.left);
+          }
+          else
+          {
+            for (i = BltInfo->DestRect.left; i <
+              BltInfo->DestRect.right; i++)
+            {
+              *((WORD *)DestBits) = (WORD)XLATEOBJ_iXlate(
+                BltInfo->XlateSourceToDest,
+                *((WORD *)SourceBits));
+              SourceBits += 2;
+              DestBits += 2;
+            }
           }
           SourceLine += BltInfo->SourceSurface->lDelta;
           DestLine += BltInfo->DestSurface->lDelta;
@@ -425,14 +450,22 @@ DIB_16BPP_BitBltSrcCopy(PBLTINFO BltInfo)
         {
           SourceBits = SourceLine;
           DestBits = DestLine;
-          for (i = BltInfo->DestRect.left; i <
-            BltInfo->DestRect.right; i++)
+          if (pfnXlateRow)
           {
-            *((WORD *)DestBits) = (WORD)XLATEOBJ_iXlate(
-              BltInfo->XlateSourceToDest,
-              *((WORD *)SourceBits));
-            SourceBits += 2;
-            DestBits += 2;
+            pfnXlateRow((PEXLATEOBJ)BltInfo->XlateSourceToDest, DestBits, SourceBits,
+                        BltInfo->DestRect.right - BltInfo->DestRect.left);
+          }
+          else
+          {
+            for (i = BltInfo->DestRect.left; i <
+              BltInfo->DestRect.right; i++)
+            {
+              *((WORD *)DestBits) = (WORD)XLATEOBJ_iXlate(
+                BltInfo->XlateSourceToDest,
+                *((WORD *)SourceBits));
+              SourceBits += 2;
+              DestBits += 2;
+            }
           }
           SourceLine -= BltInfo->SourceSurface->lDelta;
           DestLine -= BltInfo->DestSurface->lDelta;
@@ -640,6 +673,10 @@ DIB_16BPP_BitBltSrcCopy(PBLTINFO BltInfo)
     }
     DestLine = DestBits;
 
+    /* Translate whole rows if they are not flipped */
+    if (!bLeftToRight)
+      pfnXlateRow = EXLATEOBJ_pfnXlateRow(BltInfo->XlateSourceToDest, BMF_32BPP, BMF_16BPP);
+
     for (j = BltInfo->DestRect.top; j < BltInfo->DestRect.bottom; j++)
     {
       SourceBits = SourceLine;
@@ -651,13 +688,21 @@ DIB_16BPP_BitBltSrcCopy(PBLTINFO BltInfo)
         SourceBits += (BltInfo->DestRect.right - BltInfo->DestRect.left - 1) * 4;
       }
 
-      for (i = BltInfo->DestRect.left; i < BltInfo->DestRect.right; i++)
+      if (pfnXlateRow)
       {
-        *((WORD *)DestBits) = (WORD)XLATEOBJ_iXlate(
-          BltInfo->XlateSourceToDest,
-          *((PDWORD) SourceBits));
-        DEC_OR_INC(SourceBits, bLeftToRight, 4);
-        DestBits += 2;
+        pfnXlateRow((PEXLATEOBJ)BltInfo->XlateSourceToDest, DestBits, SourceBits,
+                    BltInfo->DestRect.right - BltInfo->DestRect.left);
+      }
+      else
+      {
+        for (i = BltInfo->DestRect.left; i < BltInfo->DestRect.right; i++)
+        {
+          *((WORD *)DestBits) = (WORD)XLATEOBJ_iXlate(
+            BltInfo->XlateSourceToDest,
+            *((PDWORD) SourceBits));
+          DEC_OR_INC(SourceBits, bLeftToRight, 4);
+          DestBits += 2;
+        }
       }
 
       DEC_OR_INC(SourceLine, bTopToBottom, BltInfo->SourceSurface->lDelta);
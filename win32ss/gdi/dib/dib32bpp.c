@@ -59,6 +59,7 @@ DIB_32BPP_BitBltSrcCopy(PBLTINFO BltInfo)
   PBYTE    SourceBits_4BPP, SourceLine_4BPP;
   PDWORD   Source32, Dest32;
   DWORD    Index;
+  PFN_XLATEROW pfnXlateRow = NULL;
   LONG     DestWidth, DestHeight;
   BOOLEAN  bTopToBottom, bLeftToRight;
   BOOLEAN  blDeltaSrcNeg, blDeltaDestNeg;
@@ -225,6 +226,10 @@ DIB_32BPP_BitBltSrcCopy(PBLTINFO BltInfo)
       SourceLine += BltInfo->SourceSurface->lDelta * (DestHeight - 1);
     }
 
+    /* Translate whole rows if they are not flipped */
+    if (!bLeftToRight)
+      pfnXlateRow = EXLATEOBJ_pfnXlateRow(BltInfo->XlateSourceToDest, BMF_8BPP, BMF_32BPP);
+
     for (j = BltInfo->DestRect.top; j < BltInfo->DestRect.bottom; j++)
     {
       SourceBits = SourceLine;
@@ -236,12 +241,19 @@ DIB_32BPP_BitBltSrcCopy(PBLTINFO BltInfo)
         SourceBits += (DestWidth - 1);
       }
 
-      for (i = BltInfo->DestRect.left; i < BltInfo->DestRect.right; i++)
+      if (pfnXlateRow)
       {
-        xColor = *SourceBits;
-        *((PDWORD) DestBits) = (DWORD)XLATEOBJ_iXlate(BltInfo->XlateSourceToDest, xColor);
-        DEC_OR_INC(SourceBits, bLeftToRight, 1);
-        DestBits += 4;
+        pfnXlateRow((PEXLATEOBJ)BltInfo->XlateSourceToDest, DestBits, SourceBits, DestWidth);
+      }
+      else
+      {
+        for (i = BltInfo->DestRect.left; i < BltInfo->DestRect.right; i++)
+        {
+          xColor = *SourceBits;
+          *((PDWORD) DestBits) = (DWORD)XLATEOBJ_iXlate(BltInfo->XlateSourceToDest, xColor);
+          DEC_OR_INC(SourceBits, bLeftToRight, 1);
+          DestBits += 4;
+        }
       }
       DEC_OR_INC(SourceLine, bTopToBottom, BltInfo->SourceSurface->lDelta);
       DestLine += BltInfo->DestSurface->lDelta;
@@ -267,6 +279,10 @@ DIB_32BPP_BitBltSrcCopy(PBLTINFO BltInfo)
       SourceLine += BltInfo->SourceSurface->lDelta * (DestHeight - 1);
     }
 
+    /* Translate whole rows if they are not flipped */
+    if (!bLeftToRight)
+      pfnXlateRow = EXLATEOBJ_pfnXlateRow(BltInfo->XlateSourceToDest, BMF_16BPP, BMF_32BPP);
+
     for (j = BltInfo->DestRect.top; j < BltInfo->DestRect.bottom; j++)
     {
       SourceBits = SourceLine;
@@ -278,12 +294,19 @@ DIB_32BPP_BitBltSrcCopy(PBLTINFO BltInfo)
         SourceBits += (DestWidth - 1) * 2;
       }
 
-      for (i = BltInfo->DestRect.left; i < BltInfo->DestRect.right; i++)
+      if (pfnXlateRow)
       {
-        xColor = *((PWORD) SourceBits);
-        *((PDWORD) DestBits) = (DWORD)XLATEOBJ_iXlate(BltInfo->XlateSourceToDest, xColor);
-        DEC_OR_INC(SourceBits, bLeftToRight, 2);
-        DestBits += 4;
+        pfnXlateRow((PEXLATEOBJ)BltInfo->XlateSourceToDest, DestBits, SourceBits, DestWidth);
+      }
+      else
+      {
+        for (i = BltInfo->DestRect.left; i < BltInfo->DestRect.right; i++)
+        {
+          xColor = *((PWORD) SourceBits);
+          *((PDWORD) DestBits) = (DWORD)XLATEOBJ_iXlate(BltInfo->XlateSourceToDest, xColor);
+          DEC_OR_INC(SourceBits, bLeftToRight, 2);
+          DestBits += 4;
+        }
       }
 
       DEC_OR_INC(SourceLine, bTopToBottom, BltInfo->SourceSurface->lDelta);
@@ -429,6 +452,9 @@ DIB_32BPP_BitBltSrcCopy(PBLTINFO BltInfo)
 
       if (!bTopToBottom && !bLeftToRight)
       {
+        /* Rows of the same surface only overlap going left, which translates front to back */
+        pfnXlateRow = EXLATEOBJ_pfnXlateRow(BltInfo->XlateSourceToDest, BMF_32BPP, BMF_32BPP);
+
         if (BltInfo->DestRect.top < BltInfo->SourcePoint.y)
         {
           SourceBits = ((PBYTE)BltInfo->SourceSurface->pvScan0
@@ -436,7 +462,13 @@ DIB_32BPP_BitBltSrcCopy(PBLTINFO BltInfo)
             + 4 * BltInfo->SourcePoint.x);
           for (j = BltInfo->DestRect.top; j < BltInfo->DestRect.bottom; j++)
           {
-            if (BltInfo->DestRect.left < BltInfo->SourcePoint.x)
+            if (pfnXlateRow &&
+                (BltInfo->DestRect.left < BltInfo->SourcePoint.x ||
+                 BltInfo->SourceSurface->pvScan0 != BltInfo->DestSurface->pvScan0))
+            {
+              pfnXlateRow((PEXLATEOBJ)BltInfo->XlateSourceToDest, DestBits, SourceBits, DestWidth);
+            }
+            else if (BltInfo->DestRect.left < BltInfo->SourcePoint.x)
             {
               Dest32 = (DWORD *) DestBits;
               Source32 = (DWORD *) SourceBits;
@@ -469,7 +501,13 @@ DIB_32BPP_BitBltSrcCopy(PBLTINFO BltInfo)
             + 4 * BltInfo->DestRect.left;
           for (j = BltInfo->DestRect.bottom - 1; BltInfo->DestRect.top <= j; j--)
           {
-            if (BltInfo->DestRect.left < BltInfo->SourcePoint.x)
+            if (pfnXlateRow &&
+                (BltInfo->DestRect.left < BltInfo->SourcePoint.x ||
+                 BltInfo->SourceSurface->pvScan0 != BltInfo->DestSurface->pvScan0))
+            {
+              pfnXlateRow((PEXLATEOBJ)BltInfo->XlateSourceToDest, DestBits, SourceBits, DestWidth);
+            }
+            else if (BltInfo->DestRect.left < BltInfo->SourcePoint.x)
             {
               Dest32 = (DWORD *) DestBits;
               Source32 = (DWORD *) SourceBits;
@@ -759,6 +797,40 @@ Clamp8(ULONG val)
   return (val > 255) ? 255 : (UCHAR)val;
 }
 
+static VOID
+DIB_32BPP_AlphaBlendRows(SURFOBJ* Dest, SURFOBJ* Source, RECTL* DestRect,
+                         RECTL* SourceRect, BLENDFUNCTION BlendFunc)
+{
+  ULONG SrcBuffer[64];
+  PULONG Dst, Src;
+  INT Rows, Cols, SrcY, Chunk;
+  INT DstWidth = DestRect->right - DestRect->left;
+  INT SrcWidth = SourceRect->right - SourceRect->left;
+  BOOLEAN SrcAlpha = (BlendFunc.AlphaFormat & AC_SRC_ALPHA) != 0;
+
+  for (Rows = 0; Rows < DestRect->bottom - DestRect->top; Rows++)
+  {
+    /* Same source lines and columns as the per pixel loop below */
+    SrcY = SourceRect->top + (Rows*(SourceRect->bottom - SourceRect->top))/(DestRect->bottom - DestRect->top);
+    Dst = (PULONG)((ULONG_PTR)Dest->pvScan0 + ((DestRect->top + Rows) * Dest->lDelta)) + DestRect->left;
+    Src = (PULONG)((ULONG_PTR)Source->pvScan0 + (SrcY * Source->lDelta)) + SourceRect->left;
+
+    if (SrcWidth == DstWidth)
+    {
+      DIB_32BPP_AlphaBlendRow(Dst, Src, DstWidth, BlendFunc.SourceConstantAlpha, SrcAlpha);
+      continue;
+    }
+
+    /* Stretch the source a piece at a time, then blend it */
+    for (Cols = 0; Cols < DstWidth; Cols += Chunk)
+    {
+      Chunk = min(DstWidth - Cols, (INT)ARRAYSIZE(SrcBuffer));
+      DIB_32BPP_StretchRow(SrcBuffer, Src, 1, Chunk, Cols, SrcWidth, DstWidth);
+      DIB_32BPP_AlphaBlendRow(Dst + Cols, SrcBuffer, Chunk, BlendFunc.SourceConstantAlpha, SrcAlpha);
+    }
+  }
+}
+
 BOOLEAN
 DIB_32BPP_AlphaBlend(SURFOBJ* Dest, SURFOBJ* Source, RECTL* DestRect,
                      RECTL* SourceRect, CLIPOBJ* ClipRegion,
@@ -797,6 +869,16 @@ DIB_32BPP_AlphaBlend(SURFOBJ* Dest, SURFOBJ* Source, RECTL* DestRect,
     return FALSE;
   }
 
+  /* Without color translation between two 32bpp surfaces, blend whole rows */
+  if (Source->iBitmapFormat == BMF_32BPP &&
+      Source->pvScan0 != Dest->pvScan0 &&
+      SourceRect->right >= SourceRect->left &&
+      (ColorTranslation == NULL || (ColorTranslation->flXlate & XO_TRIVIAL)))
+  {
+    DIB_32BPP_AlphaBlendRows(Dest, Source, DestRect, SourceRect, BlendFunc);
+    return TRUE;
+  }
+
   Dst = (PULONG)((ULONG_PTR)Dest->pvScan0 + (DestRect->top * Dest->lDelta) +
     (DestRect->left << 2));
   SrcBpp = BitsPerFormat(Source->iBitmapFormat);
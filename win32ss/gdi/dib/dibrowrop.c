@@ -0,0 +1,126 @@
+/*
+ * PROJECT:     ReactOS Win32k subsystem
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Row functions for the ROPs that only combine bits
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <win32k.h>
+
+/*
+ * With no color translation and a solid brush, these ROPs work on whole
+ * rows of raw pixels instead of one pixel at a time. They are used by the
+ * generated DIB_xBPP_BitBlt functions through DIB_RowBitBlt, and by DibLib.
+ * amd64 uses SSE2, which it always has. win32k does not save the extended
+ * (AVX) state, so there is no AVX2 version, and x86 would have to save the
+ * FPU state for SSE2, so it does a ULONG at a time.
+ */
+
+#if defined(_M_AMD64)
+#include <emmintrin.h>
+#define _ROWROP_SSE2 1
+#define _Not128(x) _mm_xor_si128((x), _mm_set1_epi32(-1))
+#else
+#define _ROWROP_SSE2 0
+#endif
+
+#define _RowPaste_(s1,s2) s1##s2
+#define _RowPaste(s1,s2) _RowPaste_(s1,s2)
+
+#define __ROWROP NOTSRCCOPY
+#define __USES_SOURCE 1
+#define __USES_DEST 0
+#define __USES_PATTERN 0
+#define _RowDoRop(D,S,P) (~(S))
+#define _RowDoRop128(D,S,P) _Not128(S)
+#include "dibrowrop.h"
+
+#define __ROWROP SRCAND
+#define __USES_SOURCE 1
+#define __USES_DEST 1
+#define __USES_PATTERN 0
+#define _RowDoRop(D,S,P) ((D) & (S))
+#define _RowDoRop128(D,S,P) _mm_and_si128(D, S)
+#include "dibrowrop.h"
+
+#define __ROWROP SRCPAINT
+#define __USES_SOURCE 1
+#define __USES_DEST 1
+#define __USES_PATTERN 0
+#define _RowDoRop(D,S,P) ((D) | (S))
+#define _RowDoRop128(D,S,P) _mm_or_si128(D, S)
+#include "dibrowrop.h"
+
+#define __ROWROP SRCINVERT
+#define __USES_SOURCE 1
+#define __USES_DEST 1
+#define __USES_PATTERN 0
+#define _RowDoRop(D,S,P) ((D) ^ (S))
+#define _RowDoRop128(D,S,P) _mm_xor_si128(D, S)
+#include "dibrowrop.h"
+
+#define __ROWROP SRCERASE
+#define __USES_SOURCE 1
+#define __USES_DEST 1
+#define __USES_PATTERN 0
+#define _RowDoRop(D,S,P) (~(D) & (S))
+#define _RowDoRop128(D,S,P) _mm_andnot_si128(D, S)
+#include "dibrowrop.h"
+
+#define __ROWROP NOTSRCERASE
+#define __USES_SOURCE 1
+#define __USES_DEST 1
+#define __USES_PATTERN 0
+#define _RowDoRop(D,S,P) (~((D) | (S)))
+#define _RowDoRop128(D,S,P) _Not128(_mm_or_si128(D, S))
+#include "dibrowrop.h"
+
+#define __ROWROP MERGEPAINT
+#define __USES_SOURCE 1
+#define __USES_DEST 1
+#define __USES_PATTERN 0
+#define _RowDoRop(D,S,P) ((D) | ~(S))
+#define _RowDoRop128(D,S,P) _mm_or_si128(D, _Not128(S))
+#include "dibrowrop.h"
+
+#define __ROWROP PATCOPY
+#define __USES_SOURCE 0
+#define __USES_DEST 0
+#define __USES_PATTERN 1
+#define _RowDoRop(D,S,P) (P)
+#define _RowDoRop128(D,S,P) (P)
+#include "dibrowrop.h"
+
+#define __ROWROP PATINVERT
+#define __USES_SOURCE 0
+#define __USES_DEST 1
+#define __USES_PATTERN 1
+#define _RowDoRop(D,S,P) ((D) ^ (P))
+#define _RowDoRop128(D,S,P) _mm_xor_si128(D, P)
+#include "dibrowrop.h"
+
+#define __ROWROP DSTINVERT
+#define __USES_SOURCE 0
+#define __USES_DEST 1
+#define __USES_PATTERN 0
+#define _RowDoRop(D,S,P) (~(D))
+#define _RowDoRop128(D,S,P) _Not128(D)
+#include "dibrowrop.h"
+
+#define __ROWROP MERGECOPY
+#define __USES_SOURCE 1
+#define __USES_DEST 0
+#define __USES_PATTERN 1
+#define _RowDoRop(D,S,P) ((S) & (P))
+#define _RowDoRop128(D,S,P) _mm_and_si128(P, S)
+#include "dibrowrop.h"
+
+#define __ROWROP PATPAINT
+#define __USES_SOURCE 1
+#define __USES_DEST 1
+#define __USES_PATTERN 1
+#define _RowDoRop(D,S,P) ((D) | ~(S) | (P))
+#define _RowDoRop128(D,S,P) _mm_or_si128(D, _mm_or_si128(P, _Not128(S)))
+#include "dibrowrop.h"
+
+/* EOF */
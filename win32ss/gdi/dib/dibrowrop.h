@@ -0,0 +1,111 @@
+
+/*
+ * Row function template, see dibrowrop.c
+ *
+ * __ROWROP:                name of the ROP, gives Dib_RowRop_<__ROWROP>
+ * __USES_XXX:              whether the ROP reads the dest, source and pattern
+ * _RowDoRop(D,S,P):        the ROP on ULONG_PTRs
+ * _RowDoRop128(D,S,P):     the ROP on __m128is, with _ROWROP_SSE2
+ */
+
+#if __USES_DEST
+#define _RowLoadD(type, pj) (*(type UNALIGNED *)(pj))
+#define _RowLoadD128(i) _mm_loadu_si128((__m128i*)pjDest + (i))
+#else
+#define _RowLoadD(type, pj) 0
+#define _RowLoadD128(i) _mm_setzero_si128()
+#endif
+
+#if __USES_SOURCE
+#define _RowLoadS(type, pj) (*(type UNALIGNED *)(pj))
+#define _RowLoadS128(i) _mm_loadu_si128((__m128i*)pjSource + (i))
+#else
+#define _RowLoadS(type, pj) 0
+#define _RowLoadS128(i) _mm_setzero_si128()
+#endif
+
+#if __USES_PATTERN
+#define _RowPattern(type) ((type)ulpPattern)
+#define _RowPattern128 xmmPattern
+#else
+#define _RowPattern(type) 0
+#define _RowPattern128 _mm_setzero_si128()
+#endif
+
+/* Each piece is read before it is written, so the source may start right of the dest */
+#define _RowStep(type) \
+    (void)(*(type UNALIGNED *)pjDest = (type)_RowDoRop(_RowLoadD(type, pjDest), \
+                                                       _RowLoadS(type, pjSource), \
+                                                       _RowPattern(type)), \
+           pjDest += sizeof(type), pjSource += sizeof(type))
+
+#define _RowStep128(i) \
+    _mm_storeu_si128((__m128i*)pjDest + (i), \
+                     _RowDoRop128(_RowLoadD128(i), _RowLoadS128(i), _RowPattern128))
+
+VOID
+FASTCALL
+_RowPaste(Dib_RowRop_, __ROWROP)(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern)
+{
+    PBYTE pjEnd = pjDest + cjRow;
+#if __USES_PATTERN
+    ULONG_PTR ulpPattern = ulPattern;
+#if _ROWROP_SSE2
+    __m128i xmmPattern = _mm_set1_epi32(ulPattern);
+#endif
+#else
+    UNREFERENCED_PARAMETER(ulPattern);
+#endif
+
+#if _ROWROP_SSE2
+
+    /* 64 bytes per iteration */
+    while (pjEnd - pjDest >= 64)
+    {
+        _RowStep128(0);
+        _RowStep128(1);
+        _RowStep128(2);
+        _RowStep128(3);
+        pjDest += 64;
+        pjSource += 64;
+    }
+
+    while (pjEnd - pjDest >= 16)
+    {
+        _RowStep128(0);
+        pjDest += 16;
+        pjSource += 16;
+    }
+#endif
+
+#if __USES_PATTERN && defined(_WIN64)
+    ulpPattern |= ulpPattern << 32;
+#endif
+
+    /* The rest, the pattern is aligned to the row, so it stays in phase */
+    while (pjEnd - pjDest >= (LONG_PTR)sizeof(ULONG_PTR))
+        _RowStep(ULONG_PTR);
+#ifdef _WIN64
+    if (pjEnd - pjDest >= 4)
+        _RowStep(ULONG);
+#endif
+    if (pjEnd - pjDest >= 2)
+        _RowStep(USHORT);
+    if (pjEnd - pjDest >= 1)
+        _RowStep(UCHAR);
+}
+
+#undef _RowLoadD
+#undef _RowLoadD128
+#undef _RowLoadS
+#undef _RowLoadS128
+#undef _RowStep
+#undef _RowStep128
+#undef _RowPattern
+#undef _RowPattern128
+#undef __ROWROP
+#undef _RowDoRop
+#undef _RowDoRop128
+#undef __USES_SOURCE
+#undef __USES_DEST
+#undef __USES_PATTERN
@@ -14,6 +14,64 @@
 #define NDEBUG
 #include <debug.h>
 
+/*
+ * SRCCOPY between two 32bpp surfaces that needs no color translation, with
+ * the same source pixels as the generic loop below. The source must lie
+ * within its surface.
+ */
+static VOID
+DIB_32BPP_StretchSrcCopy(SURFOBJ *DestSurf, SURFOBJ *SourceSurf,
+                         RECTL *DestRect, RECTL *SourceRect,
+                         BOOLEAN bTopToBottom, BOOLEAN bLeftToRight)
+{
+  LONG DesY, sy, PrevSy = -1;
+  PULONG Dst, Src, PrevDst = NULL;
+  LONG DstHeight = DestRect->bottom - DestRect->top;
+  LONG DstWidth = DestRect->right - DestRect->left;
+  LONG SrcHeight = SourceRect->bottom - SourceRect->top;
+  LONG SrcWidth = SourceRect->right - SourceRect->left;
+
+  for (DesY = DestRect->top; DesY < DestRect->bottom; DesY++)
+  {
+    if (bTopToBottom)
+    {
+      sy = SourceRect->bottom - (DesY - DestRect->top) * SrcHeight / DstHeight;
+    }
+    else
+    {
+      sy = SourceRect->top + (DesY - DestRect->top) * SrcHeight / DstHeight;
+    }
+
+    Dst = (PULONG)((ULONG_PTR)DestSurf->pvScan0 + DesY * DestSurf->lDelta) + DestRect->left;
+
+    if (sy == PrevSy)
+    {
+      /* Stretched lines repeat the one above */
+      RtlCopyMemory(Dst, PrevDst, DstWidth * sizeof(ULONG));
+    }
+    else
+    {
+      Src = (PULONG)((ULONG_PTR)SourceSurf->pvScan0 + sy * SourceSurf->lDelta);
+
+      if (!bLeftToRight && SrcWidth == DstWidth)
+      {
+        RtlCopyMemory(Dst, Src + SourceRect->left, DstWidth * sizeof(ULONG));
+      }
+      else if (bLeftToRight)
+      {
+        DIB_32BPP_StretchRow(Dst, Src + SourceRect->right, -1, DstWidth, 0, SrcWidth, DstWidth);
+      }
+      else
+      {
+        DIB_32BPP_StretchRow(Dst, Src + SourceRect->left, 1, DstWidth, 0, SrcWidth, DstWidth);
+      }
+    }
+
+    PrevSy = sy;
+    PrevDst = Dst;
+  }
+}
+
 BOOLEAN DIB_XXBPP_StretchBlt(SURFOBJ *DestSurf, SURFOBJ *SourceSurf, SURFOBJ *MaskSurf,
                             SURFOBJ *PatternSurface,
                             RECTL *DestRect, RECTL *SourceRect,
@@ -97,6 +155,22 @@ BOOLEAN DIB_XXBPP_StretchBlt(SURFOBJ *DestSurf, SURFOBJ *SourceSurf, SURFOBJ *Ma
   SrcHeight = SourceRect->bottom - SourceRect->top;
   SrcWidth = SourceRect->right - SourceRect->left;
 
+  /* The flipped loops also read the right and bottom edges of the source */
+  if (ROP == ROP4_SRCCOPY && !MaskSurf &&
+      DestSurf->iBitmapFormat == BMF_32BPP &&
+      SourceSurf->iBitmapFormat == BMF_32BPP &&
+      DestSurf->pvScan0 != SourceSurf->pvScan0 &&
+      (ColorTranslation == NULL || (ColorTranslation->flXlate & XO_TRIVIAL)) &&
+      DstWidth > 0 && SrcWidth > 0 && SrcHeight > 0 &&
+      SourceRect->left >= 0 && SourceRect->top >= 0 &&
+      SourceRect->right + bLeftToRight <= SourceSurf->sizlBitmap.cx &&
+      SourceRect->bottom + bTopToBottom <= SourceCy)
+  {
+    DIB_32BPP_StretchSrcCopy(DestSurf, SourceSurf, DestRect, SourceRect,
+                             bTopToBottom, bLeftToRight);
+    return TRUE;
+  }
+
   /* FIXME: MaskOrigin? */
 
   switch(DestSurf->iBitmapFormat)
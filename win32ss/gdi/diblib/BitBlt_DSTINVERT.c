@@ -15,6 +15,9 @@ VOID
 FASTCALL
 Dib_BitBlt_DSTINVERT(PBLTDATA pBltData)
 {
+    if (Dib_RowBitBlt(pBltData, Dib_RowRop_DSTINVERT, FALSE))
+        return;
+
     gapfnBitBlt_DSTINVERT[pBltData->siDst.iFormat](pBltData);
 }
 
@@ -23,6 +23,9 @@ Dib_BitBlt_MERGECOPY(PBLTDATA pBltData)
     /* Check for solid brush */
     if (pBltData->ulSolidColor != 0xFFFFFFFF)
     {
+        if (Dib_RowBitBlt(pBltData, Dib_RowRop_MERGECOPY, TRUE))
+            return;
+
         /* Use the solid version of PATCOPY! */
         gapfnBitBlt_MERGECOPY_Solid[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
     }
@@ -16,7 +16,9 @@ VOID
 FASTCALL
 Dib_BitBlt_MERGEPAINT(PBLTDATA pBltData)
 {
-    // TODO: XLATEless same-surface variants
+    if (Dib_RowBitBlt(pBltData, Dib_RowRop_MERGEPAINT, TRUE))
+        return;
+
     gapfnBitBlt_MERGEPAINT[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
 }
 
@@ -16,7 +16,9 @@ VOID
 FASTCALL
 Dib_BitBlt_NOTSRCCOPY(PBLTDATA pBltData)
 {
-    // TODO: XLATEless same-surface variants
+    if (Dib_RowBitBlt(pBltData, Dib_RowRop_NOTSRCCOPY, TRUE))
+        return;
+
     gapfnBitBlt_NOTSRCCOPY[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
 }
 
@@ -16,7 +16,9 @@ VOID
 FASTCALL
 Dib_BitBlt_NOTSRCERASE(PBLTDATA pBltData)
 {
-    // TODO: XLATEless same-surface variants
+    if (Dib_RowBitBlt(pBltData, Dib_RowRop_NOTSRCERASE, TRUE))
+        return;
+
     gapfnBitBlt_NOTSRCERASE[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
 }
 
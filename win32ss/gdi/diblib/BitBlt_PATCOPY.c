@@ -17,6 +17,17 @@
 #define __USES_SOLID_BRUSH 1
 #include "DibLib_AllDstBPP.h"
 
+/* Fills with ulSolidColor, whatever its value */
+VOID
+FASTCALL
+Dib_BitBlt_SOLIDFILL(PBLTDATA pBltData)
+{
+    if (Dib_RowBitBlt(pBltData, Dib_RowRop_PATCOPY, FALSE))
+        return;
+
+    gapfnBitBlt_PATCOPY_Solid[pBltData->siDst.iFormat](pBltData);
+}
+
 VOID
 FASTCALL
 Dib_BitBlt_PATCOPY(PBLTDATA pBltData)
@@ -25,7 +36,7 @@ Dib_BitBlt_PATCOPY(PBLTDATA pBltData)
     if (pBltData->ulSolidColor != 0xFFFFFFFF)
     {
         /* Use the solid version of PATCOPY! */
-        gapfnBitBlt_PATCOPY_Solid[pBltData->siDst.iFormat](pBltData);
+        Dib_BitBlt_SOLIDFILL(pBltData);
     }
     else
     {
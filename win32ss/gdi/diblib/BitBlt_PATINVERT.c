@@ -24,6 +24,9 @@ Dib_BitBlt_PATINVERT(PBLTDATA pBltData)
     /* Check for solid brush */
     if (pBltData->ulSolidColor != 0xFFFFFFFF)
     {
+        if (Dib_RowBitBlt(pBltData, Dib_RowRop_PATINVERT, FALSE))
+            return;
+
         /* Use the solid version of PATCOPY! */
         gapfnBitBlt_PATINVERT_Solid[pBltData->siDst.iFormat](pBltData);
     }
@@ -24,6 +24,9 @@ Dib_BitBlt_PATPAINT(PBLTDATA pBltData)
     /* Check for solid brush */
     if (pBltData->ulSolidColor != 0xFFFFFFFF)
     {
+        if (Dib_RowBitBlt(pBltData, Dib_RowRop_PATPAINT, TRUE))
+            return;
+
         /* Use the solid version of PATCOPY! */
         gapfnBitBlt_PATPAINT_Solid[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
     }
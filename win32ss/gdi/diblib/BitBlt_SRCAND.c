@@ -16,7 +16,9 @@ VOID
 FASTCALL
 Dib_BitBlt_SRCAND(PBLTDATA pBltData)
 {
-    // TODO: XLATEless same-surface variants
+    if (Dib_RowBitBlt(pBltData, Dib_RowRop_SRCAND, TRUE))
+        return;
+
     gapfnBitBlt_SRCAND[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
 }
 
@@ -65,10 +65,42 @@ Dib_BitBlt_SRCCOPY_S32_D32_EqSurf(PBLTDATA pBltData)
 
 #include "DibLib_AllSrcBPP.h"
 
+static
+VOID
+FASTCALL
+Dib_BitBlt_SRCCOPY_XlateRows(PBLTDATA pBltData)
+{
+    ULONG cLines;
+    PBYTE pjDestBase = pBltData->siDst.pjBase;
+    PBYTE pjSrcBase = pBltData->siSrc.pjBase;
+
+    /* Loop all lines */
+    cLines = pBltData->ulHeight;
+    while (cLines--)
+    {
+        pBltData->pfnXlateRow(pBltData->pxlo, pjDestBase, pjSrcBase, pBltData->ulWidth);
+        pjDestBase += pBltData->siDst.cjAdvanceY;
+        pjSrcBase += pBltData->siSrc.cjAdvanceY;
+    }
+}
+
 VOID
 FASTCALL
 Dib_BitBlt_SRCCOPY(PBLTDATA pBltData)
 {
-    gapfnBitBlt_SRCCOPY[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
+    ULONG iSrcFormat = pBltData->siSrc.iFormat;
+
+    /* Translate whole rows, if there is a function for the formats */
+    if (pBltData->pfnXlateRow)
+    {
+        Dib_BitBlt_SRCCOPY_XlateRows(pBltData);
+        return;
+    }
+
+    /* Without color translation, a copy from the same format is a plain copy */
+    if (iSrcFormat == pBltData->siDst.iFormat && (pBltData->pxlo->flXlate & XO_TRIVIAL))
+        iSrcFormat = 0;
+
+    gapfnBitBlt_SRCCOPY[pBltData->siDst.iFormat][iSrcFormat](pBltData);
 }
 
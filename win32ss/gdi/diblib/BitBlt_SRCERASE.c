@@ -16,7 +16,9 @@ VOID
 FASTCALL
 Dib_BitBlt_SRCERASE(PBLTDATA pBltData)
 {
-    // TODO: XLATEless same-surface variants
+    if (Dib_RowBitBlt(pBltData, Dib_RowRop_SRCERASE, TRUE))
+        return;
+
     gapfnBitBlt_SRCERASE[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
 }
 
@@ -16,7 +16,9 @@ VOID
 FASTCALL
 Dib_BitBlt_SRCINVERT(PBLTDATA pBltData)
 {
-    // TODO: XLATEless same-surface variants
+    if (Dib_RowBitBlt(pBltData, Dib_RowRop_SRCINVERT, TRUE))
+        return;
+
     gapfnBitBlt_SRCINVERT[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
 }
 
@@ -16,7 +16,9 @@ VOID
 FASTCALL
 Dib_BitBlt_SRCPAINT(PBLTDATA pBltData)
 {
-    // TODO: XLATEless same-surface variants
+    if (Dib_RowBitBlt(pBltData, Dib_RowRop_SRCPAINT, TRUE))
+        return;
+
     gapfnBitBlt_SRCPAINT[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
 }
 
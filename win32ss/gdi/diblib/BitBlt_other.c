@@ -1,15 +1,13 @@
 
 #include "DibLib.h"
 
-extern PFN_DIBFUNCTION gapfnBitBlt_PATCOPY_Solid[];
-
 VOID
 FASTCALL
 Dib_BitBlt_BLACKNESS(PBLTDATA pBltData)
 {
     /* Pass it to the colorfil function */
     pBltData->ulSolidColor = XLATEOBJ_iXlate(pBltData->pxlo, 0);
-    gapfnBitBlt_PATCOPY_Solid[pBltData->siDst.iFormat](pBltData);
+    Dib_BitBlt_SOLIDFILL(pBltData);
 }
 
 VOID
@@ -18,7 +16,7 @@ Dib_BitBlt_WHITENESS(PBLTDATA pBltData)
 {
     /* Pass it to the colorfil function */
     pBltData->ulSolidColor = XLATEOBJ_iXlate(pBltData->pxlo, 0xFFFFFF);
-    gapfnBitBlt_PATCOPY_Solid[pBltData->siDst.iFormat](pBltData);
+    Dib_BitBlt_SOLIDFILL(pBltData);
 }
 
 VOID
@@ -22,6 +22,10 @@ typedef
 ULONG
 (FASTCALL *PFN_XLATE)(XLATEOBJ* pxlo, ULONG ulColor);
 
+typedef
+VOID
+(FASTCALL *PFN_XLATEROW)(XLATEOBJ* pxlo, PVOID pvDst, PVOID pvSrc, ULONG cPixels);
+
 extern const BYTE ajShift4[2];
 
 #include "DibLib_interface.h"
@@ -82,3 +86,23 @@ extern const BYTE ajShift4[2];
 #define _SHIFT_32(x)
 #define _CALCSHIFT_32(pShift, x)
 
+
+typedef
+VOID
+(FASTCALL
+*PFN_DIBROWROP)(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+
+VOID FASTCALL Dib_RowRop_NOTSRCCOPY(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_SRCAND(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_SRCPAINT(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_SRCINVERT(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_SRCERASE(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_NOTSRCERASE(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_MERGEPAINT(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_PATCOPY(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_PATINVERT(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_DSTINVERT(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_MERGECOPY(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+VOID FASTCALL Dib_RowRop_PATPAINT(PBYTE pjDest, PBYTE pjSource, ULONG cjRow, ULONG ulPattern);
+
+BOOL FASTCALL Dib_RowBitBlt(PBLTDATA pBltData, PFN_DIBROWROP pfnRowRop, BOOL bUsesSource);
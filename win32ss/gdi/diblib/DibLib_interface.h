@@ -25,6 +25,7 @@ typedef struct
     ULONG ulPatHeight;
     XLATEOBJ *pxlo;
     PFN_XLATE pfnXlate;
+    PFN_XLATEROW pfnXlateRow;
     ULONG rop4;
     PFN_DOROP apfnDoRop[2];
     ULONG ulSolidColor;
@@ -0,0 +1,73 @@
+
+#include "DibLib.h"
+
+/*
+ * The row functions themselves are in win32ss/gdi/dib/dibrowrop.c, the
+ * generated DIB_xBPP_BitBlt functions use them as well.
+ */
+
+/*
+ * Does the blt with pfnRowRop if the pixels can be combined as raw bits:
+ * an 8, 16 or 32 bpp destination, and a source of the same format without
+ * color translation, or the same surface copied left to right. The caller
+ * checks that the brush is solid. Returns FALSE if the generic functions
+ * have to do it.
+ */
+BOOL
+FASTCALL
+Dib_RowBitBlt(PBLTDATA pBltData, PFN_DIBROWROP pfnRowRop, BOOL bUsesSource)
+{
+    ULONG cLines, cjRow, ulPattern;
+    PBYTE pjDestBase, pjSrcBase;
+    LONG cjSrcAdvanceY;
+
+    /* Replicate the brush color to 32 bits, 0 is the right to left version */
+    switch (pBltData->siDst.iFormat)
+    {
+        case BMF_8BPP:
+            ulPattern = (pBltData->ulSolidColor & 0xFF) * 0x01010101;
+            break;
+        case BMF_16BPP:
+            ulPattern = (pBltData->ulSolidColor & 0xFFFF) * 0x00010001;
+            break;
+        case BMF_32BPP:
+            ulPattern = pBltData->ulSolidColor;
+            break;
+        default:
+            return FALSE;
+    }
+
+    pjDestBase = pBltData->siDst.pjBase;
+    if (bUsesSource)
+    {
+        /* Source format 0 is the same surface, the xlate is ignored there as well */
+        if (pBltData->siSrc.iFormat != 0 &&
+            (pBltData->siSrc.iFormat != pBltData->siDst.iFormat ||
+             !(pBltData->pxlo->flXlate & XO_TRIVIAL)))
+        {
+            return FALSE;
+        }
+
+        pjSrcBase = pBltData->siSrc.pjBase;
+        cjSrcAdvanceY = pBltData->siSrc.cjAdvanceY;
+    }
+    else
+    {
+        /* Row functions without a source just walk along the dest */
+        pjSrcBase = pjDestBase;
+        cjSrcAdvanceY = pBltData->siDst.cjAdvanceY;
+    }
+
+    cjRow = pBltData->ulWidth * pBltData->siDst.jBpp / 8;
+
+    /* Loop all lines */
+    cLines = pBltData->ulHeight;
+    while (cLines--)
+    {
+        pfnRowRop(pjDestBase, pjSrcBase, cjRow, ulPattern);
+        pjDestBase += pBltData->siDst.cjAdvanceY;
+        pjSrcBase += cjSrcAdvanceY;
+    }
+
+    return TRUE;
+}
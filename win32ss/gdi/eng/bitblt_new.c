@@ -141,6 +141,7 @@ EngBitBlt(
     if (!pxlo) pxlo = &gexloTrivial.xlo;
     bltdata.pxlo = pxlo;
     bltdata.pfnXlate = XLATEOBJ_pfnXlate(pxlo);
+    bltdata.pfnXlateRow = NULL;
 
     /* Check if the ROP uses a source */
     if (ROP4_USES_SOURCE(rop4))
@@ -189,6 +190,14 @@ EngBitBlt(
             bltdata.siSrc.iFormat = psoSrc->iBitmapFormat;
         }
 
+        /* Different surfaces can be translated a row at a time */
+        if (bltdata.siSrc.iFormat != 0 && bltdata.siDst.iFormat != 0)
+        {
+            bltdata.pfnXlateRow = EXLATEOBJ_pfnXlateRow(pxlo,
+                                                        bltdata.siSrc.iFormat,
+                                                        bltdata.siDst.iFormat);
+        }
+
         /* Set the source format info */
         bltdata.siSrc.pvScan0 = psoSrc->pvScan0;
         bltdata.siSrc.lDelta = psoSrc->lDelta;
@@ -16,6 +16,15 @@ ULONG
     _In_ struct _EXLATEOBJ *pexlo,
     _In_ ULONG iColor);
 
+_Function_class_(FN_XLATEROW)
+typedef
+VOID
+(FASTCALL *PFN_XLATEROW)(
+    _In_ struct _EXLATEOBJ *pexlo,
+    _Out_ PVOID pvDst,
+    _In_ PVOID pvSrc,
+    _In_ ULONG cPixels);
+
 typedef struct _EXLATEOBJ
 {
     XLATEOBJ xlo;
@@ -44,6 +53,8 @@ typedef struct _EXLATEOBJ
 } EXLATEOBJ, *PEXLATEOBJ;
 
 extern EXLATEOBJ gexloTrivial;
+extern const BYTE gajXlate5to8[32];
+extern const BYTE gajXlate6to8[64];
 
 _Notnull_
 FORCEINLINE
@@ -84,3 +95,28 @@ NTAPI
 EXLATEOBJ_vCleanup(
     _Inout_ PEXLATEOBJ pexlo);
 
+/* The iXlate functions that EXLATEOBJ_pfnXlateRow has row versions of */
+#define DECLARE_IXLATE(name) \
+    _Function_class_(FN_XLATE) ULONG FASTCALL name(_In_ PEXLATEOBJ pexlo, _In_ ULONG iColor)
+
+DECLARE_IXLATE(EXLATEOBJ_iXlateTable);
+DECLARE_IXLATE(EXLATEOBJ_iXlateRGBtoBGR);
+DECLARE_IXLATE(EXLATEOBJ_iXlateRGBto555);
+DECLARE_IXLATE(EXLATEOBJ_iXlateBGRto555);
+DECLARE_IXLATE(EXLATEOBJ_iXlateRGBto565);
+DECLARE_IXLATE(EXLATEOBJ_iXlateBGRto565);
+DECLARE_IXLATE(EXLATEOBJ_iXlate555toRGB);
+DECLARE_IXLATE(EXLATEOBJ_iXlate555toBGR);
+DECLARE_IXLATE(EXLATEOBJ_iXlate555to565);
+DECLARE_IXLATE(EXLATEOBJ_iXlate565to555);
+DECLARE_IXLATE(EXLATEOBJ_iXlate565toRGB);
+DECLARE_IXLATE(EXLATEOBJ_iXlate565toBGR);
+DECLARE_IXLATE(EXLATEOBJ_iXlateShiftAndMask);
+#undef DECLARE_IXLATE
+
+PFN_XLATEROW
+FASTCALL
+EXLATEOBJ_pfnXlateRow(
+    _In_opt_ XLATEOBJ *pxlo,
+    _In_ ULONG iSrcFormat,
+    _In_ ULONG iDstFormat);
@@ -0,0 +1,352 @@
+/*
+ * PROJECT:     ReactOS Win32k subsystem
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Color translation of whole rows of pixels
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#include <win32k.h>
+
+/*
+ * The blt functions translate every pixel through pfnXlate. For the common
+ * pairs of 8, 16 and 32bpp formats, these convert a row of packed pixels
+ * at once instead, with the same results as the iXlate functions in
+ * xlateobj.c. Palettes are a table lookup, everything else that reads 32bpp
+ * pixels is a shift and mask, done 4 pixels at a time with SSE2 on amd64.
+ */
+
+#if defined(_M_AMD64)
+#include <emmintrin.h>
+#endif
+
+/** Globals *******************************************************************/
+
+const BYTE gajXlate5to8[32] =
+{  0,  8, 16, 25, 33, 41, 49, 58, 66, 74, 82, 90, 99,107,115,123,
+ 132,140,148,156,165,173,181,189,197,206,214,222,231,239,247,255};
+
+const BYTE gajXlate6to8[64] =
+{ 0,  4,  8, 12, 16, 20, 24, 28, 32, 36, 40, 45, 49, 52, 57, 61,
+ 65, 69, 73, 77, 81, 85, 89, 93, 97,101,105,109,113,117,121,125,
+130,134,138,142,146,150,154,158,162,166,170,174,178,182,186,190,
+194,198,202,207,210,215,219,223,227,231,235,239,243,247,251,255};
+
+/*
+ * The fixed conversions from 32bpp as shift and mask operations, laid out
+ * like EXLATEOBJ::aulXlate: the red, green and blue masks of the dest, then
+ * how far each is rotated left.
+ */
+static const ULONG gaulXlateRGBtoBGR[6] = {0xFF00FF00, 0x00FF0000, 0x000000FF, 0, 16, 16};
+static const ULONG gaulXlateRGBto555[6] = {0x7C00, 0x03E0, 0x001F, 7, 26, 13};
+static const ULONG gaulXlateRGBto565[6] = {0xF800, 0x07E0, 0x001F, 8, 27, 13};
+static const ULONG gaulXlateBGRto555[6] = {0x7C00, 0x03E0, 0x001F, 23, 26, 29};
+static const ULONG gaulXlateBGRto565[6] = {0xF800, 0x07E0, 0x001F, 24, 27, 29};
+
+/** Row functions *************************************************************/
+
+FORCEINLINE
+VOID
+XlateRowTable(
+    _In_ PEXLATEOBJ pexlo,
+    _Out_ PVOID pvDst,
+    _In_ PVOID pvSrc,
+    _In_ ULONG cPixels,
+    _In_ ULONG cjDstPixel)
+{
+    PBYTE pjSrc = pvSrc, pjDst = pvDst;
+    PULONG pulXlate = pexlo->xlo.pulXlate;
+    ULONG iColor;
+
+    /* With a full table, every index is in it */
+    if (pexlo->xlo.cEntries >= 256)
+    {
+        while (cPixels--)
+        {
+            iColor = pulXlate[*pjSrc++];
+            if (cjDstPixel == 4) *(ULONG UNALIGNED *)pjDst = iColor;
+            else if (cjDstPixel == 2) *(USHORT UNALIGNED *)pjDst = (USHORT)iColor;
+            else *pjDst = (BYTE)iColor;
+            pjDst += cjDstPixel;
+        }
+        return;
+    }
+
+    while (cPixels--)
+    {
+        iColor = *pjSrc++;
+        iColor = (iColor < pexlo->xlo.cEntries) ? pulXlate[iColor] : 0;
+        if (cjDstPixel == 4) *(ULONG UNALIGNED *)pjDst = iColor;
+        else if (cjDstPixel == 2) *(USHORT UNALIGNED *)pjDst = (USHORT)iColor;
+        else *pjDst = (BYTE)iColor;
+        pjDst += cjDstPixel;
+    }
+}
+
+FORCEINLINE
+ULONG
+XlateShiftAndMask(
+    _In_ const ULONG *pulMasksAndShifts,
+    _In_ ULONG iColor)
+{
+    return (_rotl(iColor, pulMasksAndShifts[3]) & pulMasksAndShifts[0]) |
+           (_rotl(iColor, pulMasksAndShifts[4]) & pulMasksAndShifts[1]) |
+           (_rotl(iColor, pulMasksAndShifts[5]) & pulMasksAndShifts[2]);
+}
+
+#if defined(_M_AMD64)
+FORCEINLINE
+__m128i
+XlateShiftAndMask4(
+    _In_ __m128i xmmColor,
+    _In_ const __m128i *pxmmMasks,
+    _In_ const __m128i *pxmmShifts)
+{
+    __m128i xmmResult = _mm_setzero_si128();
+    ULONG i;
+
+    /* Rotate by shifting both ways, a shift by 32 gives 0 */
+    for (i = 0; i < 3; i++)
+    {
+        xmmResult = _mm_or_si128(xmmResult,
+            _mm_and_si128(_mm_or_si128(_mm_sll_epi32(xmmColor, pxmmShifts[2 * i]),
+                                       _mm_srl_epi32(xmmColor, pxmmShifts[2 * i + 1])),
+                          pxmmMasks[i]));
+    }
+
+    return xmmResult;
+}
+#endif
+
+/* 32bpp pixels to 16 or 32bpp ones */
+FORCEINLINE
+VOID
+XlateRowShiftAndMask32(
+    _In_ const ULONG *pulMasksAndShifts,
+    _Out_ PVOID pvDst,
+    _In_ PVOID pvSrc,
+    _In_ ULONG cPixels,
+    _In_ ULONG cjDstPixel)
+{
+    ULONG UNALIGNED *pulSrc = pvSrc;
+    PBYTE pjDst = pvDst;
+    ULONG iColor;
+
+#if defined(_M_AMD64)
+    __m128i axmmMasks[3], axmmShifts[6], xmmLow, xmmHigh;
+    ULONG i;
+
+    for (i = 0; i < 3; i++)
+    {
+        axmmMasks[i] = _mm_set1_epi32(pulMasksAndShifts[i]);
+        axmmShifts[2 * i] = _mm_cvtsi32_si128(pulMasksAndShifts[3 + i] & 31);
+        axmmShifts[2 * i + 1] = _mm_cvtsi32_si128(32 - (pulMasksAndShifts[3 + i] & 31));
+    }
+
+    if (cjDstPixel == 4)
+    {
+        for (; cPixels >= 4; cPixels -= 4, pulSrc += 4, pjDst += 16)
+        {
+            xmmLow = XlateShiftAndMask4(_mm_loadu_si128((__m128i*)pulSrc), axmmMasks, axmmShifts);
+            _mm_storeu_si128((__m128i*)pjDst, xmmLow);
+        }
+    }
+    else
+    {
+        for (; cPixels >= 8; cPixels -= 8, pulSrc += 8, pjDst += 16)
+        {
+            xmmLow = XlateShiftAndMask4(_mm_loadu_si128((__m128i*)pulSrc), axmmMasks, axmmShifts);
+            xmmHigh = XlateShiftAndMask4(_mm_loadu_si128((__m128i*)pulSrc + 1), axmmMasks, axmmShifts);
+
+            /* Sign extend the low words, so that the signed pack keeps them as they are */
+            xmmLow = _mm_srai_epi32(_mm_slli_epi32(xmmLow, 16), 16);
+            xmmHigh = _mm_srai_epi32(_mm_slli_epi32(xmmHigh, 16), 16);
+            _mm_storeu_si128((__m128i*)pjDst, _mm_packs_epi32(xmmLow, xmmHigh));
+        }
+    }
+#endif
+
+    while (cPixels--)
+    {
+        iColor = XlateShiftAndMask(pulMasksAndShifts, *pulSrc++);
+        if (cjDstPixel == 4) *(ULONG UNALIGNED *)pjDst = iColor;
+        else *(USHORT UNALIGNED *)pjDst = (USHORT)iColor;
+        pjDst += cjDstPixel;
+    }
+}
+
+/* 16bpp pixels to 16 or 32bpp ones */
+FORCEINLINE
+VOID
+XlateRowShiftAndMask16(
+    _In_ const ULONG *pulMasksAndShifts,
+    _Out_ PVOID pvDst,
+    _In_ PVOID pvSrc,
+    _In_ ULONG cPixels,
+    _In_ ULONG cjDstPixel)
+{
+    USHORT UNALIGNED *pusSrc = pvSrc;
+    PBYTE pjDst = pvDst;
+    ULONG iColor;
+
+    while (cPixels--)
+    {
+        iColor = XlateShiftAndMask(pulMasksAndShifts, *pusSrc++);
+        if (cjDstPixel == 4) *(ULONG UNALIGNED *)pjDst = iColor;
+        else *(USHORT UNALIGNED *)pjDst = (USHORT)iColor;
+        pjDst += cjDstPixel;
+    }
+}
+
+/* 555 or 565 pixels to RGB or BGR ones, with the rounding of the tables */
+FORCEINLINE
+VOID
+XlateRow16to32(
+    _Out_ PVOID pvDst,
+    _In_ PVOID pvSrc,
+    _In_ ULONG cPixels,
+    _In_ BOOLEAN b565,
+    _In_ BOOLEAN bBGR)
+{
+    USHORT UNALIGNED *pusSrc = pvSrc;
+    ULONG UNALIGNED *pulDst = pvDst;
+    ULONG iColor, iRed, iGreen, iBlue;
+
+    while (cPixels--)
+    {
+        iColor = *pusSrc++;
+        iBlue = gajXlate5to8[iColor & 0x1F];
+        if (b565)
+        {
+            iGreen = gajXlate6to8[(iColor >> 5) & 0x3F];
+            iRed = gajXlate5to8[(iColor >> 11) & 0x1F];
+        }
+        else
+        {
+            iGreen = gajXlate5to8[(iColor >> 5) & 0x1F];
+            iRed = gajXlate5to8[(iColor >> 10) & 0x1F];
+        }
+
+        *pulDst++ = bBGR ? (iRed << 16) | (iGreen << 8) | iBlue :
+                           (iBlue << 16) | (iGreen << 8) | iRed;
+    }
+}
+
+/* 555 pixels to 565 ones and back */
+FORCEINLINE
+VOID
+XlateRow16to16(
+    _Out_ PVOID pvDst,
+    _In_ PVOID pvSrc,
+    _In_ ULONG cPixels,
+    _In_ BOOLEAN b555to565)
+{
+    USHORT UNALIGNED *pusSrc = pvSrc;
+    USHORT UNALIGNED *pusDst = pvDst;
+    ULONG iColor;
+
+    while (cPixels--)
+    {
+        iColor = *pusSrc++;
+        if (b555to565)
+        {
+            /* Duplicate the highest green bit */
+            iColor = (iColor & 0x1F) | ((iColor << 1) & 0xFFC0) | ((iColor >> 4) & 0x20);
+        }
+        else
+        {
+            iColor = (iColor & 0x1F) | ((iColor >> 1) & 0x7FE0);
+        }
+
+        *pusDst++ = (USHORT)iColor;
+    }
+}
+
+#define DEFINE_XLATE_ROW(name, body) \
+    static VOID FASTCALL name(PEXLATEOBJ pexlo, PVOID pvDst, PVOID pvSrc, ULONG cPixels) \
+    { \
+        UNREFERENCED_PARAMETER(pexlo); \
+        body; \
+    }
+
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowTable8to8, XlateRowTable(pexlo, pvDst, pvSrc, cPixels, 1))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowTable8to16, XlateRowTable(pexlo, pvDst, pvSrc, cPixels, 2))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowTable8to32, XlateRowTable(pexlo, pvDst, pvSrc, cPixels, 4))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowShiftAndMask32to32, XlateRowShiftAndMask32(pexlo->aulXlate, pvDst, pvSrc, cPixels, 4))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowShiftAndMask32to16, XlateRowShiftAndMask32(pexlo->aulXlate, pvDst, pvSrc, cPixels, 2))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowShiftAndMask16to32, XlateRowShiftAndMask16(pexlo->aulXlate, pvDst, pvSrc, cPixels, 4))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowShiftAndMask16to16, XlateRowShiftAndMask16(pexlo->aulXlate, pvDst, pvSrc, cPixels, 2))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowRGBtoBGR, XlateRowShiftAndMask32(gaulXlateRGBtoBGR, pvDst, pvSrc, cPixels, 4))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowRGBto555, XlateRowShiftAndMask32(gaulXlateRGBto555, pvDst, pvSrc, cPixels, 2))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowRGBto565, XlateRowShiftAndMask32(gaulXlateRGBto565, pvDst, pvSrc, cPixels, 2))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowBGRto555, XlateRowShiftAndMask32(gaulXlateBGRto555, pvDst, pvSrc, cPixels, 2))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRowBGRto565, XlateRowShiftAndMask32(gaulXlateBGRto565, pvDst, pvSrc, cPixels, 2))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRow555toRGB, XlateRow16to32(pvDst, pvSrc, cPixels, FALSE, FALSE))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRow555toBGR, XlateRow16to32(pvDst, pvSrc, cPixels, FALSE, TRUE))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRow565toRGB, XlateRow16to32(pvDst, pvSrc, cPixels, TRUE, FALSE))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRow565toBGR, XlateRow16to32(pvDst, pvSrc, cPixels, TRUE, TRUE))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRow555to565, XlateRow16to16(pvDst, pvSrc, cPixels, TRUE))
+DEFINE_XLATE_ROW(EXLATEOBJ_vXlateRow565to555, XlateRow16to16(pvDst, pvSrc, cPixels, FALSE))
+
+static const struct
+{
+    PFN_XLATE pfnXlate;
+    ULONG iSrcFormat;
+    ULONG iDstFormat;
+    PFN_XLATEROW pfnXlateRow;
+} gaXlateRowFunctions[] =
+{
+    {EXLATEOBJ_iXlateTable, BMF_8BPP, BMF_8BPP, EXLATEOBJ_vXlateRowTable8to8},
+    {EXLATEOBJ_iXlateTable, BMF_8BPP, BMF_16BPP, EXLATEOBJ_vXlateRowTable8to16},
+    {EXLATEOBJ_iXlateTable, BMF_8BPP, BMF_32BPP, EXLATEOBJ_vXlateRowTable8to32},
+    {EXLATEOBJ_iXlateShiftAndMask, BMF_32BPP, BMF_32BPP, EXLATEOBJ_vXlateRowShiftAndMask32to32},
+    {EXLATEOBJ_iXlateShiftAndMask, BMF_32BPP, BMF_16BPP, EXLATEOBJ_vXlateRowShiftAndMask32to16},
+    {EXLATEOBJ_iXlateShiftAndMask, BMF_16BPP, BMF_32BPP, EXLATEOBJ_vXlateRowShiftAndMask16to32},
+    {EXLATEOBJ_iXlateShiftAndMask, BMF_16BPP, BMF_16BPP, EXLATEOBJ_vXlateRowShiftAndMask16to16},
+    {EXLATEOBJ_iXlateRGBtoBGR, BMF_32BPP, BMF_32BPP, EXLATEOBJ_vXlateRowRGBtoBGR},
+    {EXLATEOBJ_iXlateRGBto555, BMF_32BPP, BMF_16BPP, EXLATEOBJ_vXlateRowRGBto555},
+    {EXLATEOBJ_iXlateRGBto565, BMF_32BPP, BMF_16BPP, EXLATEOBJ_vXlateRowRGBto565},
+    {EXLATEOBJ_iXlateBGRto555, BMF_32BPP, BMF_16BPP, EXLATEOBJ_vXlateRowBGRto555},
+    {EXLATEOBJ_iXlateBGRto565, BMF_32BPP, BMF_16BPP, EXLATEOBJ_vXlateRowBGRto565},
+    {EXLATEOBJ_iXlate555toRGB, BMF_16BPP, BMF_32BPP, EXLATEOBJ_vXlateRow555toRGB},
+    {EXLATEOBJ_iXlate555toBGR, BMF_16BPP, BMF_32BPP, EXLATEOBJ_vXlateRow555toBGR},
+    {EXLATEOBJ_iXlate565toRGB, BMF_16BPP, BMF_32BPP, EXLATEOBJ_vXlateRow565toRGB},
+    {EXLATEOBJ_iXlate565toBGR, BMF_16BPP, BMF_32BPP, EXLATEOBJ_vXlateRow565toBGR},
+    {EXLATEOBJ_iXlate555to565, BMF_16BPP, BMF_16BPP, EXLATEOBJ_vXlateRow555to565},
+    {EXLATEOBJ_iXlate565to555, BMF_16BPP, BMF_16BPP, EXLATEOBJ_vXlateRow565to555},
+};
+
+/** Private Functions *********************************************************/
+
+/*
+ * Returns the function that translates rows of iSrcFormat pixels to
+ * iDstFormat ones with pxlo, or NULL if there is none and every pixel has
+ * to go through XLATEOBJ_iXlate. A trivial xlate has none either, the
+ * callers copy those.
+ */
+PFN_XLATEROW
+FASTCALL
+EXLATEOBJ_pfnXlateRow(
+    _In_opt_ XLATEOBJ *pxlo,
+    _In_ ULONG iSrcFormat,
+    _In_ ULONG iDstFormat)
+{
+    PEXLATEOBJ pexlo = (PEXLATEOBJ)pxlo;
+    ULONG i;
+
+    if (!pxlo)
+        return NULL;
+
+    for (i = 0; i < ARRAYSIZE(gaXlateRowFunctions); i++)
+    {
+        if (gaXlateRowFunctions[i].pfnXlate == pexlo->pfnXlate &&
+            gaXlateRowFunctions[i].iSrcFormat == iSrcFormat &&
+            gaXlateRowFunctions[i].iDstFormat == iDstFormat)
+        {
+            return gaXlateRowFunctions[i].pfnXlateRow;
+        }
+    }
+
+    return NULL;
+}
+
+/* EOF */
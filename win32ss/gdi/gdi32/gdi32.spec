@@ -609,6 +609,9 @@
 609 stdcall cGetTTFFromFOT(long long long long long long long)
 610 stdcall gdiPlaySpoolStream(long long long long long long)
 
+; ReactOS extensions
+@ stdcall GdiQueryBatchStatistics(ptr)
+
 ; ReactOS Display Driver Model
 @ stdcall -version=0x600+ D3DKMTCheckExclusiveOwnership() NtGdiDdDDICheckExclusiveOwnership
 @ stdcall -version=0x600+ D3DKMTCheckMonitorPowerState(ptr) NtGdiDdDDICheckMonitorPowerState
@@ -86,6 +86,7 @@ extern LPKGTEP LpkGetTextExtentExPoint;
 /* MACRO ********************************************************************/
 
 #define ROP_USES_SOURCE(Rop)   (((Rop) << 2 ^ Rop) & 0xCC0000)
+#define ROP_USES_PATTERN(Rop)  (((Rop) >> 4 ^ Rop) & 0x0F0000)
 #define RCAST(_Type, _Value)   (*((_Type*)&_Value))
 
 
@@ -174,6 +175,11 @@ typedef struct _LOCALFONT
     FONT_ATTR  lfa[LOCALFONT_COUNT];
 } LOCALFONT, *PLOCALFONT;
 
+/* Counters of the drawing calls that can go through the TEB batch,
+   see GdiQueryBatchStatistics */
+extern GDI_BATCH_STATISTICS GdiBatchStatistics;
+#define GDI_BATCH_COUNT(Counter) InterlockedIncrement(&GdiBatchStatistics.Counter)
+
 // sdk/winspool.h
 typedef BOOL (WINAPI *ABORTPRINTER) (HANDLE);
 typedef BOOL (WINAPI *CLOSEPRINTER) (HANDLE);
@@ -428,6 +434,8 @@ GdiAllocBatchCommand(
     else if (Cmd == GdiBCSelObj) cjSize = sizeof(GDIBSOBJECT);
     else if (Cmd == GdiBCDelRgn) cjSize = sizeof(GDIBSOBJECT);
     else if (Cmd == GdiBCDelObj) cjSize = sizeof(GDIBSOBJECT);
+    else if (Cmd == GdiBCBitBlt) cjSize = sizeof(GDIBSSTRETCHBLT);
+    else if (Cmd == GdiBCStretchBlt) cjSize = sizeof(GDIBSSTRETCHBLT);
     else cjSize = 0;
 
     /* Unsupported operation */
@@ -472,6 +480,63 @@ GdiAllocBatchCommand(
     return pHdr;
 }
 
+/* Returns the last command of the batch, if the batch is for this DC */
+FORCEINLINE
+PGDIBATCHHDR
+GdiGetLastBatchCommand(
+    HDC hdc)
+{
+    PTEB pTeb;
+    PGDIBATCHHDR pHdr;
+    ULONG i;
+
+    /* Get a pointer to the TEB */
+    pTeb = NtCurrentTeb();
+
+    /* Nothing to merge with, if the batch is empty or for another DC */
+    if ((pTeb->GdiBatchCount == 0) || (pTeb->GdiTebBatch.HDC != hdc)) return NULL;
+
+    /* The commands only know their own size, so walk to the last one */
+    pHdr = (PGDIBATCHHDR)pTeb->GdiTebBatch.Buffer;
+    for (i = 1; i < pTeb->GdiBatchCount; i++)
+    {
+        pHdr = (PVOID)((PUCHAR)pHdr + pHdr->Size);
+    }
+
+    return pHdr;
+}
+
+/* Returns the DC other than hdc that blts in the batch read from, if the
+   batch is for hdc. win32k locks that DC together with the batch DC. */
+FORCEINLINE
+HDC
+GdiGetBatchSourceDc(
+    HDC hdc)
+{
+    PTEB pTeb;
+    PGDIBATCHHDR pHdr;
+    ULONG i;
+
+    /* Get a pointer to the TEB */
+    pTeb = NtCurrentTeb();
+
+    if (pTeb->GdiTebBatch.HDC != hdc) return NULL;
+
+    pHdr = (PGDIBATCHHDR)pTeb->GdiTebBatch.Buffer;
+    for (i = 0; i < pTeb->GdiBatchCount; i++)
+    {
+        if (((pHdr->Cmd == GdiBCBitBlt) || (pHdr->Cmd == GdiBCStretchBlt)) &&
+            (((PGDIBSSTRETCHBLT)pHdr)->hdcSrc != hdc))
+        {
+            return ((PGDIBSSTRETCHBLT)pHdr)->hdcSrc;
+        }
+
+        pHdr = (PVOID)((PUCHAR)pHdr + pHdr->Size);
+    }
+
+    return NULL;
+}
+
 FORCEINLINE
 PDC_ATTR
 GdiGetDcAttr(HDC hdc)
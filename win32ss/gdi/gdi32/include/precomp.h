@@ -51,13 +51,14 @@
 #include <ntgdi.h>
 #include <ntgdihdl.h>
 
+#include <undocgdi.h>
+
 /* Private GDI32 Header */
 #include "gdi32p.h"
 
 /* Deprecated NTGDI calls which shouldn't exist */
 #include <ntgdibad.h>
 
-#include <undocgdi.h>
 #include <ntintsafe.h>
 
 #endif /* _GDI32_PCH_ */
@@ -4,6 +4,9 @@
 
 #include <precomp.h>
 
+#define NDEBUG
+#include <debug.h>
+
 static BOOL gbInitialized = FALSE;
 extern HGDIOBJ stock_objects[];
 BOOL SetStockObjects = FALSE;
@@ -66,6 +69,13 @@ VOID
 WINAPI
 GdiProcessShutdown(VOID)
 {
+#if DBG
+    DPRINT1("Batchable calls: %ld batched, %ld coalesced, %ld immediate\n",
+            GdiBatchStatistics.cBatched,
+            GdiBatchStatistics.cCoalesced,
+            GdiBatchStatistics.cImmediate);
+#endif
+
     DeleteCriticalSection(&gcsClientObjLinks);
     RtlDeleteCriticalSection(&semLocal);
 }
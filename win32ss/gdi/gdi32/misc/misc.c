@@ -34,6 +34,7 @@ PGDI_TABLE_ENTRY GdiHandleTable = NULL;
 PGDI_SHARED_HANDLE_TABLE GdiSharedHandleTable = NULL;
 HANDLE CurrentProcessId = NULL;
 DWORD GDI_BatchLimit = 1;
+GDI_BATCH_STATISTICS GdiBatchStatistics;
 extern PGDIHANDLECACHE GdiHandleCache;
 
 /*
@@ -864,6 +865,27 @@ GdiGetBatchLimit(VOID)
     return GDI_BatchLimit;
 }
 
+/*
+ * Returns how many of the process' batchable drawing calls were queued,
+ * merged into the last batch command or sent to win32k directly.
+ */
+BOOL
+WINAPI
+GdiQueryBatchStatistics(
+    _Out_ PGDI_BATCH_STATISTICS pStatistics)
+{
+    if (!pStatistics)
+    {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+
+    pStatistics->cBatched = GdiBatchStatistics.cBatched;
+    pStatistics->cCoalesced = GdiBatchStatistics.cCoalesced;
+    pStatistics->cImmediate = GdiBatchStatistics.cImmediate;
+    return TRUE;
+}
+
 
 /*
  * @implemented
@@ -439,6 +439,195 @@ FloodFill(
     return ExtFloodFill(hdc, xStart, yStart, crFill, FLOODFILLBORDER);
 }
 
+/*
+ * Queues a BitBlt or StretchBlt in the TEB batch, when it needs no brush.
+ * The blts of a batch may read from one DC other than the batch DC, which
+ * win32k locks together with the batch DC when it flushes. Changing that
+ * DC through win32k flushes the batch first, but the attributes set here in
+ * user mode do not, so the batch keeps a snapshot of the ones the blt uses.
+ * Neither DC may have a DIB section selected, since the app may access those
+ * bits directly without calling into GDI.
+ */
+static
+BOOL
+GdiBatchStretchBlt(
+    _In_ USHORT Cmd,
+    _In_ HDC hdcDest,
+    _In_ INT xDest,
+    _In_ INT yDest,
+    _In_ INT cxDest,
+    _In_ INT cyDest,
+    _In_opt_ HDC hdcSrc,
+    _In_ INT xSrc,
+    _In_ INT ySrc,
+    _In_ INT cxSrc,
+    _In_ INT cySrc,
+    _In_ DWORD dwRop)
+{
+    PDC_ATTR pdcattr, pdcattrSrc;
+    PGDIBSSTRETCHBLT pgO;
+    HDC hdcBatchSrc;
+
+    if (ROP_USES_PATTERN(dwRop) ||
+        (GDI_HANDLE_GET_TYPE(hdcSrc) != GDILoObjType_LO_DC_TYPE))
+    {
+        return FALSE;
+    }
+
+    /* Get the DC attributes */
+    pdcattr = GdiGetDcAttr(hdcDest);
+    pdcattrSrc = GdiGetDcAttr(hdcSrc);
+    if (!pdcattr || (pdcattr->ulDirty_ & DC_DIBSECTION) ||
+        !pdcattrSrc || (pdcattrSrc->ulDirty_ & DC_DIBSECTION))
+    {
+        return FALSE;
+    }
+
+    if (hdcSrc != hdcDest)
+    {
+        /* The snapshot does not cover the mirroring of the source */
+        if (pdcattrSrc->dwLayout & LAYOUT_RTL) return FALSE;
+
+        /* Only one DC other than the batch DC per batch */
+        hdcBatchSrc = GdiGetBatchSourceDc(hdcDest);
+        if (hdcBatchSrc && (hdcBatchSrc != hdcSrc)) return FALSE;
+    }
+
+    pgO = GdiAllocBatchCommand(hdcDest, Cmd);
+    if (!pgO) return FALSE;
+
+    pdcattr->ulDirty_ |= DC_MODE_DIRTY;
+    pgO->xDest  = xDest;
+    pgO->yDest  = yDest;
+    pgO->cxDest = cxDest;
+    pgO->cyDest = cyDest;
+    pgO->hdcSrc = hdcSrc;
+    pgO->xSrc   = xSrc;
+    pgO->ySrc   = ySrc;
+    pgO->cxSrc  = cxSrc;
+    pgO->cySrc  = cySrc;
+    pgO->dwRop  = dwRop;
+    /* Snapshot attributes */
+    pgO->crForegroundClr = pdcattr->crForegroundClr;
+    pgO->crBackgroundClr = pdcattr->crBackgroundClr;
+    pgO->crSrcBackgroundClr = pdcattrSrc->crBackgroundClr;
+    pgO->ptlSrcWindowOrg = pdcattrSrc->ptlWindowOrg;
+    pgO->szlSrcWindowExt = pdcattrSrc->szlWindowExt;
+    pgO->ptlSrcViewportOrg = pdcattrSrc->ptlViewportOrg;
+    pgO->szlSrcViewportExt = pdcattrSrc->szlViewportExt;
+    return TRUE;
+}
+
+/*
+ * Merges a PatBlt into the last command of the batch, when that is a PatBlt
+ * or PolyPatBlt on the same DC with the same rop and colors. The result is
+ * a PolyPatBlt, which carries the brush of each rectangle. Rows of FillRect
+ * calls take a single batch command this way, and more of them fit in the
+ * batch before it is flushed.
+ */
+static
+BOOL
+GdiCoalescePatBlt(
+    _In_ HDC hdc,
+    _In_ PDC_ATTR pdcattr,
+    _In_ INT nXLeft,
+    _In_ INT nYLeft,
+    _In_ INT nWidth,
+    _In_ INT nHeight,
+    _In_ DWORD dwRop)
+{
+    PTEB pTeb = NtCurrentTeb();
+    PGDIBATCHHDR pHdr;
+    PGDIBSPPATBLT pgO;
+    GDIBSPATBLT gPatBlt;
+    PPATRECT pRect;
+
+    /* A batch limit of one asks for every call to be flushed on its own */
+    if (GDI_BatchLimit <= 1) return FALSE;
+
+    pHdr = GdiGetLastBatchCommand(hdc);
+    if (!pHdr) return FALSE;
+
+    if (pHdr->Cmd == GdiBCPatBlt)
+    {
+        gPatBlt = *(PGDIBSPATBLT)pHdr;
+        if ((gPatBlt.dwRop != dwRop) ||
+            (gPatBlt.crForegroundClr != pdcattr->crForegroundClr) ||
+            (gPatBlt.crBackgroundClr != pdcattr->crBackgroundClr) ||
+            (gPatBlt.crBrushClr != pdcattr->crBrushClr) ||
+            (gPatBlt.ulForegroundClr != pdcattr->ulForegroundClr) ||
+            (gPatBlt.ulBackgroundClr != pdcattr->ulBackgroundClr) ||
+            (gPatBlt.ulBrushClr != pdcattr->ulBrushClr))
+        {
+            return FALSE;
+        }
+
+        /* Room for the PolyPatBlt with the two rectangles in place of the PatBlt? */
+        if ((pTeb->GdiTebBatch.Offset - sizeof(GDIBSPATBLT) +
+             sizeof(GDIBSPPATBLT) + sizeof(PATRECT)) > GDIBATCHBUFSIZE)
+        {
+            return FALSE;
+        }
+
+        /* Rewrite the PatBlt as a PolyPatBlt of its rectangle */
+        pgO = (PGDIBSPPATBLT)pHdr;
+        pgO->gbHdr.Cmd = GdiBCPolyPatBlt;
+        pgO->gbHdr.Size = sizeof(GDIBSPPATBLT);
+        pgO->rop4  = gPatBlt.dwRop;
+        pgO->Mode  = 0;
+        pgO->Count = 1;
+        pgO->crForegroundClr = gPatBlt.crForegroundClr;
+        pgO->crBackgroundClr = gPatBlt.crBackgroundClr;
+        pgO->crBrushClr      = gPatBlt.crBrushClr;
+        pgO->ulForegroundClr = gPatBlt.ulForegroundClr;
+        pgO->ulBackgroundClr = gPatBlt.ulBackgroundClr;
+        pgO->ulBrushClr      = gPatBlt.ulBrushClr;
+        pgO->ptlViewportOrg  = gPatBlt.ptlViewportOrg;
+        pgO->pRect[0].r.left   = gPatBlt.nXLeft;
+        pgO->pRect[0].r.top    = gPatBlt.nYLeft;
+        pgO->pRect[0].r.right  = gPatBlt.nWidth;
+        pgO->pRect[0].r.bottom = gPatBlt.nHeight;
+        pgO->pRect[0].hBrush   = gPatBlt.hbrush;
+        pTeb->GdiTebBatch.Offset += sizeof(GDIBSPPATBLT) - sizeof(GDIBSPATBLT);
+    }
+    else if (pHdr->Cmd == GdiBCPolyPatBlt)
+    {
+        pgO = (PGDIBSPPATBLT)pHdr;
+        if ((pgO->rop4 != dwRop) ||
+            (pgO->crForegroundClr != pdcattr->crForegroundClr) ||
+            (pgO->crBackgroundClr != pdcattr->crBackgroundClr) ||
+            (pgO->crBrushClr != pdcattr->crBrushClr) ||
+            (pgO->ulForegroundClr != pdcattr->ulForegroundClr) ||
+            (pgO->ulBackgroundClr != pdcattr->ulBackgroundClr) ||
+            (pgO->ulBrushClr != pdcattr->ulBrushClr))
+        {
+            return FALSE;
+        }
+
+        if ((pTeb->GdiTebBatch.Offset + sizeof(PATRECT)) > GDIBATCHBUFSIZE)
+        {
+            return FALSE;
+        }
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    /* Append the rectangle with the current brush */
+    pRect = &pgO->pRect[pgO->Count++];
+    pRect->r.left   = nXLeft;
+    pRect->r.top    = nYLeft;
+    pRect->r.right  = nWidth;
+    pRect->r.bottom = nHeight;
+    pRect->hBrush   = pdcattr->hbrush;
+    pgO->gbHdr.Size += sizeof(PATRECT);
+    pTeb->GdiTebBatch.Offset += sizeof(PATRECT);
+
+    pdcattr->ulDirty_ |= DC_MODE_DIRTY;
+    return TRUE;
+}
+
 /*
  * @implemented
  */
@@ -477,6 +666,24 @@ BitBlt(
 
     if ( GdiConvertAndCheckDC(hdcDest) == NULL ) return FALSE;
 
+    if (GdiBatchStretchBlt(GdiBCBitBlt,
+                           hdcDest,
+                           xDest,
+                           yDest,
+                           cx,
+                           cy,
+                           hdcSrc,
+                           xSrc,
+                           ySrc,
+                           cx,
+                           cy,
+                           dwRop))
+    {
+        GDI_BATCH_COUNT(cBatched);
+        return TRUE;
+    }
+
+    GDI_BATCH_COUNT(cImmediate);
     return NtGdiBitBlt(hdcDest, xDest, yDest, cx, cy, hdcSrc, xSrc, ySrc, dwRop, 0, 0);
 }
 
@@ -502,6 +709,12 @@ PatBlt(
     {
         PGDIBSPATBLT pgO;
 
+        if (GdiCoalescePatBlt(hdc, pdcattr, nXLeft, nYLeft, nWidth, nHeight, dwRop))
+        {
+            GDI_BATCH_COUNT(cCoalesced);
+            return TRUE;
+        }
+
         pgO = GdiAllocBatchCommand(hdc, GdiBCPatBlt);
         if (pgO)
         {
@@ -519,9 +732,11 @@ PatBlt(
             pgO->ulForegroundClr = pdcattr->ulForegroundClr;
             pgO->ulBackgroundClr = pdcattr->ulBackgroundClr;
             pgO->ulBrushClr      = pdcattr->ulBrushClr;
+            GDI_BATCH_COUNT(cBatched);
             return TRUE;
         }
     }
+    GDI_BATCH_COUNT(cImmediate);
     return NtGdiPatBlt( hdc,  nXLeft,  nYLeft,  nWidth,  nHeight,  dwRop);
 }
 
@@ -605,6 +820,7 @@ PolyPatBlt(
                 // Recompute offset and return size, remember one is already accounted for in the structure.
                 pTeb->GdiTebBatch.Offset += cjSize;
                 ((PGDIBATCHHDR)pgO)->Size += cjSize;
+                GDI_BATCH_COUNT(cBatched);
                 return TRUE;
             }
             // Reset offset and count then fall through
@@ -612,6 +828,7 @@ PolyPatBlt(
             pTeb->GdiBatchCount--;
         }
     }
+    GDI_BATCH_COUNT(cImmediate);
     return NtGdiPolyPatBlt(hdc, dwRop, pPoly, nCount, dwMode);
 }
 
@@ -650,6 +867,24 @@ StretchBlt(
 
     if ( GdiConvertAndCheckDC(hdcDest) == NULL ) return FALSE;
 
+    if (GdiBatchStretchBlt(GdiBCStretchBlt,
+                           hdcDest,
+                           xDest,
+                           yDest,
+                           cxDest,
+                           cyDest,
+                           hdcSrc,
+                           xSrc,
+                           ySrc,
+                           cxSrc,
+                           cySrc,
+                           dwRop))
+    {
+        GDI_BATCH_COUNT(cBatched);
+        return TRUE;
+    }
+
+    GDI_BATCH_COUNT(cImmediate);
     return NtGdiStretchBlt(hdcDest,
                            xDest,
                            yDest,
@@ -567,6 +567,7 @@ ExtTextOutW(
                     /* Snapshot attribute */
                     pgO->ulBackgroundClr = pdcattr->ulBackgroundClr;
                     pgO->ptlViewportOrg  = pdcattr->ptlViewportOrg;
+                    GDI_BATCH_COUNT(cBatched);
                     return TRUE;
                 }
             }
@@ -634,6 +635,7 @@ ExtTextOutW(
                     // Recompute offset and return size
                     pTeb->GdiTebBatch.Offset += cjSize;
                     ((PGDIBATCHHDR)pgO)->Size += cjSize;
+                    GDI_BATCH_COUNT(cBatched);
                     return TRUE;
                 }
                 // Reset offset and count then fall through
@@ -642,6 +644,7 @@ ExtTextOutW(
             }
         }
     }
+    GDI_BATCH_COUNT(cImmediate);
     return NtGdiExtTextOutW(hdc,
                             x,
                             y,
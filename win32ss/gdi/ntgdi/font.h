@@ -1,6 +1,14 @@
 #pragma once
 
 
+struct _FONT_ENTRY;
+
+typedef struct _FONT_NAME_LINK
+{
+    LIST_ENTRY HashEntry;   /* In a g_FontNameHashTable bucket */
+    struct _FONT_ENTRY *FontEntry;
+} FONT_NAME_LINK, *PFONT_NAME_LINK;
+
 typedef struct _FONT_ENTRY
 {
     LIST_ENTRY ListEntry;
@@ -8,8 +16,26 @@ typedef struct _FONT_ENTRY
     UNICODE_STRING FaceName;
     UNICODE_STRING StyleName;
     BYTE NotEnum;
+    BOOLEAN Scored;         /* Already scored by the running FindBestFontFromList */
+    ULONG Sequence;         /* Insertion order, breaks ties between equal penalties */
+    PWSTR LocalFamilyName;  /* TT_NAME_ID_FONT_FAMILY in gusLanguageID, or NULL */
+    PWSTR LocalFullName;    /* TT_NAME_ID_FULL_NAME in gusLanguageID, or NULL */
+    FONT_NAME_LINK NameLinks[2]; /* Family and full name, only global fonts are indexed */
 } FONT_ENTRY, *PFONT_ENTRY;
 
+/* What GetFontStylePenalty() needs to know of a face, see IntGetFontStyle() */
+typedef struct _FONT_STYLE
+{
+    BYTE CharSet;
+    BYTE PitchAndFamily;
+    BYTE Italic;
+    BYTE Underlined;
+    BYTE StruckOut;
+    LONG Weight;
+    PCWSTR FamilyName;  /* NULL if unknown */
+    PCWSTR FullName;    /* NULL if unknown */
+} FONT_STYLE, *PFONT_STYLE;
+
 typedef struct _FONT_ENTRY_MEM
 {
     LIST_ENTRY ListEntry;
@@ -54,8 +80,11 @@ typedef struct _FONT_CACHE_HASHED
 
 typedef struct _FONT_CACHE_ENTRY
 {
-    LIST_ENTRY ListEntry;
+    LIST_ENTRY ListEntry;   /* In g_FontCacheListHead, most recently used first */
+    LIST_ENTRY HashEntry;   /* In the g_FontCacheHashTable bucket of dwHash */
     FT_BitmapGlyph BitmapGlyph;
+    SIZE_T cbSize;          /* Accounted against MAX_FONT_CACHE_BYTES */
+    ULONG HitCount;
     DWORD dwHash;
     FONT_CACHE_HASHED Hashed;
 } FONT_CACHE_ENTRY, *PFONT_CACHE_ENTRY;
@@ -63,6 +92,18 @@ typedef struct _FONT_CACHE_ENTRY
 C_ASSERT(FIELD_OFFSET(FONT_CACHE_ENTRY, Hashed) % sizeof(DWORD) == 0); /* for hashing */
 C_ASSERT(sizeof(FONT_CACHE_HASHED) % sizeof(DWORD) == 0); /* for hashing */
 
+/* A LOGFONTW (after substitution) and the font it was last realized with */
+typedef struct _FONT_MATCH_CACHE_ENTRY
+{
+    LIST_ENTRY ListEntry;   /* In g_FontMatchCacheListHead, most recently used first */
+    LIST_ENTRY HashEntry;   /* In the g_FontMatchHashTable bucket of dwHash */
+    DWORD dwHash;
+    LOGFONTW LogFont;       /* lfFaceName is zero-padded */
+    FONTOBJ *FontObj;
+} FONT_MATCH_CACHE_ENTRY, *PFONT_MATCH_CACHE_ENTRY;
+
+C_ASSERT(sizeof(LOGFONTW) % sizeof(DWORD) == 0); /* for hashing */
+
 /*
  * FONTSUBST_... --- constants for font substitutes
  */
@@ -90,5 +131,7 @@ typedef struct GDI_LOAD_FONT
     BOOL                IsTrueType;
     BYTE                CharSet;
     PFONT_ENTRY_MEM     PrivateEntry;
+    ULONG               FirstSequence;  /* Reserved by the font catalog, see IntLoadPendingFonts */
+    ULONG               SequenceCount;
 } GDI_LOAD_FONT, *PGDI_LOAD_FONT;
 
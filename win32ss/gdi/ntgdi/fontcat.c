@@ -0,0 +1,566 @@
+/*
+ * PROJECT:     ReactOS win32 kernel mode subsystem
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Persistent catalog of the registered font files
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+/*
+ * The catalog file starts with a FONT_CATALOG_HEADER followed by FileCount
+ * packed records:
+ *
+ *     name        file name
+ *     ULONG       dwFlags
+ *     LONGLONG    file size
+ *     LONGLONG    last write time
+ *     ULONG       EntryCount
+ *     EntryCount times:
+ *         BYTE    CharSet, PitchAndFamily, Italic, Underlined, StruckOut
+ *         LONG    Weight
+ *         name    family name, full name, English family name
+ *
+ * where a name is a USHORT count of WCHARs followed by the WCHARs, without
+ * the terminating NUL, or just FONT_CATALOG_NO_NAME. A catalog that does not
+ * parse, or was written for another language, is ignored and rebuilt.
+ */
+
+/** Includes ******************************************************************/
+
+#include <win32k.h>
+#include "fontcat.h"
+
+#define NDEBUG
+#include <debug.h>
+
+#define FONT_CATALOG_SIGNATURE  'TACF'  /* "FCAT" */
+#define FONT_CATALOG_VERSION    1       /* Bump when the faces are described differently */
+#define FONT_CATALOG_NO_NAME    0xFFFF
+#define FONT_CATALOG_MAX_SIZE   (16 * 1024 * 1024)
+#define FONT_CATALOG_MAX_ENTRIES 0x10000
+
+#include <pshpack1.h>
+typedef struct _FONT_CATALOG_HEADER
+{
+    ULONG Signature;
+    USHORT Version;
+    USHORT LanguageID;
+    ULONG FileCount;
+    ULONG DataSize;     /* Of the records following the header */
+    ULONG Checksum;     /* Of the records following the header */
+} FONT_CATALOG_HEADER, *PFONT_CATALOG_HEADER;
+#include <poppack.h>
+
+typedef struct _FONT_CATALOG_CURSOR
+{
+    PUCHAR Data;        /* NULL when only measuring */
+    ULONG Size;
+    ULONG Offset;
+} FONT_CATALOG_CURSOR, *PFONT_CATALOG_CURSOR;
+
+static const UNICODE_STRING g_FontCatalogPath =
+    RTL_CONSTANT_STRING(L"\\SystemRoot\\System32\\fontcat.dat");
+
+/* FNV-1a */
+static ULONG
+FontCatalog_Checksum(
+    _In_reads_bytes_(Size) const UCHAR *Data,
+    _In_ ULONG Size)
+{
+    ULONG Checksum = 0x811C9DC5;
+
+    while (Size-- > 0)
+    {
+        Checksum ^= *Data++;
+        Checksum *= 0x01000193;
+    }
+
+    return Checksum;
+}
+
+static BOOLEAN
+FontCatalog_Read(
+    _Inout_ PFONT_CATALOG_CURSOR Cursor,
+    _Out_writes_bytes_(Size) PVOID Buffer,
+    _In_ ULONG Size)
+{
+    if (Size > Cursor->Size - Cursor->Offset)
+        return FALSE;
+
+    RtlCopyMemory(Buffer, Cursor->Data + Cursor->Offset, Size);
+    Cursor->Offset += Size;
+    return TRUE;
+}
+
+static VOID
+FontCatalog_Write(
+    _Inout_ PFONT_CATALOG_CURSOR Cursor,
+    _In_reads_bytes_(Size) const VOID *Buffer,
+    _In_ ULONG Size)
+{
+    if (Cursor->Data)
+    {
+        ASSERT(Size <= Cursor->Size - Cursor->Offset);
+        RtlCopyMemory(Cursor->Data + Cursor->Offset, Buffer, Size);
+    }
+    Cursor->Offset += Size;
+}
+
+static BOOLEAN
+FontCatalog_ReadName(
+    _Inout_ PFONT_CATALOG_CURSOR Cursor,
+    _Out_ PWSTR *pName)
+{
+    USHORT Length;
+    PWSTR Name;
+
+    *pName = NULL;
+
+    if (!FontCatalog_Read(Cursor, &Length, sizeof(Length)))
+        return FALSE;
+    if (Length == FONT_CATALOG_NO_NAME)
+        return TRUE;
+
+    Name = ExAllocatePoolWithTag(PagedPool, (Length + 1) * sizeof(WCHAR), TAG_FONT_CATALOG);
+    if (!Name)
+        return FALSE;
+
+    if (!FontCatalog_Read(Cursor, Name, Length * sizeof(WCHAR)))
+    {
+        ExFreePoolWithTag(Name, TAG_FONT_CATALOG);
+        return FALSE;
+    }
+    Name[Length] = UNICODE_NULL;
+
+    *pName = Name;
+    return TRUE;
+}
+
+static VOID
+FontCatalog_WriteName(
+    _Inout_ PFONT_CATALOG_CURSOR Cursor,
+    _In_opt_ PCWSTR Name)
+{
+    SIZE_T Length = (Name ? wcslen(Name) : FONT_CATALOG_NO_NAME);
+    USHORT Count;
+
+    /* Names that do not fit are not worth remembering */
+    if (Length >= FONT_CATALOG_NO_NAME)
+        Length = FONT_CATALOG_NO_NAME;
+
+    Count = (USHORT)Length;
+    FontCatalog_Write(Cursor, &Count, sizeof(Count));
+    if (Count != FONT_CATALOG_NO_NAME)
+        FontCatalog_Write(Cursor, Name, Count * sizeof(WCHAR));
+}
+
+PWSTR
+FASTCALL
+FontCatalog_DuplicateName(
+    _In_opt_ PCWSTR Name)
+{
+    SIZE_T cbName;
+    PWSTR Copy;
+
+    if (!Name)
+        return NULL;
+
+    cbName = (wcslen(Name) + 1) * sizeof(WCHAR);
+    Copy = ExAllocatePoolWithTag(PagedPool, cbName, TAG_FONT_CATALOG);
+    if (Copy)
+        RtlCopyMemory(Copy, Name, cbName);
+
+    return Copy;
+}
+
+PFONT_CATALOG_FILE
+FASTCALL
+FontCatalog_AllocFile(
+    _In_ PCUNICODE_STRING FileName,
+    _In_ DWORD dwFlags,
+    _In_ ULONG EntryCount)
+{
+    PFONT_CATALOG_FILE File;
+    SIZE_T cbFile;
+
+    if (EntryCount == 0 || EntryCount > FONT_CATALOG_MAX_ENTRIES)
+        return NULL;
+
+    cbFile = FIELD_OFFSET(FONT_CATALOG_FILE, Entries) + EntryCount * sizeof(FONT_CATALOG_ENTRY);
+    File = ExAllocatePoolWithTag(PagedPool, cbFile, TAG_FONT_CATALOG);
+    if (!File)
+        return NULL;
+
+    RtlZeroMemory(File, cbFile);
+    File->dwFlags = dwFlags;
+    File->EntryCount = EntryCount;
+
+    File->FileName.Buffer = ExAllocatePoolWithTag(PagedPool,
+                                                  FileName->Length + sizeof(UNICODE_NULL),
+                                                  TAG_FONT_CATALOG);
+    if (!File->FileName.Buffer)
+    {
+        ExFreePoolWithTag(File, TAG_FONT_CATALOG);
+        return NULL;
+    }
+    File->FileName.MaximumLength = FileName->Length + sizeof(UNICODE_NULL);
+    RtlCopyUnicodeString(&File->FileName, FileName);
+
+    return File;
+}
+
+VOID
+FASTCALL
+FontCatalog_FreeFile(
+    _In_ PFONT_CATALOG_FILE File)
+{
+    PFONT_CATALOG_ENTRY Entry;
+    ULONG i;
+
+    for (i = 0; i < File->EntryCount; ++i)
+    {
+        Entry = &File->Entries[i];
+        if (Entry->FamilyName)
+            ExFreePoolWithTag(Entry->FamilyName, TAG_FONT_CATALOG);
+        if (Entry->FullName)
+            ExFreePoolWithTag(Entry->FullName, TAG_FONT_CATALOG);
+        if (Entry->EnglishFamilyName)
+            ExFreePoolWithTag(Entry->EnglishFamilyName, TAG_FONT_CATALOG);
+    }
+
+    ExFreePoolWithTag(File->FileName.Buffer, TAG_FONT_CATALOG);
+    ExFreePoolWithTag(File, TAG_FONT_CATALOG);
+}
+
+VOID
+FASTCALL
+FontCatalog_FreeList(
+    _Inout_ PLIST_ENTRY ListHead)
+{
+    PLIST_ENTRY Entry;
+
+    while (!IsListEmpty(ListHead))
+    {
+        Entry = RemoveHeadList(ListHead);
+        FontCatalog_FreeFile(CONTAINING_RECORD(Entry, FONT_CATALOG_FILE, ListEntry));
+    }
+}
+
+PFONT_CATALOG_FILE
+FASTCALL
+FontCatalog_FindFile(
+    _In_ PLIST_ENTRY ListHead,
+    _In_ PCUNICODE_STRING FileName,
+    _In_ DWORD dwFlags)
+{
+    PLIST_ENTRY Entry;
+    PFONT_CATALOG_FILE File;
+
+    for (Entry = ListHead->Flink; Entry != ListHead; Entry = Entry->Flink)
+    {
+        File = CONTAINING_RECORD(Entry, FONT_CATALOG_FILE, ListEntry);
+        if (File->dwFlags == dwFlags && RtlEqualUnicodeString(&File->FileName, FileName, TRUE))
+            return File;
+    }
+
+    return NULL;
+}
+
+NTSTATUS
+FASTCALL
+FontCatalog_QueryFile(
+    _In_ PCUNICODE_STRING FileName,
+    _In_ DWORD dwFlags,
+    _Out_ PLARGE_INTEGER FileSize,
+    _Out_ PLARGE_INTEGER LastWriteTime)
+{
+    static const UNICODE_STRING DosPathPrefix = RTL_CONSTANT_STRING(L"\\??\\");
+    FILE_NETWORK_OPEN_INFORMATION Information;
+    OBJECT_ATTRIBUTES ObjectAttributes;
+    UNICODE_STRING PathName;
+    PWSTR pszBuffer = NULL;
+    USHORT Length;
+    NTSTATUS Status;
+
+    /* Same path as IntGdiAddFontResourceSingle opens */
+    if (dwFlags & AFRX_DOS_DEVICE_PATH)
+    {
+        Length = DosPathPrefix.Length + FileName->Length + sizeof(UNICODE_NULL);
+        pszBuffer = ExAllocatePoolWithTag(PagedPool, Length, TAG_USTR);
+        if (!pszBuffer)
+            return STATUS_NO_MEMORY;
+
+        RtlInitEmptyUnicodeString(&PathName, pszBuffer, Length);
+        RtlAppendUnicodeStringToString(&PathName, &DosPathPrefix);
+        RtlAppendUnicodeStringToString(&PathName, FileName);
+    }
+    else
+    {
+        PathName = *FileName;
+    }
+
+    InitializeObjectAttributes(&ObjectAttributes, &PathName,
+                               OBJ_CASE_INSENSITIVE | OBJ_KERNEL_HANDLE,
+                               NULL, NULL);
+    Status = ZwQueryFullAttributesFile(&ObjectAttributes, &Information);
+    if (NT_SUCCESS(Status))
+    {
+        *FileSize = Information.EndOfFile;
+        *LastWriteTime = Information.LastWriteTime;
+    }
+
+    if (pszBuffer)
+        ExFreePoolWithTag(pszBuffer, TAG_USTR);
+
+    return Status;
+}
+
+static BOOLEAN
+FontCatalog_ReadFile(
+    _Inout_ PFONT_CATALOG_CURSOR Cursor,
+    _Out_ PFONT_CATALOG_FILE *pFile)
+{
+    UNICODE_STRING FileName;
+    PWSTR pszFileName;
+    DWORD dwFlags;
+    LARGE_INTEGER FileSize, LastWriteTime;
+    ULONG EntryCount, i;
+    PFONT_CATALOG_FILE File;
+    PFONT_CATALOG_ENTRY Entry;
+
+    *pFile = NULL;
+
+    if (!FontCatalog_ReadName(Cursor, &pszFileName) || !pszFileName)
+        return FALSE;
+
+    RtlInitUnicodeString(&FileName, pszFileName);
+    if (!FontCatalog_Read(Cursor, &dwFlags, sizeof(dwFlags)) ||
+        !FontCatalog_Read(Cursor, &FileSize, sizeof(FileSize)) ||
+        !FontCatalog_Read(Cursor, &LastWriteTime, sizeof(LastWriteTime)) ||
+        !FontCatalog_Read(Cursor, &EntryCount, sizeof(EntryCount)))
+    {
+        File = NULL;
+    }
+    else
+    {
+        File = FontCatalog_AllocFile(&FileName, dwFlags, EntryCount);
+    }
+    ExFreePoolWithTag(pszFileName, TAG_FONT_CATALOG);
+    if (!File)
+        return FALSE;
+
+    File->FileSize = FileSize;
+    File->LastWriteTime = LastWriteTime;
+
+    for (i = 0; i < EntryCount; ++i)
+    {
+        Entry = &File->Entries[i];
+        if (!FontCatalog_Read(Cursor, &Entry->CharSet, sizeof(Entry->CharSet)) ||
+            !FontCatalog_Read(Cursor, &Entry->PitchAndFamily, sizeof(Entry->PitchAndFamily)) ||
+            !FontCatalog_Read(Cursor, &Entry->Italic, sizeof(Entry->Italic)) ||
+            !FontCatalog_Read(Cursor, &Entry->Underlined, sizeof(Entry->Underlined)) ||
+            !FontCatalog_Read(Cursor, &Entry->StruckOut, sizeof(Entry->StruckOut)) ||
+            !FontCatalog_Read(Cursor, &Entry->Weight, sizeof(Entry->Weight)) ||
+            !FontCatalog_ReadName(Cursor, &Entry->FamilyName) ||
+            !FontCatalog_ReadName(Cursor, &Entry->FullName) ||
+            !FontCatalog_ReadName(Cursor, &Entry->EnglishFamilyName))
+        {
+            FontCatalog_FreeFile(File);
+            return FALSE;
+        }
+    }
+
+    *pFile = File;
+    return TRUE;
+}
+
+static VOID
+FontCatalog_WriteFile(
+    _Inout_ PFONT_CATALOG_CURSOR Cursor,
+    _In_ PFONT_CATALOG_FILE File)
+{
+    PFONT_CATALOG_ENTRY Entry;
+    ULONG i;
+
+    FontCatalog_WriteName(Cursor, File->FileName.Buffer);
+    FontCatalog_Write(Cursor, &File->dwFlags, sizeof(File->dwFlags));
+    FontCatalog_Write(Cursor, &File->FileSize, sizeof(File->FileSize));
+    FontCatalog_Write(Cursor, &File->LastWriteTime, sizeof(File->LastWriteTime));
+    FontCatalog_Write(Cursor, &File->EntryCount, sizeof(File->EntryCount));
+
+    for (i = 0; i < File->EntryCount; ++i)
+    {
+        Entry = &File->Entries[i];
+        FontCatalog_Write(Cursor, &Entry->CharSet, sizeof(Entry->CharSet));
+        FontCatalog_Write(Cursor, &Entry->PitchAndFamily, sizeof(Entry->PitchAndFamily));
+        FontCatalog_Write(Cursor, &Entry->Italic, sizeof(Entry->Italic));
+        FontCatalog_Write(Cursor, &Entry->Underlined, sizeof(Entry->Underlined));
+        FontCatalog_Write(Cursor, &Entry->StruckOut, sizeof(Entry->StruckOut));
+        FontCatalog_Write(Cursor, &Entry->Weight, sizeof(Entry->Weight));
+        FontCatalog_WriteName(Cursor, Entry->FamilyName);
+        FontCatalog_WriteName(Cursor, Entry->FullName);
+        FontCatalog_WriteName(Cursor, Entry->EnglishFamilyName);
+    }
+}
+
+/* Appends the records of the catalog file to ListHead */
+NTSTATUS
+FASTCALL
+FontCatalog_Load(
+    _Inout_ PLIST_ENTRY ListHead,
+    _In_ USHORT LanguageID)
+{
+    OBJECT_ATTRIBUTES ObjectAttributes;
+    IO_STATUS_BLOCK IoStatusBlock;
+    FILE_STANDARD_INFORMATION Information;
+    FONT_CATALOG_HEADER Header;
+    FONT_CATALOG_CURSOR Cursor;
+    PFONT_CATALOG_FILE File;
+    LIST_ENTRY FileListHead;
+    HANDLE hFile;
+    ULONG i;
+    NTSTATUS Status;
+
+    InitializeObjectAttributes(&ObjectAttributes, (PUNICODE_STRING)&g_FontCatalogPath,
+                               OBJ_CASE_INSENSITIVE | OBJ_KERNEL_HANDLE,
+                               NULL, NULL);
+    Status = ZwOpenFile(&hFile, FILE_GENERIC_READ | SYNCHRONIZE, &ObjectAttributes,
+                        &IoStatusBlock, FILE_SHARE_READ,
+                        FILE_SYNCHRONOUS_IO_NONALERT | FILE_NON_DIRECTORY_FILE);
+    if (!NT_SUCCESS(Status))
+        return Status;
+
+    Status = ZwQueryInformationFile(hFile, &IoStatusBlock, &Information,
+                                    sizeof(Information), FileStandardInformation);
+    if (!NT_SUCCESS(Status))
+    {
+        ZwClose(hFile);
+        return Status;
+    }
+
+    if (Information.EndOfFile.QuadPart < (LONGLONG)sizeof(Header) ||
+        Information.EndOfFile.QuadPart > FONT_CATALOG_MAX_SIZE)
+    {
+        ZwClose(hFile);
+        return STATUS_FILE_CORRUPT_ERROR;
+    }
+
+    Cursor.Size = Information.EndOfFile.LowPart;
+    Cursor.Offset = 0;
+    Cursor.Data = ExAllocatePoolWithTag(PagedPool, Cursor.Size, TAG_FONT_CATALOG);
+    if (!Cursor.Data)
+    {
+        ZwClose(hFile);
+        return STATUS_NO_MEMORY;
+    }
+
+    Status = ZwReadFile(hFile, NULL, NULL, NULL, &IoStatusBlock,
+                        Cursor.Data, Cursor.Size, NULL, NULL);
+    ZwClose(hFile);
+    if (NT_SUCCESS(Status) && IoStatusBlock.Information != Cursor.Size)
+        Status = STATUS_FILE_CORRUPT_ERROR;
+    if (!NT_SUCCESS(Status))
+    {
+        ExFreePoolWithTag(Cursor.Data, TAG_FONT_CATALOG);
+        return Status;
+    }
+
+    FontCatalog_Read(&Cursor, &Header, sizeof(Header));
+    if (Header.Signature != FONT_CATALOG_SIGNATURE ||
+        Header.Version != FONT_CATALOG_VERSION ||
+        Header.LanguageID != LanguageID ||
+        Header.DataSize != Cursor.Size - Cursor.Offset ||
+        Header.Checksum != FontCatalog_Checksum(Cursor.Data + Cursor.Offset, Header.DataSize))
+    {
+        DPRINT("Ignoring the font catalog\n");
+        ExFreePoolWithTag(Cursor.Data, TAG_FONT_CATALOG);
+        return STATUS_FILE_CORRUPT_ERROR;
+    }
+
+    /* Take all the records or none */
+    InitializeListHead(&FileListHead);
+    for (i = 0; i < Header.FileCount; ++i)
+    {
+        if (!FontCatalog_ReadFile(&Cursor, &File))
+        {
+            FontCatalog_FreeList(&FileListHead);
+            ExFreePoolWithTag(Cursor.Data, TAG_FONT_CATALOG);
+            return STATUS_FILE_CORRUPT_ERROR;
+        }
+        InsertTailList(&FileListHead, &File->ListEntry);
+    }
+    ExFreePoolWithTag(Cursor.Data, TAG_FONT_CATALOG);
+
+    while (!IsListEmpty(&FileListHead))
+        InsertTailList(ListHead, RemoveHeadList(&FileListHead));
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+FASTCALL
+FontCatalog_Save(
+    _In_ PLIST_ENTRY ListHead,
+    _In_ USHORT LanguageID)
+{
+    OBJECT_ATTRIBUTES ObjectAttributes;
+    IO_STATUS_BLOCK IoStatusBlock;
+    FONT_CATALOG_HEADER Header;
+    FONT_CATALOG_CURSOR Cursor;
+    PLIST_ENTRY Entry;
+    ULONG FileCount = 0;
+    HANDLE hFile;
+    NTSTATUS Status;
+
+    /* Measure the records, then write them after the header */
+    Cursor.Data = NULL;
+    Cursor.Size = 0;
+    Cursor.Offset = sizeof(Header);
+    for (Entry = ListHead->Flink; Entry != ListHead; Entry = Entry->Flink)
+    {
+        FontCatalog_WriteFile(&Cursor, CONTAINING_RECORD(Entry, FONT_CATALOG_FILE, ListEntry));
+        ++FileCount;
+    }
+
+    if (Cursor.Offset > FONT_CATALOG_MAX_SIZE)
+        return STATUS_FILE_TOO_LARGE;
+
+    Cursor.Size = Cursor.Offset;
+    Cursor.Offset = sizeof(Header);
+    Cursor.Data = ExAllocatePoolWithTag(PagedPool, Cursor.Size, TAG_FONT_CATALOG);
+    if (!Cursor.Data)
+        return STATUS_NO_MEMORY;
+
+    for (Entry = ListHead->Flink; Entry != ListHead; Entry = Entry->Flink)
+        FontCatalog_WriteFile(&Cursor, CONTAINING_RECORD(Entry, FONT_CATALOG_FILE, ListEntry));
+    ASSERT(Cursor.Offset == Cursor.Size);
+
+    Header.Signature = FONT_CATALOG_SIGNATURE;
+    Header.Version = FONT_CATALOG_VERSION;
+    Header.LanguageID = LanguageID;
+    Header.FileCount = FileCount;
+    Header.DataSize = Cursor.Size - sizeof(Header);
+    Header.Checksum = FontCatalog_Checksum(Cursor.Data + sizeof(Header), Header.DataSize);
+    RtlCopyMemory(Cursor.Data, &Header, sizeof(Header));
+
+    /* A partially written catalog fails its checksum and gets rebuilt */
+    InitializeObjectAttributes(&ObjectAttributes, (PUNICODE_STRING)&g_FontCatalogPath,
+                               OBJ_CASE_INSENSITIVE | OBJ_KERNEL_HANDLE,
+                               NULL, NULL);
+    Status = ZwCreateFile(&hFile, FILE_GENERIC_WRITE | SYNCHRONIZE, &ObjectAttributes,
+                          &IoStatusBlock, NULL, FILE_ATTRIBUTE_NORMAL, 0,
+                          FILE_OVERWRITE_IF,
+                          FILE_SYNCHRONOUS_IO_NONALERT | FILE_NON_DIRECTORY_FILE,
+                          NULL, 0);
+    if (NT_SUCCESS(Status))
+    {
+        Status = ZwWriteFile(hFile, NULL, NULL, NULL, &IoStatusBlock,
+                             Cursor.Data, Cursor.Size, NULL, NULL);
+        ZwClose(hFile);
+    }
+
+    if (!NT_SUCCESS(Status))
+        DPRINT1("Failed to save the font catalog, Status 0x%lx\n", Status);
+
+    ExFreePoolWithTag(Cursor.Data, TAG_FONT_CATALOG);
+    return Status;
+}
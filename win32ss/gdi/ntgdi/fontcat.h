@@ -0,0 +1,93 @@
+/*
+ * PROJECT:     ReactOS win32 kernel mode subsystem
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Persistent catalog of the registered font files
+ * COPYRIGHT:   Copyright 2026 ReactOS Team
+ */
+
+#pragma once
+
+#define TAG_FONT_CATALOG 'CTNF'
+
+/*
+ * The catalog remembers, for each font file listed in the registry, what the
+ * font matcher needs to know about its faces without opening it: their
+ * charsets, styles and names, as they are right after loading. A record is
+ * only trusted while the size and the last write time of its file are the
+ * ones it was built from.
+ */
+typedef struct _FONT_CATALOG_ENTRY
+{
+    BYTE CharSet;
+    BYTE PitchAndFamily;        /* The style of the face as it is loaded, see FONT_STYLE */
+    BYTE Italic;
+    BYTE Underlined;
+    BYTE StruckOut;
+    LONG Weight;
+    PWSTR FamilyName;           /* TT_NAME_ID_FONT_FAMILY in the catalog language, or NULL */
+    PWSTR FullName;             /* TT_NAME_ID_FULL_NAME in the catalog language, or NULL */
+    PWSTR EnglishFamilyName;    /* TT_NAME_ID_FONT_FAMILY in LANG_ENGLISH, or NULL */
+} FONT_CATALOG_ENTRY, *PFONT_CATALOG_ENTRY;
+
+typedef struct _FONT_CATALOG_FILE
+{
+    LIST_ENTRY ListEntry;
+    UNICODE_STRING FileName;    /* As passed to IntGdiAddFontResourceEx */
+    DWORD dwFlags;              /* AFRX_... */
+    LARGE_INTEGER FileSize;
+    LARGE_INTEGER LastWriteTime;
+    ULONG FirstSequence;        /* Reserved for its FONT_ENTRYs while the file is not loaded */
+    BOOLEAN Pending;            /* Not loaded yet, the record stands for its faces */
+    BOOLEAN LoadRequested;      /* May beat the current best match, load it */
+    ULONG EntryCount;           /* One per FONT_ENTRY, in load order */
+    FONT_CATALOG_ENTRY Entries[ANYSIZE_ARRAY];
+} FONT_CATALOG_FILE, *PFONT_CATALOG_FILE;
+
+PFONT_CATALOG_FILE
+FASTCALL
+FontCatalog_AllocFile(
+    _In_ PCUNICODE_STRING FileName,
+    _In_ DWORD dwFlags,
+    _In_ ULONG EntryCount);
+
+VOID
+FASTCALL
+FontCatalog_FreeFile(
+    _In_ PFONT_CATALOG_FILE File);
+
+VOID
+FASTCALL
+FontCatalog_FreeList(
+    _Inout_ PLIST_ENTRY ListHead);
+
+PWSTR
+FASTCALL
+FontCatalog_DuplicateName(
+    _In_opt_ PCWSTR Name);
+
+PFONT_CATALOG_FILE
+FASTCALL
+FontCatalog_FindFile(
+    _In_ PLIST_ENTRY ListHead,
+    _In_ PCUNICODE_STRING FileName,
+    _In_ DWORD dwFlags);
+
+NTSTATUS
+FASTCALL
+FontCatalog_QueryFile(
+    _In_ PCUNICODE_STRING FileName,
+    _In_ DWORD dwFlags,
+    _Out_ PLARGE_INTEGER FileSize,
+    _Out_ PLARGE_INTEGER LastWriteTime);
+
+NTSTATUS
+FASTCALL
+FontCatalog_Load(
+    _Inout_ PLIST_ENTRY ListHead,
+    _In_ USHORT LanguageID);
+
+NTSTATUS
+FASTCALL
+FontCatalog_Save(
+    _In_ PLIST_ENTRY ListHead,
+    _In_ USHORT LanguageID);
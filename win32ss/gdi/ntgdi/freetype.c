@@ -31,6 +31,7 @@
 
 #include <gdi/eng/floatobj.h>
 #include "font.h"
+#include "fontcat.h"
 
 #define NDEBUG
 #include <debug.h>
@@ -56,6 +57,8 @@ typedef struct _FONTLINK_CHAIN
 typedef struct _FONTLINK_CACHE
 {
     LIST_ENTRY ListEntry;
+    LIST_ENTRY HashEntry; //< Entry in the g_FontLinkCacheHashTable bucket of dwHash
+    DWORD dwHash;
     LOGFONTW LogFont;
     FONTLINK_CHAIN Chain;
 } FONTLINK_CACHE, *PFONTLINK_CACHE;
@@ -70,9 +73,21 @@ static BOOL s_fFontLinkUseOem = FALSE;
 static BOOL s_fFontLinkUseSymbol = FALSE;
 
 #define MAX_FONTLINK_CACHE 128
+#define FONTLINK_CACHE_HASH_BUCKETS 64 // Must be a power of two
 static RTL_STATIC_LIST_HEAD(g_FontLinkCache); // The list of FONTLINK_CACHE
+static LIST_ENTRY g_FontLinkCacheHashTable[FONTLINK_CACHE_HASH_BUCKETS];
 static LONG g_nFontLinkCacheCount = 0;
 
+static DWORD
+IntGetHash(IN LPCVOID pv, IN DWORD cdw);
+
+static inline PLIST_ENTRY
+FontLink_GetCacheBucket(
+    _In_ DWORD dwHash)
+{
+    return &g_FontLinkCacheHashTable[dwHash & (FONTLINK_CACHE_HASH_BUCKETS - 1)];
+}
+
 static SIZE_T
 SZZ_GetSize(_In_ PCZZWSTR pszz)
 {
@@ -241,6 +256,8 @@ FontLink_AddCache(
     /* Add the new cache entry to the top of the cache list */
     ++g_nFontLinkCacheCount;
     InsertHeadList(&g_FontLinkCache, &pCache->ListEntry);
+    pCache->dwHash = IntGetHash(&pCache->LogFont, sizeof(LOGFONTW) / sizeof(DWORD));
+    InsertHeadList(FontLink_GetCacheBucket(pCache->dwHash), &pCache->HashEntry);
 
     /* If there are too many cache entries in the list, remove the oldest one at the bottom */
     if (g_nFontLinkCacheCount > MAX_FONTLINK_CACHE)
@@ -249,6 +266,7 @@ FontLink_AddCache(
         Entry = RemoveTailList(&g_FontLinkCache);
         --g_nFontLinkCacheCount;
         pCache = CONTAINING_RECORD(Entry, FONTLINK_CACHE, ListEntry);
+        RemoveEntryList(&pCache->HashEntry);
         FontLink_Chain_Free(&pCache->Chain);
         ExFreePoolWithTag(pCache, TAG_FONT);
     }
@@ -297,17 +315,34 @@ static inline PFONTLINK_CACHE
 FontLink_FindCache(
     _In_ const LOGFONTW* pLogFont)
 {
-    PLIST_ENTRY Entry;
+    PLIST_ENTRY Entry, Bucket;
     PFONTLINK_CACHE pLinkCache;
-    for (Entry = g_FontLinkCache.Flink; Entry != &g_FontLinkCache; Entry = Entry->Flink)
+    DWORD dwHash = IntGetHash(pLogFont, sizeof(LOGFONTW) / sizeof(DWORD));
+
+    Bucket = FontLink_GetCacheBucket(dwHash);
+    for (Entry = Bucket->Flink; Entry != Bucket; Entry = Entry->Flink)
     {
-        pLinkCache = CONTAINING_RECORD(Entry, FONTLINK_CACHE, ListEntry);
-        if (RtlEqualMemory(&pLinkCache->LogFont, pLogFont, sizeof(LOGFONTW)))
+        pLinkCache = CONTAINING_RECORD(Entry, FONTLINK_CACHE, HashEntry);
+        if (pLinkCache->dwHash == dwHash &&
+            RtlEqualMemory(&pLinkCache->LogFont, pLogFont, sizeof(LOGFONTW)))
+        {
             return pLinkCache;
+        }
     }
     return NULL;
 }
 
+/// Take the entry out of the cache, the caller owns it afterwards.
+static inline VOID
+FontLink_RemoveCache(
+    _In_ PFONTLINK_CACHE pLinkCache)
+{
+    RemoveEntryList(&pLinkCache->ListEntry);
+    RemoveEntryList(&pLinkCache->HashEntry);
+    ASSERT(g_nFontLinkCacheCount > 0);
+    --g_nFontLinkCacheCount;
+}
+
 static inline VOID
 FontLink_CleanupCache(VOID)
 {
@@ -318,6 +353,7 @@ FontLink_CleanupCache(VOID)
     {
         Entry = RemoveHeadList(&g_FontLinkCache);
         pLinkCache = CONTAINING_RECORD(Entry, FONTLINK_CACHE, ListEntry);
+        RemoveEntryList(&pLinkCache->HashEntry);
         FontLink_Chain_Free(&pLinkCache->Chain);
         ExFreePoolWithTag(pLinkCache, TAG_FONT);
     }
@@ -371,6 +407,22 @@ static PFAST_MUTEX      g_FreeTypeLock;
 static RTL_STATIC_LIST_HEAD(g_FontListHead);
 static BOOL             g_RenderingEnabled = TRUE;
 
+/* Index of the global fonts by their localized family and full names */
+#define FONT_NAME_HASH_BUCKETS 256 /* Must be a power of two */
+static LIST_ENTRY g_FontNameHashTable[FONT_NAME_HASH_BUCKETS];
+static ULONG g_FontEntrySequence;
+
+/* Fonts already selected for a LOGFONTW, see IntFindBestFont */
+#define MAX_FONT_MATCH_CACHE 256
+#define FONT_MATCH_HASH_BUCKETS 64 /* Must be a power of two */
+static RTL_STATIC_LIST_HEAD(g_FontMatchCacheListHead);
+static LIST_ENTRY g_FontMatchHashTable[FONT_MATCH_HASH_BUCKETS];
+static UINT g_FontMatchCacheNumEntries;
+
+/* Catalogued font files that are not loaded yet, see IntLoadPendingFonts */
+static RTL_STATIC_LIST_HEAD(g_PendingFontListHead);
+static PFAST_MUTEX g_FontLoadLock; /* Taken before g_FreeTypeLock */
+
 #define ASSERT_FREETYPE_LOCK_HELD() \
     ASSERT(g_FreeTypeLock->Owner == KeGetCurrentThread())
 
@@ -389,10 +441,17 @@ do { \
     ExReleaseFastMutexUnsafeAndLeaveCriticalRegion(g_FreeTypeLock); \
 } while(0)
 
-#define MAX_FONT_CACHE 256
+/* The glyph cache is bounded by the memory its glyphs take, not by their number */
+#define MAX_FONT_CACHE_BYTES (4 * 1024 * 1024)
+#define FONT_CACHE_HASH_BUCKETS 1024 /* Must be a power of two */
 
 static RTL_STATIC_LIST_HEAD(g_FontCacheListHead);
+static LIST_ENTRY g_FontCacheHashTable[FONT_CACHE_HASH_BUCKETS];
 static UINT g_FontCacheNumEntries;
+static SIZE_T g_FontCacheNumBytes;
+static ULONGLONG g_FontCacheHits;
+static ULONGLONG g_FontCacheMisses;
+static ULONGLONG g_FontCacheEvictions;
 
 static PWCHAR g_ElfScripts[32] =   /* These are in the order of the fsCsb[0] bits */
 {
@@ -492,10 +551,12 @@ BYTE FASTCALL IntCharSetFromCodePage(UINT uCodePage)
     return DEFAULT_CHARSET;
 }
 
-static __inline VOID
-FindBestFontFromList(FONTOBJ **FontObj, ULONG *MatchPenalty,
-                     const LOGFONTW *LogFont,
-                     const PLIST_ENTRY Head);
+static FONTOBJ *
+IntFindBestFont(_In_ const LOGFONTW *LogFont, _In_ PPROCESSINFO Win32Process,
+                _Out_opt_ PBOOL pbLoadPending);
+
+static VOID
+IntLoadFontLinkFonts(VOID);
 
 static BOOL
 MatchFontName(PSHARED_FACE SharedFace, PUNICODE_STRING Name1, FT_UShort NameID, FT_UShort LangID);
@@ -505,9 +566,7 @@ FontLink_PrepareFontInfo(
     _Inout_ PFONTLINK pFontLink)
 {
     FONTOBJ *pFontObj;
-    ULONG MatchPenalty;
     UNICODE_STRING FaceName;
-    PPROCESSINFO Win32Process;
     PFONTGDI pFontGDI;
 
     ASSERT_FREETYPE_LOCK_HELD();
@@ -518,17 +577,9 @@ FontLink_PrepareFontInfo(
     if (pFontLink->SharedFace)
         return TRUE;
 
-    MatchPenalty = MAXULONG;
-    pFontObj = NULL;
-
-    // Search private fonts
-    Win32Process = PsGetCurrentProcessWin32Process();
-    FindBestFontFromList(&pFontObj, &MatchPenalty, &pFontLink->LogFont,
-                         &Win32Process->PrivateFontListHead);
-
-    // Search system fonts
-    FindBestFontFromList(&pFontObj, &MatchPenalty, &pFontLink->LogFont,
-                         &g_FontListHead);
+    // Search private fonts, then system fonts. The catalogued fonts FontLink
+    // may use are already loaded, see IntLoadFontLinkFonts
+    pFontObj = IntFindBestFont(&pFontLink->LogFont, PsGetCurrentProcessWin32Process(), NULL);
 
     if (!pFontObj) // Not found?
     {
@@ -620,9 +671,12 @@ RemoveCachedEntry(PFONT_CACHE_ENTRY Entry)
 
     FT_Done_Glyph((FT_Glyph)Entry->BitmapGlyph);
     RemoveEntryList(&Entry->ListEntry);
-    ExFreePoolWithTag(Entry, TAG_FONT);
+    RemoveEntryList(&Entry->HashEntry);
+    ASSERT(g_FontCacheNumEntries > 0);
+    ASSERT(g_FontCacheNumBytes >= Entry->cbSize);
     g_FontCacheNumEntries--;
-    ASSERT(g_FontCacheNumEntries <= MAX_FONT_CACHE);
+    g_FontCacheNumBytes -= Entry->cbSize;
+    ExFreePoolWithTag(Entry, TAG_FONT);
 }
 
 static void
@@ -713,6 +767,12 @@ CleanupFontEntryEx(PFONT_ENTRY FontEntry, PFONTGDI FontGDI)
     if (FontEntry->FaceName.Buffer)
         RtlFreeUnicodeString(&FontEntry->FaceName);
 
+    if (FontEntry->LocalFamilyName)
+        ExFreePoolWithTag(FontEntry->LocalFamilyName, TAG_FONT);
+
+    if (FontEntry->LocalFullName)
+        ExFreePoolWithTag(FontEntry->LocalFullName, TAG_FONT);
+
     EngFreeMem(FontGDI);
     SharedFace_Release(SharedFace);
     ExFreePoolWithTag(FontEntry, TAG_FONT);
@@ -859,11 +919,37 @@ VOID DumpGlobalFontList(BOOL bDoLock)
         IntUnLockFreeType();
 }
 
+VOID DumpFontCache(BOOL bDoLock)
+{
+    PLIST_ENTRY Entry;
+    PFONT_CACHE_ENTRY CacheEntry;
+
+    if (bDoLock)
+        IntLockFreeType();
+
+    DPRINT("## DumpFontCache: %u entries, %Iu bytes, %I64u hits, %I64u misses, %I64u evictions\n",
+           g_FontCacheNumEntries, g_FontCacheNumBytes,
+           g_FontCacheHits, g_FontCacheMisses, g_FontCacheEvictions);
+
+    for (Entry = g_FontCacheListHead.Flink; Entry != &g_FontCacheListHead; Entry = Entry->Flink)
+    {
+        CacheEntry = CONTAINING_RECORD(Entry, FONT_CACHE_ENTRY, ListEntry);
+        DPRINT("Face %p, GlyphIndex %d, lfHeight %ld, lfWidth %ld, Aspect 0x%lx, %Iu bytes, %lu hits\n",
+               CacheEntry->Hashed.Face, CacheEntry->Hashed.GlyphIndex,
+               CacheEntry->Hashed.lfHeight, CacheEntry->Hashed.lfWidth,
+               CacheEntry->Hashed.AspectValue, CacheEntry->cbSize, CacheEntry->HitCount);
+    }
+
+    if (bDoLock)
+        IntUnLockFreeType();
+}
+
 VOID DumpFontInfo(BOOL bDoLock)
 {
     DumpGlobalFontList(bDoLock);
     DumpPrivateFontList(bDoLock);
     DumpFontSubstList();
+    DumpFontCache(bDoLock);
 }
 #endif
 
@@ -1021,8 +1107,27 @@ BOOL FASTCALL
 InitFontSupport(VOID)
 {
     ULONG ulError;
+    UINT i;
 
     g_FontCacheNumEntries = 0;
+    g_FontCacheNumBytes = 0;
+    for (i = 0; i < _countof(g_FontCacheHashTable); ++i)
+    {
+        InitializeListHead(&g_FontCacheHashTable[i]);
+    }
+    for (i = 0; i < _countof(g_FontLinkCacheHashTable); ++i)
+    {
+        InitializeListHead(&g_FontLinkCacheHashTable[i]);
+    }
+    for (i = 0; i < _countof(g_FontNameHashTable); ++i)
+    {
+        InitializeListHead(&g_FontNameHashTable[i]);
+    }
+    g_FontMatchCacheNumEntries = 0;
+    for (i = 0; i < _countof(g_FontMatchHashTable); ++i)
+    {
+        InitializeListHead(&g_FontMatchHashTable[i]);
+    }
 
     g_FreeTypeLock = ExAllocatePoolWithTag(NonPagedPool, sizeof(FAST_MUTEX), TAG_INTERNAL_SYNC);
     if (g_FreeTypeLock == NULL)
@@ -1031,6 +1136,13 @@ InitFontSupport(VOID)
     }
     ExInitializeFastMutex(g_FreeTypeLock);
 
+    g_FontLoadLock = ExAllocatePoolWithTag(NonPagedPool, sizeof(FAST_MUTEX), TAG_INTERNAL_SYNC);
+    if (g_FontLoadLock == NULL)
+    {
+        return FALSE;
+    }
+    ExInitializeFastMutex(g_FontLoadLock);
+
     ulError = FT_Init_FreeType(&g_FreeTypeLibrary);
     if (ulError)
     {
@@ -1056,6 +1168,9 @@ InitFontSupport(VOID)
     FontLink_LoadDefaultFonts();
     FontLink_LoadDefaultCharset();
 
+    /* FontLink does not wait for the catalogued fonts, it needs them now */
+    IntLoadFontLinkFonts();
+
     return TRUE;
 }
 
@@ -1074,8 +1189,7 @@ FreeFontSupport(VOID)
     pHead = &g_FontCacheListHead;
     while (!IsListEmpty(pHead))
     {
-        pEntry = RemoveHeadList(pHead);
-        pFontCache = CONTAINING_RECORD(pEntry, FONT_CACHE_ENTRY, ListEntry);
+        pFontCache = CONTAINING_RECORD(pHead->Flink, FONT_CACHE_ENTRY, ListEntry);
         RemoveCachedEntry(pFontCache);
     }
 
@@ -1088,12 +1202,19 @@ FreeFontSupport(VOID)
         ExFreePoolWithTag(pSubstEntry, TAG_FONT);
     }
 
+    // Free the fonts selected for the LOGFONTs
+    IntFlushFontMatchCache();
+
+    // Forget the font files that were never loaded
+    FontCatalog_FreeList(&g_PendingFontListHead);
+
     // Free font list
     pHead = &g_FontListHead;
     while (!IsListEmpty(pHead))
     {
         pEntry = RemoveHeadList(pHead);
         pFontEntry = CONTAINING_RECORD(pEntry, FONT_ENTRY, ListEntry);
+        IntRemoveFontNameIndex(pFontEntry);
         CleanupFontEntry(pFontEntry);
     }
 
@@ -1103,6 +1224,9 @@ FreeFontSupport(VOID)
         g_FreeTypeLibrary = NULL;
     }
 
+    ExFreePoolWithTag(g_FontLoadLock, TAG_INTERNAL_SYNC);
+    g_FontLoadLock = NULL;
+
     ExFreePoolWithTag(g_FreeTypeLock, TAG_INTERNAL_SYNC);
     g_FreeTypeLock = NULL;
 }
@@ -1515,7 +1639,7 @@ FontLink_Chain_Populate(
     pLinkCache = FontLink_FindCache(&lfBase);
     if (pLinkCache)
     {
-        RemoveEntryList(&pLinkCache->ListEntry);
+        FontLink_RemoveCache(pLinkCache);
         *pChain = pLinkCache->Chain;
         IntRebaseList(&pChain->FontLinkList, &pLinkCache->Chain.FontLinkList);
         ExFreePoolWithTag(pLinkCache, TAG_FONT);
@@ -1713,6 +1837,178 @@ UINT FASTCALL IntGetCharSet(INT nIndex, FT_ULong CodePageRange1)
     return (nIndex < 0) ? nCount : ANSI_CHARSET;
 }
 
+static NTSTATUS
+IntGetFontLocalizedName(PUNICODE_STRING pNameW, PSHARED_FACE SharedFace,
+                        FT_UShort NameID, FT_UShort LangID);
+
+static DWORD
+IntGetFaceNameHash(_In_ PCWSTR pszName)
+{
+    DWORD dwHash = 0;
+
+    while (*pszName)
+        dwHash = dwHash * 31 + RtlUpcaseUnicodeChar(*pszName++);
+
+    return dwHash;
+}
+
+static inline PLIST_ENTRY
+IntGetFontNameBucket(_In_ PCWSTR pszName)
+{
+    return &g_FontNameHashTable[IntGetFaceNameHash(pszName) & (FONT_NAME_HASH_BUCKETS - 1)];
+}
+
+/* Returns the name as GetFontPenalty() sees it in the OUTLINETEXTMETRICW */
+static PWSTR
+IntGetFontEntryName(_In_ PSHARED_FACE SharedFace, _In_ FT_UShort NameID)
+{
+    UNICODE_STRING Name;
+    PWSTR pszName = NULL;
+
+    ASSERT_FREETYPE_LOCK_HELD();
+
+    RtlInitUnicodeString(&Name, NULL);
+    if (NT_SUCCESS(IntGetFontLocalizedName(&Name, SharedFace, NameID, gusLanguageID)))
+    {
+        pszName = ExAllocatePoolWithTag(PagedPool, Name.Length + sizeof(UNICODE_NULL), TAG_FONT);
+        if (pszName)
+        {
+            RtlCopyMemory(pszName, Name.Buffer, Name.Length);
+            pszName[Name.Length / sizeof(WCHAR)] = UNICODE_NULL;
+        }
+    }
+    RtlFreeUnicodeString(&Name);
+
+    return pszName;
+}
+
+static VOID
+IntInitFontEntryNames(_Inout_ PFONT_ENTRY FontEntry)
+{
+    PSHARED_FACE SharedFace = FontEntry->Font->SharedFace;
+    UINT i;
+
+    FontEntry->Scored = FALSE;
+    FontEntry->LocalFamilyName = IntGetFontEntryName(SharedFace, TT_NAME_ID_FONT_FAMILY);
+    FontEntry->LocalFullName = IntGetFontEntryName(SharedFace, TT_NAME_ID_FULL_NAME);
+
+    for (i = 0; i < _countof(FontEntry->NameLinks); ++i)
+    {
+        InitializeListHead(&FontEntry->NameLinks[i].HashEntry);
+        FontEntry->NameLinks[i].FontEntry = FontEntry;
+    }
+}
+
+static VOID
+IntAddFontNameIndex(_Inout_ PFONT_ENTRY FontEntry)
+{
+    ASSERT_FREETYPE_LOCK_HELD();
+
+    if (FontEntry->LocalFamilyName)
+    {
+        InsertTailList(IntGetFontNameBucket(FontEntry->LocalFamilyName),
+                       &FontEntry->NameLinks[0].HashEntry);
+    }
+    if (FontEntry->LocalFullName)
+    {
+        InsertTailList(IntGetFontNameBucket(FontEntry->LocalFullName),
+                       &FontEntry->NameLinks[1].HashEntry);
+    }
+}
+
+static VOID
+IntRemoveFontNameIndex(_Inout_ PFONT_ENTRY FontEntry)
+{
+    /* The links of a font that was not indexed point to themselves */
+    RemoveEntryList(&FontEntry->NameLinks[0].HashEntry);
+    RemoveEntryList(&FontEntry->NameLinks[1].HashEntry);
+}
+
+static inline PLIST_ENTRY
+IntGetFontMatchBucket(_In_ DWORD dwHash)
+{
+    return &g_FontMatchHashTable[dwHash & (FONT_MATCH_HASH_BUCKETS - 1)];
+}
+
+/* Must be called whenever a global font is added or removed */
+static VOID
+IntFlushFontMatchCache(VOID)
+{
+    PFONT_MATCH_CACHE_ENTRY Entry;
+
+    while (!IsListEmpty(&g_FontMatchCacheListHead))
+    {
+        Entry = CONTAINING_RECORD(RemoveHeadList(&g_FontMatchCacheListHead),
+                                  FONT_MATCH_CACHE_ENTRY, ListEntry);
+        RemoveEntryList(&Entry->HashEntry);
+        ExFreePoolWithTag(Entry, TAG_FONT);
+    }
+    g_FontMatchCacheNumEntries = 0;
+}
+
+/* What follows the terminator of lfFaceName must not split the cache entries */
+static VOID
+IntGetFontMatchKey(_Out_ PLOGFONTW Key, _In_ const LOGFONTW *LogFont)
+{
+    SIZE_T cch;
+
+    *Key = *LogFont;
+    for (cch = 0; cch < LF_FACESIZE && Key->lfFaceName[cch]; ++cch)
+        ;
+    RtlZeroMemory(&Key->lfFaceName[cch], (LF_FACESIZE - cch) * sizeof(WCHAR));
+}
+
+static FONTOBJ *
+IntFindFontMatchCache(_In_ const LOGFONTW *Key, _In_ DWORD dwHash)
+{
+    PLIST_ENTRY CurrentEntry, Bucket;
+    PFONT_MATCH_CACHE_ENTRY Entry;
+
+    ASSERT_FREETYPE_LOCK_HELD();
+
+    Bucket = IntGetFontMatchBucket(dwHash);
+    for (CurrentEntry = Bucket->Flink; CurrentEntry != Bucket; CurrentEntry = CurrentEntry->Flink)
+    {
+        Entry = CONTAINING_RECORD(CurrentEntry, FONT_MATCH_CACHE_ENTRY, HashEntry);
+        if (Entry->dwHash == dwHash && RtlEqualMemory(&Entry->LogFont, Key, sizeof(LOGFONTW)))
+        {
+            /* Move it to the front of the LRU list */
+            RemoveEntryList(&Entry->ListEntry);
+            InsertHeadList(&g_FontMatchCacheListHead, &Entry->ListEntry);
+            return Entry->FontObj;
+        }
+    }
+
+    return NULL;
+}
+
+static VOID
+IntAddFontMatchCache(_In_ const LOGFONTW *Key, _In_ DWORD dwHash, _In_ FONTOBJ *FontObj)
+{
+    PFONT_MATCH_CACHE_ENTRY Entry;
+
+    ASSERT_FREETYPE_LOCK_HELD();
+
+    Entry = ExAllocatePoolWithTag(PagedPool, sizeof(FONT_MATCH_CACHE_ENTRY), TAG_FONT);
+    if (!Entry)
+        return;
+
+    Entry->dwHash = dwHash;
+    Entry->LogFont = *Key;
+    Entry->FontObj = FontObj;
+    InsertHeadList(&g_FontMatchCacheListHead, &Entry->ListEntry);
+    InsertHeadList(IntGetFontMatchBucket(dwHash), &Entry->HashEntry);
+
+    if (++g_FontMatchCacheNumEntries > MAX_FONT_MATCH_CACHE)
+    {
+        Entry = CONTAINING_RECORD(RemoveTailList(&g_FontMatchCacheListHead),
+                                  FONT_MATCH_CACHE_ENTRY, ListEntry);
+        RemoveEntryList(&Entry->HashEntry);
+        ExFreePoolWithTag(Entry, TAG_FONT);
+        g_FontMatchCacheNumEntries--;
+    }
+}
+
 /* pixels to points */
 #define PX2PT(pixels) FT_MulDiv((pixels), 72, 96)
 
@@ -1940,6 +2236,17 @@ IntGdiLoadFontsFromMemory(PGDI_LOAD_FONT pLoadFont,
     Entry->NotEnum = (Characteristics & FR_NOT_ENUM);
 
     IntLockFreeType();
+    IntInitFontEntryNames(Entry);
+    if (pLoadFont->SequenceCount > 0)
+    {
+        /* Keep the place of the catalogued font in the list order */
+        Entry->Sequence = pLoadFont->FirstSequence++;
+        --pLoadFont->SequenceCount;
+    }
+    else
+    {
+        Entry->Sequence = ++g_FontEntrySequence;
+    }
     if (Characteristics & FR_PRIVATE)
     {
         /* private font */
@@ -1952,6 +2259,8 @@ IntGdiLoadFontsFromMemory(PGDI_LOAD_FONT pLoadFont,
     {
         /* global font */
         InsertTailList(&g_FontListHead, &Entry->ListEntry);
+        IntAddFontNameIndex(Entry);
+        IntFlushFontMatchCache();
     }
     IntUnLockFreeType();
 
@@ -2093,7 +2402,8 @@ static INT FASTCALL
 IntGdiAddFontResourceSingle(
     _In_ PCUNICODE_STRING FileName,
     _In_ DWORD Characteristics,
-    _In_ DWORD dwFlags)
+    _In_ DWORD dwFlags,
+    _In_opt_ PFONT_CATALOG_FILE CatalogFile)
 {
     NTSTATUS Status;
     HANDLE FileHandle;
@@ -2188,6 +2498,11 @@ IntGdiAddFontResourceSingle(
     LoadFont.Characteristics    = Characteristics;
     RtlInitUnicodeString(&LoadFont.RegValueName, NULL);
     LoadFont.CharSet            = DEFAULT_CHARSET;
+    if (CatalogFile)
+    {
+        LoadFont.FirstSequence  = CatalogFile->FirstSequence;
+        LoadFont.SequenceCount  = CatalogFile->EntryCount;
+    }
     FontCount = IntGdiLoadFontByIndexFromMemory(&LoadFont, -1);
 
     /* Release our copy */
@@ -2316,7 +2631,7 @@ IntGdiAddFontResourceEx(
         ustrPathName.MaximumLength = ustrPathName.Length + sizeof(WCHAR);
         ustrPathName.Buffer = pchFile;
 
-        INT count = IntGdiAddFontResourceSingle(&ustrPathName, Characteristics, dwFlags);
+        INT count = IntGdiAddFontResourceSingle(&ustrPathName, Characteristics, dwFlags, NULL);
         if (!count)
             return 0;
         ret += count;
@@ -2327,6 +2642,167 @@ IntGdiAddFontResourceEx(
     return ret;
 }
 
+/*
+ * Loads the catalogued font files that IntFindBestFont() asked for, or all of
+ * them. Their records leave g_PendingFontListHead once their fonts are in
+ * g_FontListHead, so that the font matcher always sees one or the other.
+ */
+static VOID
+IntLoadPendingFonts(_In_ BOOL bAll)
+{
+    PLIST_ENTRY Entry, NextEntry;
+    PFONT_CATALOG_FILE File;
+
+    ASSERT_FREETYPE_LOCK_NOT_HELD();
+
+    ExEnterCriticalRegionAndAcquireFastMutexUnsafe(g_FontLoadLock);
+
+    /* Records are only removed by the owner of g_FontLoadLock */
+    for (Entry = g_PendingFontListHead.Flink; Entry != &g_PendingFontListHead; Entry = NextEntry)
+    {
+        File = CONTAINING_RECORD(Entry, FONT_CATALOG_FILE, ListEntry);
+        NextEntry = Entry->Flink;
+
+        if (!bAll && !File->LoadRequested)
+            continue;
+
+        DPRINT("Loading %wZ\n", &File->FileName);
+        if (!IntGdiAddFontResourceSingle(&File->FileName, 0, File->dwFlags, File))
+            DPRINT1("Could not load catalogued font file %wZ\n", &File->FileName);
+
+        IntLockFreeType();
+        RemoveEntryList(&File->ListEntry);
+        IntUnLockFreeType();
+
+        FontCatalog_FreeFile(File);
+    }
+
+    ExReleaseFastMutexUnsafeAndLeaveCriticalRegion(g_FontLoadLock);
+}
+
+/* Asks for the catalogued fonts whose family is pszFaceName or its substitute */
+static VOID
+IntRequestPendingFontsByFamily(_In_ PCWSTR pszFaceName)
+{
+    PLIST_ENTRY Entry;
+    PFONT_CATALOG_FILE File;
+    PFONT_CATALOG_ENTRY CatalogEntry;
+    LOGFONTW lf;
+    ULONG i;
+
+    ASSERT_FREETYPE_LOCK_HELD();
+
+    RtlZeroMemory(&lf, sizeof(lf));
+    lf.lfCharSet = DEFAULT_CHARSET;
+    RtlStringCchCopyW(lf.lfFaceName, _countof(lf.lfFaceName), pszFaceName);
+    SubstituteFontRecurse(&lf);
+
+    for (Entry = g_PendingFontListHead.Flink; Entry != &g_PendingFontListHead; Entry = Entry->Flink)
+    {
+        File = CONTAINING_RECORD(Entry, FONT_CATALOG_FILE, ListEntry);
+        for (i = 0; i < File->EntryCount && !File->LoadRequested; ++i)
+        {
+            CatalogEntry = &File->Entries[i];
+            if ((CatalogEntry->FamilyName &&
+                 (_wcsicmp(CatalogEntry->FamilyName, pszFaceName) == 0 ||
+                  _wcsicmp(CatalogEntry->FamilyName, lf.lfFaceName) == 0)) ||
+                (CatalogEntry->EnglishFamilyName &&
+                 (_wcsicmp(CatalogEntry->EnglishFamilyName, pszFaceName) == 0 ||
+                  _wcsicmp(CatalogEntry->EnglishFamilyName, lf.lfFaceName) == 0)))
+            {
+                File->LoadRequested = TRUE;
+            }
+        }
+    }
+}
+
+/* pszzFontLink: "<FontFileName>,<FaceName>[,...]" strings, see FontLink_Create */
+static VOID
+IntRequestFontLinkFonts(_In_ PCZZWSTR pszzFontLink)
+{
+    PCWSTR pszLink, pch0, pch1;
+    WCHAR szFaceName[LF_FACESIZE];
+
+    for (pszLink = pszzFontLink; *pszLink; pszLink += wcslen(pszLink) + 1)
+    {
+        pch0 = wcschr(pszLink, L',');
+        if (!pch0)
+            continue;
+        ++pch0;
+
+        pch1 = wcschr(pch0, L',');
+        if (pch1)
+            RtlStringCchCopyNW(szFaceName, _countof(szFaceName), pch0, pch1 - pch0);
+        else
+            RtlStringCchCopyW(szFaceName, _countof(szFaceName), pch0);
+
+        IntRequestPendingFontsByFamily(szFaceName);
+    }
+}
+
+/*
+ * FontLink_PrepareFontInfo() runs with the FreeType lock held and cannot load
+ * fonts, so the catalogued fonts that any FontLink chain may link to are
+ * loaded upfront: the ones of the SystemLink values and of the defaults.
+ */
+static VOID
+IntLoadFontLinkFonts(VOID)
+{
+    const ULONG cbFontLinkMax = 8192;
+    PWSTR pszzFontLink;
+    WCHAR szName[MAX_PATH];
+    ULONG i, cchName, cbData, Type;
+    HKEY hKey;
+    BOOL bLoadAll = FALSE;
+    NTSTATUS Status;
+
+    if (IsListEmpty(&g_PendingFontListHead))
+        return;
+
+    IntLockFreeType();
+    IntRequestFontLinkFonts(s_szzDefFontLink);
+    IntRequestFontLinkFonts(s_szzDefFixedFontLink);
+    if (s_szDefFontLinkFontName[0])
+        IntRequestPendingFontsByFamily(s_szDefFontLinkFontName);
+    IntUnLockFreeType();
+
+    Status = RegOpenKey(
+        L"\\Registry\\Machine\\Software\\Microsoft\\Windows NT\\CurrentVersion\\FontLink\\SystemLink",
+        &hKey);
+    if (NT_SUCCESS(Status))
+    {
+        pszzFontLink = ExAllocatePoolWithTag(PagedPool, cbFontLinkMax + 2 * sizeof(WCHAR), TAG_FONT);
+        for (i = 0; pszzFontLink; ++i)
+        {
+            cchName = _countof(szName);
+            cbData = cbFontLinkMax;
+            Status = RegEnumValueW(hKey, i, szName, &cchName, &Type, pszzFontLink, &cbData);
+            if (!NT_SUCCESS(Status))
+                break;
+            if (Type != REG_MULTI_SZ)
+                continue;
+
+            /* Ensure double-NUL-terminated */
+            pszzFontLink[cbData / sizeof(WCHAR)] = UNICODE_NULL;
+            pszzFontLink[cbData / sizeof(WCHAR) + 1] = UNICODE_NULL;
+
+            IntLockFreeType();
+            IntRequestFontLinkFonts(pszzFontLink);
+            IntUnLockFreeType();
+        }
+        ZwClose(hKey);
+
+        /* Without all the SystemLink values, there is no telling what FontLink needs */
+        if (!pszzFontLink || Status != STATUS_NO_MORE_ENTRIES)
+            bLoadAll = TRUE;
+
+        if (pszzFontLink)
+            ExFreePoolWithTag(pszzFontLink, TAG_FONT);
+    }
+
+    IntLoadPendingFonts(bLoadAll);
+}
+
 /* Borrowed from shlwapi */
 static PWSTR
 PathFindFileNameW(_In_ PCWSTR pszPath)
@@ -2437,12 +2913,15 @@ IntGdiRemoveFontResourceSingle(
         if (FontGDI->Filename && _wcsicmp(FontGDI->Filename, pszFileTitle) == 0)
         {
             RemoveEntryList(&FontEntry->ListEntry);
+            IntRemoveFontNameIndex(FontEntry);
             CleanupFontEntry(FontEntry);
             if (dwFlags & AFRX_WRITE_REGISTRY)
                 IntDeleteRegFontEntries(pszFileTitle, dwFlags);
             ret = TRUE;
         }
     }
+    if (ret)
+        IntFlushFontMatchCache();
     IntUnLockFreeType();
 
     RtlFreeUnicodeString(&PathName);
@@ -2458,6 +2937,9 @@ IntGdiRemoveFontResource(
     PWSTR pchFile = FileName->Buffer;
     SIZE_T cchFile;
 
+    /* The fonts of the file may not be loaded yet */
+    IntLoadPendingFonts(TRUE);
+
     while (cFiles--)
     {
         _SEH2_TRY
@@ -2495,13 +2977,154 @@ BOOL WINAPI PathIsRelativeW(LPCWSTR lpszPath)
     return TRUE;
 }
 
-BOOL FASTCALL
-IntLoadFontsInRegistry(VOID)
+static FT_Error
+IntRequestFontSize(PDC dc, PFONTGDI FontGDI, LONG lfWidth, LONG lfHeight);
+
+static VOID
+IntGetFontStyle(_Out_ PFONT_STYLE Style, _In_ const OUTLINETEXTMETRICW *Otm);
+
+/*
+ * Takes the record of a registered font file out of the catalog read at
+ * startup, if the file is still the one it describes. Its fonts are then not
+ * loaded before IntFindBestFont() needs them, but they keep their place in
+ * the list order.
+ */
+static PFONT_CATALOG_FILE
+IntTakeCatalogFontFile(
+    _Inout_ PLIST_ENTRY CatalogListHead,
+    _In_ PCUNICODE_STRING FileName,
+    _In_ DWORD dwFlags)
 {
-    NTSTATUS                        Status;
-    HANDLE                          KeyHandle;
-    OBJECT_ATTRIBUTES               ObjectAttributes;
-    KEY_FULL_INFORMATION            KeyFullInfo;
+    PFONT_CATALOG_FILE File;
+    LARGE_INTEGER FileSize, LastWriteTime;
+    NTSTATUS Status;
+
+    File = FontCatalog_FindFile(CatalogListHead, FileName, dwFlags);
+    if (!File)
+        return NULL;
+
+    RemoveEntryList(&File->ListEntry);
+
+    Status = FontCatalog_QueryFile(FileName, dwFlags, &FileSize, &LastWriteTime);
+    if (!NT_SUCCESS(Status) ||
+        FileSize.QuadPart != File->FileSize.QuadPart ||
+        LastWriteTime.QuadPart != File->LastWriteTime.QuadPart)
+    {
+        DPRINT("%wZ changed, reloading it\n", FileName);
+        FontCatalog_FreeFile(File);
+        return NULL;
+    }
+
+    File->Pending = TRUE;
+    File->LoadRequested = FALSE;
+    File->FirstSequence = g_FontEntrySequence + 1;
+    g_FontEntrySequence += File->EntryCount;
+
+    return File;
+}
+
+/*
+ * Builds the catalog record of a font file that was just loaded, from its
+ * FONT_ENTRYs: the last ones of g_FontListHead, from FirstSequence on.
+ */
+static PFONT_CATALOG_FILE
+IntCatalogLoadedFontFile(
+    _In_ PCUNICODE_STRING FileName,
+    _In_ DWORD dwFlags,
+    _In_ ULONG FirstSequence)
+{
+    PLIST_ENTRY Entry, FirstEntry = NULL;
+    PFONT_ENTRY FontEntry;
+    PFONTGDI FontGDI;
+    PFONT_CATALOG_FILE File = NULL;
+    PFONT_CATALOG_ENTRY CatalogEntry;
+    OUTLINETEXTMETRICW *Otm = NULL;
+    UINT OtmSize = 0, Size;
+    UNICODE_STRING EnglishName;
+    FONT_STYLE Style;
+    ULONG Count = 0, i;
+
+    IntLockFreeType();
+
+    for (Entry = g_FontListHead.Blink; Entry != &g_FontListHead; Entry = Entry->Blink)
+    {
+        FontEntry = CONTAINING_RECORD(Entry, FONT_ENTRY, ListEntry);
+        if (FontEntry->Sequence < FirstSequence)
+            break;
+        FirstEntry = Entry;
+        ++Count;
+    }
+
+    if (Count > 0)
+        File = FontCatalog_AllocFile(FileName, dwFlags, Count);
+
+    for (Entry = FirstEntry, i = 0; File && i < Count; Entry = Entry->Flink, ++i)
+    {
+        FontEntry = CONTAINING_RECORD(Entry, FONT_ENTRY, ListEntry);
+        FontGDI = FontEntry->Font;
+        CatalogEntry = &File->Entries[i];
+
+        /* The faces were never realized yet, so this is the style IntScoreFontEntry() sees */
+        Size = IntGetOutlineTextMetrics(FontGDI, 0, NULL, TRUE);
+        if (Size > OtmSize)
+        {
+            if (Otm)
+                ExFreePoolWithTag(Otm, GDITAG_TEXT);
+            Otm = ExAllocatePoolWithTag(PagedPool, Size, GDITAG_TEXT);
+            OtmSize = Otm ? Size : 0;
+        }
+        IntRequestFontSize(NULL, FontGDI, 0, 0);
+        if (!Otm || !IntGetOutlineTextMetrics(FontGDI, OtmSize, Otm, TRUE))
+        {
+            /* Such a font is never selected, keep loading its file */
+            FontCatalog_FreeFile(File);
+            File = NULL;
+            break;
+        }
+
+        IntGetFontStyle(&Style, Otm);
+        CatalogEntry->CharSet = Style.CharSet;
+        CatalogEntry->PitchAndFamily = Style.PitchAndFamily;
+        CatalogEntry->Italic = Style.Italic;
+        CatalogEntry->Underlined = Style.Underlined;
+        CatalogEntry->StruckOut = Style.StruckOut;
+        CatalogEntry->Weight = Style.Weight;
+
+        /* A name that is missing is only unknown to the font matcher */
+        CatalogEntry->FamilyName = FontCatalog_DuplicateName(Style.FamilyName);
+        CatalogEntry->FullName = FontCatalog_DuplicateName(Style.FullName);
+
+        RtlInitUnicodeString(&EnglishName, NULL);
+        if (NT_SUCCESS(IntGetFontLocalizedName(&EnglishName, FontGDI->SharedFace,
+                                               TT_NAME_ID_FONT_FAMILY, LANG_ENGLISH)))
+        {
+            CatalogEntry->EnglishFamilyName =
+                ExAllocatePoolWithTag(PagedPool, EnglishName.Length + sizeof(UNICODE_NULL),
+                                      TAG_FONT_CATALOG);
+            if (CatalogEntry->EnglishFamilyName)
+            {
+                RtlCopyMemory(CatalogEntry->EnglishFamilyName, EnglishName.Buffer, EnglishName.Length);
+                CatalogEntry->EnglishFamilyName[EnglishName.Length / sizeof(WCHAR)] = UNICODE_NULL;
+            }
+        }
+        RtlFreeUnicodeString(&EnglishName);
+    }
+
+    IntUnLockFreeType();
+
+    if (Otm)
+        ExFreePoolWithTag(Otm, GDITAG_TEXT);
+
+    return File;
+}
+
+BOOL FASTCALL
+IntLoadFontsInRegistry(VOID)
+{
+    NTSTATUS                        Status;
+    HANDLE                          KeyHandle;
+    OBJECT_ATTRIBUTES               ObjectAttributes;
+    KEY_FULL_INFORMATION            KeyFullInfo;
     ULONG                           i, Length;
     UNICODE_STRING                  FontTitleW, FileNameW;
     SIZE_T                          InfoSize;
@@ -2509,8 +3132,14 @@ IntLoadFontsInRegistry(VOID)
     PKEY_VALUE_FULL_INFORMATION     pInfo;
     LPWSTR                          pchPath;
     WCHAR                           szPath[MAX_PATH];
-    INT                             nFontCount = 0;
+    INT                             nFontCount = 0, nCount;
     DWORD                           dwFlags;
+    LIST_ENTRY                      CatalogListHead, NewCatalogListHead;
+    PLIST_ENTRY                     Entry;
+    PFONT_CATALOG_FILE              CatalogFile;
+    LARGE_INTEGER                   FileSize, LastWriteTime;
+    ULONG                           FirstSequence;
+    BOOL                            bCatalogChanged;
 
     /* open registry key */
     InitializeObjectAttributes(&ObjectAttributes, &g_FontRegPath,
@@ -2543,6 +3172,11 @@ IntLoadFontsInRegistry(VOID)
         return FALSE;
     }
 
+    /* The font files that did not change since the last time are not opened */
+    InitializeListHead(&CatalogListHead);
+    InitializeListHead(&NewCatalogListHead);
+    bCatalogChanged = !NT_SUCCESS(FontCatalog_Load(&CatalogListHead, gusLanguageID));
+
     /* for each value */
     for (i = 0; i < KeyFullInfo.Values; ++i)
     {
@@ -2628,7 +3262,30 @@ IntLoadFontsInRegistry(VOID)
         if (NT_SUCCESS(Status))
         {
             RtlCreateUnicodeString(&FileNameW, szPath);
-            nFontCount += IntGdiAddFontResourceEx(&FileNameW, 1, 0, dwFlags);
+            CatalogFile = IntTakeCatalogFontFile(&CatalogListHead, &FileNameW, dwFlags);
+            if (CatalogFile)
+            {
+                InsertTailList(&NewCatalogListHead, &CatalogFile->ListEntry);
+                nFontCount += (INT)CatalogFile->EntryCount;
+            }
+            else
+            {
+                bCatalogChanged = TRUE;
+                Status = FontCatalog_QueryFile(&FileNameW, dwFlags, &FileSize, &LastWriteTime);
+                FirstSequence = g_FontEntrySequence + 1;
+                nCount = IntGdiAddFontResourceSingle(&FileNameW, 0, dwFlags, NULL);
+                nFontCount += nCount;
+                if (nCount > 0 && NT_SUCCESS(Status))
+                {
+                    CatalogFile = IntCatalogLoadedFontFile(&FileNameW, dwFlags, FirstSequence);
+                    if (CatalogFile)
+                    {
+                        CatalogFile->FileSize = FileSize;
+                        CatalogFile->LastWriteTime = LastWriteTime;
+                        InsertTailList(&NewCatalogListHead, &CatalogFile->ListEntry);
+                    }
+                }
+            }
             RtlFreeUnicodeString(&FileNameW);
         }
 
@@ -2644,6 +3301,31 @@ IntLoadFontsInRegistry(VOID)
         ExFreePoolWithTag(InfoBuffer, TAG_FONT);
     }
 
+    /* Forget the font files that are no longer registered */
+    if (!IsListEmpty(&CatalogListHead))
+        bCatalogChanged = TRUE;
+    FontCatalog_FreeList(&CatalogListHead);
+
+    if (bCatalogChanged)
+        FontCatalog_Save(&NewCatalogListHead, gusLanguageID);
+
+    /* Keep the records of the files that are not loaded yet */
+    while (!IsListEmpty(&NewCatalogListHead))
+    {
+        Entry = RemoveHeadList(&NewCatalogListHead);
+        CatalogFile = CONTAINING_RECORD(Entry, FONT_CATALOG_FILE, ListEntry);
+        if (CatalogFile->Pending)
+        {
+            IntLockFreeType();
+            InsertTailList(&g_PendingFontListHead, &CatalogFile->ListEntry);
+            IntUnLockFreeType();
+        }
+        else
+        {
+            FontCatalog_FreeFile(CatalogFile);
+        }
+    }
+
     return (KeyFullInfo.Values != 0 && nFontCount != 0);
 }
 
@@ -3943,6 +4625,21 @@ GetFontFamilyInfoForSubstitutes(const LOGFONTW *LogFont,
     return TRUE;
 }
 
+/*
+ * Called from the KDBG extension, where the FreeType lock cannot be taken.
+ * The counters are read without it, they may be slightly out of step.
+ */
+VOID
+FASTCALL
+IntGetFontCacheStatistics(_Out_ PFONT_CACHE_STATISTICS Statistics)
+{
+    Statistics->Entries = g_FontCacheNumEntries;
+    Statistics->Bytes = g_FontCacheNumBytes;
+    Statistics->Hits = g_FontCacheHits;
+    Statistics->Misses = g_FontCacheMisses;
+    Statistics->Evictions = g_FontCacheEvictions;
+}
+
 BOOL
 FASTCALL
 ftGdiGetRasterizerCaps(LPRASTERIZER_STATUS lprs)
@@ -3973,20 +4670,27 @@ IntGetHash(IN LPCVOID pv, IN DWORD cdw)
     return dwHash;
 }
 
+static inline PLIST_ENTRY
+IntGetGlyphCacheBucket(IN DWORD dwHash)
+{
+    return &g_FontCacheHashTable[dwHash & (FONT_CACHE_HASH_BUCKETS - 1)];
+}
+
 static FT_BitmapGlyph
 IntFindGlyphCache(IN const FONT_CACHE_ENTRY *pCache)
 {
-    PLIST_ENTRY CurrentEntry;
+    PLIST_ENTRY CurrentEntry, BucketHead;
     PFONT_CACHE_ENTRY FontEntry;
     DWORD dwHash = pCache->dwHash;
 
     ASSERT_FREETYPE_LOCK_HELD();
 
-    for (CurrentEntry = g_FontCacheListHead.Flink;
-         CurrentEntry != &g_FontCacheListHead;
+    BucketHead = IntGetGlyphCacheBucket(dwHash);
+    for (CurrentEntry = BucketHead->Flink;
+         CurrentEntry != BucketHead;
          CurrentEntry = CurrentEntry->Flink)
     {
-        FontEntry = CONTAINING_RECORD(CurrentEntry, FONT_CACHE_ENTRY, ListEntry);
+        FontEntry = CONTAINING_RECORD(CurrentEntry, FONT_CACHE_ENTRY, HashEntry);
         if (FontEntry->dwHash == dwHash &&
             FontEntry->Hashed.GlyphIndex == pCache->Hashed.GlyphIndex &&
             FontEntry->Hashed.Face == pCache->Hashed.Face &&
@@ -4000,13 +4704,18 @@ IntFindGlyphCache(IN const FONT_CACHE_ENTRY *pCache)
         }
     }
 
-    if (CurrentEntry == &g_FontCacheListHead)
+    if (CurrentEntry == BucketHead)
     {
+        g_FontCacheMisses++;
         return NULL;
     }
 
-    RemoveEntryList(CurrentEntry);
-    InsertHeadList(&g_FontCacheListHead, CurrentEntry);
+    g_FontCacheHits++;
+    FontEntry->HitCount++;
+
+    /* Move it to the front of the LRU list */
+    RemoveEntryList(&FontEntry->ListEntry);
+    InsertHeadList(&g_FontCacheListHead, &FontEntry->ListEntry);
     return FontEntry->BitmapGlyph;
 }
 
@@ -4062,14 +4771,23 @@ IntGetBitmapGlyphWithCache(
     BitmapGlyph->bitmap = AlignedBitmap;
 
     NewEntry->BitmapGlyph = BitmapGlyph;
+    NewEntry->cbSize = sizeof(FONT_CACHE_ENTRY) + sizeof(FT_BitmapGlyphRec) +
+                       (SIZE_T)abs(AlignedBitmap.pitch) * AlignedBitmap.rows;
+    NewEntry->HitCount = 0;
     NewEntry->dwHash = Cache->dwHash;
     NewEntry->Hashed = Cache->Hashed;
 
     InsertHeadList(&g_FontCacheListHead, &NewEntry->ListEntry);
-    if (++g_FontCacheNumEntries > MAX_FONT_CACHE)
+    InsertHeadList(IntGetGlyphCacheBucket(NewEntry->dwHash), &NewEntry->HashEntry);
+    g_FontCacheNumEntries++;
+    g_FontCacheNumBytes += NewEntry->cbSize;
+
+    /* Evict the least recently used glyphs, but never the one we return */
+    while (g_FontCacheNumBytes > MAX_FONT_CACHE_BYTES && g_FontCacheNumEntries > 1)
     {
         NewEntry = CONTAINING_RECORD(g_FontCacheListHead.Blink, FONT_CACHE_ENTRY, ListEntry);
         RemoveCachedEntry(NewEntry);
+        g_FontCacheEvictions++;
     }
 
     return BitmapGlyph;
@@ -5599,30 +6317,24 @@ ftGdiGetFontData(
 
 #define GOT_PENALTY(name, value) Penalty += (value)
 
-// NOTE: See Table 1. of https://learn.microsoft.com/en-us/previous-versions/ms969909(v=msdn.10)
+/*
+ * The penalties of GetFontPenalty() that do not depend on the size of the
+ * candidate. A face whose names are unknown gets no FaceName penalty, which
+ * keeps the result a lower bound of GetFontPenalty() for the faces of the
+ * font catalog.
+ */
 static UINT
-GetFontPenalty(const LOGFONTW *               LogFont,
-               const OUTLINETEXTMETRICW *     Otm,
-               const char *             style_name)
+GetFontStylePenalty(const LOGFONTW *LogFont, const FONT_STYLE *Style)
 {
     ULONG   Penalty = 0;
     BYTE    Byte;
     LONG    Long;
-    BOOL    fNeedScaling = FALSE;
     const BYTE UserCharSet = CharSetFromLangID(gusLanguageID);
-    const TEXTMETRICW * TM = &Otm->otmTextMetrics;
-    WCHAR* ActualNameW;
-
-    ASSERT(Otm);
-    ASSERT(LogFont);
-
-    /* FIXME: IntSizeSynth Penalty 20 */
-    /* FIXME: SmallPenalty Penalty 1 */
-    /* FIXME: FaceNameSubst Penalty 500 */
+    const BYTE PitchAndFamily = Style->PitchAndFamily;
 
     Byte = LogFont->lfCharSet;
 
-    if (Byte != TM->tmCharSet)
+    if (Byte != Style->CharSet)
     {
         if (Byte != DEFAULT_CHARSET && Byte != ANSI_CHARSET)
         {
@@ -5632,12 +6344,12 @@ GetFontPenalty(const LOGFONTW *               LogFont,
         }
         else
         {
-            if (UserCharSet != TM->tmCharSet)
+            if (UserCharSet != Style->CharSet)
             {
                 /* UNDOCUMENTED: Not user language */
                 GOT_PENALTY("UNDOCUMENTED:NotUserLanguage", 100);
 
-                if (ANSI_CHARSET != TM->tmCharSet)
+                if (ANSI_CHARSET != Style->CharSet)
                 {
                     /* UNDOCUMENTED: Not ANSI charset */
                     GOT_PENALTY("UNDOCUMENTED:NotAnsiCharSet", 100);
@@ -5653,8 +6365,8 @@ GetFontPenalty(const LOGFONTW *               LogFont,
             /* nothing to do */
             break;
         case OUT_DEVICE_PRECIS:
-            if (!(TM->tmPitchAndFamily & TMPF_DEVICE) ||
-                !(TM->tmPitchAndFamily & (TMPF_VECTOR | TMPF_TRUETYPE)))
+            if (!(PitchAndFamily & TMPF_DEVICE) ||
+                !(PitchAndFamily & (TMPF_VECTOR | TMPF_TRUETYPE)))
             {
                 /* OutputPrecision Penalty 19000 */
                 /* Requested OUT_STROKE_PRECIS, but the device can't do it
@@ -5663,7 +6375,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
             }
             break;
         default:
-            if (TM->tmPitchAndFamily & (TMPF_VECTOR | TMPF_TRUETYPE))
+            if (PitchAndFamily & (TMPF_VECTOR | TMPF_TRUETYPE))
             {
                 /* OutputPrecision Penalty 19000 */
                 /* Or OUT_STROKE_PRECIS not requested, and the candidate
@@ -5678,7 +6390,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
         Byte = VARIABLE_PITCH;
     if (Byte == FIXED_PITCH)
     {
-        if (TM->tmPitchAndFamily & _TMPF_VARIABLE_PITCH)
+        if (PitchAndFamily & _TMPF_VARIABLE_PITCH)
         {
             /* FixedPitch Penalty 15000 */
             /* Requested a fixed pitch font, but the candidate is a
@@ -5688,7 +6400,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
     }
     if (Byte == VARIABLE_PITCH)
     {
-        if (!(TM->tmPitchAndFamily & _TMPF_VARIABLE_PITCH))
+        if (!(PitchAndFamily & _TMPF_VARIABLE_PITCH))
         {
             /* PitchVariable Penalty 350 */
             /* Requested a variable pitch font, but the candidate is not a
@@ -5700,7 +6412,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
     Byte = (LogFont->lfPitchAndFamily & 0x0F);
     if (Byte == DEFAULT_PITCH)
     {
-        if (!(TM->tmPitchAndFamily & _TMPF_VARIABLE_PITCH))
+        if (!(PitchAndFamily & _TMPF_VARIABLE_PITCH))
         {
             /* DefaultPitchFixed Penalty 1 */
             /* Requested DEFAULT_PITCH, but the candidate is fixed pitch. */
@@ -5708,22 +6420,20 @@ GetFontPenalty(const LOGFONTW *               LogFont,
         }
     }
 
-    ActualNameW = (WCHAR*)((ULONG_PTR)Otm + (ULONG_PTR)Otm->otmpFamilyName);
-
-    if (LogFont->lfFaceName[0] != UNICODE_NULL)
+    if (LogFont->lfFaceName[0] != UNICODE_NULL &&
+        Style->FamilyName && Style->FullName)
     {
         BOOL Found = FALSE;
 
         /* localized family name */
         if (!Found)
         {
-            Found = (_wcsicmp(LogFont->lfFaceName, ActualNameW) == 0);
+            Found = (_wcsicmp(LogFont->lfFaceName, Style->FamilyName) == 0);
         }
         /* localized full name */
         if (!Found)
         {
-            ActualNameW = (WCHAR*)((ULONG_PTR)Otm + (ULONG_PTR)Otm->otmpFaceName);
-            Found = (_wcsicmp(LogFont->lfFaceName, ActualNameW) == 0);
+            Found = (_wcsicmp(LogFont->lfFaceName, Style->FullName) == 0);
         }
         if (!Found)
         {
@@ -5737,7 +6447,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
     Byte = (LogFont->lfPitchAndFamily & 0xF0);
     if (Byte != FF_DONTCARE)
     {
-        if (Byte != (TM->tmPitchAndFamily & 0xF0))
+        if (Byte != (PitchAndFamily & 0xF0))
         {
             /* Family Penalty 9000 */
             /* Requested a family, but the candidate's family is different. */
@@ -5745,48 +6455,17 @@ GetFontPenalty(const LOGFONTW *               LogFont,
         }
     }
 
-    if ((TM->tmPitchAndFamily & 0xF0) == FF_DONTCARE)
+    if ((PitchAndFamily & 0xF0) == FF_DONTCARE)
     {
         /* FamilyUnknown Penalty 8000 */
         /* Requested a family, but the candidate has no family. */
         GOT_PENALTY("FamilyUnknown", 8000);
     }
 
-    /* Is the candidate a non-vector font? */
-    if (!(TM->tmPitchAndFamily & (TMPF_TRUETYPE | TMPF_VECTOR)))
-    {
-        /* Is lfHeight specified? */
-        if (LogFont->lfHeight != 0)
-        {
-            if (labs(LogFont->lfHeight) < TM->tmHeight)
-            {
-                /* HeightBigger Penalty 600 */
-                /* The candidate is a nonvector font and is bigger than the
-                   requested height. */
-                GOT_PENALTY("HeightBigger", 600);
-                /* HeightBiggerDifference Penalty 150 */
-                /* The candidate is a raster font and is larger than the
-                   requested height. Penalty * height difference */
-                GOT_PENALTY("HeightBiggerDifference", 150 * labs(TM->tmHeight - labs(LogFont->lfHeight)));
-
-                fNeedScaling = TRUE;
-            }
-            if (TM->tmHeight < labs(LogFont->lfHeight))
-            {
-                /* HeightSmaller Penalty 150 */
-                /* The candidate is a raster font and is smaller than the
-                   requested height. Penalty * height difference */
-                GOT_PENALTY("HeightSmaller", 150 * labs(TM->tmHeight - labs(LogFont->lfHeight)));
-
-                fNeedScaling = TRUE;
-            }
-        }
-    }
-
     switch (LogFont->lfPitchAndFamily & 0xF0)
     {
         case FF_ROMAN: case FF_MODERN: case FF_SWISS:
-            switch (TM->tmPitchAndFamily & 0xF0)
+            switch (PitchAndFamily & 0xF0)
             {
                 case FF_DECORATIVE: case FF_SCRIPT:
                     /* FamilyUnlikely Penalty 50 */
@@ -5799,7 +6478,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
             }
             break;
         case FF_DECORATIVE: case FF_SCRIPT:
-            switch (TM->tmPitchAndFamily & 0xF0)
+            switch (PitchAndFamily & 0xF0)
             {
                 case FF_ROMAN: case FF_MODERN: case FF_SWISS:
                     /* FamilyUnlikely Penalty 50 */
@@ -5814,28 +6493,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
             break;
     }
 
-    if (LogFont->lfWidth != 0)
-    {
-        if (LogFont->lfWidth != TM->tmAveCharWidth)
-        {
-            /* Width Penalty 50 */
-            /* Requested a nonzero width, but the candidate's width
-               doesn't match. Penalty * width difference */
-            GOT_PENALTY("Width", 50 * labs(LogFont->lfWidth - TM->tmAveCharWidth));
-
-            if (!(TM->tmPitchAndFamily & (TMPF_TRUETYPE | TMPF_VECTOR)))
-                fNeedScaling = TRUE;
-        }
-    }
-
-    if (fNeedScaling)
-    {
-        /* SizeSynth Penalty 50 */
-        /* The candidate is a raster font that needs scaling by GDI. */
-        GOT_PENALTY("SizeSynth", 50);
-    }
-
-    if (!LogFont->lfItalic && TM->tmItalic)
+    if (!LogFont->lfItalic && Style->Italic)
     {
         /* Italic Penalty 4 */
         /* Requested font and candidate font do not agree on italic status,
@@ -5843,7 +6501,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
         /* Adjusted to 40 to satisfy (Oblique Penalty > Book Penalty). */
         GOT_PENALTY("Italic", 40);
     }
-    else if (LogFont->lfItalic && !TM->tmItalic)
+    else if (LogFont->lfItalic && !Style->Italic)
     {
         /* ItalicSim Penalty 1 */
         /* Requested italic font but the candidate is not italic,
@@ -5853,7 +6511,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
 
     if (LogFont->lfOutPrecision == OUT_TT_PRECIS)
     {
-        if (!(TM->tmPitchAndFamily & TMPF_TRUETYPE))
+        if (!(PitchAndFamily & TMPF_TRUETYPE))
         {
             /* NotTrueType Penalty 4 */
             /* Requested OUT_TT_PRECIS, but the candidate is not a
@@ -5865,15 +6523,15 @@ GetFontPenalty(const LOGFONTW *               LogFont,
     Long = LogFont->lfWeight;
     if (LogFont->lfWeight == FW_DONTCARE)
         Long = FW_NORMAL;
-    if (Long != TM->tmWeight)
+    if (Long != Style->Weight)
     {
         /* Weight Penalty 3 */
         /* The candidate's weight does not match the requested weight.
            Penalty * (weight difference/10) */
-        GOT_PENALTY("Weight", 3 * (labs(Long - TM->tmWeight) / 10));
+        GOT_PENALTY("Weight", 3 * (labs(Long - Style->Weight) / 10));
     }
 
-    if (!LogFont->lfUnderline && TM->tmUnderlined)
+    if (!LogFont->lfUnderline && Style->Underlined)
     {
         /* Underline Penalty 3 */
         /* Requested font has no underline, but the candidate is
@@ -5881,7 +6539,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
         GOT_PENALTY("Underline", 3);
     }
 
-    if (!LogFont->lfStrikeOut && TM->tmStruckOut)
+    if (!LogFont->lfStrikeOut && Style->StruckOut)
     {
         /* StrikeOut Penalty 3 */
         /* Requested font has no strike-out, but the candidate is
@@ -5889,6 +6547,104 @@ GetFontPenalty(const LOGFONTW *               LogFont,
         GOT_PENALTY("StrikeOut", 3);
     }
 
+    if (!(PitchAndFamily & TMPF_DEVICE))
+    {
+        /* DeviceFavor Penalty 2 */
+        /* Extra penalty for all nondevice fonts. */
+        GOT_PENALTY("DeviceFavor", 2);
+    }
+
+    return Penalty;
+}
+
+static VOID
+IntGetFontStyle(_Out_ PFONT_STYLE Style, _In_ const OUTLINETEXTMETRICW *Otm)
+{
+    const TEXTMETRICW *TM = &Otm->otmTextMetrics;
+
+    Style->CharSet = TM->tmCharSet;
+    Style->PitchAndFamily = TM->tmPitchAndFamily;
+    Style->Italic = TM->tmItalic;
+    Style->Underlined = TM->tmUnderlined;
+    Style->StruckOut = TM->tmStruckOut;
+    Style->Weight = TM->tmWeight;
+    Style->FamilyName = (PCWSTR)((ULONG_PTR)Otm + (ULONG_PTR)Otm->otmpFamilyName);
+    Style->FullName = (PCWSTR)((ULONG_PTR)Otm + (ULONG_PTR)Otm->otmpFaceName);
+}
+
+// NOTE: See Table 1. of https://learn.microsoft.com/en-us/previous-versions/ms969909(v=msdn.10)
+static UINT
+GetFontPenalty(const LOGFONTW *               LogFont,
+               const OUTLINETEXTMETRICW *     Otm,
+               const char *             style_name)
+{
+    ULONG   Penalty;
+    BOOL    fNeedScaling = FALSE;
+    const TEXTMETRICW * TM = &Otm->otmTextMetrics;
+    FONT_STYLE Style;
+
+    ASSERT(Otm);
+    ASSERT(LogFont);
+
+    /* FIXME: IntSizeSynth Penalty 20 */
+    /* FIXME: SmallPenalty Penalty 1 */
+    /* FIXME: FaceNameSubst Penalty 500 */
+
+    IntGetFontStyle(&Style, Otm);
+    Penalty = GetFontStylePenalty(LogFont, &Style);
+
+    /* Is the candidate a non-vector font? */
+    if (!(TM->tmPitchAndFamily & (TMPF_TRUETYPE | TMPF_VECTOR)))
+    {
+        /* Is lfHeight specified? */
+        if (LogFont->lfHeight != 0)
+        {
+            if (labs(LogFont->lfHeight) < TM->tmHeight)
+            {
+                /* HeightBigger Penalty 600 */
+                /* The candidate is a nonvector font and is bigger than the
+                   requested height. */
+                GOT_PENALTY("HeightBigger", 600);
+                /* HeightBiggerDifference Penalty 150 */
+                /* The candidate is a raster font and is larger than the
+                   requested height. Penalty * height difference */
+                GOT_PENALTY("HeightBiggerDifference", 150 * labs(TM->tmHeight - labs(LogFont->lfHeight)));
+
+                fNeedScaling = TRUE;
+            }
+            if (TM->tmHeight < labs(LogFont->lfHeight))
+            {
+                /* HeightSmaller Penalty 150 */
+                /* The candidate is a raster font and is smaller than the
+                   requested height. Penalty * height difference */
+                GOT_PENALTY("HeightSmaller", 150 * labs(TM->tmHeight - labs(LogFont->lfHeight)));
+
+                fNeedScaling = TRUE;
+            }
+        }
+    }
+
+    if (LogFont->lfWidth != 0)
+    {
+        if (LogFont->lfWidth != TM->tmAveCharWidth)
+        {
+            /* Width Penalty 50 */
+            /* Requested a nonzero width, but the candidate's width
+               doesn't match. Penalty * width difference */
+            GOT_PENALTY("Width", 50 * labs(LogFont->lfWidth - TM->tmAveCharWidth));
+
+            if (!(TM->tmPitchAndFamily & (TMPF_TRUETYPE | TMPF_VECTOR)))
+                fNeedScaling = TRUE;
+        }
+    }
+
+    if (fNeedScaling)
+    {
+        /* SizeSynth Penalty 50 */
+        /* The candidate is a raster font that needs scaling by GDI. */
+        GOT_PENALTY("SizeSynth", 50);
+    }
+
     /* Is the candidate a non-vector font? */
     if (!(TM->tmPitchAndFamily & (TMPF_TRUETYPE | TMPF_VECTOR)))
     {
@@ -5908,13 +6664,6 @@ GetFontPenalty(const LOGFONTW *               LogFont,
         }
     }
 
-    if (!(TM->tmPitchAndFamily & TMPF_DEVICE))
-    {
-        /* DeviceFavor Penalty 2 */
-        /* Extra penalty for all nondevice fonts. */
-        GOT_PENALTY("DeviceFavor", 2);
-    }
-
     if (TM->tmAveCharWidth >= 5 && TM->tmHeight >= 5)
     {
         if (TM->tmAveCharWidth / TM->tmHeight >= 3)
@@ -5936,7 +6685,7 @@ GetFontPenalty(const LOGFONTW *               LogFont,
         DPRINT("WARNING: Penalty:%ld < 200: RequestedNameW:%ls, "
             "ActualNameW:%ls, lfCharSet:%d, lfWeight:%ld, "
             "tmCharSet:%d, tmWeight:%ld\n",
-            Penalty, LogFont->lfFaceName, ActualNameW,
+            Penalty, LogFont->lfFaceName, Style.FamilyName,
             LogFont->lfCharSet, LogFont->lfWeight,
             TM->tmCharSet, TM->tmWeight);
     }
@@ -5946,71 +6695,272 @@ GetFontPenalty(const LOGFONTW *               LogFont,
 
 #undef GOT_PENALTY
 
+/*
+ * The part of GetFontPenalty() that only depends on the charset and the names
+ * of the font, which are known without setting the size of the face. Nothing
+ * else GetFontPenalty() adds is negative, so a font whose lower bound is not
+ * better than the best penalty so far cannot win and need not be scored.
+ */
+static UINT
+IntGetFontPenaltyLowerBound(const LOGFONTW *LogFont, const FONT_ENTRY *FontEntry)
+{
+    UINT Penalty = 0;
+    const BYTE CharSet = FontEntry->Font->CharSet;
+
+    if (LogFont->lfCharSet != CharSet)
+    {
+        if (LogFont->lfCharSet != DEFAULT_CHARSET && LogFont->lfCharSet != ANSI_CHARSET)
+        {
+            Penalty += 65000;
+        }
+        else if (CharSetFromLangID(gusLanguageID) != CharSet)
+        {
+            Penalty += 100;
+            if (CharSet != ANSI_CHARSET)
+                Penalty += 100;
+        }
+    }
+
+    /* Without its names, nothing is known of the face name penalty */
+    if (LogFont->lfFaceName[0] != UNICODE_NULL &&
+        FontEntry->LocalFamilyName && FontEntry->LocalFullName &&
+        _wcsicmp(LogFont->lfFaceName, FontEntry->LocalFamilyName) != 0 &&
+        _wcsicmp(LogFont->lfFaceName, FontEntry->LocalFullName) != 0)
+    {
+        Penalty += 10000;
+    }
+
+    return Penalty;
+}
+
+typedef struct _FONT_MATCH
+{
+    FONTOBJ *FontObj;
+    ULONG MatchPenalty;
+    ULONG Sequence;         /* Of the best font, 0 if it comes from a previous list */
+    OUTLINETEXTMETRICW *Otm;
+    UINT OtmSize;
+} FONT_MATCH, *PFONT_MATCH;
+
+/*
+ * Fonts are not scored in the order of their list, so ties are broken by
+ * their sequence to keep the font that comes first, as a plain walk would.
+ */
+static inline BOOL
+IntIsBetterFontMatch(PFONT_MATCH Match, ULONG Penalty, ULONG Sequence)
+{
+    return Match->MatchPenalty == MAXULONG || Penalty < Match->MatchPenalty ||
+           (Penalty == Match->MatchPenalty && Sequence < Match->Sequence);
+}
+
+static VOID
+IntScoreFontEntry(PFONT_MATCH Match, const LOGFONTW *LogFont, PFONT_ENTRY FontEntry)
+{
+    FONTGDI *FontGDI = FontEntry->Font;
+    UINT OtmSize;
+    ULONG Penalty;
+
+    ASSERT(FontGDI);
+    ASSERT_FREETYPE_LOCK_HELD();
+
+    /* get text metrics */
+    OtmSize = IntGetOutlineTextMetrics(FontGDI, 0, NULL, TRUE);
+    if (OtmSize > Match->OtmSize)
+    {
+        if (Match->Otm)
+            ExFreePoolWithTag(Match->Otm, GDITAG_TEXT);
+        Match->Otm = ExAllocatePoolWithTag(PagedPool, OtmSize, GDITAG_TEXT);
+        Match->OtmSize = Match->Otm ? OtmSize : 0;
+    }
+    if (!Match->Otm)
+        return;
+
+    IntRequestFontSize(NULL, FontGDI, LogFont->lfWidth, LogFont->lfHeight);
+
+    OtmSize = IntGetOutlineTextMetrics(FontGDI, Match->OtmSize, Match->Otm, TRUE);
+    if (!OtmSize)
+        return;
+
+    /* update FontObj if lowest penalty */
+    Penalty = GetFontPenalty(LogFont, Match->Otm, FontGDI->SharedFace->Face->style_name);
+    if (IntIsBetterFontMatch(Match, Penalty, FontEntry->Sequence))
+    {
+        Match->FontObj = GDIToObj(FontGDI, FONT);
+        Match->MatchPenalty = Penalty;
+        Match->Sequence = FontEntry->Sequence;
+    }
+}
+
 static __inline VOID
-FindBestFontFromList(FONTOBJ **FontObj, ULONG *MatchPenalty,
+FindBestFontFromList(PFONT_MATCH Match,
                      const LOGFONTW *LogFont,
                      const PLIST_ENTRY Head)
 {
-    ULONG Penalty;
-    PLIST_ENTRY Entry;
+    PLIST_ENTRY Entry, Bucket;
+    PFONT_NAME_LINK Link;
     PFONT_ENTRY CurrentEntry;
-    FONTGDI *FontGDI;
-    OUTLINETEXTMETRICW *Otm = NULL;
-    UINT OtmSize, OldOtmSize = 0;
-    FT_Face Face;
+    UINT LowerBound;
 
-    ASSERT(FontObj);
-    ASSERT(MatchPenalty);
+    ASSERT(Match);
     ASSERT(LogFont);
     ASSERT(Head);
+    ASSERT_FREETYPE_LOCK_HELD();
 
-    /* Start with a pretty big buffer */
-    OldOtmSize = 0x200;
-    Otm = ExAllocatePoolWithTag(PagedPool, OldOtmSize, GDITAG_TEXT);
+    /* Score the global fonts of the requested name first, they set the bar for the others */
+    if (Head == &g_FontListHead && LogFont->lfFaceName[0] != UNICODE_NULL)
+    {
+        Bucket = IntGetFontNameBucket(LogFont->lfFaceName);
+        for (Entry = Bucket->Flink; Entry != Bucket; Entry = Entry->Flink)
+        {
+            Link = CONTAINING_RECORD(Entry, FONT_NAME_LINK, HashEntry);
+            CurrentEntry = Link->FontEntry;
+            if (CurrentEntry->Scored)
+                continue;
+            if (_wcsicmp(LogFont->lfFaceName, (Link == &CurrentEntry->NameLinks[0]) ?
+                         CurrentEntry->LocalFamilyName : CurrentEntry->LocalFullName) != 0)
+            {
+                continue;   /* only the same bucket */
+            }
+
+            CurrentEntry->Scored = TRUE;
+            IntScoreFontEntry(Match, LogFont, CurrentEntry);
+        }
+    }
 
     /* get the FontObj of lowest penalty */
     for (Entry = Head->Flink; Entry != Head; Entry = Entry->Flink)
     {
         CurrentEntry = CONTAINING_RECORD(Entry, FONT_ENTRY, ListEntry);
 
-        FontGDI = CurrentEntry->Font;
-        ASSERT(FontGDI);
-        Face = FontGDI->SharedFace->Face;
-
-        /* get text metrics */
-        ASSERT_FREETYPE_LOCK_HELD();
-        OtmSize = IntGetOutlineTextMetrics(FontGDI, 0, NULL, TRUE);
-        if (OtmSize > OldOtmSize)
+        if (CurrentEntry->Scored)
         {
-            if (Otm)
-                ExFreePoolWithTag(Otm, GDITAG_TEXT);
-            Otm = ExAllocatePoolWithTag(PagedPool, OtmSize, GDITAG_TEXT);
+            CurrentEntry->Scored = FALSE;
+            continue;
         }
 
-        /* update FontObj if lowest penalty */
-        if (Otm)
-        {
-            ASSERT_FREETYPE_LOCK_HELD();
-            IntRequestFontSize(NULL, FontGDI, LogFont->lfWidth, LogFont->lfHeight);
+        LowerBound = IntGetFontPenaltyLowerBound(LogFont, CurrentEntry);
+        if (!IntIsBetterFontMatch(Match, LowerBound, CurrentEntry->Sequence))
+            continue;
 
-            ASSERT_FREETYPE_LOCK_HELD();
-            OtmSize = IntGetOutlineTextMetrics(FontGDI, OtmSize, Otm, TRUE);
-            if (!OtmSize)
-                continue;
+        IntScoreFontEntry(Match, LogFont, CurrentEntry);
+    }
+}
+
+/*
+ * Asks for the catalogued font files that have a face that could beat the
+ * best match among the loaded fonts, see IntLoadPendingFonts(). The faces of
+ * a file that was never loaded were never realized, so their style is the
+ * one the catalog recorded and GetFontStylePenalty() is a lower bound of
+ * their penalty.
+ */
+static BOOL
+IntRequestPendingFonts(PFONT_MATCH Match, const LOGFONTW *LogFont)
+{
+    PLIST_ENTRY Entry;
+    PFONT_CATALOG_FILE File;
+    PFONT_CATALOG_ENTRY CatalogEntry;
+    FONT_STYLE Style;
+    BOOL bRequested = FALSE;
+    ULONG i;
+
+    ASSERT_FREETYPE_LOCK_HELD();
 
-            OldOtmSize = OtmSize;
+    for (Entry = g_PendingFontListHead.Flink; Entry != &g_PendingFontListHead; Entry = Entry->Flink)
+    {
+        File = CONTAINING_RECORD(Entry, FONT_CATALOG_FILE, ListEntry);
+        for (i = 0; i < File->EntryCount; ++i)
+        {
+            CatalogEntry = &File->Entries[i];
+            Style.CharSet = CatalogEntry->CharSet;
+            Style.PitchAndFamily = CatalogEntry->PitchAndFamily;
+            Style.Italic = CatalogEntry->Italic;
+            Style.Underlined = CatalogEntry->Underlined;
+            Style.StruckOut = CatalogEntry->StruckOut;
+            Style.Weight = CatalogEntry->Weight;
+            Style.FamilyName = CatalogEntry->FamilyName;
+            Style.FullName = CatalogEntry->FullName;
 
-            Penalty = GetFontPenalty(LogFont, Otm, Face->style_name);
-            if (*MatchPenalty == MAXULONG || Penalty < *MatchPenalty)
+            if (IntIsBetterFontMatch(Match, GetFontStylePenalty(LogFont, &Style),
+                                     File->FirstSequence + i))
             {
-                *FontObj = GDIToObj(FontGDI, FONT);
-                *MatchPenalty = Penalty;
+                File->LoadRequested = TRUE;
+                bRequested = TRUE;
+                break;
             }
         }
     }
 
-    if (Otm)
-        ExFreePoolWithTag(Otm, GDITAG_TEXT);
+    return bRequested;
+}
+
+/*
+ * Returns the font of lowest penalty for LogFont among the private fonts of
+ * Win32Process and the global fonts. The choice among the global fonts is
+ * remembered until a global font is added or removed. Processes that have
+ * private fonts always search, their choice depends on more than LogFont.
+ *
+ * If a catalogued font that is not loaded yet could be a better choice,
+ * *pbLoadPending is set and the caller should call IntLoadPendingFonts() and
+ * search again. FontLink passes NULL, it only links loaded fonts.
+ */
+static FONTOBJ *
+IntFindBestFont(_In_ const LOGFONTW *LogFont, _In_ PPROCESSINFO Win32Process,
+                _Out_opt_ PBOOL pbLoadPending)
+{
+    FONT_MATCH Match;
+    FONTOBJ *FontObj;
+    LOGFONTW Key;
+    DWORD dwHash;
+    BOOL bUseCache, bLoadPending;
+
+    ASSERT_FREETYPE_LOCK_HELD();
+
+    if (pbLoadPending)
+        *pbLoadPending = FALSE;
+
+    bUseCache = IsListEmpty(&Win32Process->PrivateFontListHead);
+    if (bUseCache)
+    {
+        IntGetFontMatchKey(&Key, LogFont);
+        dwHash = IntGetHash(&Key, sizeof(Key) / sizeof(DWORD));
+        FontObj = IntFindFontMatchCache(&Key, dwHash);
+        if (FontObj)
+            return FontObj;
+    }
+
+    Match.FontObj = NULL;
+    Match.MatchPenalty = MAXULONG;
+    Match.Sequence = 0;
+
+    /* Start with a pretty big buffer */
+    Match.OtmSize = 0x200;
+    Match.Otm = ExAllocatePoolWithTag(PagedPool, Match.OtmSize, GDITAG_TEXT);
+    if (!Match.Otm)
+        Match.OtmSize = 0;
+
+    if (!bUseCache)
+    {
+        FindBestFontFromList(&Match, LogFont, &Win32Process->PrivateFontListHead);
+        Match.Sequence = 0;
+    }
+
+    FindBestFontFromList(&Match, LogFont, &g_FontListHead);
+
+    if (Match.Otm)
+        ExFreePoolWithTag(Match.Otm, GDITAG_TEXT);
+
+    bLoadPending = IntRequestPendingFonts(&Match, LogFont);
+    if (bLoadPending)
+    {
+        if (pbLoadPending)
+            *pbLoadPending = TRUE;
+    }
+    else if (bUseCache && Match.FontObj)
+    {
+        IntAddFontMatchCache(&Key, dwHash, Match.FontObj);
+    }
+
+    return Match.FontObj;
 }
 
 static
@@ -6106,9 +7056,9 @@ TextIntRealizeFont(HFONT FontHandle, PTEXTOBJ pTextObj)
     NTSTATUS Status = STATUS_SUCCESS;
     PTEXTOBJ TextObj;
     PPROCESSINFO Win32Process;
-    ULONG MatchPenalty;
     LOGFONTW *pLogFont;
     LOGFONTW SubstitutedLogFont;
+    BOOL bLoadPending;
 
     if (!pTextObj)
     {
@@ -6138,22 +7088,23 @@ TextIntRealizeFont(HFONT FontHandle, PTEXTOBJ pTextObj)
            pLogFont->lfFaceName, pLogFont->lfCharSet,
            SubstitutedLogFont.lfFaceName, SubstitutedLogFont.lfCharSet);
 
-    MatchPenalty = 0xFFFFFFFF;
-    TextObj->Font = NULL;
-
     Win32Process = PsGetCurrentProcessWin32Process();
 
-    /* Search private fonts */
-    IntLockFreeType();
-    IntLockProcessPrivateFonts(Win32Process);
-    FindBestFontFromList(&TextObj->Font, &MatchPenalty, &SubstitutedLogFont,
-                         &Win32Process->PrivateFontListHead);
-    IntUnLockProcessPrivateFonts(Win32Process);
+    /* Search private fonts, then system fonts */
+    for (;;)
+    {
+        IntLockFreeType();
+        IntLockProcessPrivateFonts(Win32Process);
+        TextObj->Font = IntFindBestFont(&SubstitutedLogFont, Win32Process, &bLoadPending);
+        IntUnLockProcessPrivateFonts(Win32Process);
+        IntUnLockFreeType();
 
-    /* Search system fonts */
-    FindBestFontFromList(&TextObj->Font, &MatchPenalty, &SubstitutedLogFont,
-                         &g_FontListHead);
-    IntUnLockFreeType();
+        if (!bLoadPending)
+            break;
+
+        /* A catalogued font may do better, load it and search again */
+        IntLoadPendingFonts(FALSE);
+    }
 
     if (NULL == TextObj->Font)
     {
@@ -6312,6 +7263,9 @@ IntGdiGetFontResourceInfo(
 
     DPRINT("IntGdiGetFontResourceInfo: dwType == %lu\n", dwType);
 
+    /* The fonts of the file may not be loaded yet */
+    IntLoadPendingFonts(TRUE);
+
     do
     {
         /* Create buffer for full path name */
@@ -6637,6 +7591,9 @@ IntGetFontFamilyInfo(HDC Dc,
     LONG AvailCount = 0;
     PPROCESSINFO Win32Process;
 
+    /* Enumerating needs every font */
+    IntLoadPendingFonts(TRUE);
+
     /* Enumerate font families in the global list */
     IntLockFreeType();
     if (!GetFontFamilyInfoForList(SafeLogFont, SafeInfo, NULL, &AvailCount,
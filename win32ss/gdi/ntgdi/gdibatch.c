@@ -62,12 +62,46 @@ SynchronizeDriver(FLONG Flags)
   return;
 }
 
+//
+// Find the DC other than the batch DC that the blts of the batch read from,
+// gdi32 queues blts from at most one such DC per batch.
+//
+static
+HDC
+GdiGetBatchSourceDc(HDC hDC, PCHAR pHdr, ULONG GdiBatchCount)
+{
+  HDC hdcSrc = NULL;
+
+  _SEH2_TRY
+  {
+     for (; GdiBatchCount > 0; GdiBatchCount--)
+     {
+        PGDIBATCHHDR pgHdr = (PGDIBATCHHDR) pHdr;
+        if (!pgHdr->Size) break;
+        if ((pgHdr->Cmd == GdiBCBitBlt) || (pgHdr->Cmd == GdiBCStretchBlt))
+        {
+           hdcSrc = ((PGDIBSSTRETCHBLT) pgHdr)->hdcSrc;
+           if (hdcSrc != hDC) break;
+           hdcSrc = NULL;
+        }
+        pHdr += pgHdr->Size;
+     }
+  }
+  _SEH2_EXCEPT(EXCEPTION_EXECUTE_HANDLER)
+  {
+     hdcSrc = NULL;
+  }
+  _SEH2_END;
+
+  return hdcSrc;
+}
+
 //
 // Process the batch.
 //
 ULONG
 FASTCALL
-GdiFlushUserBatch(PDC dc, PGDIBATCHHDR pHdr)
+GdiFlushUserBatch(PDC dc, PDC pdcSrc, PGDIBATCHHDR pHdr)
 {
   ULONG Cmd = 0, Size = 0;
   PDC_ATTR pdcattr = NULL;
@@ -117,7 +151,7 @@ GdiFlushUserBatch(PDC dc, PGDIBATCHHDR pHdr)
         }
         // Save current attributes and flags
         crColor         = dc->pdcattr->crForegroundClr;
-        crBkColor       = dc->pdcattr->ulBackgroundClr;
+        crBkColor       = dc->pdcattr->crBackgroundClr;
         crBrushClr      = dc->pdcattr->crBrushClr;
         ulForegroundClr = dc->pdcattr->ulForegroundClr;
         ulBackgroundClr = dc->pdcattr->ulBackgroundClr;
@@ -182,7 +216,7 @@ GdiFlushUserBatch(PDC dc, PGDIBATCHHDR pHdr)
         }
         // Save current attributes and flags
         crColor         = dc->pdcattr->crForegroundClr;
-        crBkColor       = dc->pdcattr->ulBackgroundClr;
+        crBkColor       = dc->pdcattr->crBackgroundClr;
         crBrushClr      = dc->pdcattr->crBrushClr;
         ulForegroundClr = dc->pdcattr->ulForegroundClr;
         ulBackgroundClr = dc->pdcattr->ulBackgroundClr;
@@ -201,7 +235,6 @@ GdiFlushUserBatch(PDC dc, PGDIBATCHHDR pHdr)
         if (pdcattr->ulDirty_ & DIRTY_BACKGROUND)
             DC_vUpdateBackgroundBrush(dc);
 
-        DPRINT1("GdiBCPolyPatBlt Testing\n");
         pRects = &pgDPB->pRect[0];
 
         for (i = 0; i < pgDPB->Count; i++)
@@ -214,6 +247,12 @@ GdiFlushUserBatch(PDC dc, PGDIBATCHHDR pHdr)
                 /* Initialize a brush object */
                 EBRUSHOBJ_vInitFromDC(&eboFill, pbrush, dc);
 
+                /* The DC brush takes the snapshot color, as with PatBlt */
+                if (pRects->hBrush == StockObjects[DC_BRUSH])
+                {
+                    EBRUSHOBJ_vSetSolidRGBColor(&eboFill, dc->pdcattr->crBrushClr);
+                }
+
                 IntPatBlt(
                     dc,
                     pRects->r.left,
@@ -413,6 +452,116 @@ GdiFlushUserBatch(PDC dc, PGDIBATCHHDR pHdr)
         break;
      }
 
+     case GdiBCBitBlt:
+     case GdiBCStretchBlt:
+     {
+        PGDIBSSTRETCHBLT pgO;
+        PDC_ATTR pdcattrSrc;
+        HDC hdc;
+        COLORREF crColor, crBkColor, crSrcBkColor;
+        POINTL ptlWindowOrg, ptlViewportOrg;
+        SIZEL szlWindowExt, szlViewportExt;
+        BOOL bSrcXform = FALSE;
+        if (!dc) break;
+        pgO = (PGDIBSSTRETCHBLT) pHdr;
+        hdc = dc->BaseObject.hHmgr;
+
+        // The source DC is locked already, either it is the batch DC or the
+        // one NtGdiFlushUserBatch locked with it. Locking it again in
+        // NtGdiBitBlt and NtGdiStretchBlt is recursive.
+        if (pgO->hdcSrc == hdc)
+        {
+           pdcattrSrc = pdcattr;
+        }
+        else if (pdcSrc && (pgO->hdcSrc == pdcSrc->BaseObject.hHmgr))
+        {
+           pdcattrSrc = pdcSrc->pdcattr;
+        }
+        else
+        {
+           break;
+        }
+
+        // Save current attributes and set the attribute snapshot, these are
+        // the colors used to convert between monochrome and color bitmaps.
+        crColor   = pdcattr->crForegroundClr;
+        crBkColor = pdcattr->crBackgroundClr;
+        pdcattr->crForegroundClr = pgO->crForegroundClr;
+        pdcattr->crBackgroundClr = pgO->crBackgroundClr;
+        crSrcBkColor = pdcattrSrc->crBackgroundClr;
+        pdcattrSrc->crBackgroundClr = pgO->crSrcBackgroundClr;
+
+        // Changing the mapping of another source DC does not flush the batch,
+        // so it may have moved since the blt was queued.
+        if ((pdcattrSrc != pdcattr) &&
+            ((pdcattrSrc->ptlWindowOrg.x != pgO->ptlSrcWindowOrg.x) ||
+             (pdcattrSrc->ptlWindowOrg.y != pgO->ptlSrcWindowOrg.y) ||
+             (pdcattrSrc->szlWindowExt.cx != pgO->szlSrcWindowExt.cx) ||
+             (pdcattrSrc->szlWindowExt.cy != pgO->szlSrcWindowExt.cy) ||
+             (pdcattrSrc->ptlViewportOrg.x != pgO->ptlSrcViewportOrg.x) ||
+             (pdcattrSrc->ptlViewportOrg.y != pgO->ptlSrcViewportOrg.y) ||
+             (pdcattrSrc->szlViewportExt.cx != pgO->szlSrcViewportExt.cx) ||
+             (pdcattrSrc->szlViewportExt.cy != pgO->szlSrcViewportExt.cy)))
+        {
+           bSrcXform = TRUE;
+           ptlWindowOrg   = pdcattrSrc->ptlWindowOrg;
+           szlWindowExt   = pdcattrSrc->szlWindowExt;
+           ptlViewportOrg = pdcattrSrc->ptlViewportOrg;
+           szlViewportExt = pdcattrSrc->szlViewportExt;
+           pdcattrSrc->ptlWindowOrg   = pgO->ptlSrcWindowOrg;
+           pdcattrSrc->szlWindowExt   = pgO->szlSrcWindowExt;
+           pdcattrSrc->ptlViewportOrg = pgO->ptlSrcViewportOrg;
+           pdcattrSrc->szlViewportExt = pgO->szlSrcViewportExt;
+           pdcattrSrc->flXform |= (PAGE_XLATE_CHANGED | PAGE_EXTENTS_CHANGED |
+                                   WORLD_XFORM_CHANGED | DEVICE_TO_WORLD_INVALID);
+        }
+
+        if (Cmd == GdiBCBitBlt)
+        {
+            NtGdiBitBlt(hdc,
+                        pgO->xDest,
+                        pgO->yDest,
+                        pgO->cxDest,
+                        pgO->cyDest,
+                        pgO->hdcSrc,
+                        pgO->xSrc,
+                        pgO->ySrc,
+                        pgO->dwRop,
+                        0,
+                        0);
+        }
+        else
+        {
+            NtGdiStretchBlt(hdc,
+                            pgO->xDest,
+                            pgO->yDest,
+                            pgO->cxDest,
+                            pgO->cyDest,
+                            pgO->hdcSrc,
+                            pgO->xSrc,
+                            pgO->ySrc,
+                            pgO->cxSrc,
+                            pgO->cySrc,
+                            pgO->dwRop,
+                            0);
+        }
+
+        // Restore attributes
+        if (bSrcXform)
+        {
+           pdcattrSrc->ptlWindowOrg   = ptlWindowOrg;
+           pdcattrSrc->szlWindowExt   = szlWindowExt;
+           pdcattrSrc->ptlViewportOrg = ptlViewportOrg;
+           pdcattrSrc->szlViewportExt = szlViewportExt;
+           pdcattrSrc->flXform |= (PAGE_XLATE_CHANGED | PAGE_EXTENTS_CHANGED |
+                                   WORLD_XFORM_CHANGED | DEVICE_TO_WORLD_INVALID);
+        }
+        pdcattrSrc->crBackgroundClr = crSrcBkColor;
+        pdcattr->crForegroundClr = crColor;
+        pdcattr->crBackgroundClr = crBkColor;
+        break;
+     }
+
      case GdiBCSetBrushOrg:
      {
         PGDIBSSETBRHORG pgSBO;
@@ -499,11 +648,27 @@ NtGdiFlushUserBatch(VOID)
     if (hDC || GdiBatchCount)
     {
       PCHAR pHdr = (PCHAR)&pTeb->GdiTebBatch.Buffer[0];
-      PDC pDC = NULL;
+      PDC pDC = NULL, pdcSrc = NULL;
+      HDC ahDC[2];
+      PGDIOBJ apObj[2];
 
       if (GDI_HANDLE_GET_TYPE(hDC) == GDILoObjType_LO_DC_TYPE && GreIsHandleValid(hDC))
       {
-          pDC = DC_LockDc(hDC);
+          // Lock the source DC of the blts together with the batch DC, in
+          // the same order as NtGdiBitBlt does, so they cannot deadlock
+          // with another thread blting between the two.
+          ahDC[0] = hDC;
+          ahDC[1] = GdiGetBatchSourceDc(hDC, pHdr, GdiBatchCount);
+          if (ahDC[1] &&
+              GDIOBJ_bLockMultipleObjects(2, (HGDIOBJ*)ahDC, apObj, GDIObjType_DC_TYPE))
+          {
+              pDC = apObj[0];
+              pdcSrc = apObj[1];
+          }
+          else
+          {
+              pDC = DC_LockDc(hDC);
+          }
       }
 
        // No need to init anything, just go!
@@ -511,11 +676,16 @@ NtGdiFlushUserBatch(VOID)
        {
            ULONG Size;
            // Process Gdi Batch!
-           Size = GdiFlushUserBatch(pDC, (PGDIBATCHHDR) pHdr);
+           Size = GdiFlushUserBatch(pDC, pdcSrc, (PGDIBATCHHDR) pHdr);
            if (!Size) break;
            pHdr += Size;
        }
 
+       if (pdcSrc)
+       {
+           DC_UnlockDc(pdcSrc);
+       }
+
        if (pDC)
        {
            DC_UnlockDc(pDC);
@@ -288,6 +288,7 @@ DbgGdiHTIntegrityCheck(VOID)
 {
 	ULONG i, nDeleted = 0, nFree = 0, nUsed = 0;
 	PGDI_TABLE_ENTRY pEntry;
+	GDI_HANDLE_CACHE_STATISTICS Statistics;
 	BOOL r = 1;
 
 	KeEnterCriticalRegion();
@@ -392,11 +393,14 @@ DbgGdiHTIntegrityCheck(VOID)
 		}
 	}
 
-	if (RESERVE_ENTRIES_COUNT + nDeleted + nFree + nUsed != GDI_HANDLE_COUNT)
+	/* Deleted entries can also be in the caches of the processors */
+	GDIOBJ_vGetHandleCacheStatistics(&Statistics);
+
+	if (RESERVE_ENTRIES_COUNT + nDeleted + Statistics.cCached + nFree + nUsed != GDI_HANDLE_COUNT)
 	{
 		r = 0;
-		DPRINT1("Number of all entries incorrect: RESERVE_ENTRIES_COUNT = %lu, nDeleted = %lu, nFree = %lu, nUsed = %lu\n",
-		        RESERVE_ENTRIES_COUNT, nDeleted, nFree, nUsed);
+		DPRINT1("Number of all entries incorrect: RESERVE_ENTRIES_COUNT = %lu, nDeleted = %lu, nCached = %lu, nFree = %lu, nUsed = %lu\n",
+		        RESERVE_ENTRIES_COUNT, nDeleted, Statistics.cCached, nFree, nUsed);
 	}
 
 	KeLeaveCriticalRegion();
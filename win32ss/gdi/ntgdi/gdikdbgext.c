@@ -69,6 +69,8 @@ KdbCommand_Gdi_help(VOID)
              "- handle <handle> - Displays information about a handle\n"
              "- entry <entry> - Displays an ENTRY, <entry> can be a pointer or index\n"
              "- baseobject <object> - Displays a BASEOBJECT\n"
+             "- handlecache - Displays the counters of the free handle caches\n"
+             "- fontcache - Displays the counters of the glyph cache\n"
 #if DBG_ENABLE_EVENT_LOGGING
              "- eventlist <object> - Displays the eventlist for an object\n"
 #endif
@@ -319,6 +321,44 @@ KdbCommand_Gdi_eventlist(char *argv)
 }
 #endif
 
+static
+VOID
+KdbCommand_Gdi_handlecache(VOID)
+{
+    GDI_HANDLE_CACHE_STATISTICS Statistics;
+
+    GDIOBJ_vGetHandleCacheStatistics(&Statistics);
+    DbgPrint("Free handles cached:  %lu\n"
+             "Allocation hits:      %I64u\n"
+             "Allocation misses:    %I64u\n"
+             "Flushes:              %I64u\n"
+             "Free list retries:    %lu\n",
+             Statistics.cCached,
+             Statistics.cHits,
+             Statistics.cMisses,
+             Statistics.cFlushes,
+             Statistics.cFreeListRetries);
+}
+
+static
+VOID
+KdbCommand_Gdi_fontcache(VOID)
+{
+    FONT_CACHE_STATISTICS Statistics;
+
+    IntGetFontCacheStatistics(&Statistics);
+    DbgPrint("Cached glyphs:        %lu\n"
+             "Cached bytes:         %Iu\n"
+             "Lookup hits:          %I64u\n"
+             "Lookup misses:        %I64u\n"
+             "Evictions:            %I64u\n",
+             Statistics.Entries,
+             Statistics.Bytes,
+             Statistics.Hits,
+             Statistics.Misses,
+             Statistics.Evictions);
+}
+
 BOOLEAN
 NTAPI
 DbgGdiKdbgCliCallback(
@@ -347,6 +387,14 @@ DbgGdiKdbgCliCallback(
     {
         KdbCommand_Gdi_baseobject(argv[1]);
     }
+    else if (_stricmp(argv[0], "!gdi.handlecache") == 0)
+    {
+        KdbCommand_Gdi_handlecache();
+    }
+    else if (_stricmp(argv[0], "!gdi.fontcache") == 0)
+    {
+        KdbCommand_Gdi_fontcache();
+    }
 #if DBG_ENABLE_EVENT_LOGGING
     else if (_stricmp(argv[0], "!gdi.eventlist") == 0)
     {
@@ -28,6 +28,20 @@
  *   this is the only way it can ever be exclusively locked. It prevents the
  *   object from being locked by another thread. A shared lock will simply fail,
  *   while an exclusive lock will succeed after the object was unlocked.
+ * - Every handle that is owned by a process is linked into a list of that
+ *   process, through gpaOwnerLinks, which has an entry for each handle like
+ *   gpaulRefCount. The list head and its lock are in the PROCESSINFO. The
+ *   links change together with the process' GDIHandleCount, and let
+ *   GDI_CleanupForProcess delete the handles of a process without looking
+ *   at all the others. A link also records the PROCESSINFO of its list,
+ *   so a handle whose owner's id was given to a new process is not taken
+ *   off the list of that one. Handles given to a process before it has a
+ *   PROCESSINFO cannot be linked. They are marked as pending instead, and
+ *   GDI_CleanupForProcess scans the table for them while any exist.
+ * - Free handle entries are kept in a small cache for each processor, which
+ *   is only touched by that processor at DISPATCH_LEVEL. The global free
+ *   list, starting at gulFirstFree, only sees batches of entries, when a
+ *   cache runs empty or full.
  *
  * Ownership:
  *
@@ -133,6 +147,35 @@ ASSERT_LOCK_ORDER(
 
 #define GDIOBJ_POOL_TAG(type) ('00hG' + (((type) & 0x1f) << 24))
 
+/* Links of a handle in the list of its owner process, 0 ends the list.
+   ppiOwner is the PROCESSINFO of that list, it is only compared. */
+typedef struct _ENTRY_LINK
+{
+    PPROCESSINFO ppiOwner;
+    ULONG iNext;
+    ULONG iPrev;
+} ENTRY_LINK, *PENTRY_LINK;
+
+/* iPrev of a handle that is in no list */
+#define ENTRY_NOT_LINKED 0xffffffff
+
+/* iPrev of a handle whose owner had no PROCESSINFO to link it to */
+#define ENTRY_LINK_PENDING 0xfffffffe
+
+/* Free handle entries of a processor. The counters are only changed by that
+   processor, see GDIOBJ_vGetHandleCacheStatistics */
+#define GDI_MAGAZINE_SIZE 64
+#define GDI_MAGAZINE_BATCH 32
+
+typedef struct DECLSPEC_CACHEALIGN _GDI_HANDLE_MAGAZINE
+{
+    ULONG cEntries;
+    ULONG aulIndex[GDI_MAGAZINE_SIZE];
+    ULONGLONG cHits;
+    ULONGLONG cMisses;
+    ULONGLONG cFlushes;
+} GDI_HANDLE_MAGAZINE, *PGDI_HANDLE_MAGAZINE;
+
 enum
 {
     REF_MASK_REUSE = 0xff000000,
@@ -148,8 +191,12 @@ enum
 static PVOID gpvGdiHdlTblSection = NULL;
 PENTRY gpentHmgr;
 PULONG gpaulRefCount;
+static PENTRY_LINK gpaOwnerLinks;
 volatile ULONG gulFirstFree;
 volatile ULONG gulFirstUnused;
+static PGDI_HANDLE_MAGAZINE gpaMagazines;
+static volatile LONG gcFreeListRetries;
+static volatile LONG gcPendingLinks;
 static PPAGED_LOOKASIDE_LIST gpaLookasideList;
 
 static VOID NTAPI GDIOBJ_vCleanup(PVOID ObjectBody);
@@ -302,9 +349,36 @@ InitGdiHandleTable(void)
         return STATUS_INSUFFICIENT_RESOURCES;
     }
 
+    /* Allocate memory for the process links, no handle is linked yet */
+    gpaOwnerLinks = EngAllocSectionMem(&pvSection,
+                                       0,
+                                       GDI_HANDLE_COUNT * sizeof(ENTRY_LINK),
+                                       'loHG');
+    if (!gpaOwnerLinks)
+    {
+        DPRINT1("INITGDI: Failed to allocate owner link table.\n");
+        ObDereferenceObject(gpvGdiHdlTblSection);
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    RtlFillMemory(gpaOwnerLinks, GDI_HANDLE_COUNT * sizeof(ENTRY_LINK), 0xff);
+
     gulFirstFree = 0;
     gulFirstUnused = RESERVE_ENTRIES_COUNT;
 
+    /* Allocate the free handle caches, one for each processor */
+    gpaMagazines = ExAllocatePoolWithTag(NonPagedPoolCacheAligned,
+                                         KeNumberProcessors * sizeof(GDI_HANDLE_MAGAZINE),
+                                         TAG_GDIHNDTBLE);
+    if (!gpaMagazines)
+    {
+        DPRINT1("INITGDI: Failed to allocate the free handle caches.\n");
+        ObDereferenceObject(gpvGdiHdlTblSection);
+        return STATUS_NO_MEMORY;
+    }
+
+    RtlZeroMemory(gpaMagazines, KeNumberProcessors * sizeof(GDI_HANDLE_MAGAZINE));
+
     GdiHandleTable = (PVOID)gpentHmgr;
 
     /* Initialize the lookaside lists */
@@ -327,25 +401,132 @@ InitGdiHandleTable(void)
     return STATUS_SUCCESS;
 }
 
+/* Links a handle into the list of the process that owns it */
+static
+VOID
+ENTRY_vLinkToProcess(PPROCESSINFO ppi, ULONG ulIndex)
+{
+    PENTRY_LINK plink = &gpaOwnerLinks[ulIndex];
+
+    KeEnterCriticalRegion();
+    ExAcquirePushLockExclusive(&ppi->GDIOwnedListLock);
+
+    /* Insert it at the head of the list */
+    ASSERT(plink->iPrev == ENTRY_NOT_LINKED);
+    plink->ppiOwner = ppi;
+    plink->iPrev = 0;
+    plink->iNext = ppi->GDIOwnedListHead;
+    if (plink->iNext != 0)
+        gpaOwnerLinks[plink->iNext].iPrev = ulIndex;
+    ppi->GDIOwnedListHead = ulIndex;
+
+    ExReleasePushLockExclusive(&ppi->GDIOwnedListLock);
+    KeLeaveCriticalRegion();
+}
+
+/* Marks a handle whose owner has no PROCESSINFO, see GDI_CleanupForProcess */
+static
+VOID
+ENTRY_vMarkLinkPending(ULONG ulIndex)
+{
+    ASSERT(gpaOwnerLinks[ulIndex].iPrev == ENTRY_NOT_LINKED);
+    gpaOwnerLinks[ulIndex].iPrev = ENTRY_LINK_PENDING;
+    InterlockedIncrement(&gcPendingLinks);
+}
+
+/*
+ * Called before a handle loses its owner. Returns FALSE if the handle is in
+ * no list, then there is no need to look up its owner. A pending mark is
+ * removed. This is only a hint, ENTRY_bUnlinkFromProcess checks again under
+ * the lock of the list.
+ */
+static
+BOOLEAN
+ENTRY_bIsLinkedToProcess(ULONG ulIndex)
+{
+    PENTRY_LINK plink = &gpaOwnerLinks[ulIndex];
+
+    if (plink->iPrev == ENTRY_LINK_PENDING)
+    {
+        plink->iPrev = ENTRY_NOT_LINKED;
+        InterlockedDecrement(&gcPendingLinks);
+        return FALSE;
+    }
+
+    /* Handles that outlived their process were taken off its list already */
+    return (plink->iPrev != ENTRY_NOT_LINKED);
+}
+
+/* Removes a handle from the list of ppi, returns FALSE if it is not in
+   that list: the cleanup of its owner took it off the list already, or
+   ppi is a later process that got the same id */
+static
+BOOLEAN
+ENTRY_bUnlinkFromProcess(PPROCESSINFO ppi, ULONG ulIndex)
+{
+    PENTRY_LINK plink = &gpaOwnerLinks[ulIndex];
+    BOOLEAN bLinked;
+
+    KeEnterCriticalRegion();
+    ExAcquirePushLockExclusive(&ppi->GDIOwnedListLock);
+
+    bLinked = (plink->iPrev != ENTRY_NOT_LINKED) && (plink->ppiOwner == ppi);
+    if (bLinked)
+    {
+        if (plink->iPrev != 0)
+            gpaOwnerLinks[plink->iPrev].iNext = plink->iNext;
+        else
+            ppi->GDIOwnedListHead = plink->iNext;
+
+        if (plink->iNext != 0)
+            gpaOwnerLinks[plink->iNext].iPrev = plink->iPrev;
+
+        plink->ppiOwner = NULL;
+        plink->iPrev = ENTRY_NOT_LINKED;
+        plink->iNext = 0;
+    }
+
+    ExReleasePushLockExclusive(&ppi->GDIOwnedListLock);
+    KeLeaveCriticalRegion();
+
+    return bLinked;
+}
+
 FORCEINLINE
 VOID
-IncrementCurrentProcessGdiHandleCount(void)
+IncrementCurrentProcessGdiHandleCount(ULONG ulIndex)
 {
     PPROCESSINFO ppi = PsGetCurrentProcessWin32Process();
-    if (ppi) InterlockedIncrement((LONG*)&ppi->GDIHandleCount);
+    if (ppi)
+    {
+        InterlockedIncrement((LONG*)&ppi->GDIHandleCount);
+        ENTRY_vLinkToProcess(ppi, ulIndex);
+    }
+    else
+    {
+        ENTRY_vMarkLinkPending(ulIndex);
+    }
 }
 
 FORCEINLINE
 VOID
-DecrementCurrentProcessGdiHandleCount(void)
+DecrementCurrentProcessGdiHandleCount(ULONG ulIndex)
 {
-    PPROCESSINFO ppi = PsGetCurrentProcessWin32Process();
-    if (ppi) InterlockedDecrement((LONG*)&ppi->GDIHandleCount);
+    PPROCESSINFO ppi;
+
+    if (!ENTRY_bIsLinkedToProcess(ulIndex))
+        return;
+
+    ppi = PsGetCurrentProcessWin32Process();
+    if (ppi && ENTRY_bUnlinkFromProcess(ppi, ulIndex))
+    {
+        InterlockedDecrement((LONG*)&ppi->GDIHandleCount);
+    }
 }
 
 static inline
 VOID
-IncrementGdiHandleCount(ULONG ulProcessId)
+IncrementGdiHandleCount(ULONG ulProcessId, ULONG ulIndex)
 {
     PEPROCESS pep;
     PPROCESSINFO ppi;
@@ -353,64 +534,66 @@ IncrementGdiHandleCount(ULONG ulProcessId)
 
     Status = PsLookupProcessByProcessId(ULongToHandle(ulProcessId), &pep);
     NT_ASSERT(NT_SUCCESS(Status));
-    __analysis_assume(NT_SUCCESS(Status));
+    if (!NT_SUCCESS(Status))
+    {
+        ENTRY_vMarkLinkPending(ulIndex);
+        return;
+    }
 
     ppi = PsGetProcessWin32Process(pep);
-    if (ppi) InterlockedIncrement((LONG*)&ppi->GDIHandleCount);
-    if (NT_SUCCESS(Status)) ObDereferenceObject(pep);
+    if (ppi)
+    {
+        InterlockedIncrement((LONG*)&ppi->GDIHandleCount);
+        ENTRY_vLinkToProcess(ppi, ulIndex);
+    }
+    else
+    {
+        ENTRY_vMarkLinkPending(ulIndex);
+    }
+    ObDereferenceObject(pep);
 }
 
 static inline
 VOID
-DecrementGdiHandleCount(ULONG ulProcessId)
+DecrementGdiHandleCount(ULONG ulProcessId, ULONG ulIndex)
 {
     PEPROCESS pep;
     PPROCESSINFO ppi;
     NTSTATUS Status;
 
+    if (!ENTRY_bIsLinkedToProcess(ulIndex))
+        return;
+
+    /* The owner may be exiting, or be gone with its id given to another
+       process. Its cleanup takes the handle off the list, which the unlink
+       checks under the lock. */
     Status = PsLookupProcessByProcessId(ULongToHandle(ulProcessId), &pep);
-    NT_ASSERT(NT_SUCCESS(Status));
-    __analysis_assume(NT_SUCCESS(Status));
+    if (!NT_SUCCESS(Status)) return;
 
     ppi = PsGetProcessWin32Process(pep);
-    if (ppi) InterlockedDecrement((LONG*)&ppi->GDIHandleCount);
-    if (NT_SUCCESS(Status)) ObDereferenceObject(pep);
+    if (ppi && ENTRY_bUnlinkFromProcess(ppi, ulIndex))
+    {
+        InterlockedDecrement((LONG*)&ppi->GDIHandleCount);
+    }
+    ObDereferenceObject(pep);
 }
 
+/* Pops an entry from the global free list, NULL if it is empty */
 static
 PENTRY
-ENTRY_pentPopFreeEntry(VOID)
+ENTRY_pentPopFreeListEntry(VOID)
 {
     ULONG iFirst, iNext, iPrev;
     PENTRY pentFree;
 
-    DPRINT("Enter InterLockedPopFreeEntry\n");
-
-    do
+    for (;;)
     {
         /* Get the index and sequence number of the first free entry */
         iFirst = InterlockedReadUlong(&gulFirstFree);
 
         /* Check if we have a free entry */
         if (!(iFirst & GDI_HANDLE_INDEX_MASK))
-        {
-            /* Increment FirstUnused and get the new index */
-            iFirst = InterlockedIncrement((LONG*)&gulFirstUnused) - 1;
-
-            /* Check if we have unused entries left */
-            if (iFirst >= GDI_HANDLE_COUNT)
-            {
-                DPRINT1("No more GDI handles left!\n");
-#if DBG_ENABLE_GDIOBJ_BACKTRACES
-                DbgDumpGdiHandleTableWithBT();
-#endif
-                InterlockedDecrement((LONG*)&gulFirstUnused);
-                return 0;
-            }
-
-            /* Return the old entry */
-            return &gpentHmgr[iFirst];
-        }
+            return NULL;
 
         /* Get a pointer to the first free entry */
         pentFree = &gpentHmgr[iFirst & GDI_HANDLE_INDEX_MASK];
@@ -423,8 +606,12 @@ ENTRY_pentPopFreeEntry(VOID)
         iPrev = InterlockedCompareExchange((LONG*)&gulFirstFree,
                                            iNext,
                                            iFirst);
+        if (iPrev == iFirst)
+            break;
+
+        /* Another processor got there first */
+        InterlockedIncrement(&gcFreeListRetries);
     }
-    while (iPrev != iFirst);
 
     /* Sanity check: is entry really free? */
     ASSERT(((ULONG_PTR)pentFree->einfo.pobj & ~GDI_HANDLE_INDEX_MASK) == 0);
@@ -432,13 +619,175 @@ ENTRY_pentPopFreeEntry(VOID)
     return pentFree;
 }
 
+/* Pushes a free entry to the global free list */
+static
+VOID
+ENTRY_vPushFreeListEntry(PENTRY pentFree)
+{
+    ULONG iToFree, iFirst, iPrev, idxToFree;
+
+    idxToFree = pentFree - gpentHmgr;
+
+    for (;;)
+    {
+        /* Get the current first free index and sequence number */
+        iFirst = InterlockedReadUlong(&gulFirstFree);
+
+        /* Set the einfo.pobj member to the index of the first free entry */
+        pentFree->einfo.pobj = UlongToPtr(iFirst & GDI_HANDLE_INDEX_MASK);
+
+        /* Combine new index and increased sequence number in iToFree */
+        iToFree = idxToFree | ((iFirst & ~GDI_HANDLE_INDEX_MASK) + 0x10000);
+
+        /* Try to atomically update the first free entry */
+        iPrev = InterlockedCompareExchange((LONG*)&gulFirstFree,
+                                           iToFree,
+                                           iFirst);
+        if (iPrev == iFirst)
+            break;
+
+        /* Another processor got there first */
+        InterlockedIncrement(&gcFreeListRetries);
+    }
+}
+
+/* The free handle cache of the current processor, at DISPATCH_LEVEL */
+FORCEINLINE
+PGDI_HANDLE_MAGAZINE
+ENTRY_pmagCurrentProcessor(VOID)
+{
+    ASSERT(KeGetCurrentIrql() == DISPATCH_LEVEL);
+    ASSERT(KeGetCurrentProcessorNumber() < (ULONG)KeNumberProcessors);
+    return &gpaMagazines[KeGetCurrentProcessorNumber()];
+}
+
+/* Moves the entries of all the caches to the global free list. This is
+   only done when the handles run out, the thread runs on each processor in
+   turn, so each cache is still only touched by its own processor */
+static
+VOID
+ENTRY_vDrainMagazines(VOID)
+{
+    PGDI_HANDLE_MAGAZINE pmag;
+    ULONG aulBatch[GDI_MAGAZINE_SIZE];
+    ULONG cEntries, i;
+    LONG iProcessor;
+    KIRQL OldIrql;
+
+    for (iProcessor = 0; iProcessor < KeNumberProcessors; iProcessor++)
+    {
+        KeSetSystemAffinityThread((KAFFINITY)1 << iProcessor);
+
+        KeRaiseIrql(DISPATCH_LEVEL, &OldIrql);
+        pmag = ENTRY_pmagCurrentProcessor();
+        cEntries = pmag->cEntries;
+        RtlCopyMemory(aulBatch, pmag->aulIndex, cEntries * sizeof(ULONG));
+        pmag->cEntries = 0;
+        KeLowerIrql(OldIrql);
+
+        for (i = 0; i < cEntries; i++)
+        {
+            ENTRY_vPushFreeListEntry(&gpentHmgr[aulBatch[i]]);
+        }
+    }
+
+    KeRevertToUserAffinityThread();
+}
+
+static
+PENTRY
+ENTRY_pentPopFreeEntry(VOID)
+{
+    PGDI_HANDLE_MAGAZINE pmag;
+    ULONG aulBatch[GDI_MAGAZINE_BATCH];
+    ULONG ulIndex = 0, cBatch, i;
+    PENTRY pentFree;
+    KIRQL OldIrql;
+
+    DPRINT("Enter InterLockedPopFreeEntry\n");
+
+    /* Take an entry from the cache of this processor */
+    KeRaiseIrql(DISPATCH_LEVEL, &OldIrql);
+    pmag = ENTRY_pmagCurrentProcessor();
+    if (pmag->cEntries > 0)
+    {
+        ulIndex = pmag->aulIndex[--pmag->cEntries];
+        pmag->cHits++;
+    }
+    else
+    {
+        pmag->cMisses++;
+    }
+    KeLowerIrql(OldIrql);
+
+    if (ulIndex != 0)
+        return &gpentHmgr[ulIndex];
+
+    /* The cache is empty, get a batch from the global free list */
+    for (cBatch = 0; cBatch < GDI_MAGAZINE_BATCH; cBatch++)
+    {
+        pentFree = ENTRY_pentPopFreeListEntry();
+        if (!pentFree)
+            break;
+
+        aulBatch[cBatch] = pentFree - gpentHmgr;
+    }
+
+    if (cBatch == 0)
+    {
+        /* Increment FirstUnused and get the new index */
+        ulIndex = InterlockedIncrement((LONG*)&gulFirstUnused) - 1;
+
+        /* Check if we have unused entries left */
+        if (ulIndex >= GDI_HANDLE_COUNT)
+        {
+            InterlockedDecrement((LONG*)&gulFirstUnused);
+
+            /* The free entries left may all be in the caches */
+            ENTRY_vDrainMagazines();
+            pentFree = ENTRY_pentPopFreeListEntry();
+            if (pentFree)
+                return pentFree;
+
+            DPRINT1("No more GDI handles left!\n");
+#if DBG_ENABLE_GDIOBJ_BACKTRACES
+            DbgDumpGdiHandleTableWithBT();
+#endif
+            return 0;
+        }
+
+        /* Return the old entry */
+        return &gpentHmgr[ulIndex];
+    }
+
+    /* Keep the first entry and put the others in the cache. The thread
+       may run on another processor now, whose cache may have filled up */
+    KeRaiseIrql(DISPATCH_LEVEL, &OldIrql);
+    pmag = ENTRY_pmagCurrentProcessor();
+    for (i = 1; (i < cBatch) && (pmag->cEntries < GDI_MAGAZINE_SIZE); i++)
+    {
+        pmag->aulIndex[pmag->cEntries++] = aulBatch[i];
+    }
+    KeLowerIrql(OldIrql);
+
+    for (; i < cBatch; i++)
+    {
+        ENTRY_vPushFreeListEntry(&gpentHmgr[aulBatch[i]]);
+    }
+
+    return &gpentHmgr[aulBatch[0]];
+}
+
 /* Pushes an entry of the handle table to the free list,
    The entry must not have any references left */
 static
 VOID
 ENTRY_vPushFreeEntry(PENTRY pentFree)
 {
-    ULONG iToFree, iFirst, iPrev, idxToFree;
+    PGDI_HANDLE_MAGAZINE pmag;
+    ULONG aulBatch[GDI_MAGAZINE_BATCH];
+    ULONG idxToFree, cBatch = 0, i;
+    KIRQL OldIrql;
 
     DPRINT("Enter ENTRY_vPushFreeEntry\n");
 
@@ -446,6 +795,7 @@ ENTRY_vPushFreeEntry(PENTRY pentFree)
     ASSERT((gpaulRefCount[idxToFree] & REF_MASK_INUSE) == 0);
 
     /* Initialize entry */
+    pentFree->einfo.pobj = NULL;
     pentFree->Objt = GDIObjType_DEF_TYPE;
     pentFree->ObjectOwner.ulObj = 0;
     pentFree->pUser = NULL;
@@ -454,23 +804,28 @@ ENTRY_vPushFreeEntry(PENTRY pentFree)
     InterlockedExchangeAdd((LONG*)&gpaulRefCount[idxToFree], REF_INC_REUSE);
     pentFree->FullUnique += 0x0100;
 
-    do
+    /* Put it in the cache of this processor, if it is full move
+       the oldest entries out of it */
+    KeRaiseIrql(DISPATCH_LEVEL, &OldIrql);
+    pmag = ENTRY_pmagCurrentProcessor();
+    if (pmag->cEntries == GDI_MAGAZINE_SIZE)
     {
-        /* Get the current first free index and sequence number */
-        iFirst = InterlockedReadUlong(&gulFirstFree);
-
-        /* Set the einfo.pobj member to the index of the first free entry */
-        pentFree->einfo.pobj = UlongToPtr(iFirst & GDI_HANDLE_INDEX_MASK);
-
-        /* Combine new index and increased sequence number in iToFree */
-        iToFree = idxToFree | ((iFirst & ~GDI_HANDLE_INDEX_MASK) + 0x10000);
+        cBatch = GDI_MAGAZINE_BATCH;
+        RtlCopyMemory(aulBatch, pmag->aulIndex, cBatch * sizeof(ULONG));
+        RtlMoveMemory(pmag->aulIndex,
+                      &pmag->aulIndex[cBatch],
+                      (GDI_MAGAZINE_SIZE - cBatch) * sizeof(ULONG));
+        pmag->cEntries -= cBatch;
+        pmag->cFlushes++;
+    }
+    pmag->aulIndex[pmag->cEntries++] = idxToFree;
+    KeLowerIrql(OldIrql);
 
-        /* Try to atomically update the first free entry */
-        iPrev = InterlockedCompareExchange((LONG*)&gulFirstFree,
-                                           iToFree,
-                                           iFirst);
+    /* And give those to the global free list */
+    for (i = 0; i < cBatch; i++)
+    {
+        ENTRY_vPushFreeListEntry(&gpentHmgr[aulBatch[i]]);
     }
-    while (iPrev != iFirst);
 }
 
 static
@@ -630,7 +985,7 @@ VOID
 NTAPI
 GDIOBJ_vDereferenceObject(POBJ pobj)
 {
-    ULONG cRefs, ulIndex;
+    ULONG cRefs, ulIndex, ulOwner;
 
     /* Calculate the index */
     ulIndex = GDI_HANDLE_GET_INDEX(pobj->hHmgr);
@@ -654,13 +1009,16 @@ GDIOBJ_vDereferenceObject(POBJ pobj)
             ASSERT(pobj->BaseFlags & BASEFLAG_READY_TO_DIE);
 
             /* Check if the handle was process owned */
-            if (gpentHmgr[ulIndex].ObjectOwner.ulObj != GDI_OBJ_HMGR_PUBLIC &&
-                gpentHmgr[ulIndex].ObjectOwner.ulObj != GDI_OBJ_HMGR_NONE)
+            ulOwner = gpentHmgr[ulIndex].ObjectOwner.ulObj;
+            if (ulOwner != GDI_OBJ_HMGR_PUBLIC &&
+                ulOwner != GDI_OBJ_HMGR_NONE)
             {
-                /* Decrement the process handle count */
-                ASSERT(gpentHmgr[ulIndex].ObjectOwner.ulObj ==
-                       HandleToUlong(PsGetCurrentProcessId()));
-                DecrementCurrentProcessGdiHandleCount();
+                /* Decrement the process handle count and unlink the handle,
+                   the last reference may be dropped by another process */
+                if (ulOwner == HandleToUlong(PsGetCurrentProcessId()))
+                    DecrementCurrentProcessGdiHandleCount(ulIndex);
+                else
+                    DecrementGdiHandleCount(ulOwner, ulIndex);
             }
 
             /* Push entry to the free list */
@@ -944,8 +1302,8 @@ GDIOBJ_hInsertObject(
     /* Check if current process is requested owner */
     if (ulOwner == GDI_OBJ_HMGR_POWNED)
     {
-        /* Increment the process handle count */
-        IncrementCurrentProcessGdiHandleCount();
+        /* Increment the process handle count and link the handle */
+        IncrementCurrentProcessGdiHandleCount(pentry - gpentHmgr);
 
         /* Use Process id */
         ulOwner = HandleToUlong(PsGetCurrentProcessId());
@@ -1004,7 +1362,7 @@ GDIOBJ_vSetObjectOwner(
         (ulOldOwner != GDI_OBJ_HMGR_NONE))
     {
         /* Decrement the previous owners handle count */
-        DecrementGdiHandleCount(ulOldOwner);
+        DecrementGdiHandleCount(ulOldOwner, pentry - gpentHmgr);
     }
 
     /* Is the new owner a process? */
@@ -1012,7 +1370,7 @@ GDIOBJ_vSetObjectOwner(
         (ulNewOwner != GDI_OBJ_HMGR_NONE))
     {
         /* Increment the new owners handle count */
-        IncrementGdiHandleCount(ulNewOwner);
+        IncrementGdiHandleCount(ulNewOwner, pentry - gpentHmgr);
     }
     else
     {
@@ -1471,6 +1829,13 @@ GDIOBJ_ConvertToStockObj(HGDIOBJ *phObj)
         return FALSE;
     }
 
+    /* A stock object has no owner, take it from the owner's list */
+    if (pentry->ObjectOwner.ulObj != GDI_OBJ_HMGR_PUBLIC &&
+        pentry->ObjectOwner.ulObj != GDI_OBJ_HMGR_NONE)
+    {
+        DecrementGdiHandleCount(pentry->ObjectOwner.ulObj, pentry - gpentHmgr);
+    }
+
     /* Update the entry */
     pentry->FullUnique |= GDI_ENTRY_STOCK_MASK;
     pentry->ObjectOwner.ulObj = 0;
@@ -1505,9 +1870,10 @@ GDIOBJ_ConvertFromStockObj(HGDIOBJ *phObj)
         return FALSE;
     }
 
-    /* Update the entry */
+    /* Update the entry and add it to the current process' list */
     pentry->FullUnique &= ~GDI_ENTRY_STOCK_MASK;
     pentry->ObjectOwner.ulObj = PtrToUlong(PsGetCurrentProcessId());
+    IncrementCurrentProcessGdiHandleCount(pentry - gpentHmgr);
 
     /* Get the pointer to the BASEOBJECT */
     pobj = pentry->einfo.pobj;
@@ -1599,20 +1965,59 @@ GDI_CleanupForProcess(struct _EPROCESS *Process)
 
     /* Get the current process Id */
     dwProcessId = PtrToUlong(PsGetCurrentProcessId());
+    ppi = PsGetCurrentProcessWin32Process();
 
-    /* Loop all handles in the handle table */
-    for (ulIndex = RESERVE_ENTRIES_COUNT; ulIndex < gulFirstUnused; ulIndex++)
+    /* Loop the handles the process owns */
+    for (;;)
     {
-        pentry = &gpentHmgr[ulIndex];
+        KeEnterCriticalRegion();
+        ExAcquirePushLockExclusive(&ppi->GDIOwnedListLock);
 
-        /* Check if the object is owned by the process */
-        if (pentry->ObjectOwner.ulObj == dwProcessId)
+        /* Deleted objects that are still referenced stay in the list,
+           until their last reference is gone. Skip them. */
+        for (ulIndex = ppi->GDIOwnedListHead;
+             ulIndex != 0;
+             ulIndex = gpaOwnerLinks[ulIndex].iNext)
         {
-            ASSERT(pentry->einfo.pobj->cExclusiveLock == 0);
+            if (gpaulRefCount[ulIndex] & REF_MASK_VALID)
+                break;
+        }
 
-            /* Reference the object and delete it */
+        /* Reference the object, before the list is unlocked */
+        if (ulIndex != 0)
             InterlockedIncrement((LONG*)&gpaulRefCount[ulIndex]);
-            GDIOBJ_vDeleteObject(pentry->einfo.pobj);
+
+        ExReleasePushLockExclusive(&ppi->GDIOwnedListLock);
+        KeLeaveCriticalRegion();
+
+        if (ulIndex == 0)
+            break;
+
+        pentry = &gpentHmgr[ulIndex];
+        ASSERT(pentry->ObjectOwner.ulObj == dwProcessId);
+        ASSERT(pentry->einfo.pobj->cExclusiveLock == 0);
+
+        /* Delete it, this removes it from the list once it is freed */
+        GDIOBJ_vDeleteObject(pentry->einfo.pobj);
+    }
+
+    /* Handles the process got before it had a PROCESSINFO are in no list */
+    if (gcPendingLinks != 0)
+    {
+        for (ulIndex = RESERVE_ENTRIES_COUNT; ulIndex < gulFirstUnused; ulIndex++)
+        {
+            pentry = &gpentHmgr[ulIndex];
+
+            if ((pentry->ObjectOwner.ulObj == dwProcessId) &&
+                (gpaOwnerLinks[ulIndex].iPrev == ENTRY_LINK_PENDING) &&
+                (gpaulRefCount[ulIndex] & REF_MASK_VALID))
+            {
+                ASSERT(pentry->einfo.pobj->cExclusiveLock == 0);
+
+                /* Reference the object and delete it */
+                InterlockedIncrement((LONG*)&gpaulRefCount[ulIndex]);
+                GDIOBJ_vDeleteObject(pentry->einfo.pobj);
+            }
         }
     }
 
@@ -1620,7 +2025,6 @@ GDI_CleanupForProcess(struct _EPROCESS *Process)
     DbgGdiHTIntegrityCheck();
 #endif
 
-    ppi = PsGetCurrentProcessWin32Process();
     DPRINT("Completed cleanup for process %p\n", Process->UniqueProcessId);
     if (ppi->GDIHandleCount != 0)
     {
@@ -1628,25 +2032,51 @@ GDI_CleanupForProcess(struct _EPROCESS *Process)
         ASSERT(FALSE);
     }
 
-    /* Loop all handles in the handle table */
-    for (ulIndex = RESERVE_ENTRIES_COUNT; ulIndex < gulFirstUnused; ulIndex++)
+    /* Report what is left, and take it off the list of the process,
+       which goes away now */
+    KeEnterCriticalRegion();
+    ExAcquirePushLockExclusive(&ppi->GDIOwnedListLock);
+    while (ppi->GDIOwnedListHead != 0)
     {
+        ulIndex = ppi->GDIOwnedListHead;
         pentry = &gpentHmgr[ulIndex];
 
-        /* Check if the object is owned by the process */
-        if (pentry->ObjectOwner.ulObj == dwProcessId)
-        {
-            DPRINT1("Leaking object. Index=%lx, type=0x%x, refcount=%lx\n",
-                    ulIndex, pentry->Objt, gpaulRefCount[ulIndex]);
-            DBG_DUMP_EVENT_LIST(&pentry->einfo.pobj->slhLog);
-            //DBG_CLEANUP_EVENT_LIST(&pentry->einfo.pobj->slhLog);
-            ASSERT(FALSE);
-        }
+        DPRINT1("Leaking object. Index=%lx, type=0x%x, refcount=%lx\n",
+                ulIndex, pentry->Objt, gpaulRefCount[ulIndex]);
+        DBG_DUMP_EVENT_LIST(&pentry->einfo.pobj->slhLog);
+        //DBG_CLEANUP_EVENT_LIST(&pentry->einfo.pobj->slhLog);
+        ASSERT(FALSE);
+
+        ppi->GDIOwnedListHead = gpaOwnerLinks[ulIndex].iNext;
+        gpaOwnerLinks[ulIndex].ppiOwner = NULL;
+        gpaOwnerLinks[ulIndex].iPrev = ENTRY_NOT_LINKED;
+        gpaOwnerLinks[ulIndex].iNext = 0;
     }
+    ExReleasePushLockExclusive(&ppi->GDIOwnedListLock);
+    KeLeaveCriticalRegion();
 
     return TRUE;
 }
 
+VOID
+NTAPI
+GDIOBJ_vGetHandleCacheStatistics(
+    _Out_ PGDI_HANDLE_CACHE_STATISTICS pStatistics)
+{
+    LONG i;
+
+    /* The counters of the other processors may be moving, this is a snapshot */
+    RtlZeroMemory(pStatistics, sizeof(*pStatistics));
+    for (i = 0; i < KeNumberProcessors; i++)
+    {
+        pStatistics->cCached += gpaMagazines[i].cEntries;
+        pStatistics->cHits += gpaMagazines[i].cHits;
+        pStatistics->cMisses += gpaMagazines[i].cMisses;
+        pStatistics->cFlushes += gpaMagazines[i].cFlushes;
+    }
+    pStatistics->cFreeListRetries = gcFreeListRetries;
+}
+
 /// HACK!
 PGDI_POOL
 GetBrushAttrPool(VOID)
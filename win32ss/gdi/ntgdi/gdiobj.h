@@ -194,6 +194,21 @@ NTAPI
 GDIOBJ_pvGetObjectAttr(
     POBJ pobj);
 
+/* Counters of the free handle caches of the processors */
+typedef struct _GDI_HANDLE_CACHE_STATISTICS
+{
+    ULONG cCached;          /* Free entries in the caches now */
+    ULONGLONG cHits;        /* Allocations served by a cache */
+    ULONGLONG cMisses;      /* Allocations that refilled a cache */
+    ULONGLONG cFlushes;     /* Frees that moved entries to the global list */
+    ULONG cFreeListRetries; /* Compare exchanges on the global list that failed */
+} GDI_HANDLE_CACHE_STATISTICS, *PGDI_HANDLE_CACHE_STATISTICS;
+
+VOID
+NTAPI
+GDIOBJ_vGetHandleCacheStatistics(
+    _Out_ PGDI_HANDLE_CACHE_STATISTICS pStatistics);
+
 BOOL    NTAPI GDIOBJ_ConvertToStockObj(HGDIOBJ *hObj);
 BOOL    NTAPI GDIOBJ_ConvertFromStockObj(HGDIOBJ *phObj);
 POBJ    NTAPI GDIOBJ_AllocObjWithHandle(ULONG ObjectType, ULONG cjSize);
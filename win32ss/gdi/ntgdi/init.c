@@ -27,6 +27,9 @@ GdiProcessCreate(PEPROCESS Process)
     InitializeListHead(&ppiCurrent->GDIBrushAttrFreeList);
     InitializeListHead(&ppiCurrent->GDIDcAttrFreeList);
 
+    ExInitializePushLock(&ppiCurrent->GDIOwnedListLock);
+    ppiCurrent->GDIOwnedListHead = 0;
+
     /* Map the GDI handle table to user land */
     Process->Peb->GdiSharedHandleTable = GDI_MapHandleTable(Process);
     Process->Peb->GdiDCAttributeList = GDI_BATCH_LIMIT;
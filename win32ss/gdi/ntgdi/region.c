@@ -508,6 +508,70 @@ REGION_bAddRect(
     return TRUE;
 }
 
+/*
+ * Returns the first rectangle in prcl..prclEnd whose bottom is below y, which
+ * starts the band that contains y, or the first band after it. The bands are
+ * sorted from top to bottom, so this is a binary search.
+ */
+static
+PRECTL
+REGION_pFindBandBelow(
+    _In_ PRECTL prcl,
+    _In_ PRECTL prclEnd,
+    _In_ LONG y)
+{
+    SIZE_T cRects = prclEnd - prcl, cHalf;
+
+    while (cRects > 0)
+    {
+        cHalf = cRects / 2;
+        if (prcl[cHalf].bottom <= y)
+        {
+            prcl += cHalf + 1;
+            cRects -= cHalf + 1;
+        }
+        else
+        {
+            cRects = cHalf;
+        }
+    }
+
+    return prcl;
+}
+
+/*
+ * Returns the first rectangle of the band prcl..prclBandEnd whose right edge
+ * is right of x. The rectangles of a band are sorted from left to right.
+ */
+static
+PRECTL
+REGION_pFindRectRightOf(
+    _In_ PRECTL prcl,
+    _In_ PRECTL prclBandEnd,
+    _In_ LONG x)
+{
+    SIZE_T cRects = prclBandEnd - prcl, cHalf;
+
+    while (cRects > 0)
+    {
+        cHalf = cRects / 2;
+        if (prcl[cHalf].right <= x)
+        {
+            prcl += cHalf + 1;
+            cRects -= cHalf + 1;
+        }
+        else
+        {
+            cRects = cHalf;
+        }
+    }
+
+    return prcl;
+}
+
+/* The end of the band that starts at prcl */
+#define REGION_pBandEnd(prcl, prclEnd) REGION_pFindBandBelow(prcl, prclEnd, (prcl)->bottom)
+
 typedef BOOL (FASTCALL *overlapProcp)(PREGION, PRECT, PRECT, PRECT, PRECT, INT, INT);
 typedef BOOL (FASTCALL *nonOverlapProcp)(PREGION, PRECT, PRECT, INT, INT);
 
@@ -1218,6 +1282,105 @@ REGION_RegionOp(
     return TRUE;
 }
 
+/*!
+ *      Apply the union or the subtraction of a single rectangle to a region,
+ *      in place. Only the bands the rectangle reaches go through
+ *      REGION_RegionOp, together with the band above and below them, so
+ *      they can be coalesced with the new ones. The other bands are left
+ *      where they are, instead of being rebuilt for every rectangle that is
+ *      added to or taken from a region with many bands.
+ *
+ * Results:
+ *      TRUE, FALSE if memory ran out.
+ *
+ * \note Side Effects:
+ *      The rectangles of prgn are changed, its extents are not.
+ *
+ */
+static
+BOOL
+FASTCALL
+REGION_bRectOpInPlace(
+    PREGION prgn,   /* Region to change, with at least two rectangles */
+    PREGION prgnRect, /* Region with the single rectangle */
+    overlapProcp overlapFunc,
+    nonOverlapProcp nonOverlap1Func,
+    nonOverlapProcp nonOverlap2Func)
+{
+    PRECTL prclStart, prclFirst, prclLast, prclEnd;
+    REGION rgnBands, rgnResult;
+    ULONG cPrefix, cBands, cSuffix;
+    BOOL bResult;
+
+    NT_ASSERT(prgn->rdh.nCount > 1);
+    NT_ASSERT(prgnRect->rdh.nCount == 1);
+
+    prclStart = prgn->Buffer;
+    prclEnd = prclStart + prgn->rdh.nCount;
+
+    /* The first band the rectangle reaches, or the one after, and the band above */
+    prclFirst = REGION_pFindBandBelow(prclStart, prclEnd, prgnRect->Buffer->top);
+    if (prclFirst != prclStart)
+    {
+        prclFirst = REGION_pFindBandBelow(prclStart, prclFirst, (prclFirst - 1)->top);
+    }
+
+    /* The band after the last one the rectangle reaches */
+    prclLast = REGION_pFindBandBelow(prclFirst, prclEnd, prgnRect->Buffer->bottom - 1);
+    if ((prclLast != prclEnd) && (prclLast->top < prgnRect->Buffer->bottom))
+    {
+        prclLast = REGION_pBandEnd(prclLast, prclEnd);
+    }
+
+    if (prclLast != prclEnd)
+    {
+        prclLast = REGION_pBandEnd(prclLast, prclEnd);
+    }
+
+    /* Combine only those bands with the rectangle */
+    rgnBands.Buffer = prclFirst;
+    rgnBands.rdh.nCount = prclLast - prclFirst;
+    rgnBands.rdh.rcBound.top = prclFirst->top;
+    NT_ASSERT(rgnBands.rdh.nCount > 0);
+
+    rgnResult.Buffer = &rgnResult.rdh.rcBound;
+    rgnResult.rdh.nCount = 0;
+    rgnResult.rdh.nRgnSize = sizeof(RECT);
+
+    bResult = REGION_RegionOp(&rgnResult,
+                              &rgnBands,
+                              prgnRect,
+                              overlapFunc,
+                              nonOverlap1Func,
+                              nonOverlap2Func);
+
+    /* Replace the bands with the result */
+    cPrefix = prclFirst - prclStart;
+    cBands = rgnBands.rdh.nCount;
+    cSuffix = prclEnd - prclLast;
+    if (bResult)
+    {
+        bResult = REGION_bEnsureBufferSize(prgn, cPrefix + rgnResult.rdh.nCount + cSuffix);
+    }
+
+    if (bResult)
+    {
+        RtlMoveMemory(prgn->Buffer + cPrefix + rgnResult.rdh.nCount,
+                      prgn->Buffer + cPrefix + cBands,
+                      cSuffix * sizeof(RECTL));
+        COPY_RECTS(prgn->Buffer + cPrefix, rgnResult.Buffer, rgnResult.rdh.nCount);
+        prgn->rdh.nCount = cPrefix + rgnResult.rdh.nCount + cSuffix;
+        prgn->rdh.iType = RDH_RECTANGLES;
+    }
+
+    if ((rgnResult.Buffer != NULL) && (rgnResult.Buffer != &rgnResult.rdh.rcBound))
+    {
+        ExFreePoolWithTag(rgnResult.Buffer, TAG_REGION);
+    }
+
+    return bResult;
+}
+
 /***********************************************************************
  *          Region Intersection
  ***********************************************************************/
@@ -1528,12 +1691,26 @@ REGION_UnionRegion(
         return ret;
     }
 
-    if ((ret = REGION_RegionOp(newReg,
-                    reg1,
-                    reg2,
-                    REGION_UnionO,
-                    REGION_UnionNonO,
-                    REGION_UnionNonO)))
+    /* Adding a single rectangle to a region only changes the bands it reaches */
+    if ((newReg == reg1) && (reg1->rdh.nCount > 1) && (reg2->rdh.nCount == 1))
+    {
+        ret = REGION_bRectOpInPlace(newReg,
+                                    reg2,
+                                    REGION_UnionO,
+                                    REGION_UnionNonO,
+                                    REGION_UnionNonO);
+    }
+    else
+    {
+        ret = REGION_RegionOp(newReg,
+                              reg1,
+                              reg2,
+                              REGION_UnionO,
+                              REGION_UnionNonO,
+                              REGION_UnionNonO);
+    }
+
+    if (ret)
     {
     newReg->rdh.rcBound.left = min(reg1->rdh.rcBound.left, reg2->rdh.rcBound.left);
     newReg->rdh.rcBound.top = min(reg1->rdh.rcBound.top, reg2->rdh.rcBound.top);
@@ -1730,7 +1907,17 @@ REGION_SubtractRegion(
         return REGION_CopyRegion(regD, regM);
     }
 
-    if (!REGION_RegionOp(regD,
+    /* Taking a single rectangle from a region only changes the bands it reaches */
+    if ((regD == regM) && (regM->rdh.nCount > 1) && (regS->rdh.nCount == 1))
+    {
+        if (!REGION_bRectOpInPlace(regD,
+                                   regS,
+                                   REGION_SubtractO,
+                                   REGION_SubtractNonO1,
+                                   NULL))
+            return FALSE;
+    }
+    else if (!REGION_RegionOp(regD,
                     regM,
                     regS,
                     REGION_SubtractO,
@@ -2587,16 +2774,18 @@ REGION_PtInRegion(
     INT X,
     INT Y)
 {
-    ULONG i;
-    PRECT r;
+    PRECTL prcl, prclEnd;
 
     if (prgn->rdh.nCount > 0 && INRECT(prgn->rdh.rcBound, X, Y))
     {
-        r =  prgn->Buffer;
-        for (i = 0; i < prgn->rdh.nCount; i++)
+        /* Find the band Y is in, then the rectangle of the band X may be in */
+        prclEnd = prgn->Buffer + prgn->rdh.nCount;
+        prcl = REGION_pFindBandBelow(prgn->Buffer, prclEnd, Y);
+        if ((prcl != prclEnd) && (prcl->top <= Y))
         {
-            if (INRECT(r[i], X, Y))
-                return TRUE;
+            prclEnd = REGION_pBandEnd(prcl, prclEnd);
+            prcl = REGION_pFindRectRightOf(prcl, prclEnd, X);
+            return (prcl != prclEnd) && (prcl->left <= X);
         }
     }
 
@@ -2609,7 +2798,7 @@ REGION_RectInRegion(
     PREGION Rgn,
     const RECTL *rect)
 {
-    PRECTL pCurRect, pRectEnd;
+    PRECTL pCurRect, pRectEnd, pBandEnd;
     RECT rc;
 
     /* Swap the coordinates to make right >= left and bottom >= top */
@@ -2639,24 +2828,20 @@ REGION_RectInRegion(
     /* This is (just) a useful optimization */
     if ((Rgn->rdh.nCount > 0) && EXTENTCHECK(&Rgn->rdh.rcBound, &rc))
     {
-        for (pCurRect = Rgn->Buffer, pRectEnd = pCurRect +
-                                                Rgn->rdh.nCount; pCurRect < pRectEnd; pCurRect++)
-        {
-            if (pCurRect->bottom <= rc.top)
-                continue;             /* Not far enough down yet */
-
-            if (pCurRect->top >= rc.bottom)
-                break;                /* Too far down */
+        pRectEnd = Rgn->Buffer + Rgn->rdh.nCount;
 
-            if (pCurRect->right <= rc.left)
-                continue;              /* Not far enough over yet */
+        /* Skip the bands above the rectangle */
+        pCurRect = REGION_pFindBandBelow(Rgn->Buffer, pRectEnd, rc.top);
 
-            if (pCurRect->left >= rc.right)
-            {
-                continue;
-            }
+        while ((pCurRect != pRectEnd) && (pCurRect->top < rc.bottom))
+        {
+            /* In each band, only the first rectangle ending right of it can overlap */
+            pBandEnd = REGION_pBandEnd(pCurRect, pRectEnd);
+            pCurRect = REGION_pFindRectRightOf(pCurRect, pBandEnd, rc.left);
+            if ((pCurRect != pBandEnd) && (pCurRect->left < rc.right))
+                return TRUE;
 
-            return TRUE;
+            pCurRect = pBandEnd;
         }
     }
 
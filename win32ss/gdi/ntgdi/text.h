@@ -100,6 +100,16 @@ TEXTOBJ_UnlockText(PLFONT plfnt)
     LFONT_ShareUnlockFont(plfnt);
 }
 
+/* Glyph cache statistics, see IntGetFontCacheStatistics */
+typedef struct _FONT_CACHE_STATISTICS
+{
+    ULONG Entries;
+    SIZE_T Bytes;
+    ULONGLONG Hits;
+    ULONGLONG Misses;
+    ULONGLONG Evictions;
+} FONT_CACHE_STATISTICS, *PFONT_CACHE_STATISTICS;
+
 /* dwFlags for IntGdiAddFontResourceEx */
 #define AFRX_WRITE_REGISTRY 0x1
 #define AFRX_ALTERNATIVE_PATH 0x2
@@ -111,6 +121,7 @@ NTSTATUS FASTCALL TextIntCreateFontIndirect(CONST LPLOGFONTW lf, HFONT *NewFont)
 BYTE FASTCALL IntCharSetFromCodePage(UINT uCodePage);
 BOOL FASTCALL InitFontSupport(VOID);
 VOID FASTCALL FreeFontSupport(VOID);
+VOID FASTCALL IntGetFontCacheStatistics(_Out_ PFONT_CACHE_STATISTICS Statistics);
 BOOL FASTCALL IntIsFontRenderingEnabled(VOID);
 BOOL FASTCALL IntIsFontRenderingEnabled(VOID);
 VOID FASTCALL IntEnableFontRendering(BOOL Enable);
@@ -92,6 +92,8 @@ typedef enum _GDIBATCHCMD
     GdiBCSelObj,
     GdiBCDelObj,
     GdiBCDelRgn,
+    GdiBCBitBlt,
+    GdiBCStretchBlt,
 } GDIBATCHCMD, *PGDIBATCHCMD;
 
 typedef enum _TRANSFORMTYPE
@@ -560,6 +562,30 @@ typedef struct _GDIBSOBJECT
   HGDIOBJ hgdiobj;
 } GDIBSOBJECT, *PGDIBSOBJECT;
 
+/* Use with GdiBCBitBlt and GdiBCStretchBlt, BitBlt ignores cxSrc and cySrc.
+   The blts of a batch read from the batch DC and at most one other DC. */
+typedef struct _GDIBSSTRETCHBLT
+{
+  GDIBATCHHDR gbHdr;
+  int xDest;
+  int yDest;
+  int cxDest;
+  int cyDest;
+  HDC hdcSrc;
+  int xSrc;
+  int ySrc;
+  int cxSrc;
+  int cySrc;
+  DWORD dwRop;
+  COLORREF crForegroundClr;
+  COLORREF crBackgroundClr;
+  COLORREF crSrcBackgroundClr;
+  POINTL ptlSrcWindowOrg;
+  SIZEL szlSrcWindowExt;
+  POINTL ptlSrcViewportOrg;
+  SIZEL szlSrcViewportExt;
+} GDIBSSTRETCHBLT, *PGDIBSSTRETCHBLT;
+
 /* Declaration missing in ddk/winddi.h */
 typedef VOID (APIENTRY *PFN_DrvMovePanning)(LONG, LONG, FLONG);
 
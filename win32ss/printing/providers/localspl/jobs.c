@@ -105,6 +105,20 @@ _GlobalJobListCompareRoutine(PVOID FirstStruct, PVOID SecondStruct)
     return A->dwJobID - B->dwJobID;
 }
 
+/**
+ * @name _GlobalJobListHashRoutine
+ *
+ * SKIPLIST_HASH_ROUTINE for the Global Job List.
+ * Job IDs are handed out sequentially, so they can be used as hash values as they are.
+ */
+static DWORD WINAPI
+_GlobalJobListHashRoutine(PVOID Struct)
+{
+    PLOCAL_JOB pJob = (PLOCAL_JOB)Struct;
+
+    return pJob->dwJobID;
+}
+
 /**
  * @name _PrinterJobListCompareRoutine
  *
@@ -165,7 +179,7 @@ InitializeGlobalJobList(void)
 
     DWORD dwErrorCode;
     DWORD dwJobID;
-    HANDLE hFind;
+    HANDLE hFind = NULL;
     PLOCAL_JOB pJob = NULL;
     PWSTR p;
     WCHAR wszFullPath[MAX_PATH];
@@ -180,6 +194,14 @@ InitializeGlobalJobList(void)
     // We will search it by Job ID (supply a pointer to a DWORD in LookupElementSkiplist).
     InitializeSkiplist(&GlobalJobList, DllAllocSplMem, _GlobalJobListCompareRoutine, (PSKIPLIST_FREE_ROUTINE)DllFreeSplMem);
 
+    // Jobs are looked up by ID far more often than the list is walked, so index it by Job ID as well.
+    if (!InitializeHashIndexSkiplist(&GlobalJobList, _GlobalJobListHashRoutine))
+    {
+        dwErrorCode = ERROR_NOT_ENOUGH_MEMORY;
+        ERR("InitializeHashIndexSkiplist failed!\n");
+        goto Cleanup;
+    }
+
     // Construct the full path search pattern.
     CopyMemory(wszFullPath, wszJobDirectory, cchJobDirectory * sizeof(WCHAR));
     CopyMemory(&wszFullPath[cchJobDirectory], wszPath, (cchPath + 1) * sizeof(WCHAR));
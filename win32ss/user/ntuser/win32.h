@@ -293,6 +293,10 @@ typedef struct _PROCESSINFO
     struct _GDI_POOL* pPoolBrushAttr;
     struct _GDI_POOL* pPoolRgnAttr;
 
+    /* The GDI handle entries the process owns, linked by index, see gdiobj.c */
+    EX_PUSH_LOCK GDIOwnedListLock;
+    ULONG GDIOwnedListHead;
+
 #if DBG
     BYTE DbgChannelLevel[DbgChCount];
 #ifndef __cplusplus